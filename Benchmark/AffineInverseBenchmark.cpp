@@ -0,0 +1,77 @@
+#include "Benchmark.h"
+#include "MathFunction.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+	double MaxAbsoluteError(const Matrix4x4& expected, const Matrix4x4& actual) {
+		double maxError = 0.0;
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				maxError = std::max(maxError, std::fabs(static_cast<double>(expected.m[row][column]) - actual.m[row][column]));
+			}
+		}
+		return maxError;
+	}
+
+	bool IsFinite(const Matrix4x4& matrix) {
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				if (!std::isfinite(matrix.m[row][column])) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+}
+
+BENCHMARK_SUITE(AffineInverse) {
+	std::mt19937 engine(options.seed);
+	std::vector<Matrix4x4> rigid = Benchmark::MakeInputs<Matrix4x4>(options, [&] {
+		return MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, Benchmark::RandomVector3(engine, -3.14f, 3.14f), Benchmark::RandomVector3(engine, -10.0f, 10.0f));
+		});
+	std::vector<Matrix4x4> affine = Benchmark::MakeInputs<Matrix4x4>(options, [&] {
+		return MakeAffineMatrix(Benchmark::RandomVector3(engine, 0.5f, 2.0f), Benchmark::RandomVector3(engine, -3.14f, 3.14f), Benchmark::RandomVector3(engine, -10.0f, 10.0f));
+		});
+
+	double rigidError = 0.0;
+	double affineError = 0.0;
+	for (size_t i = 0; i < options.inputCount; ++i) {
+		rigidError = std::max(rigidError, MaxAbsoluteError(InverseScalar(rigid[i]), InverseRigid(rigid[i])));
+		affineError = std::max(affineError, MaxAbsoluteError(InverseScalar(affine[i]), InverseAffine(affine[i])));
+	}
+	Benchmark::Check("InverseRigid ~= Inverse (rotate+translate)", rigidError, 1e-4);
+	Benchmark::Check("InverseAffine ~= Inverse (scale+rotate+translate)", affineError, 1e-4);
+
+	// スケール0の行列でもNaN/Infを出さない
+	Matrix4x4 degenerate = MakeAffineMatrix({ 0.0f, 1.0f, 1.0f }, { 0.3f, 0.2f, 0.1f }, { 1.0f, 2.0f, 3.0f });
+	Benchmark::Check("InverseAffine(singular) is finite", IsFinite(InverseAffine(degenerate)) ? 0.0 : 1.0, 0.0);
+	Matrix4x4 inverse;
+	Benchmark::Check("TryInverseAffine rejects singular", TryInverseAffine(degenerate, inverse) ? 1.0 : 0.0, 0.0);
+
+	// 小さな一様スケール(行列式8e-9)も正則として扱う
+	const float smallScale = 0.002f;
+	double smallScaleError = 0.0;
+	size_t smallScaleRejected = 0;
+	for (size_t i = 0; i < options.inputCount; ++i) {
+		Matrix4x4 scaled = MakeAffineMatrix({ smallScale, smallScale, smallScale }, Benchmark::RandomVector3(engine, -3.14f, 3.14f), Benchmark::RandomVector3(engine, -1.0f, 1.0f));
+		smallScaleRejected += !TryInverseAffine(scaled, inverse);
+		// 逆行列と掛けて単位行列に戻るか(逆行列の要素は1/0.002倍なので誤差は積で見る)
+		Matrix4x4 product = Multiply(scaled, inverse);
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				smallScaleError = std::max(smallScaleError, std::fabs(static_cast<double>(product.m[row][column]) - (row == column ? 1.0 : 0.0)));
+			}
+		}
+	}
+	Benchmark::Check("TryInverseAffine accepts small uniform scale", static_cast<double>(smallScaleRejected), 0.0);
+	Benchmark::Check("InverseAffine * M ~= I (scale 0.002)", smallScaleError, 1e-4);
+
+	Benchmark::Run("Inverse (general)", options, [&](size_t i) { Benchmark::DoNotOptimize(Inverse(rigid[i])); });
+	Benchmark::Run("InverseScalar (general)", options, [&](size_t i) { Benchmark::DoNotOptimize(InverseScalar(rigid[i])); });
+	Benchmark::Run("InverseAffine", options, [&](size_t i) { Benchmark::DoNotOptimize(InverseAffine(affine[i])); });
+	Benchmark::Run("InverseRigid", options, [&](size_t i) { Benchmark::DoNotOptimize(InverseRigid(rigid[i])); });
+}
@@ -0,0 +1,106 @@
+#include "Benchmark.h"
+#include "MathFunction.h"
+#include "TransformBatch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+	double MaxAbsoluteError(const Matrix4x4& expected, const Matrix4x4& actual) {
+		double maxError = 0.0;
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				maxError = std::max(maxError, std::fabs(static_cast<double>(expected.m[row][column]) - actual.m[row][column]));
+			}
+		}
+		return maxError;
+	}
+
+}
+
+BENCHMARK_SUITE(AffineMatrix) {
+	std::mt19937 engine(options.seed);
+	const size_t count = options.inputCount;
+
+	std::vector<float> soa[9];
+	for (std::vector<float>& values : soa) {
+		values.resize(count);
+	}
+	for (size_t i = 0; i < count; ++i) {
+		for (int axis = 0; axis < 3; ++axis) {
+			soa[axis][i] = Benchmark::RandomFloat(engine, 0.1f, 3.0f);
+			soa[3 + axis][i] = Benchmark::RandomFloat(engine, -6.28f, 6.28f);
+			soa[6 + axis][i] = Benchmark::RandomFloat(engine, -10.0f, 10.0f);
+		}
+	}
+	TransformsSoA transforms = { soa[0], soa[1], soa[2], soa[3], soa[4], soa[5], soa[6], soa[7], soa[8] };
+	std::vector<Matrix4x4> matrices(count);
+
+	auto scaleAt = [&](size_t i) { return Vector3{ soa[0][i], soa[1][i], soa[2][i] }; };
+	auto rotateAt = [&](size_t i) { return Vector3{ soa[3][i], soa[4][i], soa[5][i] }; };
+	auto translateAt = [&](size_t i) { return Vector3{ soa[6][i], soa[7][i], soa[8][i] }; };
+
+	MakeAffineMatrices(transforms, matrices);
+	double closedFormError = 0.0;
+	double batchError = 0.0;
+	for (size_t i = 0; i < count; ++i) {
+		Matrix4x4 expected = MakeAffineMatrixByMultiply(scaleAt(i), rotateAt(i), translateAt(i));
+		closedFormError = std::max(closedFormError, MaxAbsoluteError(expected, MakeAffineMatrix(scaleAt(i), rotateAt(i), translateAt(i))));
+		batchError = std::max(batchError, MaxAbsoluteError(expected, matrices[i]));
+	}
+	Benchmark::Check("MakeAffineMatrix ~= ByMultiply", closedFormError, 1e-5);
+	Benchmark::Check("MakeAffineMatrices ~= ByMultiply", batchError, 1e-5);
+
+	// SinCos: 範囲内は多項式、範囲外(大きな角度やNaN)はsinf/cosfと同じ値
+	std::vector<float> angles = Benchmark::MakeInputs<float>(options, [&] { return Benchmark::RandomFloat(engine, -kSinCosMaxAngle, kSinCosMaxAngle); });
+	double sinCosError = 0.0;
+	for (float angle : angles) {
+		float sin, cos;
+		SinCos(angle, sin, cos);
+		sinCosError = std::max({ sinCosError, std::fabs(std::sin(static_cast<double>(angle)) - sin), std::fabs(std::cos(static_cast<double>(angle)) - cos) });
+	}
+	size_t outOfRangeMismatches = 0;
+	for (float angle : { 1.0e5f, -3.0e7f, 2.0e9f, 1.0e30f, NAN }) {
+		float sin, cos;
+		SinCos(angle, sin, cos);
+		float expectedSin = sinf(angle);
+		float expectedCos = cosf(angle);
+		outOfRangeMismatches += std::memcmp(&sin, &expectedSin, sizeof(float)) != 0 || std::memcmp(&cos, &expectedCos, sizeof(float)) != 0;
+	}
+	Benchmark::Check("SinCos ~= sin/cos (|theta| <= 8192)", sinCosError, 1e-6);
+	Benchmark::Check("SinCos == sinf/cosf out of range", static_cast<double>(outOfRangeMismatches), 0.0);
+
+	// 大きな角度を含む4個もスカラー版と同じ行列になる(SIMDの象限計算を通さない)
+	soa[3][1] = 3.0e9f;
+	soa[5][6] = -1.0e20f;
+	MakeAffineMatrices(transforms, matrices);
+	double largeAngleError = 0.0;
+	for (size_t i = 0; i < 8; ++i) {
+		largeAngleError = std::max(largeAngleError, MaxAbsoluteError(MakeAffineMatrix(scaleAt(i), rotateAt(i), translateAt(i)), matrices[i]));
+	}
+	Benchmark::Check("MakeAffineMatrices with huge angles", largeAngleError, 0.0);
+	soa[3][1] = 1.0f;
+	soa[5][6] = 1.0f;
+
+	Benchmark::Run("sinf + cosf", options, [&](size_t i) {
+		Benchmark::DoNotOptimize(sinf(angles[i]));
+		Benchmark::DoNotOptimize(cosf(angles[i]));
+		});
+	Benchmark::Run("SinCos", options, [&](size_t i) {
+		float sin, cos;
+		SinCos(angles[i], sin, cos);
+		Benchmark::DoNotOptimize(sin);
+		Benchmark::DoNotOptimize(cos);
+		});
+	Benchmark::Run("MakeAffineMatrixByMultiply", options, [&](size_t i) {
+		Benchmark::DoNotOptimize(MakeAffineMatrixByMultiply(scaleAt(i), rotateAt(i), translateAt(i)));
+		});
+	Benchmark::Run("MakeAffineMatrix (closed form)", options, [&](size_t i) {
+		Benchmark::DoNotOptimize(MakeAffineMatrix(scaleAt(i), rotateAt(i), translateAt(i)));
+		});
+	Benchmark::RunBatch("MakeAffineMatrices (SoA batch)", options, count, [&] {
+		MakeAffineMatrices(transforms, matrices);
+		Benchmark::DoNotOptimize(matrices[0]);
+		});
+}
@@ -0,0 +1,199 @@
+#pragma once
+#include "Camera.h"
+#include <Matrix4x4.h>
+#include <Vector3.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/// <summary>
+/// ヘッドレスのベンチマーク基盤
+/// 各スイートはBENCHMARK_SUITEで登録し、BenchmarkMainから名前で選んで実行する
+/// </summary>
+namespace Benchmark {
+
+	// 実行オプション
+	struct Options {
+		size_t iterations;// 1項目あたりの計測回数
+		size_t inputCount;// ランダム入力の個数
+		uint32_t seed;// 乱数シード
+	};
+
+	typedef void (*SuiteFunction)(const Options& options);
+
+	/// <summary>
+	/// スイートを登録する(静的初期化から呼ばれる)
+	/// </summary>
+	/// <param name="name">スイート名</param>
+	/// <param name="function">実行関数</param>
+	/// <returns>ダミー値</returns>
+	int RegisterSuite(const char* name, SuiteFunction function);
+
+	/// <summary>
+	/// 計測結果が最適化で消されないようにする
+	/// </summary>
+	template<typename T>
+	inline void DoNotOptimize(const T& value) {
+#if defined(_MSC_VER)
+		static volatile const void* sink;
+		sink = &value;
+#else
+		asm volatile("" : : "r"(&value) : "memory");
+#endif
+	}
+
+	/// <summary>
+	/// body(index)をiterations回呼んで1回あたりのナノ秒を表示する
+	/// indexは入力配列を巡回するために使う
+	/// </summary>
+	/// <param name="name">計測項目名</param>
+	/// <param name="options">実行オプション</param>
+	/// <param name="body">計測する処理</param>
+	/// <returns>1回あたりのナノ秒</returns>
+	template<typename Body>
+	inline double Run(const char* name, const Options& options, Body&& body) {
+		const size_t mask = options.inputCount - 1;
+
+		// キャッシュと分岐予測を温める
+		for (size_t i = 0; i < options.inputCount; ++i) {
+			body(i);
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < options.iterations; ++i) {
+			body(i & mask);
+		}
+		auto end = std::chrono::steady_clock::now();
+
+		double ns = std::chrono::duration<double, std::nano>(end - start).count();
+		double nsPerOp = ns / static_cast<double>(options.iterations);
+		std::printf("  %-44s %10.3f ns/op\n", name, nsPerOp);
+		return nsPerOp;
+	}
+
+	/// <summary>
+	/// 1回でitemsPerCall個を処理するbody()を、合計がiterations個程度になるまで呼んで
+	/// 1要素あたりのナノ秒を表示する
+	/// </summary>
+	/// <param name="name">計測項目名</param>
+	/// <param name="options">実行オプション</param>
+	/// <param name="itemsPerCall">1回の呼び出しで処理する要素数</param>
+	/// <param name="body">計測する処理</param>
+	/// <returns>1要素あたりのナノ秒</returns>
+	template<typename Body>
+	inline double RunBatch(const char* name, const Options& options, size_t itemsPerCall, Body&& body) {
+		size_t calls = itemsPerCall == 0 ? 1 : options.iterations / itemsPerCall;
+		if (calls == 0) {
+			calls = 1;
+		}
+
+		body();
+
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < calls; ++i) {
+			body();
+		}
+		auto end = std::chrono::steady_clock::now();
+
+		double ns = std::chrono::duration<double, std::nano>(end - start).count();
+		double nsPerItem = ns / static_cast<double>(calls * (itemsPerCall == 0 ? 1 : itemsPerCall));
+		std::printf("  %-44s %10.3f ns/item\n", name, nsPerItem);
+		return nsPerItem;
+	}
+
+	/// <summary>
+	/// body()を1回だけ実行して1要素あたりのナノ秒を表示する
+	/// 1回が重い処理(構築やN×Mの総当たり)用
+	/// </summary>
+	/// <param name="name">計測項目名</param>
+	/// <param name="items">body()が処理する要素数</param>
+	/// <param name="body">計測する処理</param>
+	/// <returns>1要素あたりのナノ秒</returns>
+	template<typename Body>
+	inline double RunOnce(const char* name, size_t items, Body&& body) {
+		auto start = std::chrono::steady_clock::now();
+		body();
+		auto end = std::chrono::steady_clock::now();
+
+		double ns = std::chrono::duration<double, std::nano>(end - start).count();
+		double nsPerItem = ns / static_cast<double>(items == 0 ? 1 : items);
+		std::printf("  %-44s %10.3f ns/item\n", name, nsPerItem);
+		return nsPerItem;
+	}
+
+	/// <summary>
+	/// 比較検証の結果を表示する(失敗したら終了コードに反映される)
+	/// </summary>
+	/// <param name="name">検証項目名</param>
+	/// <param name="maxError">最大誤差</param>
+	/// <param name="tolerance">許容誤差</param>
+	void Check(const char* name, double maxError, double tolerance);
+
+	// 検証に失敗した数
+	int FailureCount();
+
+	// operator newを数える版に置き換えているか(CountingAllocator.cpp、MT3_BENCHMARK_COUNT_ALLOCATIONS)
+	bool IsCountingAllocations();
+
+	// 起動してからのoperator newの呼び出し回数(数えていなければ常に0)
+	size_t GetAllocationCount();
+
+	// [min, max)の一様乱数
+	inline float RandomFloat(std::mt19937& engine, float min, float max) {
+		std::uniform_real_distribution<float> distribution(min, max);
+		return distribution(engine);
+	}
+
+	inline Vector3 RandomVector3(std::mt19937& engine, float min, float max) {
+		return { RandomFloat(engine, min, max), RandomFloat(engine, min, max), RandomFloat(engine, min, max) };
+	}
+
+	/// <summary>
+	/// 各要素が[min, max)の乱数の行列
+	/// </summary>
+	inline Matrix4x4 RandomMatrix(std::mt19937& engine, float min, float max) {
+		Matrix4x4 matrix;
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				matrix.m[row][column] = RandomFloat(engine, min, max);
+			}
+		}
+		return matrix;
+	}
+
+	/// <summary>
+	/// main.cppの起動直後と同じカメラ(1280x720、少し見下ろす位置)
+	/// 行列と視錐台はGet系で取り出す
+	/// </summary>
+	inline Camera MakeMainCamera() {
+		Camera camera;
+		camera.SetRotate({ 0.26f, 0.0f, 0.0f });
+		camera.SetTranslate({ 0.0f, 1.9f, -6.49f });
+		camera.SetPerspective(0.45f, 1280.0f / 720.0f, 0.1f, 100.0f);
+		camera.SetViewport(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f);
+		return camera;
+	}
+
+	template<typename T, typename Generator>
+	inline std::vector<T> MakeInputs(const Options& options, Generator&& generator) {
+		std::vector<T> inputs;
+		inputs.reserve(options.inputCount);
+		for (size_t i = 0; i < options.inputCount; ++i) {
+			inputs.push_back(generator());
+		}
+		return inputs;
+	}
+
+}
+
+#define BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_IMPL(a, b)
+
+// スイートを定義して登録する
+#define BENCHMARK_SUITE(name) \
+	static void BENCHMARK_CONCAT(BenchmarkSuite_, name)(const Benchmark::Options& options); \
+	static const int BENCHMARK_CONCAT(benchmarkSuiteRegistered_, name) = Benchmark::RegisterSuite(#name, &BENCHMARK_CONCAT(BenchmarkSuite_, name)); \
+	static void BENCHMARK_CONCAT(BenchmarkSuite_, name)([[maybe_unused]] const Benchmark::Options& options)
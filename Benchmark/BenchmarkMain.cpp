@@ -0,0 +1,99 @@
+#include "Benchmark.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+	struct Suite {
+		const char* name;
+		Benchmark::SuiteFunction function;
+	};
+
+	// 静的初期化の順序に依存しないよう関数内staticで持つ
+	std::vector<Suite>& Suites() {
+		static std::vector<Suite> suites;
+		return suites;
+	}
+
+	int failureCount = 0;
+
+	// 2のべき乗に切り上げる(入力の巡回をマスクで行うため)
+	size_t RoundUpToPowerOfTwo(size_t value) {
+		size_t result = 1;
+		while (result < value) {
+			result <<= 1;
+		}
+		return result;
+	}
+
+	void PrintUsage(const char* program) {
+		std::printf("usage: %s [--iterations N] [--inputs N] [--seed N] [--list] [suite...]\n", program);
+	}
+
+}
+
+int Benchmark::RegisterSuite(const char* name, SuiteFunction function) {
+	Suites().push_back({ name, function });
+	return 0;
+}
+
+void Benchmark::Check(const char* name, double maxError, double tolerance) {
+	bool passed = maxError <= tolerance;
+	if (!passed) {
+		++failureCount;
+	}
+	std::printf("  %-44s %s (max error %.3g, tolerance %.3g)\n", name, passed ? "OK  " : "FAIL", maxError, tolerance);
+}
+
+int Benchmark::FailureCount() {
+	return failureCount;
+}
+
+int main(int argc, char** argv) {
+	Benchmark::Options options = { 1u << 22, 1u << 16, 12345u };
+	std::vector<const char*> filters;
+
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+			options.iterations = std::strtoull(argv[++i], nullptr, 10);
+		} else if (std::strcmp(argv[i], "--inputs") == 0 && i + 1 < argc) {
+			options.inputCount = std::strtoull(argv[++i], nullptr, 10);
+		} else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+			options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		} else if (std::strcmp(argv[i], "--list") == 0) {
+			for (const Suite& suite : Suites()) {
+				std::printf("%s\n", suite.name);
+			}
+			return 0;
+		} else if (argv[i][0] == '-') {
+			PrintUsage(argv[0]);
+			return 2;
+		} else {
+			filters.push_back(argv[i]);
+		}
+	}
+
+	options.inputCount = RoundUpToPowerOfTwo(options.inputCount == 0 ? 1 : options.inputCount);
+	if (options.iterations == 0) {
+		options.iterations = 1;
+	}
+
+	std::printf("iterations %zu, inputs %zu, seed %u\n", options.iterations, options.inputCount, options.seed);
+
+	for (const Suite& suite : Suites()) {
+		bool selected = filters.empty();
+		for (const char* filter : filters) {
+			if (std::strcmp(filter, suite.name) == 0) {
+				selected = true;
+			}
+		}
+		if (!selected) {
+			continue;
+		}
+
+		std::printf("[%s]\n", suite.name);
+		suite.function(options);
+	}
+
+	return Benchmark::FailureCount() == 0 ? 0 : 1;
+}
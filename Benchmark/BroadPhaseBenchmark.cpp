@@ -0,0 +1,198 @@
+#include "Benchmark.h"
+#include "BroadPhase.h"
+#include "MathFunction.h"
+#include <cmath>
+#include <string>
+
+namespace {
+
+	// 密度が一定になるようにN個の球と線分を並べた場面
+	struct Scene {
+		std::vector<Sphere> spheres;
+		std::vector<Segment> segments;
+		std::vector<AABB> queryBoxes;
+		std::vector<Segment> querySegments;
+	};
+
+	Scene MakeScene(std::mt19937& engine, size_t objectCount, size_t queryCount) {
+		const float halfExtent = 10.0f * std::cbrt(static_cast<float>(objectCount) / 1000.0f);
+		Scene scene;
+		for (size_t i = 0; i < objectCount; ++i) {
+			Vector3 position = Benchmark::RandomVector3(engine, -halfExtent, halfExtent);
+			if (i % 2 == 0) {
+				scene.spheres.push_back({ position, Benchmark::RandomFloat(engine, 0.1f, 0.5f) });
+			} else {
+				scene.segments.push_back({ position, Add(position, Benchmark::RandomVector3(engine, -0.5f, 0.5f)) });
+			}
+		}
+		for (size_t i = 0; i < queryCount; ++i) {
+			Vector3 center = Benchmark::RandomVector3(engine, -halfExtent, halfExtent);
+			scene.queryBoxes.push_back({ Subtract(center, { 1.0f, 1.0f, 1.0f }), Add(center, { 1.0f, 1.0f, 1.0f }) });
+			scene.querySegments.push_back({ center, Add(center, Benchmark::RandomVector3(engine, -2.0f, 2.0f)) });
+		}
+		return scene;
+	}
+
+	void RunScale(const Benchmark::Options& options, size_t objectCount) {
+		const size_t queryCount = 1000;
+		std::mt19937 engine(options.seed);
+		Scene scene = MakeScene(engine, objectCount, queryCount);
+
+		// 総当たり用に各形状のAABBを先に求めておく
+		std::vector<AABB> bounds;
+		for (const Sphere& sphere : scene.spheres) {
+			bounds.push_back(MakeAABB(sphere));
+		}
+		for (const Segment& segment : scene.segments) {
+			bounds.push_back(MakeAABB(segment));
+		}
+
+		std::printf("  -- %zu objects, %zu queries\n", objectCount, queryCount);
+		std::string label = std::to_string(objectCount / 1000) + "k";
+
+		BroadPhase broadPhase;
+		std::vector<BroadPhase::Handle> handles;
+		handles.reserve(objectCount);
+		Benchmark::RunOnce(("build (" + label + ")").c_str(), objectCount, [&] {
+			for (size_t i = 0; i < scene.spheres.size(); ++i) {
+				handles.push_back(broadPhase.Add(scene.spheres[i], static_cast<uint32_t>(i)));
+			}
+			for (size_t i = 0; i < scene.segments.size(); ++i) {
+				handles.push_back(broadPhase.Add(scene.segments[i], static_cast<uint32_t>(scene.spheres.size() + i)));
+			}
+			});
+		std::printf("  tree height %d\n", broadPhase.GetTree().GetHeight());
+
+		// AABBの候補は総当たりの結果をすべて含んでいるはず
+		std::vector<uint8_t> found(objectCount);
+		size_t missing = 0;
+		for (size_t q = 0; q < 100; ++q) {
+			std::fill(found.begin(), found.end(), uint8_t(0));
+			broadPhase.QueryOverlap(scene.queryBoxes[q], [&](BroadPhase::Handle handle) {
+				found[broadPhase.GetUserData(handle)] = 1;
+				return true;
+				});
+			for (size_t i = 0; i < objectCount; ++i) {
+				if (IsCollision(bounds[i], scene.queryBoxes[q]) && !found[i]) {
+					++missing;
+				}
+			}
+		}
+		Benchmark::Check(("overlap candidates cover brute force (" + label + ")").c_str(), static_cast<double>(missing), 0.0);
+
+		size_t hits = 0;
+		Benchmark::RunOnce(("overlap brute force (" + label + ")").c_str(), queryCount, [&] {
+			for (const AABB& query : scene.queryBoxes) {
+				for (const AABB& aabb : bounds) {
+					hits += IsCollision(aabb, query);
+				}
+			}
+			});
+		Benchmark::RunOnce(("overlap BVH (" + label + ")").c_str(), queryCount, [&] {
+			for (const AABB& query : scene.queryBoxes) {
+				broadPhase.QueryOverlap(query, [&](BroadPhase::Handle) { ++hits; return true; });
+			}
+			});
+
+		Benchmark::RunOnce(("segment brute force (" + label + ")").c_str(), queryCount, [&] {
+			for (const Segment& query : scene.querySegments) {
+				Vector3 direction = Subtract(query.diff, query.origin);
+				Vector3 inverseDirection = { 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+				for (const AABB& aabb : bounds) {
+					float t;
+					hits += IntersectRayAABB(query.origin, inverseDirection, aabb, 1.0f, t);
+				}
+			}
+			});
+		Benchmark::RunOnce(("segment BVH (" + label + ")").c_str(), queryCount, [&] {
+			for (const Segment& query : scene.querySegments) {
+				broadPhase.QuerySegment(query, [&](BroadPhase::Handle) { ++hits; return true; });
+			}
+			});
+
+		// 全体を少しずつ動かしてツリーを更新する
+		Benchmark::RunOnce(("refit all (" + label + ")").c_str(), objectCount, [&] {
+			for (size_t i = 0; i < scene.spheres.size(); ++i) {
+				scene.spheres[i].center.x += 0.05f;
+				broadPhase.Update(handles[i], scene.spheres[i]);
+			}
+			for (size_t i = 0; i < scene.segments.size(); ++i) {
+				scene.segments[i].origin.y += 0.2f;
+				scene.segments[i].diff.y += 0.2f;
+				broadPhase.Update(handles[scene.spheres.size() + i], scene.segments[i]);
+			}
+			});
+
+		Benchmark::RunOnce(("remove all (" + label + ")").c_str(), objectCount, [&] {
+			for (BroadPhase::Handle handle : handles) {
+				broadPhase.Remove(handle);
+			}
+			});
+		Benchmark::DoNotOptimize(hits);
+	}
+
+	// 削除済みや再利用されたスロットの古いハンドルは何も壊さずに弾かれる
+	void CheckHandles() {
+		BroadPhase broadPhase;
+		BroadPhase::Handle sphere = broadPhase.Add(Sphere{ { 0.0f, 0.0f, 0.0f }, 1.0f }, 10);
+		BroadPhase::Handle plane = broadPhase.Add(Plane{ { 0.0f, 1.0f, 0.0f }, 0.0f }, 11);
+		BroadPhase::Handle segment = broadPhase.Add(Segment{ { 5.0f, 0.0f, 0.0f }, { 6.0f, 0.0f, 0.0f } }, 12);
+
+		size_t errors = 0;
+		errors += !broadPhase.Remove(sphere);
+		errors += broadPhase.Remove(sphere);// 二重の削除
+		errors += broadPhase.IsValid(sphere);
+		errors += broadPhase.Update(sphere, Sphere{ { 1.0f, 0.0f, 0.0f }, 1.0f });
+
+		// 空いたスロットを再利用しても古いハンドルは別物
+		BroadPhase::Handle reused = broadPhase.Add(Sphere{ { 0.0f, 3.0f, 0.0f }, 1.0f }, 13);
+		errors += reused.slot != sphere.slot || reused == sphere;
+		errors += broadPhase.Remove(sphere);
+		errors += !broadPhase.IsValid(reused) || broadPhase.GetUserData(reused) != 13;
+
+		// 種類の違う更新は弾く
+		errors += broadPhase.Update(plane, Sphere{ { 0.0f, 0.0f, 0.0f }, 1.0f });
+		errors += !broadPhase.Update(segment, Segment{ { 5.0f, 1.0f, 0.0f }, { 6.0f, 1.0f, 0.0f } });
+		errors += broadPhase.GetCount() != 3;
+
+		// 残った形状はすべてクエリで見つかる
+		size_t found = 0;
+		broadPhase.QueryOverlap({ { -10.0f, -10.0f, -10.0f }, { 10.0f, 10.0f, 10.0f } }, [&](BroadPhase::Handle handle) {
+			found += broadPhase.IsValid(handle);
+			return true;
+			});
+		errors += found != 3;
+		Benchmark::Check("stale and double-removed handles are rejected", static_cast<double>(errors), 0.0);
+	}
+
+	// 軸と平行なレイが始点をAABBの面の上に置いても当たる(0*infのNaNを落とさない)
+	void CheckParallelRays() {
+		const AABB box = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } };
+		const Vector3 inverseX = { 1.0f, INFINITY, INFINITY };
+		size_t errors = 0;
+		float t = -1.0f;
+		errors += !IntersectRayAABB({ -1.0f, 1.0f, 0.0f }, inverseX, box, 10.0f, t) || t != 1.0f;// 上面と手前の面が交わる辺の上
+		errors += !IntersectRayAABB({ 0.0f, 0.5f, 1.0f }, inverseX, box, 10.0f, t) || t != 0.0f;
+		errors += IntersectRayAABB({ -1.0f, 1.5f, 0.5f }, inverseX, box, 10.0f, t);// 平行で外側
+		errors += IntersectRayAABB({ -1.0f, 1.0f, 0.5f }, { -1.0f, INFINITY, INFINITY }, box, 10.0f, t);// 面の上を逆向き
+
+		// ツリーでも同じ(葉のfat AABBの上面をなぞる)
+		DynamicAABBTree tree;
+		tree.CreateProxy(box, 0);
+		const float top = box.max.y + DynamicAABBTree::kAABBMargin;
+		size_t hits = 0;
+		tree.RayCast({ -1.0f, top, 0.5f }, { 1.0f, 0.0f, 0.0f }, 10.0f, [&](int32_t, float maxT) { ++hits; return maxT; });
+		tree.RayCast({ -1.0f, top + 0.5f, 0.5f }, { 1.0f, 0.0f, 0.0f }, 10.0f, [&](int32_t, float maxT) { hits += 10; return maxT; });
+		errors += hits != 1;
+		Benchmark::Check("axis-parallel rays on a face hit the AABB", static_cast<double>(errors), 0.0);
+	}
+
+}
+
+BENCHMARK_SUITE(BroadPhase) {
+	CheckHandles();
+	CheckParallelRays();
+	RunScale(options, 1000);
+	RunScale(options, 10000);
+	RunScale(options, 100000);
+}
@@ -0,0 +1,109 @@
+#include "Benchmark.h"
+#include "Camera.h"
+#include "MathFunction.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+	double GetMaxDifference(const Matrix4x4& a, const Matrix4x4& b) {
+		double difference = 0.0;
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				difference = std::max(difference, std::fabs(static_cast<double>(a.m[row][column]) - b.m[row][column]));
+			}
+		}
+		return difference;
+	}
+
+	double GetMaxDifference(const Frustum& a, const Frustum& b) {
+		double difference = 0.0;
+		for (int i = 0; i < Frustum::kPlaneCount; ++i) {
+			difference = std::max({ difference,
+				std::fabs(static_cast<double>(a.planes[i].normal.x) - b.planes[i].normal.x),
+				std::fabs(static_cast<double>(a.planes[i].normal.y) - b.planes[i].normal.y),
+				std::fabs(static_cast<double>(a.planes[i].normal.z) - b.planes[i].normal.z),
+				std::fabs(static_cast<double>(a.planes[i].distance) - b.planes[i].distance) });
+		}
+		return difference;
+	}
+
+}
+
+BENCHMARK_SUITE(Camera) {
+	// ランダムに値を変えながら、キャッシュした行列が毎回作った行列と一致するか
+	std::mt19937 engine(options.seed);
+	Camera camera;
+	Vector3 rotate = { 0.26f, 0.0f, 0.0f };
+	Vector3 translate = { 0.0f, 1.9f, -6.49f };
+	float fovY = 0.45f;
+	float viewportWidth = 1280.0f;
+	double maxError = 0.0;
+	for (int step = 0; step < 1000; ++step) {
+		switch (engine() % 4) {
+		case 0: rotate = Benchmark::RandomVector3(engine, -3.0f, 3.0f); break;
+		case 1: translate = Benchmark::RandomVector3(engine, -10.0f, 10.0f); break;
+		case 2: fovY = Benchmark::RandomFloat(engine, 0.3f, 1.2f); break;
+		default: viewportWidth = Benchmark::RandomFloat(engine, 320.0f, 1920.0f); break;
+		}
+		camera.SetRotate(rotate);
+		camera.SetTranslate(translate);
+		camera.SetPerspective(fovY, 1280.0f / 720.0f, 0.1f, 100.0f);
+		camera.SetViewport(0, 0, viewportWidth, 720, 0.0f, 1.0f);
+
+		// 取り出す順番も変えて、途中の行列だけを先に作った場合も確かめる
+		if (step % 3 == 0) {
+			camera.GetFrustum();
+		} else if (step % 3 == 1) {
+			camera.GetViewportMatrix();
+		}
+
+		Matrix4x4 view = InverseRigid(MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, rotate, translate));
+		Matrix4x4 viewProjection = Multiply(view, MakePerspectiveFovMatrix(fovY, 1280.0f / 720.0f, 0.1f, 100.0f));
+		Matrix4x4 viewProjectionViewport = Multiply(viewProjection, MakeViewportMatrix(0, 0, viewportWidth, 720, 0.0f, 1.0f));
+		maxError = std::max({ maxError,
+			GetMaxDifference(camera.GetViewMatrix(), view),
+			GetMaxDifference(camera.GetViewProjectionMatrix(), viewProjection),
+			GetMaxDifference(camera.GetViewProjectionViewportMatrix(), viewProjectionViewport),
+			GetMaxDifference(camera.GetFrustum(), MakeFrustum(viewProjection)) });
+	}
+	Benchmark::Check("cached matrices match rebuilt matrices", maxError, 0.0);
+
+	// 同じ値をSetしても汚れない
+	uint32_t revision = camera.GetRevision();
+	camera.SetRotate(rotate);
+	camera.SetTranslate(translate);
+	camera.SetPerspective(fovY, 1280.0f / 720.0f, 0.1f, 100.0f);
+	camera.SetViewport(0, 0, viewportWidth, 720, 0.0f, 1.0f);
+	Benchmark::Check("setting unchanged values keeps the revision", static_cast<double>(camera.GetRevision() - revision), 0.0);
+
+	// 1フレーム分の行列を用意する(ImGuiの値をSetしてVP×ビューポートと視錐台を取り出す)
+	std::vector<Vector3> translates = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, -10.0f, 10.0f); });
+	rotate = { 0.26f, 0.0f, 0.0f };
+	translate = { 0.0f, 1.9f, -6.49f };
+	Benchmark::Run("rebuild every frame (previous WinMain)", options, [&](size_t) {
+		Matrix4x4 cameraMatrix = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, rotate, translate);
+		Matrix4x4 viewMatrix = InverseRigid(cameraMatrix);
+		Matrix4x4 projectionMatrix = MakePerspectiveFovMatrix(0.45f, 1280.0f / 720.0f, 0.1f, 100.0f);
+		Matrix4x4 viewProjectionMatrix = Multiply(viewMatrix, projectionMatrix);
+		Matrix4x4 viewportMatrix = MakeViewportMatrix(0, 0, 1280, 720, 0.0f, 1.0f);
+		Benchmark::DoNotOptimize(Multiply(viewProjectionMatrix, viewportMatrix));
+		Benchmark::DoNotOptimize(MakeFrustum(viewProjectionMatrix));
+		});
+
+	Camera frameCamera;
+	frameCamera.SetPerspective(0.45f, 1280.0f / 720.0f, 0.1f, 100.0f);
+	frameCamera.SetViewport(0, 0, 1280, 720, 0.0f, 1.0f);
+	Benchmark::Run("Camera, nothing changed", options, [&](size_t) {
+		frameCamera.SetRotate(rotate);
+		frameCamera.SetTranslate(translate);
+		Benchmark::DoNotOptimize(frameCamera.GetViewProjectionViewportMatrix());
+		Benchmark::DoNotOptimize(frameCamera.GetFrustum());
+		});
+	Benchmark::Run("Camera, translate changed", options, [&](size_t i) {
+		frameCamera.SetRotate(rotate);
+		frameCamera.SetTranslate(translates[i]);
+		Benchmark::DoNotOptimize(frameCamera.GetViewProjectionViewportMatrix());
+		Benchmark::DoNotOptimize(frameCamera.GetFrustum());
+		});
+}
@@ -0,0 +1,120 @@
+#include "Benchmark.h"
+#include "Collision.h"
+#include "CollisionBatch.h"
+#include "MathFunction.h"
+#include <algorithm>
+#include <cmath>
+
+BENCHMARK_SUITE(CollisionBatch) {
+	const size_t segmentCount = 1024;
+	const size_t otherCount = 64;
+	const size_t pairCount = segmentCount * otherCount;
+
+	std::mt19937 engine(options.seed);
+	std::vector<Segment> segments(segmentCount);
+	std::vector<float> segmentSoA[6];
+	for (std::vector<float>& values : segmentSoA) {
+		values.resize(segmentCount);
+	}
+	for (size_t i = 0; i < segmentCount; ++i) {
+		segments[i].origin = Benchmark::RandomVector3(engine, -5.0f, 5.0f);
+		segments[i].diff = Add(segments[i].origin, Benchmark::RandomVector3(engine, -3.0f, 3.0f));
+		segmentSoA[0][i] = segments[i].origin.x;
+		segmentSoA[1][i] = segments[i].origin.y;
+		segmentSoA[2][i] = segments[i].origin.z;
+		segmentSoA[3][i] = segments[i].diff.x;
+		segmentSoA[4][i] = segments[i].diff.y;
+		segmentSoA[5][i] = segments[i].diff.z;
+	}
+	SegmentsSoA segmentsSoA = { segmentSoA[0], segmentSoA[1], segmentSoA[2], segmentSoA[3], segmentSoA[4], segmentSoA[5] };
+
+	std::vector<Plane> planes(otherCount);
+	std::vector<Sphere> spheres(otherCount);
+	std::vector<float> planeSoA[4];
+	std::vector<float> sphereSoA[4];
+	for (int k = 0; k < 4; ++k) {
+		planeSoA[k].resize(otherCount);
+		sphereSoA[k].resize(otherCount);
+	}
+	for (size_t j = 0; j < otherCount; ++j) {
+		planes[j] = { Normalize(Benchmark::RandomVector3(engine, -1.0f, 1.0f)), Benchmark::RandomFloat(engine, -3.0f, 3.0f) };
+		spheres[j] = { Benchmark::RandomVector3(engine, -5.0f, 5.0f), Benchmark::RandomFloat(engine, 0.2f, 2.0f) };
+		planeSoA[0][j] = planes[j].normal.x;
+		planeSoA[1][j] = planes[j].normal.y;
+		planeSoA[2][j] = planes[j].normal.z;
+		planeSoA[3][j] = planes[j].distance;
+		sphereSoA[0][j] = spheres[j].center.x;
+		sphereSoA[1][j] = spheres[j].center.y;
+		sphereSoA[2][j] = spheres[j].center.z;
+		sphereSoA[3][j] = spheres[j].radius;
+	}
+	PlanesSoA planesSoA = { planeSoA[0], planeSoA[1], planeSoA[2], planeSoA[3] };
+	SpheresSoA spheresSoA = { sphereSoA[0], sphereSoA[1], sphereSoA[2], sphereSoA[3] };
+
+	std::vector<uint8_t> hit(pairCount);
+	std::vector<float> t(pairCount);
+
+	// 1組ずつの判定との一致と、tの位置が平面上/球面上にあることを確認する
+	IsCollisionBatch(segmentsSoA, planesSoA, { hit, t });
+	size_t planeMismatch = 0;
+	double planeTError = 0.0;
+	for (size_t j = 0; j < otherCount; ++j) {
+		for (size_t i = 0; i < segmentCount; ++i) {
+			bool expected = IsCollision(segments[i], planes[j]);
+			planeMismatch += expected != (hit[j * segmentCount + i] != 0);
+			if (expected) {
+				float hitT = t[j * segmentCount + i];
+				Vector3 direction = Subtract(segments[i].diff, segments[i].origin);
+				Vector3 point = Add(segments[i].origin, { direction.x * hitT, direction.y * hitT, direction.z * hitT });
+				planeTError = std::max(planeTError, static_cast<double>(std::fabs(Dot(planes[j].normal, point) - planes[j].distance)));
+			}
+		}
+	}
+	Benchmark::Check("Segment x Plane batch == IsCollision", static_cast<double>(planeMismatch), 0.0);
+	Benchmark::Check("Segment x Plane t lies on plane", planeTError, 1e-4);
+
+	// バッチは2次方程式の判別式、IsCollisionは最近接点の距離で判定するので、
+	// 表面をかすめる組は丸め誤差で結果が分かれうる。境界から離れた組だけを比べる
+	IsCollisionBatch(segmentsSoA, spheresSoA, { hit, t });
+	const float kGrazingBand = 1.0e-3f;
+	size_t sphereMismatch = 0;
+	size_t grazingPairs = 0;
+	for (size_t j = 0; j < otherCount; ++j) {
+		for (size_t i = 0; i < segmentCount; ++i) {
+			bool isHit = hit[j * segmentCount + i] != 0;
+			if (std::fabs(GetLength(Subtract(ClosestPoint(spheres[j].center, segments[i]), spheres[j].center)) - spheres[j].radius) <= kGrazingBand) {
+				++grazingPairs;
+				continue;
+			}
+			sphereMismatch += IsCollision(segments[i], spheres[j]) != isHit;
+		}
+	}
+	Benchmark::Check("Segment x Sphere batch == IsCollision", static_cast<double>(sphereMismatch), 0.0);
+	std::printf("  %zu grazing pairs within %g of the surface skipped\n", grazingPairs, kGrazingBand);
+
+	size_t hits = 0;
+	Benchmark::RunBatch("IsCollision(Segment, Plane) N x M", options, pairCount, [&] {
+		for (size_t j = 0; j < otherCount; ++j) {
+			for (size_t i = 0; i < segmentCount; ++i) {
+				hits += IsCollision(segments[i], planes[j]);
+			}
+		}
+		});
+	Benchmark::RunBatch("IsCollisionBatch(Segments, Planes)", options, pairCount, [&] {
+		hits += IsCollisionBatch(segmentsSoA, planesSoA, { hit, {} });
+		});
+	Benchmark::RunBatch("IsCollisionBatch(Segments, Planes) + t", options, pairCount, [&] {
+		hits += IsCollisionBatch(segmentsSoA, planesSoA, { hit, t });
+		});
+	Benchmark::RunBatch("IsCollision(Segment, Sphere) N x M", options, pairCount, [&] {
+		for (size_t j = 0; j < otherCount; ++j) {
+			for (size_t i = 0; i < segmentCount; ++i) {
+				hits += IsCollision(segments[i], spheres[j]);
+			}
+		}
+		});
+	Benchmark::RunBatch("IsCollisionBatch(Segments, Spheres) + t", options, pairCount, [&] {
+		hits += IsCollisionBatch(segmentsSoA, spheresSoA, { hit, t });
+		});
+	Benchmark::DoNotOptimize(hits);
+}
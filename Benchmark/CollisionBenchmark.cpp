@@ -0,0 +1,17 @@
+#include "Benchmark.h"
+#include "Collision.h"
+#include "MathFunction.h"
+
+BENCHMARK_SUITE(Collision) {
+	std::mt19937 engine(options.seed);
+	std::vector<Segment> segments = Benchmark::MakeInputs<Segment>(options, [&] {
+		return Segment{ Benchmark::RandomVector3(engine, -5.0f, 5.0f), Benchmark::RandomVector3(engine, -5.0f, 5.0f) };
+		});
+	std::vector<Plane> planes = Benchmark::MakeInputs<Plane>(options, [&] {
+		return Plane{ Normalize(Benchmark::RandomVector3(engine, -1.0f, 1.0f)), Benchmark::RandomFloat(engine, -3.0f, 3.0f) };
+		});
+	std::vector<Vector3> points = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, -5.0f, 5.0f); });
+
+	Benchmark::Run("IsCollision(Segment, Plane)", options, [&](size_t i) { Benchmark::DoNotOptimize(IsCollision(segments[i], planes[i])); });
+	Benchmark::Run("ClosestPoint", options, [&](size_t i) { Benchmark::DoNotOptimize(ClosestPoint(points[i], segments[i])); });
+}
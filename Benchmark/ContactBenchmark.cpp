@@ -0,0 +1,220 @@
+#include "Benchmark.h"
+#include "Collision.h"
+#include "Contact.h"
+#include "MathFunction.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace {
+
+	const char* const kShapeNames[] = { "Sphere", "Plane", "Segment", "AABB", "OBB", "Triangle" };
+	const int kShapeTypeCount = static_cast<int>(Shape::Type::kCount);
+
+	Shape RandomShape(std::mt19937& engine, Shape::Type type) {
+		Vector3 center = Benchmark::RandomVector3(engine, -2.0f, 2.0f);
+		switch (type) {
+		case Shape::Type::kSphere:
+			return MakeShape(Sphere{ center, Benchmark::RandomFloat(engine, 0.2f, 1.2f) });
+		case Shape::Type::kPlane:
+			return MakeShape(Plane{ Normalize(Benchmark::RandomVector3(engine, -1.0f, 1.0f)), Benchmark::RandomFloat(engine, -2.0f, 2.0f) });
+		case Shape::Type::kSegment:
+			return MakeShape(Segment{ center, Add(center, Benchmark::RandomVector3(engine, -2.0f, 2.0f)) });
+		case Shape::Type::kAABB: {
+			Vector3 extent = Benchmark::RandomVector3(engine, 0.2f, 1.2f);
+			return MakeShape(AABB{ Subtract(center, extent), Add(center, extent) });
+		}
+		case Shape::Type::kOBB: {
+			Matrix4x4 rotate = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, Benchmark::RandomVector3(engine, -3.14f, 3.14f), { 0.0f, 0.0f, 0.0f });
+			OBB obb;
+			obb.center = center;
+			for (int axis = 0; axis < 3; ++axis) {
+				obb.orientations[axis] = { rotate.m[axis][0], rotate.m[axis][1], rotate.m[axis][2] };
+			}
+			obb.size = Benchmark::RandomVector3(engine, 0.2f, 1.2f);
+			return MakeShape(obb);
+		}
+		default: {
+			Triangle triangle;
+			for (Vector3& vertex : triangle.vertices) {
+				vertex = Add(center, Benchmark::RandomVector3(engine, -1.5f, 1.5f));
+			}
+			return MakeShape(triangle);
+		}
+		}
+	}
+
+	Shape Translate(Shape shape, const Vector3& offset) {
+		switch (shape.type) {
+		case Shape::Type::kSphere:
+			shape.sphere.center = Add(shape.sphere.center, offset);
+			break;
+		case Shape::Type::kPlane:
+			shape.plane.distance += Dot(shape.plane.normal, offset);
+			break;
+		case Shape::Type::kSegment:
+			shape.segment.origin = Add(shape.segment.origin, offset);
+			shape.segment.diff = Add(shape.segment.diff, offset);
+			break;
+		case Shape::Type::kAABB:
+			shape.aabb.min = Add(shape.aabb.min, offset);
+			shape.aabb.max = Add(shape.aabb.max, offset);
+			break;
+		case Shape::Type::kOBB:
+			shape.obb.center = Add(shape.obb.center, offset);
+			break;
+		default:
+			for (Vector3& vertex : shape.triangle.vertices) {
+				vertex = Add(vertex, offset);
+			}
+			break;
+		}
+		return shape;
+	}
+
+	// depthだけ押し出せば確実に離れる組(厚みのない線分・平面どうしと、線分と箱は近似なので除く)
+	bool HasExactDepth(Shape::Type a, Shape::Type b) {
+		auto isThin = [](Shape::Type type) { return type == Shape::Type::kSegment; };
+		if (a == Shape::Type::kPlane && b == Shape::Type::kPlane) {
+			return false;
+		}
+		if (isThin(a) && isThin(b)) {
+			return false;
+		}
+		auto isBox = [](Shape::Type type) { return type == Shape::Type::kAABB || type == Shape::Type::kOBB; };
+		if ((isThin(a) && isBox(b)) || (isBox(a) && isThin(b))) {
+			return false;
+		}
+		return true;
+	}
+
+}
+
+BENCHMARK_SUITE(Contact) {
+	std::mt19937 engine(options.seed);
+
+	// 種類ごとにA側とB側の入力を別々に作る
+	std::vector<Shape> shapesA[kShapeTypeCount];
+	std::vector<Shape> shapesB[kShapeTypeCount];
+	for (int type = 0; type < kShapeTypeCount; ++type) {
+		for (size_t i = 0; i < options.inputCount; ++i) {
+			shapesA[type].push_back(RandomShape(engine, static_cast<Shape::Type>(type)));
+			shapesB[type].push_back(RandomShape(engine, static_cast<Shape::Type>(type)));
+		}
+	}
+
+	// 逆順の組が同じ結果(法線だけ反転)になるか、法線が単位長か、depthだけ押し出すと離れるかを確認する
+	size_t mirrorMismatch = 0;
+	size_t notSeparated = 0;
+	double normalError = 0.0;
+	double hitRates[kShapeTypeCount][kShapeTypeCount] = {};
+	for (int typeA = 0; typeA < kShapeTypeCount; ++typeA) {
+		for (int typeB = 0; typeB < kShapeTypeCount; ++typeB) {
+			size_t hits = 0;
+			for (size_t i = 0; i < options.inputCount; ++i) {
+				const Shape& a = shapesA[typeA][i];
+				const Shape& b = shapesB[typeB][i];
+				Contact contact;
+				Contact mirrored;
+				bool hit = ComputeContact(a, b, contact);
+				bool mirroredHit = ComputeContact(b, a, mirrored);
+				// 同じ種類どうしは法線の選び方が対称とは限らない(交わる2平面など)ので、テーブルの逆順の組だけ見る
+				if (typeA == typeB) {
+					mirroredHit = hit;
+					mirrored.normal = Multiply(-1.0f, contact.normal);
+					mirrored.depth = contact.depth;
+				}
+				if (hit != mirroredHit) {
+					++mirrorMismatch;
+					continue;
+				}
+				if (!hit) {
+					continue;
+				}
+				++hits;
+
+				Vector3 sum = Add(contact.normal, mirrored.normal);
+				if (Dot(sum, sum) > 1e-8f || std::fabs(contact.depth - mirrored.depth) > 1e-5f) {
+					++mirrorMismatch;
+				}
+				normalError = std::max(normalError, static_cast<double>(std::fabs(GetLength(contact.normal) - 1.0f)));
+
+				if (HasExactDepth(a.type, b.type)) {
+					Contact separated;
+					Shape moved = Translate(b, Multiply(contact.depth + 1e-3f, contact.normal));
+					notSeparated += ComputeContact(a, moved, separated);
+				}
+			}
+			hitRates[typeA][typeB] = 100.0 * static_cast<double>(hits) / static_cast<double>(options.inputCount);
+		}
+	}
+	Benchmark::Check("ComputeContact(a, b) mirrors ComputeContact(b, a)", static_cast<double>(mirrorMismatch), 0.0);
+	Benchmark::Check("contact normal is unit length", normalError, 1e-4);
+	Benchmark::Check("moving B by normal * depth separates", static_cast<double>(notSeparated), 0.0);
+
+	// 既存のbool判定と一致するか
+	size_t boolMismatch = 0;
+	for (size_t i = 0; i < options.inputCount; ++i) {
+		Contact contact;
+		const Segment& segment = shapesA[static_cast<int>(Shape::Type::kSegment)][i].segment;
+		const Plane& plane = shapesB[static_cast<int>(Shape::Type::kPlane)][i].plane;
+		const Sphere& sphere = shapesB[static_cast<int>(Shape::Type::kSphere)][i].sphere;
+		const AABB& aabbA = shapesA[static_cast<int>(Shape::Type::kAABB)][i].aabb;
+		const AABB& aabbB = shapesB[static_cast<int>(Shape::Type::kAABB)][i].aabb;
+		boolMismatch += IsCollision(segment, plane) != ComputeContact(plane, segment, contact);
+		boolMismatch += IsCollision(segment, sphere) != ComputeContact(sphere, segment, contact);
+		boolMismatch += IsCollision(aabbA, aabbB) != ComputeContact(aabbA, aabbB, contact);
+		boolMismatch += IsCollision(aabbA, plane) != ComputeContact(plane, aabbA, contact);
+	}
+	Benchmark::Check("ComputeContact agrees with IsCollision", static_cast<double>(boolMismatch), 0.0);
+
+	// 三角形の面の上にある線分(面と平行なので交点の式は使えない)
+	// 大きさを変えても結果は同じ(平行の判定は長さに対する比)
+	size_t coplanarErrors = 0;
+	for (float scale : { 1.0f, 1.0e-2f, 1.0e3f }) {
+		Triangle triangle = { { { 0.0f, 0.0f, 0.0f }, { 2.0f * scale, 0.0f, 0.0f }, { 0.0f, 0.0f, 2.0f * scale } } };
+		auto segmentAt = [&](float x0, float z0, float x1, float z1, float y) {
+			return Segment{ { x0 * scale, y, z0 * scale }, { x1 * scale, y, z1 * scale } };
+		};
+		Contact contact;
+		// 三角形を横切る: 重なる区間 x∈[0, 1.5] の中点(辺はkContactEpsilonだけ広げて見る)
+		bool crossing = ComputeContact(segmentAt(-1.0f, 0.5f, 3.0f, 0.5f, 0.0f), triangle, contact);
+		coplanarErrors += !crossing || contact.depth != 0.0f || std::fabs(contact.point.x - 0.75f * scale) > 1e-3f * scale + kContactEpsilon || std::fabs(contact.normal.y) != 1.0f;
+		// 三角形の中に収まる
+		coplanarErrors += !ComputeContact(segmentAt(0.2f, 0.2f, 0.8f, 0.4f, 0.0f), triangle, contact);
+		// 同じ平面で三角形の外
+		coplanarErrors += ComputeContact(segmentAt(1.5f, 1.5f, 3.0f, 1.5f, 0.0f), triangle, contact);
+		// 平行だが面から離れている
+		coplanarErrors += ComputeContact(segmentAt(-1.0f, 0.5f, 3.0f, 0.5f, 0.01f), triangle, contact);
+		// Shape経由の逆順の組も同じ
+		Contact mirrored;
+		coplanarErrors += !ComputeContact(MakeShape(triangle), MakeShape(segmentAt(-1.0f, 0.5f, 3.0f, 0.5f, 0.0f)), mirrored) || mirrored.normal.y != -contact.normal.y;
+	}
+	Benchmark::Check("segment lying on a triangle touches it", static_cast<double>(coplanarErrors), 0.0);
+
+	// 種類の組ごとのスループット(テーブル経由)
+	size_t hits = 0;
+	for (int typeA = 0; typeA < kShapeTypeCount; ++typeA) {
+		for (int typeB = typeA; typeB < kShapeTypeCount; ++typeB) {
+			const std::vector<Shape>& inputsA = shapesA[typeA];
+			const std::vector<Shape>& inputsB = shapesB[typeB];
+			char name[64];
+			std::snprintf(name, sizeof(name), "%s x %s (hit %.0f%%)", kShapeNames[typeA], kShapeNames[typeB], hitRates[typeA][typeB]);
+			Benchmark::Run(name, options, [&](size_t i) {
+				Contact contact;
+				hits += ComputeContact(inputsA[i], inputsB[i], contact);
+				Benchmark::DoNotOptimize(contact);
+				});
+		}
+	}
+
+	// テーブルを引くコストの目安として、型が決まっている呼び出しと比べる
+	const std::vector<Shape>& spheresA = shapesA[static_cast<int>(Shape::Type::kSphere)];
+	const std::vector<Shape>& spheresB = shapesB[static_cast<int>(Shape::Type::kSphere)];
+	Benchmark::Run("Sphere x Sphere (direct call)", options, [&](size_t i) {
+		Contact contact;
+		hits += ComputeContact(spheresA[i].sphere, spheresB[i].sphere, contact);
+		Benchmark::DoNotOptimize(contact);
+		});
+	Benchmark::DoNotOptimize(hits);
+}
@@ -0,0 +1,269 @@
+#include "Benchmark.h"
+#include "BroadPhase.h"
+#include "ContinuousCollision.h"
+#include "MathFunction.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+	// 分割して調べるときの1フレームあたりの回数
+	const int kSubSteps = 16;
+
+	float SignedDistance(const Plane& plane, const Vector3& point) {
+		return Dot(plane.normal, point) - plane.distance;
+	}
+
+	Vector3 Lerp(const Vector3& a, const Vector3& b, float t) {
+		return Add(a, Multiply(t, Subtract(b, a)));
+	}
+
+	bool Overlaps(const Sphere& sphere, const Plane& plane) {
+		return std::fabs(SignedDistance(plane, sphere.center)) <= sphere.radius;
+	}
+
+	// 平面にめり込んでいるか(丸め誤差で表面に触れる程度のものは数えない)
+	// 隙間がほぼ0の組では、補間した中心の丸め誤差で衝突時刻より前の標本が表面に触れることがある
+	bool Penetrates(const Sphere& sphere, const Plane& plane) {
+		return std::fabs(SignedDistance(plane, sphere.center)) < sphere.radius - 1e-4f;
+	}
+
+	// 平面をまたいでいるか(丸め誤差で平面に触れる程度のものは数えない)
+	bool Crosses(const Segment& segment, const Plane& plane) {
+		float distanceA = SignedDistance(plane, segment.origin);
+		float distanceB = SignedDistance(plane, segment.diff);
+		return distanceA * distanceB <= 0.0f && std::min(std::fabs(distanceA), std::fabs(distanceB)) > 1e-5f;
+	}
+
+	Segment LerpSegment(const Segment& start, const Segment& end, float t) {
+		return { Lerp(start.origin, end.origin, t), Lerp(start.diff, end.diff, t) };
+	}
+
+}
+
+BENCHMARK_SUITE(ContinuousCollision) {
+	const size_t sphereCount = 1024;
+	const size_t planeCount = 64;
+	const size_t pairCount = sphereCount * planeCount;
+
+	// 小さくて速い球(1フレームで半径の何十倍も動く)
+	std::mt19937 engine(options.seed);
+	std::vector<Sphere> spheres(sphereCount);
+	std::vector<Vector3> displacements(sphereCount);
+	std::vector<float> sphereSoA[7];
+	for (std::vector<float>& values : sphereSoA) {
+		values.resize(sphereCount);
+	}
+	for (size_t i = 0; i < sphereCount; ++i) {
+		spheres[i] = { Benchmark::RandomVector3(engine, -5.0f, 5.0f), Benchmark::RandomFloat(engine, 0.05f, 0.2f) };
+		displacements[i] = Benchmark::RandomVector3(engine, -6.0f, 6.0f);
+		sphereSoA[0][i] = spheres[i].center.x;
+		sphereSoA[1][i] = spheres[i].center.y;
+		sphereSoA[2][i] = spheres[i].center.z;
+		sphereSoA[3][i] = spheres[i].radius;
+		sphereSoA[4][i] = displacements[i].x;
+		sphereSoA[5][i] = displacements[i].y;
+		sphereSoA[6][i] = displacements[i].z;
+	}
+	SpheresSoA spheresSoA = { sphereSoA[0], sphereSoA[1], sphereSoA[2], sphereSoA[3] };
+	PointsSoA displacementsSoA = { sphereSoA[4], sphereSoA[5], sphereSoA[6] };
+
+	std::vector<Plane> planes(planeCount);
+	std::vector<float> planeSoA[4];
+	for (std::vector<float>& values : planeSoA) {
+		values.resize(planeCount);
+	}
+	for (size_t j = 0; j < planeCount; ++j) {
+		planes[j] = { Normalize(Benchmark::RandomVector3(engine, -1.0f, 1.0f)), Benchmark::RandomFloat(engine, -3.0f, 3.0f) };
+		planeSoA[0][j] = planes[j].normal.x;
+		planeSoA[1][j] = planes[j].normal.y;
+		planeSoA[2][j] = planes[j].normal.z;
+		planeSoA[3][j] = planes[j].distance;
+	}
+	PlanesSoA planesSoA = { planeSoA[0], planeSoA[1], planeSoA[2], planeSoA[3] };
+
+	std::vector<uint8_t> hit(pairCount);
+	std::vector<float> timeOfImpact(pairCount);
+
+	// 球と平面: 一括判定と1組ずつの判定が一致し、時刻ちょうどで接し、それより前は離れているか
+	size_t sphereHits = ComputeTimeOfImpactBatch(spheresSoA, displacementsSoA, planesSoA, { hit, timeOfImpact });
+	size_t batchMismatch = 0;
+	double contactError = 0.0;
+	size_t earlyOverlaps = 0;
+	size_t tunneled = 0;
+	for (size_t j = 0; j < planeCount; ++j) {
+		for (size_t i = 0; i < sphereCount; ++i) {
+			size_t index = j * sphereCount + i;
+			float t = -1.0f;
+			bool single = ComputeTimeOfImpact(spheres[i], displacements[i], planes[j], t);
+			batchMismatch += single != (hit[index] != 0) || (single && t != timeOfImpact[index]);
+
+			Sphere endSphere = { Add(spheres[i].center, displacements[i]), spheres[i].radius };
+			float checkUntil = single ? t : 1.0f;
+			if (single && t > 0.0f) {
+				Vector3 center = Lerp(spheres[i].center, endSphere.center, t);
+				contactError = std::max(contactError, static_cast<double>(std::fabs(std::fabs(SignedDistance(planes[j], center)) - spheres[i].radius)) / std::max(1.0f, GetLength(displacements[i])));
+			}
+			for (int step = 0; step < 256; ++step) {
+				float s = checkUntil * step / 256.0f * 0.999f;
+				if (single && t == 0.0f) {
+					break;
+				}
+				earlyOverlaps += Penetrates({ Lerp(spheres[i].center, endSphere.center, s), spheres[i].radius }, planes[j]);
+			}
+			// 開始時も終了時も離れているのに途中で当たった組(端点だけの判定ではすり抜ける)
+			tunneled += single && !Overlaps(spheres[i], planes[j]) && !Overlaps(endSphere, planes[j]);
+		}
+	}
+	Benchmark::Check("sphere-plane batch matches single", static_cast<double>(batchMismatch), 0.0);
+	Benchmark::Check("sphere touches the plane at time of impact", contactError, 1e-5);
+	Benchmark::Check("sphere-plane: no contact before time of impact", static_cast<double>(earlyOverlaps), 0.0);
+
+	// 球どうし: 時刻ちょうどで接し、それより前は離れていて、順番を入れ替えても同じか
+	double sphereContactError = 0.0;
+	size_t sphereEarlyOverlaps = 0;
+	size_t asymmetric = 0;
+	for (size_t i = 0; i + 1 < sphereCount; i += 2) {
+		const Sphere& a = spheres[i];
+		const Sphere& b = spheres[i + 1];
+		// 当たりやすいように相手の方へ向ける
+		Vector3 toward = Add(Subtract(b.center, a.center), displacements[i]);
+		float t = -1.0f, mirrored = -1.0f;
+		bool single = ComputeTimeOfImpact(a, toward, b, displacements[i + 1], t);
+		bool mirroredHit = ComputeTimeOfImpact(b, displacements[i + 1], a, toward, mirrored);
+		asymmetric += single != mirroredHit || (single && std::fabs(t - mirrored) > 1e-5f);
+		float radius = a.radius + b.radius;
+		auto distanceAt = [&](float s) {
+			return GetLength(Subtract(Add(a.center, Multiply(s, toward)), Add(b.center, Multiply(s, displacements[i + 1]))));
+			};
+		if (single && t > 0.0f) {
+			sphereContactError = std::max(sphereContactError, static_cast<double>(std::fabs(distanceAt(t) - radius)) / std::max(1.0f, GetLength(toward)));
+		}
+		float checkUntil = single ? t : 1.0f;
+		for (int step = 0; step < 256 && !(single && t == 0.0f); ++step) {
+			sphereEarlyOverlaps += distanceAt(checkUntil * step / 256.0f * 0.999f) <= radius;
+		}
+	}
+	Benchmark::Check("sphere-sphere touches at time of impact", sphereContactError, 1e-5);
+	Benchmark::Check("sphere-sphere: no contact before time of impact", static_cast<double>(sphereEarlyOverlaps), 0.0);
+	Benchmark::Check("sphere-sphere is symmetric", static_cast<double>(asymmetric), 0.0);
+
+	// 2つの姿勢の間を動く線分と平面
+	std::vector<Segment> starts(sphereCount), ends(sphereCount);
+	std::vector<float> segmentSoA[12];
+	for (std::vector<float>& values : segmentSoA) {
+		values.resize(sphereCount);
+	}
+	for (size_t i = 0; i < sphereCount; ++i) {
+		starts[i].origin = Benchmark::RandomVector3(engine, -5.0f, 5.0f);
+		starts[i].diff = Add(starts[i].origin, Benchmark::RandomVector3(engine, -0.5f, 0.5f));
+		ends[i].origin = Add(starts[i].origin, displacements[i]);
+		ends[i].diff = Add(ends[i].origin, Benchmark::RandomVector3(engine, -0.5f, 0.5f));
+		const Vector3* points[4] = { &starts[i].origin, &starts[i].diff, &ends[i].origin, &ends[i].diff };
+		for (int k = 0; k < 4; ++k) {
+			segmentSoA[k * 3][i] = points[k]->x;
+			segmentSoA[k * 3 + 1][i] = points[k]->y;
+			segmentSoA[k * 3 + 2][i] = points[k]->z;
+		}
+	}
+	SegmentsSoA startsSoA = { segmentSoA[0], segmentSoA[1], segmentSoA[2], segmentSoA[3], segmentSoA[4], segmentSoA[5] };
+	SegmentsSoA endsSoA = { segmentSoA[6], segmentSoA[7], segmentSoA[8], segmentSoA[9], segmentSoA[10], segmentSoA[11] };
+
+	size_t segmentHits = ComputeTimeOfImpactBatch(startsSoA, endsSoA, planesSoA, { hit, timeOfImpact });
+	size_t segmentMismatch = 0;
+	double segmentContactError = 0.0;
+	size_t segmentEarlyCrossings = 0;
+	for (size_t j = 0; j < planeCount; ++j) {
+		for (size_t i = 0; i < sphereCount; ++i) {
+			size_t index = j * sphereCount + i;
+			float t = -1.0f;
+			bool single = ComputeTimeOfImpact(starts[i], ends[i], planes[j], t);
+			segmentMismatch += single != (hit[index] != 0) || (single && t != timeOfImpact[index]);
+			if (single && t > 0.0f) {
+				Segment segment = LerpSegment(starts[i], ends[i], t);
+				float distance = std::min(std::fabs(SignedDistance(planes[j], segment.origin)), std::fabs(SignedDistance(planes[j], segment.diff)));
+				segmentContactError = std::max(segmentContactError, static_cast<double>(distance) / std::max(1.0f, GetLength(displacements[i])));
+			}
+			float checkUntil = single ? t : 1.0f;
+			for (int step = 0; step < 256 && !(single && t == 0.0f); ++step) {
+				segmentEarlyCrossings += Crosses(LerpSegment(starts[i], ends[i], checkUntil * step / 256.0f * 0.999f), planes[j]);
+			}
+		}
+	}
+	Benchmark::Check("segment sweep batch matches single", static_cast<double>(segmentMismatch), 0.0);
+	Benchmark::Check("swept segment touches the plane at time of impact", segmentContactError, 1e-5);
+	Benchmark::Check("swept segment: no crossing before time of impact", static_cast<double>(segmentEarlyCrossings), 0.0);
+
+	// ブロードフェーズ: 掃引AABBの候補に、総当たりで見つけた当たりがすべて含まれるか
+	BroadPhase broadPhase;
+	std::vector<Sphere> obstacles(2048);
+	for (size_t k = 0; k < obstacles.size(); ++k) {
+		obstacles[k] = { Benchmark::RandomVector3(engine, -20.0f, 20.0f), Benchmark::RandomFloat(engine, 0.2f, 1.0f) };
+		broadPhase.Add(obstacles[k], static_cast<uint32_t>(k));
+	}
+	std::vector<SweepCandidate> candidates;
+	QuerySweptSpheres(broadPhase, spheres, displacements, candidates);
+	std::vector<uint8_t> found(sphereCount * obstacles.size());
+	for (const SweepCandidate& candidate : candidates) {
+		found[candidate.index * obstacles.size() + broadPhase.GetUserData(candidate.handle)] = 1;
+	}
+	size_t missedCandidates = 0;
+	size_t obstacleHits = 0;
+	for (size_t i = 0; i < sphereCount; ++i) {
+		for (size_t k = 0; k < obstacles.size(); ++k) {
+			float t;
+			if (ComputeTimeOfImpact(spheres[i], displacements[i], obstacles[k], { 0.0f, 0.0f, 0.0f }, t)) {
+				++obstacleHits;
+				missedCandidates += found[i * obstacles.size() + k] == 0;
+			}
+		}
+	}
+	Benchmark::Check("swept broadphase candidates contain every hit", static_cast<double>(missedCandidates), 0.0);
+
+	std::printf("  sphere-plane: %zu / %zu pairs hit, %zu would tunnel with an endpoint test; segment sweeps: %zu hits\n",
+		sphereHits, pairCount, tunneled, segmentHits);
+	std::printf("  broadphase: %zu candidates for %zu hits against %zu obstacles\n", candidates.size(), obstacleHits, obstacles.size());
+
+	Benchmark::RunBatch("sphere-plane sub-stepping (16 discrete tests)", options, pairCount, [&] {
+		size_t hits = 0;
+		for (size_t j = 0; j < planeCount; ++j) {
+			for (size_t i = 0; i < sphereCount; ++i) {
+				bool any = false;
+				for (int step = 0; step <= kSubSteps; ++step) {
+					Vector3 center = Lerp(spheres[i].center, Add(spheres[i].center, displacements[i]), static_cast<float>(step) / kSubSteps);
+					any |= Overlaps({ center, spheres[i].radius }, planes[j]);
+				}
+				hits += any;
+			}
+		}
+		Benchmark::DoNotOptimize(hits);
+		});
+	Benchmark::RunBatch("ComputeTimeOfImpact (sphere-plane, single)", options, pairCount, [&] {
+		size_t hits = 0;
+		for (size_t j = 0; j < planeCount; ++j) {
+			for (size_t i = 0; i < sphereCount; ++i) {
+				float t;
+				hits += ComputeTimeOfImpact(spheres[i], displacements[i], planes[j], t);
+			}
+		}
+		Benchmark::DoNotOptimize(hits);
+		});
+	Benchmark::RunBatch("ComputeTimeOfImpactBatch (sphere-plane)", options, pairCount, [&] {
+		Benchmark::DoNotOptimize(ComputeTimeOfImpactBatch(spheresSoA, displacementsSoA, planesSoA, { hit, timeOfImpact }));
+		});
+	Benchmark::RunBatch("ComputeTimeOfImpactBatch (swept segment-plane)", options, pairCount, [&] {
+		Benchmark::DoNotOptimize(ComputeTimeOfImpactBatch(startsSoA, endsSoA, planesSoA, { hit, timeOfImpact }));
+		});
+
+	Benchmark::Options queryOptions = options;
+	queryOptions.iterations = std::min(options.iterations, sphereCount * 64);
+	Benchmark::RunBatch("QuerySweptSpheres + ComputeTimeOfImpact", queryOptions, sphereCount, [&] {
+		QuerySweptSpheres(broadPhase, spheres, displacements, candidates);
+		size_t hits = 0;
+		for (const SweepCandidate& candidate : candidates) {
+			float t;
+			hits += ComputeTimeOfImpact(spheres[candidate.index], displacements[candidate.index], obstacles[broadPhase.GetUserData(candidate.handle)], { 0.0f, 0.0f, 0.0f }, t);
+		}
+		Benchmark::DoNotOptimize(hits);
+		});
+}
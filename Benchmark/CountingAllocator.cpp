@@ -0,0 +1,76 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// MT3Benchmarkの実行ファイル全体のoperator new/deleteを、呼び出し回数を数える版に置き換える
+// (FrameArenaスイートの「定常状態のフレームでは確保しない」検証に使う。中身はmalloc/freeのまま)
+// ほかのスイートのnew/deleteにもカウンタの加算が乗るので、素のアロケータで計りたいときは
+// -DMT3_BENCHMARK_COUNT_ALLOCATIONS=OFFでビルドする(このファイルは何も置き換えず、回数は常に0)
+
+#if defined(MT3_BENCHMARK_COUNT_ALLOCATIONS)
+
+namespace {
+
+	std::atomic<size_t> allocationCount{ 0 };
+
+	void* AllocateCounted(size_t size, size_t alignment) {
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+		size = std::max<size_t>(size, 1);
+		void* memory;
+		if (alignment <= alignof(std::max_align_t)) {
+			memory = std::malloc(size);
+		} else {
+#if defined(_MSC_VER)
+			memory = _aligned_malloc(size, alignment);
+#else
+			memory = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+		}
+		if (!memory) {
+			throw std::bad_alloc();
+		}
+		return memory;
+	}
+
+	void FreeCounted(void* memory, size_t alignment) {
+#if defined(_MSC_VER)
+		if (alignment > alignof(std::max_align_t)) {
+			_aligned_free(memory);
+			return;
+		}
+#endif
+		(void)alignment;
+		std::free(memory);
+	}
+
+}
+
+// 配列版・nothrow版は標準の実装がこれらを呼ぶ
+void* operator new(size_t size) { return AllocateCounted(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t alignment) { return AllocateCounted(size, static_cast<size_t>(alignment)); }
+void operator delete(void* memory) noexcept { FreeCounted(memory, alignof(std::max_align_t)); }
+void operator delete(void* memory, size_t) noexcept { FreeCounted(memory, alignof(std::max_align_t)); }
+void operator delete(void* memory, std::align_val_t alignment) noexcept { FreeCounted(memory, static_cast<size_t>(alignment)); }
+void operator delete(void* memory, size_t, std::align_val_t alignment) noexcept { FreeCounted(memory, static_cast<size_t>(alignment)); }
+
+bool Benchmark::IsCountingAllocations() {
+	return true;
+}
+
+size_t Benchmark::GetAllocationCount() {
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+#else
+
+bool Benchmark::IsCountingAllocations() {
+	return false;
+}
+
+size_t Benchmark::GetAllocationCount() {
+	return 0;
+}
+
+#endif
@@ -0,0 +1,92 @@
+#include "Benchmark.h"
+#include "DebugDraw.h"
+#include "MathFunction.h"
+#include "Primitive.h"
+#include "SphereWireframe.h"
+#include <cmath>
+
+namespace {
+
+	// 即時描画(1本ごとに整数座標で呼ぶ)の代わりに数を数えるだけの関数
+	size_t immediateLineCount = 0;
+
+	void DrawLineImmediate(int startX, int startY, int endX, int endY, uint32_t color) {
+		immediateLineCount += static_cast<size_t>((startX ^ startY ^ endX ^ endY ^ static_cast<int>(color)) != 0x7FFFFFFF);
+	}
+
+	// 関数ポインタ越しに呼んで、外部ライブラリの呼び出しのようにインライン展開させない
+	void (*volatile drawLineImmediate)(int, int, int, int, uint32_t) = &DrawLineImmediate;
+
+}
+
+BENCHMARK_SUITE(DebugDraw) {
+	const Camera camera = Benchmark::MakeMainCamera();
+	const Matrix4x4& viewProjectionViewportMatrix = camera.GetViewProjectionViewportMatrix();
+
+	// デバッグ描画の多いフレーム: 球200個
+	std::mt19937 engine(options.seed);
+	const size_t sphereCount = 200;
+	std::vector<Sphere> spheres(sphereCount);
+	for (Sphere& sphere : spheres) {
+		sphere = { Benchmark::RandomVector3(engine, -3.0f, 3.0f), Benchmark::RandomFloat(engine, 0.1f, 0.6f) };
+	}
+
+	const SphereWireframe& wireframe = GetSphereWireframe(20);
+	std::vector<float> screenX(wireframe.x.size()), screenY(wireframe.x.size());
+	std::vector<uint8_t> visible(wireframe.x.size());
+
+	auto buildFrame = [&](DebugDraw& debugDraw) {
+		for (const Sphere& sphere : spheres) {
+			TransformSphereWireframe(wireframe, sphere.center, sphere.radius, viewProjectionViewportMatrix, { screenX, screenY, visible });
+			debugDraw.AddLines(screenX.data(), screenY.data(), visible.data(), wireframe.lines, 0xFFFFFFFF);
+		}
+		};
+
+	DebugDraw debugDraw;
+	DebugDrawRecorder recorder;
+	debugDraw.SetBackend(&DebugDrawRecorder::Submit, &recorder);
+
+	// 1回のFlushで1回だけ渡され、小数座標がそのまま届くか
+	buildFrame(debugDraw);
+	std::vector<DebugLine> queued(debugDraw.GetLines().begin(), debugDraw.GetLines().end());
+	size_t flushed = debugDraw.Flush();
+	size_t mismatches = recorder.lines.size() != queued.size();
+	for (size_t i = 0; i < std::min(queued.size(), recorder.lines.size()); ++i) {
+		const DebugLine& a = queued[i];
+		const DebugLine& b = recorder.lines[i];
+		mismatches += a.startX != b.startX || a.startY != b.startY || a.endX != b.endX || a.endY != b.endY || a.color != b.color;
+	}
+	Benchmark::Check("recorder receives the queued lines unchanged", static_cast<double>(mismatches), 0.0);
+	Benchmark::Check("one submission per flush", static_cast<double>(recorder.submitCount) - 1.0, 0.0);
+	Benchmark::Check("queue is empty after flush", static_cast<double>(debugDraw.GetLines().size()), 0.0);
+
+	// 2フレーム目以降は容量が増えない(確保が起きない)
+	size_t capacity = debugDraw.GetCapacity();
+	for (int frame = 0; frame < 8; ++frame) {
+		buildFrame(debugDraw);
+		debugDraw.Flush();
+	}
+	Benchmark::Check("steady-state frames do not grow the buffer", static_cast<double>(debugDraw.GetCapacity() - capacity), 0.0);
+
+	std::printf("  %zu lines per frame\n", flushed);
+	Benchmark::RunBatch("build frame + immediate DrawLine per line", options, flushed, [&] {
+		for (const Sphere& sphere : spheres) {
+			TransformSphereWireframe(wireframe, sphere.center, sphere.radius, viewProjectionViewportMatrix, { screenX, screenY, visible });
+			for (size_t i = 0; i < wireframe.lines.size(); i += 2) {
+				uint32_t start = wireframe.lines[i];
+				uint32_t end = wireframe.lines[i + 1];
+				if (!visible[start] || !visible[end]) {
+					continue;
+				}
+				drawLineImmediate(
+					static_cast<int>(screenX[start]), static_cast<int>(screenY[start]),
+					static_cast<int>(screenX[end]), static_cast<int>(screenY[end]), 0xFFFFFFFF);
+			}
+		}
+		});
+	Benchmark::RunBatch("build frame + DebugDraw::Flush (recorder)", options, flushed, [&] {
+		buildFrame(debugDraw);
+		debugDraw.Flush();
+		});
+	Benchmark::DoNotOptimize(immediateLineCount);
+}
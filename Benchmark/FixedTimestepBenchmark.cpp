@@ -0,0 +1,125 @@
+#include "Benchmark.h"
+#include "FixedTimestep.h"
+#include "MathFunction.h"
+#include "Simulation.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+	// フレーム時間を与えて、シミュレーションがtargetStepsステップ進むまで回す
+	template<typename FrameSeconds>
+	uint64_t RunUntil(SimulationState& state, uint64_t targetSteps, FrameSeconds&& frameSeconds) {
+		FixedTimestep timestep;
+		for (uint32_t frame = 0; state.stepCount < targetSteps; ++frame) {
+			RunFixedSteps(timestep, frameSeconds(frame), [&](float stepSeconds) {
+				// 1フレームで複数回回るので、目標で止める
+				if (state.stepCount < targetSteps) {
+					StepSimulation(state, stepSeconds);
+				}
+				});
+		}
+		return HashSimulation(state);
+	}
+
+	// 平面の裏へめり込んだ量の最大値(箱の外へ抜けた球も含む)
+	double GetMaxPenetration(const SimulationState& state) {
+		double penetration = 0.0;
+		for (const Sphere& sphere : state.current) {
+			if (!std::isfinite(sphere.center.x) || !std::isfinite(sphere.center.y) || !std::isfinite(sphere.center.z)) {
+				return INFINITY;
+			}
+			for (const Plane& plane : state.planes) {
+				double distance = static_cast<double>(Dot(plane.normal, sphere.center)) - plane.distance;
+				penetration = std::max(penetration, sphere.radius - distance);
+			}
+		}
+		return penetration;
+	}
+
+}
+
+BENCHMARK_SUITE(FixedTimestep) {
+	std::mt19937 engine(options.seed);
+
+	// 色々なフレームレートで10秒ぶん進めても、更新回数は経過時間/刻み幅になり補間係数は[0, 1)に収まるか
+	const double kStepSeconds = 1.0 / 60.0;
+	const double frameRates[] = { 30.0, 59.94, 60.0, 144.0, 240.0 };
+	double stepCountError = 0.0;
+	double alphaError = 0.0;
+	for (double frameRate : frameRates) {
+		FixedTimestep timestep(kStepSeconds);
+		double total = 0.0;
+		for (int frame = 0; frame < static_cast<int>(frameRate * 10.0); ++frame) {
+			// ±20%のぶれ
+			double seconds = (1.0 + Benchmark::RandomFloat(engine, -0.2f, 0.2f)) / frameRate;
+			total += seconds;
+			timestep.Advance(seconds);
+			float alpha = timestep.GetAlpha();
+			alphaError = std::max(alphaError, alpha < 0.0f || alpha >= 1.0f ? 1.0 : 0.0);
+		}
+		double expected = std::floor(total / kStepSeconds);
+		stepCountError = std::max(stepCountError, std::fabs(static_cast<double>(timestep.GetStepCount()) - expected));
+	}
+	Benchmark::Check("step count matches elapsed time", stepCountError, 1.0);
+	Benchmark::Check("interpolation alpha stays in [0, 1)", alphaError, 0.0);
+
+	// 重いフレーム(60.5ステップ分)の後は上限で打ち切り、残りを捨てる
+	FixedTimestep clamped(kStepSeconds, 8);
+	uint32_t clampedSteps = clamped.Advance(60.5 * kStepSeconds);
+	Benchmark::Check("long frame is clamped to maxStepsPerFrame", std::fabs(static_cast<double>(clampedSteps) - 8.0) + std::fabs(clamped.GetAlpha() - 0.5), 1e-6);
+	Benchmark::Check("clamped steps are counted as dropped", std::fabs(static_cast<double>(clamped.GetDroppedStepCount()) - 52.0), 0.0);
+
+	// 描画のフレームレートが違っても、同じステップ数なら結果はビット単位で同じ
+	const uint32_t sphereCount = 256;
+	const uint64_t frameTestSteps = 600;
+	SimulationState at30 = MakeSimulationScene(sphereCount, options.seed);
+	SimulationState at144 = MakeSimulationScene(sphereCount, options.seed);
+	uint64_t hash30 = RunUntil(at30, frameTestSteps, [](uint32_t) { return 1.0 / 30.0; });
+	uint64_t hash144 = RunUntil(at144, frameTestSteps, [&](uint32_t) { return (1.0 + Benchmark::RandomFloat(engine, -0.5f, 0.5f)) / 144.0; });
+	Benchmark::Check("simulation is independent of frame rate", hash30 == hash144 ? 0.0 : 1.0, 0.0);
+
+	double interpolationError = 0.0;
+	for (size_t i = 0; i < sphereCount; ++i) {
+		Sphere from = GetInterpolatedSphere(at30, i, 0.0f);
+		Sphere to = GetInterpolatedSphere(at30, i, 1.0f);
+		interpolationError = std::max({ interpolationError,
+			static_cast<double>(GetLength(Subtract(from.center, at30.previous[i].center))),
+			static_cast<double>(GetLength(Subtract(to.center, at30.current[i].center))) });
+	}
+	Benchmark::Check("interpolation spans previous to current", interpolationError, 1e-5);
+
+	// 耐久: 長く回しても球が箱から抜けない(速い球もCCDで止まる)
+	SimulationState soak = MakeSimulationScene(sphereCount, options.seed + 1);
+	double maxPenetration = 0.0;
+	const uint64_t soakSteps = 20000;
+	for (uint64_t step = 0; step < soakSteps; ++step) {
+		StepSimulation(soak, static_cast<float>(kStepSeconds));
+		if (step % 16 == 0) {
+			maxPenetration = std::max(maxPenetration, GetMaxPenetration(soak));
+		}
+	}
+	maxPenetration = std::max(maxPenetration, GetMaxPenetration(soak));
+	Benchmark::Check("soak: no sphere leaves the box", maxPenetration, 1e-3);
+
+	// ヘッドレスで最速に回す
+	SimulationState headless = MakeSimulationScene(sphereCount, options.seed);
+	HeadlessReport report = RunHeadless(headless, static_cast<float>(kStepSeconds), std::max<uint64_t>(options.iterations / sphereCount, 1));
+	std::printf("  headless: %llu steps of %u spheres in %.3f s (%.0f steps/s, %.1fx real time), step avg %.4f ms, max %.4f ms, hash %016llx\n",
+		static_cast<unsigned long long>(report.stepCount), sphereCount, report.seconds, report.stepsPerSecond, report.stepsPerSecond * kStepSeconds,
+		report.stepStats.averageMs, report.stepStats.maxMs, static_cast<unsigned long long>(report.hash));
+
+	SimulationState timed = MakeSimulationScene(sphereCount, options.seed);
+	Benchmark::RunBatch("StepSimulation (per sphere)", options, sphereCount, [&] {
+		StepSimulation(timed, static_cast<float>(kStepSeconds));
+		Benchmark::DoNotOptimize(timed.current[0]);
+		});
+
+	std::vector<float> frameSeconds = Benchmark::MakeInputs<float>(options, [&] { return Benchmark::RandomFloat(engine, 0.005f, 0.03f); });
+	FixedTimestep timestep(kStepSeconds);
+	Benchmark::Run("FixedTimestep::Advance", options, [&](size_t i) {
+		Benchmark::DoNotOptimize(timestep.Advance(frameSeconds[i]));
+		});
+	FrameTimer frameTimer;
+	Benchmark::Run("FrameTimer::Tick", options, [&](size_t) { Benchmark::DoNotOptimize(frameTimer.Tick()); });
+}
@@ -0,0 +1,177 @@
+#include "Benchmark.h"
+#include "Collision.h"
+#include "Contact.h"
+#include "DebugDraw.h"
+#include "FrameArena.h"
+#include "Frustum.h"
+#include "InstancedWireframe.h"
+#include "MathFunction.h"
+#include "Profiler.h"
+#include "Simulation.h"
+#include "SphereWireframe.h"
+#include <algorithm>
+
+namespace {
+
+	// 描画側の代わり(線を数えるだけで、コピーしない)
+	size_t submittedLineCount = 0;
+	void CountLines(void*, std::span<const DebugLine> lines) {
+		submittedLineCount += lines.size();
+	}
+
+	bool IsAligned(const void* pointer, size_t alignment) {
+		return reinterpret_cast<uintptr_t>(pointer) % alignment == 0;
+	}
+
+}
+
+BENCHMARK_SUITE(FrameArena) {
+	// 確保の回数の検証は、operator newを数える版に置き換えたときだけ行う
+	const bool counting = Benchmark::IsCountingAllocations();
+	if (!counting) {
+		std::printf("  allocation checks skipped (MT3_BENCHMARK_COUNT_ALLOCATIONS is OFF)\n");
+	}
+
+	// 数える仕組み自体が働いているか
+	size_t before = Benchmark::GetAllocationCount();
+	{
+		std::vector<int> probe(16);
+		Benchmark::DoNotOptimize(probe.data());
+	}
+	if (counting) {
+		Benchmark::Check("allocation counter sees std::vector", Benchmark::GetAllocationCount() > before ? 0.0 : 1.0, 0.0);
+	}
+
+	// アライメントとScopeでの巻き戻し
+	FrameArena arena(4096);
+	double alignmentError = 0.0;
+	for (size_t count = 1; count < 64; count += 7) {
+		alignmentError += IsAligned(arena.AllocateArray<uint8_t>(count).data(), FrameArena::kMinAlignment) ? 0.0 : 1.0;
+		alignmentError += IsAligned(arena.Allocate(count, 64), 64) ? 0.0 : 1.0;
+	}
+	Benchmark::Check("allocations are aligned", alignmentError, 0.0);
+
+	size_t usedBefore = arena.GetUsedBytes();
+	{
+		FrameArena::Scope scope(arena);
+		arena.AllocateArray<float>(100);
+	}
+	Benchmark::Check("Scope gives back its allocations", static_cast<double>(arena.GetUsedBytes()) - static_cast<double>(usedBefore), 0.0);
+
+	// 足りなかったフレームの次のResetで1つのブロックにまとめ直し、以後は増えない
+	arena.Reset();
+	auto overflowFrame = [&] {
+		for (int i = 0; i < 16; ++i) {
+			std::span<float> values = arena.AllocateArray<float>(256);
+			values[0] = static_cast<float>(i);
+		}
+		};
+	overflowFrame();
+	uint64_t grownOnce = arena.GetGrowCount();
+	arena.Reset();
+	before = Benchmark::GetAllocationCount();
+	for (int frame = 0; frame < 16; ++frame) {
+		overflowFrame();
+		arena.Reset();
+	}
+	Benchmark::Check("overflowing frame grows the arena", grownOnce > 0 ? 0.0 : 1.0, 0.0);
+	Benchmark::Check("arena is large enough after one Reset", static_cast<double>(arena.GetGrowCount() - grownOnce), 0.0);
+	if (counting) {
+		Benchmark::Check("regrown arena does not allocate", static_cast<double>(Benchmark::GetAllocationCount() - before), 0.0);
+	}
+
+	// 1フレーム分の処理(固定刻みの更新、接触、頂点変換、線、インスタンス)
+	SimulationState state = MakeSimulationScene(64, options.seed);
+	const float stepSeconds = 1.0f / 60.0f;
+	Camera camera = Benchmark::MakeMainCamera();
+	camera.SetTranslate({ 0.0f, 6.0f, -20.0f });
+	const Matrix4x4& viewProjectionViewportMatrix = camera.GetViewProjectionViewportMatrix();
+	const Frustum& frustum = camera.GetFrustum();
+
+	const SphereWireframe& wireframe = GetSphereWireframe(8);
+	WireframeMesh planeMesh = MakePlaneWireframeMesh();
+	WireframeInstanceBuffer planeInstances;
+
+	DebugDraw debugDraw;
+	debugDraw.SetBackend(&CountLines, nullptr);
+	debugDraw.Reserve(state.current.size() * wireframe.lines.size() / 2 + state.planes.size() * planeMesh.indices.size() / 2);
+
+	FrameArena& frameArena = GetFrameArena();
+	size_t contactCount = 0;
+	auto runFrame = [&] {
+		Profiler::Get().BeginFrame();
+		frameArena.Reset();
+
+		StepSimulation(state, stepSeconds);
+
+		// 球同士の接触(フレームの間だけ使う配列はアリーナ)
+		const size_t sphereCount = state.current.size();
+		std::span<Contact> contacts = frameArena.AllocateArray<Contact>(sphereCount * (sphereCount - 1) / 2);
+		size_t count = 0;
+		for (size_t a = 0; a < sphereCount; ++a) {
+			for (size_t b = a + 1; b < sphereCount; ++b) {
+				count += ComputeContact(state.current[a], state.current[b], contacts[count]);
+			}
+		}
+		contactCount += count;
+
+		// 補間した球の頂点変換(main.cppのDrawSphereと同じ)
+		for (size_t i = 0; i < state.current.size(); ++i) {
+			Sphere sphere = GetInterpolatedSphere(state, i, 0.5f);
+			if (!IsVisible(frustum, sphere)) {
+				continue;
+			}
+			FrameArena::Scope scope(frameArena);
+			std::span<float> screenX = frameArena.AllocateArray<float>(wireframe.x.size());
+			std::span<float> screenY = frameArena.AllocateArray<float>(wireframe.x.size());
+			std::span<uint8_t> visible = frameArena.AllocateArray<uint8_t>(wireframe.x.size());
+			TransformSphereWireframe(wireframe, sphere.center, sphere.radius, viewProjectionViewportMatrix, { screenX, screenY, visible });
+			debugDraw.AddLines(screenX.data(), screenY.data(), visible.data(), wireframe.lines, 0x4040FFFF);
+		}
+
+		// 箱の面はインスタンスで
+		planeInstances.Clear();
+		for (const Plane& plane : state.planes) {
+			planeInstances.AddPlane(plane, 0x000000FF);
+		}
+		DrawWireframeInstancesCpu(planeMesh, planeInstances.GetInstances(), viewProjectionViewportMatrix, debugDraw);
+
+		debugDraw.Flush();
+		Profiler::Get().EndFrame();
+		};
+
+	// 最初の数フレームで容量がそろったら、以後のフレームは1回も確保しない
+	for (int frame = 0; frame < 8; ++frame) {
+		runFrame();
+	}
+	const int frameCount = 600;
+	before = Benchmark::GetAllocationCount();
+	for (int frame = 0; frame < frameCount; ++frame) {
+		runFrame();
+	}
+	size_t frameAllocations = Benchmark::GetAllocationCount() - before;
+	std::printf("  %d frames: %zu lines, %zu contacts, arena peak %zu bytes\n", frameCount, submittedLineCount, contactCount, frameArena.GetPeakBytes());
+	if (counting) {
+		Benchmark::Check("steady-state frame loop never calls operator new", static_cast<double>(frameAllocations), 0.0);
+	}
+
+	// 作業領域の取り方ごとのコスト(球1つ分の頂点変換の置き場)
+	const size_t vertexCount = wireframe.x.size();
+	Benchmark::Run("std::vector scratch per sphere", options, [&](size_t) {
+		std::vector<float> screenX(vertexCount);
+		std::vector<float> screenY(vertexCount);
+		std::vector<uint8_t> visible(vertexCount);
+		Benchmark::DoNotOptimize(screenX.data());
+		Benchmark::DoNotOptimize(screenY.data());
+		Benchmark::DoNotOptimize(visible.data());
+		});
+	Benchmark::Run("FrameArena scratch per sphere", options, [&](size_t) {
+		FrameArena::Scope scope(frameArena);
+		std::span<float> screenX = frameArena.AllocateArray<float>(vertexCount);
+		std::span<float> screenY = frameArena.AllocateArray<float>(vertexCount);
+		std::span<uint8_t> visible = frameArena.AllocateArray<uint8_t>(vertexCount);
+		Benchmark::DoNotOptimize(screenX.data());
+		Benchmark::DoNotOptimize(screenY.data());
+		Benchmark::DoNotOptimize(visible.data());
+		});
+}
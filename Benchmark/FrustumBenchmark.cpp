@@ -0,0 +1,171 @@
+#include "Benchmark.h"
+#include "DebugDraw.h"
+#include "Frustum.h"
+#include "MathFunction.h"
+#include "Primitive.h"
+#include "SphereWireframe.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+	// クリップ空間の視錐台(-w<=x<=w, -w<=y<=w, 0<=z<=w)に入っているか
+	bool IsInsideClipSpace(const Vector3& point, const Matrix4x4& matrix) {
+		float x = point.x * matrix.m[0][0] + point.y * matrix.m[1][0] + point.z * matrix.m[2][0] + matrix.m[3][0];
+		float y = point.x * matrix.m[0][1] + point.y * matrix.m[1][1] + point.z * matrix.m[2][1] + matrix.m[3][1];
+		float z = point.x * matrix.m[0][2] + point.y * matrix.m[1][2] + point.z * matrix.m[2][2] + matrix.m[3][2];
+		float w = point.x * matrix.m[0][3] + point.y * matrix.m[1][3] + point.z * matrix.m[2][3] + matrix.m[3][3];
+		return -w <= x && x <= w && -w <= y && y <= w && 0.0f <= z && z <= w;
+	}
+
+	// 同次座標(x,y,z,w)
+	void TransformHomogeneous(const Vector3& point, const Matrix4x4& matrix, float clip[4]) {
+		for (int column = 0; column < 4; ++column) {
+			clip[column] = point.x * matrix.m[0][column] + point.y * matrix.m[1][column] + point.z * matrix.m[2][column] + matrix.m[3][column];
+		}
+	}
+
+	// 線と近平面 z = 0 (ビューポート行列の最小深度0)の交点のスクリーン座標
+	// ワールド空間の近平面で交点を求めてから変換すると、w(≒近クリップ距離)で割るので
+	// 誤差が大きくなる。同次座標のまま z = 0 で補間してから割る
+	void GetNearCrossingOnScreen(const Vector3& start, const Vector3& end, const Matrix4x4& matrix, float& x, float& y) {
+		float a[4];
+		float b[4];
+		TransformHomogeneous(start, matrix, a);
+		TransformHomogeneous(end, matrix, b);
+		float t = a[2] / (a[2] - b[2]);
+		float w = a[3] + t * (b[3] - a[3]);
+		x = (a[0] + t * (b[0] - a[0])) / w;
+		y = (a[1] + t * (b[1] - a[1])) / w;
+	}
+
+	double GetRelativeError(float actual, float expected) {
+		return std::fabs(static_cast<double>(actual) - expected) / std::max(1.0, std::fabs(static_cast<double>(expected)));
+	}
+
+}
+
+BENCHMARK_SUITE(Frustum) {
+	const Camera camera = Benchmark::MakeMainCamera();
+	const Matrix4x4& viewProjectionMatrix = camera.GetViewProjectionMatrix();
+	const Matrix4x4& viewProjectionViewportMatrix = camera.GetViewProjectionViewportMatrix();
+	const Frustum& frustum = camera.GetFrustum();
+
+	// カメラの周り(後ろも含む)に散らばった大きなシーン
+	std::mt19937 engine(options.seed);
+	const size_t sphereCount = 10000;
+	std::vector<Sphere> spheres(sphereCount);
+	std::vector<float> centerX(sphereCount), centerY(sphereCount), centerZ(sphereCount), radius(sphereCount);
+	for (size_t i = 0; i < sphereCount; ++i) {
+		spheres[i] = { Benchmark::RandomVector3(engine, -100.0f, 100.0f), Benchmark::RandomFloat(engine, 0.1f, 2.0f) };
+		centerX[i] = spheres[i].center.x;
+		centerY[i] = spheres[i].center.y;
+		centerZ[i] = spheres[i].center.z;
+		radius[i] = spheres[i].radius;
+	}
+	SpheresSoA spheresSoA = { centerX, centerY, centerZ, radius };
+	std::vector<uint8_t> sphereVisible(sphereCount);
+	size_t visibleCount = CullSpheres(frustum, spheresSoA, sphereVisible);
+
+	// 一括判定が1つずつの判定と一致するか、球が見えるならそれを囲むAABBも見えるか
+	size_t batchMismatches = 0;
+	size_t aabbMisses = 0;
+	for (size_t i = 0; i < sphereCount; ++i) {
+		bool visible = IsVisible(frustum, spheres[i]);
+		batchMismatches += visible != (sphereVisible[i] != 0);
+		Vector3 extent = { spheres[i].radius, spheres[i].radius, spheres[i].radius };
+		AABB aabb = { Subtract(spheres[i].center, extent), Add(spheres[i].center, extent) };
+		aabbMisses += visible && !IsVisible(frustum, aabb);
+	}
+	Benchmark::Check("CullSpheres matches IsVisible", static_cast<double>(batchMismatches), 0.0);
+	Benchmark::Check("visible sphere => visible bounding AABB", static_cast<double>(aabbMisses), 0.0);
+
+	// 捨てた球の表面にクリップ空間内の点が無いか(カリングが保守的か)
+	const SphereWireframe& wireframe = GetSphereWireframe(12);
+	const size_t vertexCount = wireframe.x.size();
+	size_t culledButInside = 0;
+	for (size_t i = 0; i < sphereCount; ++i) {
+		if (sphereVisible[i]) {
+			continue;
+		}
+		for (size_t v = 0; v < vertexCount; ++v) {
+			Vector3 point = Add(spheres[i].center, Multiply(spheres[i].radius, Vector3{ wireframe.x[v], wireframe.y[v], wireframe.z[v] }));
+			culledButInside += IsInsideClipSpace(point, viewProjectionMatrix);
+		}
+	}
+	Benchmark::Check("culling is conservative", static_cast<double>(culledButInside), 0.0);
+
+	// 両端がカメラの前にある線はTransformToScreenと同じ座標になり、
+	// 後ろへ伸びる線は近平面との交点で切られるか
+	const size_t lineCount = 4096;
+	double frontError = 0.0;
+	double clipError = 0.0;
+	size_t frontLines = 0;
+	size_t clippedLines = 0;
+	const Plane& nearPlane = frustum.planes[Frustum::kNear];
+	for (size_t i = 0; i < lineCount; ++i) {
+		Vector3 start = Benchmark::RandomVector3(engine, -20.0f, 20.0f);
+		Vector3 end = Benchmark::RandomVector3(engine, -20.0f, 20.0f);
+		float startDistance = Dot(nearPlane.normal, start) - nearPlane.distance;
+		float endDistance = Dot(nearPlane.normal, end) - nearPlane.distance;
+		DebugLine line = { 0.0f, 0.0f, 0.0f, 0.0f, 0 };
+		bool drawn = ClipLineToScreen(start, end, viewProjectionViewportMatrix, line);
+		if (startDistance > 0.01f && endDistance > 0.01f) {
+			Vector3 screenStart = Transform(start, viewProjectionViewportMatrix);
+			Vector3 screenEnd = Transform(end, viewProjectionViewportMatrix);
+			frontError = std::max({ frontError, drawn ? 0.0 : 1.0,
+				GetRelativeError(line.startX, screenStart.x), GetRelativeError(line.startY, screenStart.y),
+				GetRelativeError(line.endX, screenEnd.x), GetRelativeError(line.endY, screenEnd.y) });
+			++frontLines;
+		} else if ((startDistance > 0.01f && endDistance < -0.01f) || (startDistance < -0.01f && endDistance > 0.01f)) {
+			float crossingX;
+			float crossingY;
+			GetNearCrossingOnScreen(start, end, viewProjectionViewportMatrix, crossingX, crossingY);
+			float clippedX = startDistance < 0.0f ? line.startX : line.endX;
+			float clippedY = startDistance < 0.0f ? line.startY : line.endY;
+			bool finite = std::isfinite(line.startX) && std::isfinite(line.startY) && std::isfinite(line.endX) && std::isfinite(line.endY);
+			clipError = std::max({ clipError, drawn && finite ? 0.0 : 1.0,
+				GetRelativeError(clippedX, crossingX), GetRelativeError(clippedY, crossingY) });
+			++clippedLines;
+		} else if (startDistance < -0.01f && endDistance < -0.01f) {
+			clipError = std::max(clipError, drawn ? 1.0 : 0.0);
+		}
+	}
+	Benchmark::Check("ClipLineToScreen matches TransformToScreen in front of the camera", frontError, 1e-4);
+	Benchmark::Check("ClipLineToScreen cuts at the near plane", clipError, 1e-4);
+
+	std::printf("  %zu / %zu spheres visible (%.1f%% of sphere wireframe vertices skipped), %zu front lines, %zu clipped lines\n",
+		visibleCount, sphereCount, 100.0 * static_cast<double>(sphereCount - visibleCount) / static_cast<double>(sphereCount), frontLines, clippedLines);
+
+	std::vector<float> screenX(vertexCount), screenY(vertexCount);
+	std::vector<uint8_t> visible(vertexCount);
+	DebugDraw debugDraw;
+
+	// 1フレーム分の球を変換して線をためる
+	Benchmark::Options sceneOptions = options;
+	sceneOptions.iterations = std::min(options.iterations, sphereCount * 32);
+	Benchmark::RunBatch("transform all spheres", sceneOptions, sphereCount, [&] {
+		for (const Sphere& sphere : spheres) {
+			TransformSphereWireframe(wireframe, sphere.center, sphere.radius, viewProjectionViewportMatrix, { screenX, screenY, visible });
+			debugDraw.AddLines(screenX.data(), screenY.data(), visible.data(), wireframe.lines, 0xFFFFFFFF);
+		}
+		debugDraw.Flush();
+		});
+	Benchmark::RunBatch("cull + transform visible spheres", sceneOptions, sphereCount, [&] {
+		CullSpheres(frustum, spheresSoA, sphereVisible);
+		for (size_t i = 0; i < sphereCount; ++i) {
+			if (!sphereVisible[i]) {
+				continue;
+			}
+			// main.cppのDrawSphereと同じく、カメラの後ろへ伸びる線は近平面で切る
+			Matrix4x4 sphereMatrix = MakeSphereWireframeMatrix(spheres[i].center, spheres[i].radius, viewProjectionViewportMatrix);
+			PointsSoA points = { wireframe.x, wireframe.y, wireframe.z };
+			TransformToScreen(points, sphereMatrix, { screenX, screenY, visible });
+			AddClippedLines(debugDraw, points, { screenX, screenY, visible }, wireframe.lines, sphereMatrix, 0xFFFFFFFF);
+		}
+		debugDraw.Flush();
+		});
+	Benchmark::RunBatch("CullSpheres only", options, sphereCount, [&] {
+		Benchmark::DoNotOptimize(CullSpheres(frustum, spheresSoA, sphereVisible));
+		});
+}
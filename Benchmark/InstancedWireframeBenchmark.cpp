@@ -0,0 +1,159 @@
+#include "Benchmark.h"
+#include "DebugDraw.h"
+#include "Frustum.h"
+#include "InstancedWireframe.h"
+#include "MathFunction.h"
+#include "Primitive.h"
+#include "SphereWireframe.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+	// 2つの線の列の端点の差の最大(本数が違えば大きな値)
+	double GetMaxLineError(std::span<const DebugLine> actual, std::span<const DebugLine> expected) {
+		if (actual.size() != expected.size()) {
+			return 1e9;
+		}
+		double error = 0.0;
+		for (size_t i = 0; i < actual.size(); ++i) {
+			const DebugLine& a = actual[i];
+			const DebugLine& b = expected[i];
+			error = std::max(error, static_cast<double>(std::fabs(a.startX - b.startX)));
+			error = std::max(error, static_cast<double>(std::fabs(a.startY - b.startY)));
+			error = std::max(error, static_cast<double>(std::fabs(a.endX - b.endX)));
+			error = std::max(error, static_cast<double>(std::fabs(a.endY - b.endY)));
+			error += a.color == b.color ? 0.0 : 1e9;
+		}
+		return error;
+	}
+
+}
+
+BENCHMARK_SUITE(InstancedWireframe) {
+	const Camera camera = Benchmark::MakeMainCamera();
+	const Matrix4x4& viewProjectionViewportMatrix = camera.GetViewProjectionViewportMatrix();
+	const Frustum& frustum = camera.GetFrustum();
+
+	// 色の変換は往復で元に戻る
+	double colorError = 0.0;
+	for (uint32_t color : { 0x00000000u, 0xFFFFFFFFu, 0x4040FFFFu, 0x12345678u, 0xAAAAAAFFu }) {
+		float rgba[4];
+		ColorToFloat4(color, rgba);
+		colorError += Float4ToColor(rgba) == color ? 0.0 : 1.0;
+	}
+	Benchmark::Check("color round trip", colorError, 0.0);
+
+	// 球: 形状は単位球と同じで、インスタンスの行列を通した線がTransformSphereWireframeの線と一致する
+	std::mt19937 engine(options.seed);
+	const size_t sphereCount = 500;
+	const uint32_t subdivision = 8;
+	std::vector<Sphere> spheres(sphereCount);
+	std::vector<float> centerX(sphereCount), centerY(sphereCount), centerZ(sphereCount), radius(sphereCount);
+	for (size_t i = 0; i < sphereCount; ++i) {
+		spheres[i] = { Benchmark::RandomVector3(engine, -5.0f, 5.0f), Benchmark::RandomFloat(engine, 0.1f, 0.3f) };
+		centerX[i] = spheres[i].center.x;
+		centerY[i] = spheres[i].center.y;
+		centerZ[i] = spheres[i].center.z;
+		radius[i] = spheres[i].radius;
+	}
+
+	const SphereWireframe& wireframe = GetSphereWireframe(subdivision);
+	WireframeMesh sphereMesh = MakeSphereWireframeMesh(subdivision);
+	Benchmark::Check("sphere mesh matches the shared wireframe",
+		(sphereMesh.x == wireframe.x && sphereMesh.y == wireframe.y && sphereMesh.z == wireframe.z && sphereMesh.indices == wireframe.lines) ? 0.0 : 1.0, 0.0);
+
+	std::vector<float> screenX(wireframe.x.size()), screenY(wireframe.x.size());
+	std::vector<uint8_t> visible(sphereCount);
+	std::vector<uint8_t> vertexVisible(wireframe.x.size());
+
+	// CPUで頂点を変換する従来の経路(DrawSphereと同じ)
+	auto buildCpuFrame = [&](DebugDraw& debugDraw) {
+		for (const Sphere& sphere : spheres) {
+			if (!IsVisible(frustum, sphere)) {
+				continue;
+			}
+			TransformSphereWireframe(wireframe, sphere.center, sphere.radius, viewProjectionViewportMatrix, { screenX, screenY, vertexVisible });
+			debugDraw.AddLines(screenX.data(), screenY.data(), vertexVisible.data(), wireframe.lines, 0x4040FFFF);
+		}
+		};
+
+	// インスタンスの経路(CPUの仕事は見えている球の行列を並べるだけ)
+	WireframeInstanceBuffer instances;
+	SpheresSoA spheresSoA = { centerX, centerY, centerZ, radius };
+	auto buildInstances = [&] {
+		instances.Clear();
+		return AddVisibleSpheres(instances, frustum, spheresSoA, visible, 0x4040FFFF);
+		};
+
+	DebugDraw expected;
+	buildCpuFrame(expected);
+	size_t visibleCount = buildInstances();
+	DebugDraw actual;
+	DrawWireframeInstancesCpu(sphereMesh, instances.GetInstances(), viewProjectionViewportMatrix, actual);
+	Benchmark::Check("visible spheres become instances", static_cast<double>(instances.GetInstances().size()) - static_cast<double>(visibleCount), 0.0);
+	Benchmark::Check("instanced spheres match the CPU path (pixels)", GetMaxLineError(actual.GetLines(), expected.GetLines()), 1e-3);
+
+	// 平面: 菱形をインスタンスの行列で写すとDrawPlaneと同じ4頂点になる
+	double planeError = 0.0;
+	for (int i = 0; i < 64; ++i) {
+		Vector3 normal;
+		if (!TryNormalize(Benchmark::RandomVector3(engine, -1.0f, 1.0f), normal)) {
+			continue;
+		}
+		Plane plane = { normal, Benchmark::RandomFloat(engine, -3.0f, 3.0f) };
+		Vector3 center = Multiply(plane.distance, plane.normal);
+		Vector3 perpendicular = Normalize(Perpendicular(plane.normal));
+		Vector3 cross = Cross(plane.normal, perpendicular);
+		const Vector3 corners[4] = {
+			Add(center, Multiply(2.0f, perpendicular)),
+			Subtract(center, Multiply(2.0f, perpendicular)),
+			Add(center, Multiply(2.0f, cross)),
+			Subtract(center, Multiply(2.0f, cross)),
+		};
+
+		WireframeMesh planeMesh = MakePlaneWireframeMesh();
+		Matrix4x4 world = MakePlaneInstanceMatrix(plane);
+		for (int corner = 0; corner < 4; ++corner) {
+			Vector3 local = { planeMesh.x[corner], planeMesh.y[corner], planeMesh.z[corner] };
+			Vector3 transformed = Transform(local, world);
+			planeError = std::max(planeError, static_cast<double>(GetLength(Subtract(transformed, corners[corner]))));
+		}
+	}
+	Benchmark::Check("plane instance matches DrawPlane corners", planeError, 1e-5);
+
+	// グリッド: 線の本数と、中央線だけ黒いこと
+	WireframeMesh gridMesh = MakeGridWireframeMesh();
+	size_t blackLines = 0;
+	for (size_t i = 0; i < gridMesh.indices.size(); i += 2) {
+		blackLines += gridMesh.vertices[gridMesh.indices[i]].color[0] == 0.0f;
+	}
+	Benchmark::Check("grid mesh line count", static_cast<double>(gridMesh.indices.size()) - 44.0, 0.0);
+	Benchmark::Check("grid mesh has two black center lines", static_cast<double>(blackLines) - 2.0, 0.0);
+
+	// 2フレーム目以降は容量が増えない(確保が起きない)
+	size_t capacity = instances.GetCapacity();
+	for (int frame = 0; frame < 8; ++frame) {
+		buildInstances();
+	}
+	Benchmark::Check("steady-state frames do not grow the instance buffer", static_cast<double>(instances.GetCapacity() - capacity), 0.0);
+
+	// 1フレームでCPUが送る量: 従来は線(スクリーン座標)、インスタンスでは行列と色だけ
+	std::printf("  %zu visible spheres: %zu lines (%zu bytes) on the CPU path, %zu bytes of instances\n",
+		visibleCount, expected.GetLines().size(), expected.GetLines().size() * sizeof(DebugLine), instances.GetByteSize());
+
+	DebugDraw debugDraw;
+	Benchmark::RunBatch("CPU path: transform every vertex", options, sphereCount, [&] {
+		buildCpuFrame(debugDraw);
+		Benchmark::DoNotOptimize(debugDraw.GetLines().size());
+		debugDraw.Flush();
+		});
+	Benchmark::RunBatch("instanced path: build instance buffer", options, sphereCount, [&] {
+		Benchmark::DoNotOptimize(buildInstances());
+		});
+	Benchmark::RunBatch("instanced path: CPU emulation of the vertex shader", options, sphereCount, [&] {
+		DrawWireframeInstancesCpu(sphereMesh, instances.GetInstances(), viewProjectionViewportMatrix, debugDraw);
+		Benchmark::DoNotOptimize(debugDraw.GetLines().size());
+		debugDraw.Flush();
+		});
+}
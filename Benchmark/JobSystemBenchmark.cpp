@@ -0,0 +1,172 @@
+#include "Benchmark.h"
+#include "MathFunction.h"
+#include "ParallelBatch.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace {
+
+	// 1, 2, 4, ... と論理コア数まで(1コアの環境でも複数スレッドの経路を通すため最低2まで)
+	std::vector<uint32_t> MakeThreadCounts() {
+		uint32_t maxThreads = std::max(2u, std::thread::hardware_concurrency());
+		std::vector<uint32_t> counts;
+		for (uint32_t threads = 1; threads < maxThreads; threads *= 2) {
+			counts.push_back(threads);
+		}
+		counts.push_back(maxThreads);
+		return counts;
+	}
+
+	template<typename T>
+	size_t CountMismatches(const std::vector<T>& expected, const std::vector<T>& actual) {
+		size_t mismatches = 0;
+		for (size_t i = 0; i < expected.size(); ++i) {
+			mismatches += std::memcmp(&expected[i], &actual[i], sizeof(T)) != 0;
+		}
+		return mismatches;
+	}
+
+}
+
+BENCHMARK_SUITE(JobSystem) {
+	std::mt19937 engine(options.seed);
+
+	// 変換: 大量の点をスクリーンへ
+	const Camera camera = Benchmark::MakeMainCamera();
+	const Matrix4x4& viewProjectionViewportMatrix = camera.GetViewProjectionViewportMatrix();
+	const size_t pointCount = 1 << 20;
+	std::vector<float> x(pointCount), y(pointCount), z(pointCount);
+	for (size_t i = 0; i < pointCount; ++i) {
+		x[i] = Benchmark::RandomFloat(engine, -4.0f, 4.0f);
+		y[i] = Benchmark::RandomFloat(engine, -4.0f, 4.0f);
+		z[i] = Benchmark::RandomFloat(engine, -4.0f, 4.0f);
+	}
+	PointsSoA points = { x, y, z };
+
+	// 線分 × 球の総当たり
+	const size_t segmentCount = 4096;
+	const size_t sphereCount = 256;
+	std::vector<float> segmentSoA[6];
+	for (std::vector<float>& values : segmentSoA) {
+		values.resize(segmentCount);
+	}
+	std::vector<Segment> segments(segmentCount);
+	for (size_t i = 0; i < segmentCount; ++i) {
+		segments[i].origin = Benchmark::RandomVector3(engine, -20.0f, 20.0f);
+		segments[i].diff = Add(segments[i].origin, Benchmark::RandomVector3(engine, -3.0f, 3.0f));
+		segmentSoA[0][i] = segments[i].origin.x;
+		segmentSoA[1][i] = segments[i].origin.y;
+		segmentSoA[2][i] = segments[i].origin.z;
+		segmentSoA[3][i] = segments[i].diff.x;
+		segmentSoA[4][i] = segments[i].diff.y;
+		segmentSoA[5][i] = segments[i].diff.z;
+	}
+	SegmentsSoA segmentsSoA = { segmentSoA[0], segmentSoA[1], segmentSoA[2], segmentSoA[3], segmentSoA[4], segmentSoA[5] };
+	std::vector<float> sphereSoA[4];
+	for (std::vector<float>& values : sphereSoA) {
+		values.resize(sphereCount);
+	}
+	for (size_t j = 0; j < sphereCount; ++j) {
+		Vector3 center = Benchmark::RandomVector3(engine, -20.0f, 20.0f);
+		sphereSoA[0][j] = center.x;
+		sphereSoA[1][j] = center.y;
+		sphereSoA[2][j] = center.z;
+		sphereSoA[3][j] = Benchmark::RandomFloat(engine, 0.5f, 3.0f);
+	}
+	SpheresSoA spheresSoA = { sphereSoA[0], sphereSoA[1], sphereSoA[2], sphereSoA[3] };
+	const size_t pairCount = segmentCount * sphereCount;
+
+	// ブロードフェーズへの線分クエリ
+	BroadPhase broadPhase;
+	for (size_t i = 0; i < 20000; ++i) {
+		Vector3 center = Benchmark::RandomVector3(engine, -20.0f, 20.0f);
+		broadPhase.Add(Sphere{ center, Benchmark::RandomFloat(engine, 0.1f, 0.5f) }, static_cast<uint32_t>(i));
+	}
+
+	// ワールド行列(出力は変換より多めに取り、余りに書かないことも確かめる)
+	const size_t transformCount = 10000;
+	const size_t matrixPadding = 3000;
+	std::vector<float> transformSoA[9];
+	for (size_t k = 0; k < 9; ++k) {
+		transformSoA[k].resize(transformCount);
+		for (float& value : transformSoA[k]) {
+			value = k < 3 ? Benchmark::RandomFloat(engine, 0.5f, 2.0f) : Benchmark::RandomFloat(engine, -3.0f, 3.0f);
+		}
+	}
+	TransformsSoA transforms = {
+		transformSoA[0], transformSoA[1], transformSoA[2], transformSoA[3], transformSoA[4],
+		transformSoA[5], transformSoA[6], transformSoA[7], transformSoA[8],
+	};
+
+	// 逐次版の結果
+	std::vector<float> expectedX(pointCount), expectedY(pointCount);
+	std::vector<uint8_t> expectedVisible(pointCount);
+	TransformToScreen(points, viewProjectionViewportMatrix, { expectedX, expectedY, expectedVisible });
+	std::vector<uint8_t> expectedHit(pairCount);
+	std::vector<float> expectedT(pairCount);
+	IsCollisionBatch(segmentsSoA, spheresSoA, { expectedHit, expectedT });
+	std::vector<SegmentCandidate> expectedCandidates;
+	for (size_t i = 0; i < segmentCount; ++i) {
+		broadPhase.QuerySegment(segments[i], [&](BroadPhase::Handle handle) {
+			expectedCandidates.push_back({ static_cast<uint32_t>(i), handle });
+			return true;
+			});
+	}
+
+	std::vector<float> screenX(pointCount), screenY(pointCount);
+	std::vector<uint8_t> visible(pointCount);
+	std::vector<uint8_t> hit(pairCount);
+	std::vector<float> t(pairCount);
+	std::vector<SegmentCandidate> candidates;
+	std::vector<Matrix4x4> expectedMatrices(transformCount);
+	MakeAffineMatrices(transforms, expectedMatrices);
+	Matrix4x4 sentinel = {};
+	sentinel.m[0][0] = 12345.0f;
+	std::vector<Matrix4x4> matrices(transformCount + matrixPadding);
+
+	// クエリは1件が重いので回数を抑える
+	Benchmark::Options queryOptions = options;
+	queryOptions.iterations = std::min(options.iterations, segmentCount * 16);
+
+	for (uint32_t threads : MakeThreadCounts()) {
+		JobSystem jobs(threads - 1);
+		std::printf("  -- %u threads\n", jobs.GetThreadCount());
+		std::string label = " (" + std::to_string(threads) + "T)";
+
+		// スレッド数によらず逐次版とビット単位で一致するか
+		TransformToScreen(jobs, points, viewProjectionViewportMatrix, { screenX, screenY, visible });
+		IsCollisionBatch(jobs, segmentsSoA, spheresSoA, { hit, t });
+		QuerySegments(jobs, broadPhase, segments, candidates);
+		size_t mismatches = CountMismatches(expectedX, screenX) + CountMismatches(expectedY, screenY) + CountMismatches(expectedVisible, visible);
+		mismatches += CountMismatches(expectedHit, hit);
+		for (size_t i = 0; i < pairCount; ++i) {
+			mismatches += expectedHit[i] && std::memcmp(&expectedT[i], &t[i], sizeof(float)) != 0;
+		}
+		mismatches += candidates.size() != expectedCandidates.size();
+		for (size_t i = 0; i < std::min(candidates.size(), expectedCandidates.size()); ++i) {
+			mismatches += candidates[i].segment != expectedCandidates[i].segment || candidates[i].handle != expectedCandidates[i].handle;
+		}
+		Benchmark::Check(("parallel == sequential" + label).c_str(), static_cast<double>(mismatches), 0.0);
+
+		std::fill(matrices.begin(), matrices.end(), sentinel);
+		MakeAffineMatrices(jobs, transforms, matrices);
+		size_t matrixMismatches = 0;
+		for (size_t i = 0; i < matrices.size(); ++i) {
+			const Matrix4x4& expected = i < transformCount ? expectedMatrices[i] : sentinel;
+			matrixMismatches += std::memcmp(&expected, &matrices[i], sizeof(Matrix4x4)) != 0;
+		}
+		Benchmark::Check(("oversized matrix output" + label).c_str(), static_cast<double>(matrixMismatches), 0.0);
+
+		Benchmark::RunBatch(("TransformToScreen" + label).c_str(), options, pointCount, [&] {
+			Benchmark::DoNotOptimize(TransformToScreen(jobs, points, viewProjectionViewportMatrix, { screenX, screenY, visible }));
+			});
+		Benchmark::RunBatch(("IsCollisionBatch(Segments, Spheres)" + label).c_str(), options, pairCount, [&] {
+			Benchmark::DoNotOptimize(IsCollisionBatch(jobs, segmentsSoA, spheresSoA, { hit, t }));
+			});
+		Benchmark::RunBatch(("QuerySegments" + label).c_str(), queryOptions, segmentCount, [&] {
+			QuerySegments(jobs, broadPhase, segments, candidates);
+			Benchmark::DoNotOptimize(candidates.size());
+			});
+	}
+}
@@ -0,0 +1,51 @@
+#include "Benchmark.h"
+#include "MathFunction.h"
+
+namespace {
+
+	// w成分が1になる(射影を含まない)ランダム行列
+	Matrix4x4 RandomAffineMatrix(std::mt19937& engine) {
+		Matrix4x4 matrix = Benchmark::RandomMatrix(engine, -2.0f, 2.0f);
+		matrix.m[0][3] = 0.0f;
+		matrix.m[1][3] = 0.0f;
+		matrix.m[2][3] = 0.0f;
+		matrix.m[3][3] = 1.0f;
+		return matrix;
+	}
+
+}
+
+BENCHMARK_SUITE(Vector) {
+	std::mt19937 engine(options.seed);
+	std::vector<Vector3> a = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, -10.0f, 10.0f); });
+	std::vector<Vector3> b = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, -10.0f, 10.0f); });
+
+	Benchmark::Run("Add", options, [&](size_t i) { Benchmark::DoNotOptimize(Add(a[i], b[i])); });
+	Benchmark::Run("Subtract", options, [&](size_t i) { Benchmark::DoNotOptimize(Subtract(a[i], b[i])); });
+	Benchmark::Run("Dot", options, [&](size_t i) { Benchmark::DoNotOptimize(Dot(a[i], b[i])); });
+	Benchmark::Run("Cross", options, [&](size_t i) { Benchmark::DoNotOptimize(Cross(a[i], b[i])); });
+	Benchmark::Run("GetLength", options, [&](size_t i) { Benchmark::DoNotOptimize(GetLength(a[i])); });
+	Benchmark::Run("Normalize", options, [&](size_t i) { Benchmark::DoNotOptimize(Normalize(a[i])); });
+	Benchmark::Run("Project", options, [&](size_t i) { Benchmark::DoNotOptimize(Project(a[i], b[i])); });
+	Benchmark::Run("Perpendicular", options, [&](size_t i) { Benchmark::DoNotOptimize(Perpendicular(a[i])); });
+}
+
+BENCHMARK_SUITE(Matrix) {
+	std::mt19937 engine(options.seed);
+	std::vector<Matrix4x4> m1 = Benchmark::MakeInputs<Matrix4x4>(options, [&] { return Benchmark::RandomMatrix(engine, -2.0f, 2.0f); });
+	std::vector<Matrix4x4> m2 = Benchmark::MakeInputs<Matrix4x4>(options, [&] { return Benchmark::RandomMatrix(engine, -2.0f, 2.0f); });
+	std::vector<Matrix4x4> affine = Benchmark::MakeInputs<Matrix4x4>(options, [&] { return RandomAffineMatrix(engine); });
+	std::vector<Vector3> points = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, -10.0f, 10.0f); });
+	std::vector<Vector3> scales = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, 0.1f, 3.0f); });
+	std::vector<Vector3> rotates = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, -3.14f, 3.14f); });
+	std::vector<float> angles = Benchmark::MakeInputs<float>(options, [&] { return Benchmark::RandomFloat(engine, 0.1f, 3.0f); });
+
+	Benchmark::Run("Multiply", options, [&](size_t i) { Benchmark::DoNotOptimize(Multiply(m1[i], m2[i])); });
+	Benchmark::Run("Inverse", options, [&](size_t i) { Benchmark::DoNotOptimize(Inverse(m1[i])); });
+	Benchmark::Run("Transform", options, [&](size_t i) { Benchmark::DoNotOptimize(Transform(points[i], affine[i])); });
+	Benchmark::Run("TransformWithoutW", options, [&](size_t i) { Benchmark::DoNotOptimize(TransformWithoutW(points[i], m1[i])); });
+	Benchmark::Run("MakeAffineMatrix", options, [&](size_t i) { Benchmark::DoNotOptimize(MakeAffineMatrix(scales[i], rotates[i], points[i])); });
+	Benchmark::Run("MakePerspectiveFovMatrix", options, [&](size_t i) { Benchmark::DoNotOptimize(MakePerspectiveFovMatrix(angles[i], 1280.0f / 720.0f, 0.1f, 100.0f)); });
+	Benchmark::Run("MakeViewportMatrix", options, [&](size_t i) { Benchmark::DoNotOptimize(MakeViewportMatrix(0.0f, 0.0f, angles[i] * 1280.0f, 720.0f, 0.0f, 1.0f)); });
+	Benchmark::Run("Cotangent", options, [&](size_t i) { Benchmark::DoNotOptimize(Cotangent(angles[i])); });
+}
@@ -0,0 +1,116 @@
+#include "Benchmark.h"
+#include "MathExpression.h"
+#include "MathFunction.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+	// コンパイル時に計算できるか(式テンプレートと行列の結果)
+	constexpr Vector3 kOrigin = { 1.0f, 2.0f, 3.0f };
+	constexpr Vector3 kDirection = { 0.0f, 0.0f, 2.0f };
+
+	static_assert(Math::Equals(kOrigin + 0.5f * kDirection, Vector3{ 1.0f, 2.0f, 4.0f }));
+	static_assert(Math::Equals(kOrigin - kDirection / 2.0f, Vector3{ 1.0f, 2.0f, 2.0f }));
+	static_assert(Math::Equals(-kOrigin + kOrigin * 2.0f, kOrigin));
+	static_assert(Math::Dot(kOrigin, kDirection) == 6.0f);
+	static_assert(Math::Equals(Math::Cross(Vector3{ 1.0f, 0.0f, 0.0f }, Vector3{ 0.0f, 1.0f, 0.0f }), Vector3{ 0.0f, 0.0f, 1.0f }));
+	static_assert(Math::GetLength(Vector3{ 3.0f, 4.0f, 0.0f }) == 5.0f);
+	static_assert(Math::Equals(Math::Normalize(kDirection), Vector3{ 0.0f, 0.0f, 1.0f }));
+	static_assert(Math::Equals(Math::Project(kOrigin, kDirection), Vector3{ 0.0f, 0.0f, 3.0f }));
+	static_assert(Math::Equals(Math::Project(kOrigin, Vector3{ 0.0f, 0.0f, 0.0f }), Vector3{ 0.0f, 0.0f, 0.0f }));
+
+	// 式は値を持つので、autoで受け取って後から計算しても同じ結果
+	constexpr auto kLazy = kOrigin + 2.0f * kDirection;
+	static_assert(Math::Equals(Math::Evaluate(kLazy), Vector3{ 1.0f, 2.0f, 7.0f }));
+
+	constexpr Vector3 AccumulateInPlace() {
+		Vector3 v = kOrigin;
+		v += v;// 右辺が自分自身でも壊れない
+		v -= kDirection;
+		v *= 0.5f;
+		return v;
+	}
+	static_assert(Math::Equals(AccumulateInPlace(), Vector3{ 1.0f, 2.0f, 2.0f }));
+
+	constexpr Matrix4x4 kViewport = Math::MakeViewportMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f);
+	static_assert(kViewport.m[0][0] == 640.0f && kViewport.m[1][1] == -360.0f && kViewport.m[3][0] == 640.0f && kViewport.m[3][1] == 360.0f);
+	static_assert(Math::Equals(Math::kIdentityMatrix * kViewport, kViewport));
+	static_assert(Math::Equals(Math::Transpose(Math::Transpose(kViewport)), kViewport));
+
+	constexpr Matrix4x4 kScaleTranslate = Math::MakeScaleMatrix({ 2.0f, 4.0f, 8.0f }) * Math::MakeTranslateMatrix({ 1.0f, 2.0f, 3.0f });
+	static_assert(Math::Equals(Math::Transform(Vector3{ 1.0f, 1.0f, 1.0f }, kScaleTranslate), Vector3{ 3.0f, 6.0f, 11.0f }));
+	static_assert(Math::Equals(Math::TransformDirection(Vector3{ 1.0f, 1.0f, 1.0f }, kScaleTranslate), Vector3{ 2.0f, 4.0f, 8.0f }));
+	// 2の累乗の拡縮と整数の移動なので逆行列も誤差なく求まる
+	static_assert(Math::Equals(Math::Inverse(kScaleTranslate) * kScaleTranslate, Math::kIdentityMatrix));
+	static_assert(Math::Equals(Math::Inverse(Matrix4x4{}), Math::kIdentityMatrix));
+
+	double GetMaxDifference(const Vector3& a, const Vector3& b) {
+		return std::max({ std::fabs(static_cast<double>(a.x) - b.x), std::fabs(static_cast<double>(a.y) - b.y), std::fabs(static_cast<double>(a.z) - b.z) });
+	}
+
+	double GetMaxRelativeDifference(const Matrix4x4& a, const Matrix4x4& b) {
+		double difference = 0.0;
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				double expected = b.m[row][column];
+				difference = std::max(difference, std::fabs(a.m[row][column] - expected) / std::max(1.0, std::fabs(expected)));
+			}
+		}
+		return difference;
+	}
+
+}
+
+BENCHMARK_SUITE(MathExpression) {
+	std::mt19937 engine(options.seed);
+	std::vector<Vector3> a = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, -10.0f, 10.0f); });
+	std::vector<Vector3> b = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, -10.0f, 10.0f); });
+	std::vector<Vector3> c = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, -10.0f, 10.0f); });
+	std::vector<float> s = Benchmark::MakeInputs<float>(options, [&] { return Benchmark::RandomFloat(engine, -2.0f, 2.0f); });
+	std::vector<Matrix4x4> m1 = Benchmark::MakeInputs<Matrix4x4>(options, [&] { return Benchmark::RandomMatrix(engine, -2.0f, 2.0f); });
+	std::vector<Matrix4x4> m2 = Benchmark::MakeInputs<Matrix4x4>(options, [&] { return Benchmark::RandomMatrix(engine, -2.0f, 2.0f); });
+
+	// 実行時の結果が従来の関数と一致するか
+	double vectorError = 0.0;
+	double matrixError = 0.0;
+	double inverseError = 0.0;
+	for (size_t i = 0; i < options.inputCount; ++i) {
+		Vector3 fused = a[i] + s[i] * b[i] - c[i];
+		Vector3 chained = Subtract(Add(a[i], Multiply(s[i], b[i])), c[i]);
+		vectorError = std::max({ vectorError, GetMaxDifference(fused, chained),
+			std::fabs(static_cast<double>(Math::Dot(a[i], b[i])) - Dot(a[i], b[i])),
+			GetMaxDifference(Math::Cross(a[i], b[i]), Cross(a[i], b[i])),
+			GetMaxDifference(Math::Normalize(a[i]), Normalize(a[i])),
+			GetMaxDifference(Math::Project(a[i], b[i]), Project(a[i], b[i])) });
+		matrixError = std::max(matrixError, GetMaxRelativeDifference(m1[i] * m2[i], Multiply(m1[i], m2[i])));
+		// 逆行列は条件数の悪い行列では誤差が大きいので、従来のInverseで精度よく戻る行列だけで比べる
+		if (GetMaxRelativeDifference(Multiply(Inverse(m1[i]), m1[i]), Math::kIdentityMatrix) < 1e-4) {
+			inverseError = std::max(inverseError, GetMaxRelativeDifference(Math::Inverse(m1[i]) * m1[i], Math::kIdentityMatrix));
+		}
+	}
+	Benchmark::Check("fused vector chains match MathFunction", vectorError, 1e-5);
+	Benchmark::Check("Math::Multiply matches Multiply", matrixError, 1e-5);
+	Benchmark::Check("Math::Inverse matches Inverse on well-conditioned inputs", inverseError, 1e-3);
+	Benchmark::Check("Math::MakeViewportMatrix matches MakeViewportMatrix", GetMaxRelativeDifference(kViewport, MakeViewportMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f)), 0.0);
+
+	// a + s * b - c (従来は途中の結果ごとにVector3を返す関数呼び出し)
+	Benchmark::Run("Subtract(Add(a, Multiply(s, b)), c)", options, [&](size_t i) {
+		Benchmark::DoNotOptimize(Subtract(Add(a[i], Multiply(s[i], b[i])), c[i]));
+		});
+	Benchmark::Run("a + s * b - c (expression)", options, [&](size_t i) {
+		Benchmark::DoNotOptimize(Math::Evaluate(a[i] + s[i] * b[i] - c[i]));
+		});
+	Benchmark::Run("Dot(Add(a, b), c)", options, [&](size_t i) {
+		Benchmark::DoNotOptimize(Dot(Add(a[i], b[i]), c[i]));
+		});
+	Benchmark::Run("Math::Dot(a + b, c) (expression)", options, [&](size_t i) {
+		Benchmark::DoNotOptimize(Math::Dot(a[i] + b[i], c[i]));
+		});
+	Benchmark::Run("Multiply", options, [&](size_t i) { Benchmark::DoNotOptimize(Multiply(m1[i], m2[i])); });
+	Benchmark::Run("Math::Multiply (operator*)", options, [&](size_t i) { Benchmark::DoNotOptimize(m1[i] * m2[i]); });
+	Benchmark::Run("Inverse", options, [&](size_t i) { Benchmark::DoNotOptimize(Inverse(m1[i])); });
+	Benchmark::Run("Math::Inverse", options, [&](size_t i) { Benchmark::DoNotOptimize(Math::Inverse(m1[i])); });
+	Benchmark::Run("MakeViewportMatrix (run time)", options, [&](size_t) { Benchmark::DoNotOptimize(MakeViewportMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f)); });
+	Benchmark::Run("Math::MakeViewportMatrix (constant)", options, [&](size_t) { Benchmark::DoNotOptimize(kViewport); });
+}
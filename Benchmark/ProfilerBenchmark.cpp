@@ -0,0 +1,140 @@
+#include "Benchmark.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+	// 計測される側の仕事(最適化で消えない程度の計算)
+	float Work(uint32_t count) {
+		float sum = 0.0f;
+		for (uint32_t i = 0; i < count; ++i) {
+			sum += std::sqrt(static_cast<float>(i));
+		}
+		Benchmark::DoNotOptimize(sum);
+		return sum;
+	}
+
+	void Inner() {
+		PROFILE_SCOPE("Benchmark::Inner");
+		Work(2000);
+	}
+
+	void Outer() {
+		PROFILE_SCOPE("Benchmark::Outer");
+		Work(1000);
+		for (int i = 0; i < 3; ++i) {
+			Inner();
+		}
+	}
+
+	size_t CountOccurrences(const std::string& text, const char* pattern) {
+		size_t count = 0;
+		for (size_t position = text.find(pattern); position != std::string::npos; position = text.find(pattern, position + 1)) {
+			++count;
+		}
+		return count;
+	}
+
+}
+
+BENCHMARK_SUITE(Profiler) {
+#if defined(MT3_DISABLE_PROFILER)
+	std::printf("  PROFILE_SCOPE is compiled out (MT3_DISABLE_PROFILER)\n");
+	return;
+#endif
+	Profiler& profiler = Profiler::Get();
+	Profiler::SetEnabled(true);
+	profiler.Clear();
+
+	const uint32_t outerScope = profiler.RegisterScope("Benchmark::Outer");
+	const uint32_t innerScope = profiler.RegisterScope("Benchmark::Inner");
+	Benchmark::Check("same name registers the same scope", outerScope == profiler.RegisterScope("Benchmark::Outer") ? 0.0 : 1.0, 0.0);
+
+	// 入れ子の区間: 外側は内側3回分を含み、回数はフレームごとに数える
+	const uint32_t frameCount = 64;
+	for (uint32_t frame = 0; frame < frameCount; ++frame) {
+		profiler.BeginFrame();
+		Outer();
+		profiler.EndFrame();
+	}
+	Profiler::ScopeStats outer = profiler.GetStats(outerScope);
+	Profiler::ScopeStats inner = profiler.GetStats(innerScope);
+	Benchmark::Check("call counts per frame", std::fabs(outer.lastCallCount - 1.0) + std::fabs(inner.lastCallCount - 3.0), 0.0);
+	Benchmark::Check("outer scope includes inner scopes", inner.averageMs <= outer.averageMs ? 0.0 : inner.averageMs - outer.averageMs, 0.0);
+	Benchmark::Check("average <= p99 <= max", (outer.averageMs <= outer.maxMs && outer.p99Ms <= outer.maxMs) ? 0.0 : 1.0, 0.0);
+	Benchmark::Check("frame history count", std::fabs(static_cast<double>(profiler.GetFrameCount()) - frameCount), 0.0);
+
+	// 1フレームにつき外側1回・内側3回・フレーム1回のイベントが残る
+	Benchmark::Check("events are recorded", std::fabs(static_cast<double>(profiler.GetEventCount()) - frameCount * 5.0), 0.0);
+
+	// 内側のイベントはすべて外側のイベントの中に収まる
+	double nestingError = 0.0;
+	int64_t outerStart = 0;
+	int64_t outerEnd = 0;
+	for (size_t i = profiler.GetEventCount(); i-- > 0;) {
+		// 内側は外側より先に終わるので、後ろから見て直前の外側と比べる
+		const Profiler::Event& event = profiler.GetEvent(i);
+		if (event.scope == outerScope) {
+			outerStart = event.startNs;
+			outerEnd = event.startNs + event.durationNs;
+		} else if (event.scope == innerScope) {
+			bool inside = outerStart <= event.startNs && event.startNs + event.durationNs <= outerEnd;
+			nestingError = std::max(nestingError, inside ? 0.0 : 1.0);
+		}
+	}
+	Benchmark::Check("inner events nest inside outer events", nestingError, 0.0);
+
+	// Chrome traceに全イベントが書き出されるか
+	const char* tracePath = "profiler_benchmark_trace.json";
+	bool written = profiler.WriteChromeTrace(tracePath);
+	std::string trace;
+	if (FILE* file = std::fopen(tracePath, "rb")) {
+		char buffer[4096];
+		size_t read;
+		while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+			trace.append(buffer, read);
+		}
+		std::fclose(file);
+	}
+	std::remove(tracePath);
+	double traceError = written ? 0.0 : 1.0;
+	traceError += std::fabs(static_cast<double>(CountOccurrences(trace, "\"ph\":\"X\"")) - static_cast<double>(profiler.GetEventCount()));
+	traceError += CountOccurrences(trace, "{") == CountOccurrences(trace, "}") ? 0.0 : 1.0;
+	traceError += trace.rfind("]}\n") == trace.size() - 3 ? 0.0 : 1.0;
+	Benchmark::Check("Chrome trace contains every event", traceError, 0.0);
+
+	// 無効のときは何も記録しない
+	size_t eventsBefore = profiler.GetEventCount();
+	Profiler::SetEnabled(false);
+	Outer();
+	Profiler::SetEnabled(true);
+	Benchmark::Check("disabled scopes record nothing", std::fabs(static_cast<double>(profiler.GetEventCount()) - eventsBefore), 0.0);
+
+	// 区間1つのコスト(空の区間)
+	uint32_t counter = 0;
+	Benchmark::Run("no scope", options, [&](size_t) {
+		Benchmark::DoNotOptimize(++counter);
+		});
+	Profiler::SetEnabled(false);
+	Benchmark::Run("PROFILE_SCOPE (disabled)", options, [&](size_t) {
+		PROFILE_SCOPE("Benchmark::Empty");
+		Benchmark::DoNotOptimize(++counter);
+		});
+	Profiler::SetEnabled(true);
+	Benchmark::Run("PROFILE_SCOPE (enabled)", options, [&](size_t) {
+		PROFILE_SCOPE("Benchmark::Empty");
+		Benchmark::DoNotOptimize(++counter);
+		});
+	Benchmark::Check("event ring buffer is bounded", profiler.GetEventCount() <= Profiler::kMaxEvents ? 0.0 : 1.0, 0.0);
+
+	Benchmark::RunOnce("WriteChromeTrace (full ring buffer)", profiler.GetEventCount(), [&] {
+		profiler.WriteChromeTrace(tracePath);
+		});
+	std::remove(tracePath);
+
+	// 他のスイートの計測と混ざらないように空にしておく
+	profiler.Clear();
+}
@@ -0,0 +1,145 @@
+#include "Benchmark.h"
+#include "MathFunction.h"
+#include "Quaternion.h"
+#include "TransformBatch.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+	double MaxAbsoluteError(const Matrix4x4& expected, const Matrix4x4& actual) {
+		double maxError = 0.0;
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				maxError = std::max(maxError, std::fabs(static_cast<double>(expected.m[row][column]) - actual.m[row][column]));
+			}
+		}
+		return maxError;
+	}
+
+	double MaxAbsoluteError(const Vector3& expected, const Vector3& actual) {
+		return std::max({ std::fabs(static_cast<double>(expected.x) - actual.x), std::fabs(static_cast<double>(expected.y) - actual.y), std::fabs(static_cast<double>(expected.z) - actual.z) });
+	}
+
+	// qと-qは同じ回転なので、向きをそろえて比べる
+	double RotationError(const Quaternion& expected, const Quaternion& actual) {
+		return 1.0 - std::fabs(static_cast<double>(Dot(expected, actual)));
+	}
+
+	Quaternion RandomQuaternion(std::mt19937& engine) {
+		return Normalize({ Benchmark::RandomFloat(engine, -1.0f, 1.0f), Benchmark::RandomFloat(engine, -1.0f, 1.0f), Benchmark::RandomFloat(engine, -1.0f, 1.0f), Benchmark::RandomFloat(engine, -1.0f, 1.0f) });
+	}
+
+}
+
+BENCHMARK_SUITE(Quaternion) {
+	std::mt19937 engine(options.seed);
+	const size_t count = options.inputCount;
+
+	std::vector<Vector3> scales = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, 0.1f, 3.0f); });
+	std::vector<Vector3> rotates = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, -6.28f, 6.28f); });
+	std::vector<Vector3> translates = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, -10.0f, 10.0f); });
+	std::vector<Vector3> points = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, -10.0f, 10.0f); });
+	std::vector<Quaternion> q1 = Benchmark::MakeInputs<Quaternion>(options, [&] { return RandomQuaternion(engine); });
+	std::vector<Quaternion> q2 = Benchmark::MakeInputs<Quaternion>(options, [&] { return RandomQuaternion(engine); });
+	std::vector<float> ts = Benchmark::MakeInputs<float>(options, [&] { return Benchmark::RandomFloat(engine, 0.0f, 1.0f); });
+
+	std::vector<Quaternion> eulerQuaternions(count);
+	for (size_t i = 0; i < count; ++i) {
+		eulerQuaternions[i] = MakeRotateQuaternion(rotates[i]);
+	}
+
+	// オイラー角と同じ回転になるか、積・回転・補間が行列と一致するか
+	double eulerError = 0.0;
+	double rotateError = 0.0;
+	double composeError = 0.0;
+	double inverseError = 0.0;
+	double slerpEndError = 0.0;
+	double slerpLengthError = 0.0;
+	double slerpAngleError = 0.0;
+	double nlerpError = 0.0;
+	for (size_t i = 0; i < count; ++i) {
+		eulerError = std::max(eulerError, MaxAbsoluteError(MakeAffineMatrix(scales[i], rotates[i], translates[i]), MakeAffineMatrix(scales[i], eulerQuaternions[i], translates[i])));
+		rotateError = std::max(rotateError, MaxAbsoluteError(Transform(points[i], MakeRotateMatrix(q1[i])), RotateVector(points[i], q1[i])));
+		composeError = std::max(composeError, MaxAbsoluteError(Multiply(MakeRotateMatrix(q2[i]), MakeRotateMatrix(q1[i])), MakeRotateMatrix(Multiply(q1[i], q2[i]))));
+		inverseError = std::max(inverseError, RotationError(MakeIdentityQuaternion(), Multiply(q1[i], Inverse(q1[i]))));
+
+		slerpEndError = std::max({ slerpEndError, RotationError(q1[i], Slerp(q1[i], q2[i], 0.0f)), RotationError(q2[i], Slerp(q1[i], q2[i], 1.0f)) });
+		Quaternion slerped = Slerp(q1[i], q2[i], ts[i]);
+		slerpLengthError = std::max(slerpLengthError, std::fabs(GetLength(slerped) - 1.0));
+		// 角度がtに比例して進むか(θ(q1, slerp) = t * θ(q1, q2))
+		double total = std::acos(std::min(1.0, std::fabs(static_cast<double>(Dot(q1[i], q2[i])))));
+		double partial = std::acos(std::min(1.0, std::fabs(static_cast<double>(Dot(q1[i], slerped)))));
+		if (total > 0.05) {
+			slerpAngleError = std::max(slerpAngleError, std::fabs(partial - ts[i] * total));
+		}
+		nlerpError = std::max(nlerpError, std::fabs(GetLength(Nlerp(q1[i], q2[i], ts[i])) - 1.0));
+	}
+	Benchmark::Check("MakeRotateQuaternion matches Euler MakeAffineMatrix", eulerError, 1e-4);
+	Benchmark::Check("RotateVector matches Transform by MakeRotateMatrix", rotateError, 1e-4);
+	Benchmark::Check("Multiply(q1, q2) rotates by q2 then q1", composeError, 1e-5);
+	Benchmark::Check("q * Inverse(q) is identity", inverseError, 1e-6);
+	Benchmark::Check("Slerp hits both endpoints", slerpEndError, 1e-6);
+	Benchmark::Check("Slerp stays unit length", slerpLengthError, 1e-5);
+	Benchmark::Check("Slerp has constant angular speed", slerpAngleError, 1e-3);
+	Benchmark::Check("Nlerp stays unit length", nlerpError, 1e-5);
+
+	// 大量のインスタンスの行列作成(オイラー角 / クォータニオン)
+	std::vector<float> soa[10];
+	for (std::vector<float>& values : soa) {
+		values.resize(count);
+	}
+	for (size_t i = 0; i < count; ++i) {
+		soa[0][i] = scales[i].x; soa[1][i] = scales[i].y; soa[2][i] = scales[i].z;
+		soa[3][i] = eulerQuaternions[i].x; soa[4][i] = eulerQuaternions[i].y; soa[5][i] = eulerQuaternions[i].z; soa[6][i] = eulerQuaternions[i].w;
+		soa[7][i] = translates[i].x; soa[8][i] = translates[i].y; soa[9][i] = translates[i].z;
+	}
+	std::vector<float> eulerX(count), eulerY(count), eulerZ(count);
+	for (size_t i = 0; i < count; ++i) {
+		eulerX[i] = rotates[i].x; eulerY[i] = rotates[i].y; eulerZ[i] = rotates[i].z;
+	}
+	QuaternionTransformsSoA quaternionTransforms = { soa[0], soa[1], soa[2], soa[3], soa[4], soa[5], soa[6], soa[7], soa[8], soa[9] };
+	TransformsSoA eulerTransforms = { soa[0], soa[1], soa[2], eulerX, eulerY, eulerZ, soa[7], soa[8], soa[9] };
+	std::vector<Matrix4x4> matrices(count);
+
+	MakeAffineMatrices(quaternionTransforms, matrices);
+	double batchError = 0.0;
+	for (size_t i = 0; i < count; ++i) {
+		batchError = std::max(batchError, MaxAbsoluteError(MakeAffineMatrix(scales[i], eulerQuaternions[i], translates[i]), matrices[i]));
+	}
+	Benchmark::Check("MakeAffineMatrices (quaternion) matches single", batchError, 0.0);
+
+	Benchmark::Run("MakeAffineMatrix (Euler)", options, [&](size_t i) {
+		Benchmark::DoNotOptimize(MakeAffineMatrix(scales[i], rotates[i], translates[i]));
+		});
+	Benchmark::Run("MakeAffineMatrix (Quaternion)", options, [&](size_t i) {
+		Benchmark::DoNotOptimize(MakeAffineMatrix(scales[i], eulerQuaternions[i], translates[i]));
+		});
+	Benchmark::RunBatch("MakeAffineMatrices (Euler SoA batch)", options, count, [&] {
+		MakeAffineMatrices(eulerTransforms, matrices);
+		Benchmark::DoNotOptimize(matrices[0]);
+		});
+	Benchmark::RunBatch("MakeAffineMatrices (Quaternion SoA batch)", options, count, [&] {
+		MakeAffineMatrices(quaternionTransforms, matrices);
+		Benchmark::DoNotOptimize(matrices[0]);
+		});
+
+	// 回転の合成と補間
+	Benchmark::Run("compose: MakeRotateMatrix x2 + Multiply(Matrix4x4)", options, [&](size_t i) {
+		Benchmark::DoNotOptimize(Multiply(MakeRotateMatrix(q1[i]), MakeRotateMatrix(q2[i])));
+		});
+	Benchmark::Run("compose: Multiply(Quaternion)", options, [&](size_t i) {
+		Benchmark::DoNotOptimize(Multiply(q2[i], q1[i]));
+		});
+	Benchmark::Run("Slerp", options, [&](size_t i) { Benchmark::DoNotOptimize(Slerp(q1[i], q2[i], ts[i])); });
+	Benchmark::Run("Nlerp", options, [&](size_t i) { Benchmark::DoNotOptimize(Nlerp(q1[i], q2[i], ts[i])); });
+	Benchmark::Run("Slerp + MakeAffineMatrix (animated instance)", options, [&](size_t i) {
+		Benchmark::DoNotOptimize(MakeAffineMatrix(scales[i], Slerp(q1[i], q2[i], ts[i]), translates[i]));
+		});
+
+	// 点の回転
+	Benchmark::Run("Transform(MakeRotateMatrix(q))", options, [&](size_t i) {
+		Benchmark::DoNotOptimize(Transform(points[i], MakeRotateMatrix(q1[i])));
+		});
+	Benchmark::Run("RotateVector", options, [&](size_t i) { Benchmark::DoNotOptimize(RotateVector(points[i], q1[i])); });
+}
@@ -0,0 +1,443 @@
+#include "Benchmark.h"
+#include "Collision.h"
+#include "MathFunction.h"
+#include "Raycast.h"
+#include "Scene.h"
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+namespace {
+
+	const float kSegmentRadius = 0.1f;
+
+	Ray RandomRay(std::mt19937& engine, float maxDistance) {
+		Vector3 direction;
+		while (!TryNormalize(Benchmark::RandomVector3(engine, -1.0f, 1.0f), direction)) {
+		}
+		return { Benchmark::RandomVector3(engine, -8.0f, 8.0f), direction, maxDistance };
+	}
+
+	// 形状の表面からの符号付き距離(外が正)
+	float SignedDistance(const Scene& scene, Scene::Handle handle, const Vector3& point, float segmentRadius) {
+		Sphere sphere;
+		Segment segment;
+		Plane plane;
+		if (scene.Get(handle, sphere)) {
+			return GetLength(Subtract(point, sphere.center)) - sphere.radius;
+		}
+		if (scene.Get(handle, segment)) {
+			return GetLength(Subtract(point, ClosestPoint(point, segment))) - segmentRadius;
+		}
+		scene.Get(handle, plane);
+		return std::fabs(Dot(plane.normal, point) - plane.distance);
+	}
+
+	// 1つずつIntersectRayを呼んで一番近いものを探す(比較用)
+	bool RaycastBruteForce(const Scene& scene, const Ray& ray, float segmentRadius, float& nearest, Scene::Handle& handle, size_t& hitCount) {
+		nearest = INFINITY;
+		hitCount = 0;
+		auto visit = [&](Scene::Handle candidate, bool hit, float distance) {
+			if (hit) {
+				++hitCount;
+				if (distance < nearest) {
+					nearest = distance;
+					handle = candidate;
+				}
+			}
+			};
+		for (size_t i = 0; i < scene.GetCount(Scene::ShapeType::kSphere); ++i) {
+			Scene::Handle candidate = scene.GetHandle(Scene::ShapeType::kSphere, i);
+			Sphere sphere;
+			scene.Get(candidate, sphere);
+			float distance;
+			bool hit = IntersectRay(ray, sphere, distance);
+			visit(candidate, hit, distance);
+		}
+		for (size_t i = 0; segmentRadius > 0.0f && i < scene.GetCount(Scene::ShapeType::kSegment); ++i) {
+			Scene::Handle candidate = scene.GetHandle(Scene::ShapeType::kSegment, i);
+			Segment segment;
+			scene.Get(candidate, segment);
+			float distance;
+			bool hit = IntersectRay(ray, segment, segmentRadius, distance);
+			visit(candidate, hit, distance);
+		}
+		for (size_t i = 0; i < scene.GetCount(Scene::ShapeType::kPlane); ++i) {
+			Scene::Handle candidate = scene.GetHandle(Scene::ShapeType::kPlane, i);
+			Plane plane;
+			scene.Get(candidate, plane);
+			float distance;
+			bool hit = IntersectRay(ray, plane, distance);
+			visit(candidate, hit, distance);
+		}
+		return nearest != INFINITY;
+	}
+
+	// 始点から当たった位置の手前までを細かくたどって、形状の中に入っていないか
+	// (当たらなかったレイはmaxDistanceまで)
+	bool PassesThroughShape(const Scene& scene, Scene::Handle handle, const Ray& ray, float distance, float segmentRadius) {
+		const int kSamples = 64;
+		for (int k = 0; k < kSamples; ++k) {
+			Vector3 point = Add(ray.origin, Multiply(distance * static_cast<float>(k) / kSamples, ray.direction));
+			if (SignedDistance(scene, handle, point, segmentRadius) < -1.0e-3f) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// RaysSoAの列を持っておく
+	struct RayColumns {
+		std::vector<float> originX;
+		std::vector<float> originY;
+		std::vector<float> originZ;
+		std::vector<float> directionX;
+		std::vector<float> directionY;
+		std::vector<float> directionZ;
+		std::vector<float> maxDistance;
+
+		explicit RayColumns(std::span<const Ray> rays) {
+			for (const Ray& ray : rays) {
+				originX.push_back(ray.origin.x);
+				originY.push_back(ray.origin.y);
+				originZ.push_back(ray.origin.z);
+				directionX.push_back(ray.direction.x);
+				directionY.push_back(ray.direction.y);
+				directionZ.push_back(ray.direction.z);
+				maxDistance.push_back(ray.maxDistance);
+			}
+		}
+
+		RaysSoA Get() const { return { originX, originY, originZ, directionX, directionY, directionZ, maxDistance }; }
+	};
+
+	// 1点から画面の各画素へ向かうレイ(行ごとに並べるので、隣どうしは向きが近い)
+	std::vector<Ray> MakeCameraRays(const Vector3& origin, size_t width, size_t height, float maxDistance) {
+		std::vector<Ray> rays;
+		const float halfHeight = std::tan(0.45f * 0.5f);
+		const float halfWidth = halfHeight * static_cast<float>(width) / static_cast<float>(height);
+		for (size_t y = 0; y < height; ++y) {
+			for (size_t x = 0; x < width; ++x) {
+				Vector3 direction = {
+					(2.0f * (static_cast<float>(x) + 0.5f) / static_cast<float>(width) - 1.0f) * halfWidth,
+					(1.0f - 2.0f * (static_cast<float>(y) + 0.5f) / static_cast<float>(height)) * halfHeight,
+					1.0f,
+				};
+				rays.push_back({ origin, Normalize(direction), maxDistance });
+			}
+		}
+		return rays;
+	}
+
+	// 束で調べた結果とレイ1本ずつ調べた結果が違うレイの数
+	size_t CountBatchMismatches(const Scene& scene, const SceneRaycaster& raycaster, std::span<const Ray> rays, const RaysSoA& packet) {
+		std::vector<RaycastHit> hits(rays.size());
+		std::vector<uint8_t> occluded(rays.size());
+		size_t batchHitCount = RaycastBatch(scene, raycaster, packet, hits);
+		size_t anyHitCount = RaycastAnyBatch(scene, raycaster, packet, occluded);
+		size_t mismatches = 0;
+		size_t singleHitCount = 0;
+		for (size_t i = 0; i < rays.size(); ++i) {
+			RaycastHit hit;
+			bool isHit = Raycast(scene, raycaster, rays[i], hit);
+			singleHitCount += isHit;
+			mismatches += isHit ? (hits[i].distance != hit.distance || hits[i].handle != hit.handle || std::fabs(hits[i].normal.x - hit.normal.x) > 1.0e-6f)
+				: hits[i].distance != INFINITY;
+			mismatches += (occluded[i] != 0) != isHit;
+		}
+		return mismatches + (batchHitCount != singleHitCount) + (anyHitCount != singleHitCount);
+	}
+
+	Scene MakeRaycastScene(std::mt19937& engine, size_t sphereCount, size_t segmentCount, size_t planeCount) {
+		Scene scene;
+		for (size_t i = 0; i < sphereCount; ++i) {
+			scene.Add(Sphere{ Benchmark::RandomVector3(engine, -10.0f, 10.0f), Benchmark::RandomFloat(engine, 0.1f, 1.0f) });
+		}
+		for (size_t i = 0; i < segmentCount; ++i) {
+			Vector3 origin = Benchmark::RandomVector3(engine, -10.0f, 10.0f);
+			scene.Add(Segment{ origin, Add(origin, Benchmark::RandomVector3(engine, -2.0f, 2.0f)) });
+		}
+		for (size_t i = 0; i < planeCount; ++i) {
+			scene.Add(Plane{ Normalize(Benchmark::RandomVector3(engine, -1.0f, 1.0f)), Benchmark::RandomFloat(engine, -20.0f, 20.0f) });
+		}
+		return scene;
+	}
+
+	// 木をたどった問い合わせが1つずつ調べた結果と違うレイの数
+	size_t CountNearestMismatches(const Scene& scene, const SceneRaycaster& raycaster, std::span<const Ray> rays) {
+		size_t mismatches = 0;
+		for (const Ray& ray : rays) {
+			float expected;
+			Scene::Handle expectedHandle;
+			size_t expectedCount;
+			bool expectedHit = RaycastBruteForce(scene, ray, raycaster.GetSegmentRadius(), expected, expectedHandle, expectedCount);
+			RaycastHit hit;
+			bool isHit = Raycast(scene, raycaster, ray, hit);
+			mismatches += isHit != expectedHit || (isHit && (hit.distance != expected || hit.handle != expectedHandle));
+			mismatches += RaycastAny(scene, raycaster, ray) != expectedHit;
+		}
+		return mismatches;
+	}
+
+}
+
+BENCHMARK_SUITE(Raycast) {
+	std::mt19937 engine(options.seed);
+
+	// 1つの形状との交差: 当たった位置は表面上、そこまでの途中は形状の外
+	{
+		Scene shapes = MakeRaycastScene(engine, 64, 64, 64);
+		double surfaceError = 0.0;
+		size_t tunneled = 0;
+		size_t hits = 0;
+		for (int n = 0; n < 2000; ++n) {
+			Ray ray = RandomRay(engine, 30.0f);
+			for (uint32_t type = 0; type < static_cast<uint32_t>(Scene::ShapeType::kCount); ++type) {
+				Scene::ShapeType shapeType = static_cast<Scene::ShapeType>(type);
+				for (size_t i = 0; i < shapes.GetCount(shapeType); ++i) {
+					Scene::Handle handle = shapes.GetHandle(shapeType, i);
+					Sphere sphere;
+					Segment segment;
+					Plane plane;
+					float distance = 0.0f;
+					bool hit = shapes.Get(handle, sphere) ? IntersectRay(ray, sphere, distance)
+						: shapes.Get(handle, segment) ? IntersectRay(ray, segment, kSegmentRadius, distance)
+						: (shapes.Get(handle, plane), IntersectRay(ray, plane, distance));
+					if (hit && distance > 0.0f) {
+						++hits;
+						Vector3 point = Add(ray.origin, Multiply(distance, ray.direction));
+						surfaceError = std::max(surfaceError, static_cast<double>(std::fabs(SignedDistance(shapes, handle, point, kSegmentRadius))));
+					}
+					// 始点が中にあるものは0で当たるので見ない
+					if (SignedDistance(shapes, handle, ray.origin, kSegmentRadius) >= 0.0f) {
+						tunneled += PassesThroughShape(shapes, handle, ray, hit ? distance : ray.maxDistance, kSegmentRadius);
+					}
+				}
+			}
+		}
+		Benchmark::Check("hit points lie on the surface", surfaceError, 1.0e-3);
+		Benchmark::Check("no shape is skipped before the hit", static_cast<double>(tunneled), 0.0);
+		std::printf("  %zu shape hits checked\n", hits);
+	}
+
+	// 決まった値になる場合
+	{
+		Ray inside = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, 10.0f };
+		float distance = -1.0f;
+		Benchmark::Check("origin inside sphere hits at 0", IntersectRay(inside, Sphere{ { 0.5f, 0.0f, 0.0f }, 1.0f }, distance) ? distance : 1.0, 0.0);
+		Ray parallel = { { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, INFINITY };
+		Benchmark::Check("ray parallel to plane misses", IntersectRay(parallel, Plane{ { 0.0f, 1.0f, 0.0f }, 0.0f }, distance) ? 1.0 : 0.0, 0.0);
+		Ray away = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, INFINITY };
+		Benchmark::Check("miss with infinite maxDistance", IntersectRay(away, Sphere{ { -5.0f, 0.0f, 0.0f }, 1.0f }, distance) ? 1.0 : 0.0, 0.0);
+		Ray down = { { 0.0f, 5.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, 10.0f };
+		IntersectRay(down, Segment{ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } }, 0.5f, distance);
+		Benchmark::Check("zero-length capsule is a sphere", std::fabs(distance - 4.5f), 1.0e-6);
+		IntersectRay(down, Segment{ { 0.0f, -3.0f, 0.0f }, { 0.0f, 2.0f, 0.0f } }, 0.5f, distance);
+		Benchmark::Check("ray along capsule axis hits the cap", std::fabs(distance - 2.5f), 1.0e-6);
+
+		Scene single;
+		single.Add(Sphere{ { 0.5f, 0.0f, 0.0f }, 1.0f });
+		single.Add(Segment{ { 0.0f, -1.0f, 3.0f }, { 0.0f, 1.0f, 3.0f } });
+		SceneRaycaster singleRaycaster;
+		singleRaycaster.Update(single, kSegmentRadius);
+		RaycastHit hit;
+		Raycast(single, singleRaycaster, inside, hit);
+		Benchmark::Check("inside normal faces back along the ray", std::fabs(hit.normal.x + 1.0f), 0.0);
+		Ray towardSegment = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, 10.0f };
+		Scene segmentOnly;
+		segmentOnly.Add(Segment{ { 0.0f, -1.0f, 3.0f }, { 0.0f, 1.0f, 3.0f } });
+		SceneRaycaster segmentRaycaster;
+		segmentRaycaster.Update(segmentOnly, 0.0f);
+		Benchmark::Check("segmentRadius 0 ignores segments", RaycastAny(segmentOnly, segmentRaycaster, towardSegment) ? 1.0 : 0.0, 0.0);
+		segmentRaycaster.Update(segmentOnly, 0.25f);
+		Benchmark::Check("segments are hit as capsules", Raycast(segmentOnly, segmentRaycaster, towardSegment, hit) ? std::fabs(hit.distance - 2.75f) : 1.0, 1.0e-6);
+	}
+
+	// シーンへの問い合わせは、1つずつ調べた結果と同じ
+	Scene scene = MakeRaycastScene(engine, 256, 256, 16);
+	SceneRaycaster raycaster;
+	raycaster.Update(scene, kSegmentRadius);
+	const size_t rayCount = 4096;
+	std::vector<Ray> rays(rayCount);
+	for (Ray& ray : rays) {
+		ray = RandomRay(engine, 15.0f);
+	}
+
+	size_t nearestMismatches = 0;
+	size_t anyMismatches = 0;
+	size_t allMismatches = 0;
+	size_t normalErrors = 0;
+	size_t shortMismatches = 0;
+	size_t hitRays = 0;
+	std::vector<RaycastHit> all(1024);
+	RaycastHit nearestFew[4];
+	for (const Ray& ray : rays) {
+		float expected;
+		Scene::Handle expectedHandle;
+		size_t expectedCount;
+		bool expectedHit = RaycastBruteForce(scene, ray, kSegmentRadius, expected, expectedHandle, expectedCount);
+
+		RaycastHit hit;
+		bool isHit = Raycast(scene, raycaster, ray, hit);
+		hitRays += isHit;
+		nearestMismatches += isHit != expectedHit || (isHit && (hit.distance != expected || hit.handle != expectedHandle));
+		anyMismatches += RaycastAny(scene, raycaster, ray) != expectedHit;
+		if (isHit) {
+			float length = GetLength(hit.normal);
+			normalErrors += std::fabs(length - 1.0f) > 1.0e-4f || Dot(hit.normal, ray.direction) > 1.0e-4f;
+		}
+
+		size_t count = RaycastAll(scene, raycaster, ray, all);
+		bool sorted = std::is_sorted(all.begin(), all.begin() + count, [](const RaycastHit& a, const RaycastHit& b) { return a.distance < b.distance; });
+		allMismatches += count != expectedCount || !sorted || (count > 0 && (all[0].distance != expected || all[0].handle != expectedHandle));
+
+		// 小さなバッファには近い方から入る(全部を受け取ったときの先頭と同じ)
+		size_t shortCount = RaycastAll(scene, raycaster, ray, nearestFew);
+		shortMismatches += shortCount != count;
+		for (size_t k = 0; k < std::min(count, std::size(nearestFew)); ++k) {
+			shortMismatches += nearestFew[k].distance != all[k].distance || nearestFew[k].handle != all[k].handle;
+		}
+	}
+	Benchmark::Check("Raycast matches brute force", static_cast<double>(nearestMismatches), 0.0);
+	Benchmark::Check("RaycastAny matches brute force", static_cast<double>(anyMismatches), 0.0);
+	Benchmark::Check("RaycastAll finds every hit, nearest first", static_cast<double>(allMismatches), 0.0);
+	Benchmark::Check("RaycastAll keeps the nearest hits in a short buffer", static_cast<double>(shortMismatches), 0.0);
+	Benchmark::Check("normals are unit and face the ray", static_cast<double>(normalErrors), 0.0);
+	std::printf("  %zu / %zu rays hit\n", hitRays, rayCount);
+
+	// 入りきらないときは近い方から残して、数は全部を返す
+	// (遠い順に追加して、配列の順では先に来る遠い球が残らないことも確かめる)
+	{
+		Ray through = { { -20.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, 40.0f };
+		Scene row;
+		for (int i = 7; i >= 0; --i) {
+			row.Add(Sphere{ { static_cast<float>(i * 2), 0.0f, 0.0f }, 0.5f });
+		}
+		SceneRaycaster rowRaycaster;
+		rowRaycaster.Update(row, 0.0f);
+		RaycastHit few[3];
+		size_t total = RaycastAll(row, rowRaycaster, through, few);
+		Benchmark::Check("RaycastAll reports hits beyond the buffer", static_cast<double>(total) - 8.0, 0.0);
+		double fewError = 0.0;
+		for (size_t k = 0; k < std::size(few); ++k) {
+			fewError = std::max(fewError, static_cast<double>(std::fabs(few[k].distance - (19.5f + 2.0f * static_cast<float>(k)))));
+		}
+		Benchmark::Check("RaycastAll keeps the nearest hits when the buffer is short", fewError, 1.0e-5);
+	}
+
+	// 追加・移動・削除・太さの変更のあとにUpdateすれば、木の問い合わせは1つずつ調べた結果と同じ
+	{
+		Scene changing = MakeRaycastScene(engine, 128, 128, 4);
+		SceneRaycaster changingRaycaster;
+		changingRaycaster.Update(changing, kSegmentRadius);
+		std::vector<Ray> changeRays(512);
+		for (Ray& ray : changeRays) {
+			ray = RandomRay(engine, 15.0f);
+		}
+		size_t changeMismatches = 0;
+		for (int round = 0; round < 8; ++round) {
+			for (int k = 0; k < 16; ++k) {
+				Scene::ShapeType type = k % 2 ? Scene::ShapeType::kSegment : Scene::ShapeType::kSphere;
+				Scene::Handle handle = changing.GetHandle(type, engine() % changing.GetCount(type));
+				Sphere sphere;
+				Segment segment;
+				if (changing.Get(handle, sphere)) {
+					sphere.center = Add(sphere.center, Benchmark::RandomVector3(engine, -2.0f, 2.0f));
+					changing.Set(handle, sphere);
+				} else if (changing.Get(handle, segment)) {
+					segment.origin = Add(segment.origin, Benchmark::RandomVector3(engine, -2.0f, 2.0f));
+					changing.Set(handle, segment);
+				}
+			}
+			for (int k = 0; k < 8; ++k) {
+				Scene::ShapeType type = k % 2 ? Scene::ShapeType::kSegment : Scene::ShapeType::kSphere;
+				changing.Remove(changing.GetHandle(type, engine() % changing.GetCount(type)));
+			}
+			for (int k = 0; k < 6; ++k) {
+				changing.Add(Sphere{ Benchmark::RandomVector3(engine, -10.0f, 10.0f), Benchmark::RandomFloat(engine, 0.1f, 1.0f) });
+				Vector3 origin = Benchmark::RandomVector3(engine, -10.0f, 10.0f);
+				changing.Add(Segment{ origin, Add(origin, Benchmark::RandomVector3(engine, -2.0f, 2.0f)) });
+			}
+			changingRaycaster.Update(changing, round % 4 == 3 ? kSegmentRadius * 2.0f : kSegmentRadius);
+			changeMismatches += CountNearestMismatches(changing, changingRaycaster, changeRays);
+		}
+		Benchmark::Check("SceneRaycaster follows added, moved and removed shapes", static_cast<double>(changeMismatches), 0.0);
+
+		// Updateを呼ばずに形状を消しても、消えた形状の葉は飛ばして残りの形状だけを返す
+		for (int k = 0; k < 64; ++k) {
+			Scene::ShapeType type = k % 2 ? Scene::ShapeType::kSegment : Scene::ShapeType::kSphere;
+			changing.Remove(changing.GetHandle(type, engine() % changing.GetCount(type)));
+		}
+		size_t staleMismatches = CountNearestMismatches(changing, changingRaycaster, changeRays);
+		std::vector<RaycastHit> staleHits(1024);
+		for (const Ray& ray : changeRays) {
+			float expected;
+			Scene::Handle expectedHandle;
+			size_t expectedCount;
+			RaycastBruteForce(changing, ray, changingRaycaster.GetSegmentRadius(), expected, expectedHandle, expectedCount);
+			staleMismatches += RaycastAll(changing, changingRaycaster, ray, staleHits) != expectedCount;
+		}
+		RayColumns staleColumns(changeRays);
+		staleMismatches += CountBatchMismatches(changing, changingRaycaster, changeRays, staleColumns.Get());
+		Benchmark::Check("SceneRaycaster skips removed shapes before Update", static_cast<double>(staleMismatches), 0.0);
+	}
+
+	// レイの束はレイ1本ずつと同じ(端数のレイも含める)
+	// ばらばらの向きのレイと、カメラから扇形に出した向きのそろったレイ(束のAABBで形状を飛ばせる)の両方で比べる
+	std::vector<Ray> incoherent(rays.begin(), rays.end() - 3);
+	std::vector<Ray> coherent = MakeCameraRays({ 0.0f, 0.0f, -15.0f }, 64, 64, 40.0f);
+	RayColumns incoherentColumns(incoherent);
+	RayColumns coherentColumns(coherent);
+	const RaysSoA incoherentPacket = incoherentColumns.Get();
+	const RaysSoA coherentPacket = coherentColumns.Get();
+	size_t batchMismatches = CountBatchMismatches(scene, raycaster, incoherent, incoherentPacket) + CountBatchMismatches(scene, raycaster, coherent, coherentPacket);
+	Benchmark::Check("RaycastBatch/RaycastAnyBatch match Raycast", static_cast<double>(batchMismatches), 0.0);
+
+	// 1秒あたりのレイ数(256球 + 256カプセル + 16平面)
+	auto report = [](double nsPerRay) {
+		std::printf("  %-44s %10.3f Mrays/s\n", "", 1.0e3 / nsPerRay);
+		};
+	const size_t mask = rayCount - 1;
+	Benchmark::Options rayOptions = options;
+	rayOptions.inputCount = rayCount;
+	rayOptions.iterations = std::max<size_t>(options.iterations / 256, rayCount);
+	report(Benchmark::Run("Raycast (nearest)", rayOptions, [&](size_t i) {
+		RaycastHit hit;
+		Benchmark::DoNotOptimize(Raycast(scene, raycaster, rays[i & mask], hit));
+		}));
+	report(Benchmark::Run("RaycastAny", rayOptions, [&](size_t i) {
+		Benchmark::DoNotOptimize(RaycastAny(scene, raycaster, rays[i & mask]));
+		}));
+	report(Benchmark::Run("RaycastAll", rayOptions, [&](size_t i) {
+		Benchmark::DoNotOptimize(RaycastAll(scene, raycaster, rays[i & mask], all));
+		}));
+	report(Benchmark::Run("RaycastBruteForce (IntersectRay per shape)", rayOptions, [&](size_t i) {
+		float nearest;
+		Scene::Handle handle;
+		size_t count;
+		Benchmark::DoNotOptimize(RaycastBruteForce(scene, rays[i & mask], kSegmentRadius, nearest, handle, count));
+		}));
+	Benchmark::Run("SceneRaycaster::Update (nothing moved)", rayOptions, [&](size_t) {
+		raycaster.Update(scene, kSegmentRadius);
+		});
+
+	std::vector<RaycastHit> batchHits(coherent.size());
+	std::vector<uint8_t> occluded(coherent.size());
+	report(Benchmark::RunBatch("RaycastBatch (incoherent packets)", rayOptions, incoherent.size(), [&] {
+		Benchmark::DoNotOptimize(RaycastBatch(scene, raycaster, incoherentPacket, batchHits));
+		}));
+	report(Benchmark::RunBatch("RaycastAnyBatch (incoherent packets)", rayOptions, incoherent.size(), [&] {
+		Benchmark::DoNotOptimize(RaycastAnyBatch(scene, raycaster, incoherentPacket, occluded));
+		}));
+	const size_t coherentMask = coherent.size() - 1;
+	report(Benchmark::Run("Raycast (camera rays, one at a time)", rayOptions, [&](size_t i) {
+		RaycastHit hit;
+		Benchmark::DoNotOptimize(Raycast(scene, raycaster, coherent[i & coherentMask], hit));
+		}));
+	report(Benchmark::RunBatch("RaycastBatch (camera packets)", rayOptions, coherent.size(), [&] {
+		Benchmark::DoNotOptimize(RaycastBatch(scene, raycaster, coherentPacket, batchHits));
+		}));
+	report(Benchmark::RunBatch("RaycastAnyBatch (camera packets)", rayOptions, coherent.size(), [&] {
+		Benchmark::DoNotOptimize(RaycastAnyBatch(scene, raycaster, coherentPacket, occluded));
+		}));
+}
@@ -0,0 +1,152 @@
+#include "Benchmark.h"
+#include "FrameArena.h"
+#include "Replay.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace {
+
+	const ReplaySettings kSettings = { 64, 1, 1.0 / 60.0, 1280.0f, 720.0f };
+
+	// 触っているフレームと放っておくフレームを混ぜた操作(フレーム時間も揺らす)
+	std::vector<ReplayFrame> MakeSession(std::mt19937& engine, size_t frameCount) {
+		std::vector<ReplayFrame> frames(frameCount);
+		ReplayFrame frame = {};
+		frame.direction = { 0.0f, -1.0f, 0.0f };
+		frame.segmentOrigin = { 0.0f, 1.0f, 0.0f };
+		frame.cameraRotate = { 0.26f, 0.0f, 0.0f };
+		frame.cameraTranslate = { 0.0f, 1.9f, -6.49f };
+		std::uniform_int_distribution<int> action(0, 99);
+		for (size_t i = 0; i < frameCount; ++i) {
+			frame.frameSeconds = Benchmark::RandomFloat(engine, 0.012f, 0.022f);
+			frame.reset = false;
+			int roll = action(engine);
+			if (roll < 10) {
+				frame.direction = Benchmark::RandomVector3(engine, -1.0f, 1.0f);
+			} else if (roll < 20) {
+				frame.segmentOrigin = Benchmark::RandomVector3(engine, -2.0f, 2.0f);
+			} else if (roll < 25) {
+				frame.cameraRotate.y += 0.01f;
+			} else if (roll < 27) {
+				frame.keys[4] ^= 0x10;// 押して離す
+			} else if (roll == 27) {
+				frame.paused = !frame.paused;
+			} else if (roll == 28) {
+				frame.reset = true;
+			}
+			frames[i] = frame;
+		}
+		return frames;
+	}
+
+	// WinMainと同じように、記録を通さずに入力を直接流したときのハッシュ
+	uint64_t RunLive(const std::vector<ReplayFrame>& frames) {
+		InteractiveState state;
+		InitializeInteractiveState(state, kSettings);
+		uint64_t hash = 14695981039346656037ull;
+		for (const ReplayFrame& frame : frames) {
+			GetFrameArena().Reset();
+			UpdateInteractiveFrame(state, frame);
+			hash = HashInteractiveFrame(hash, state);
+		}
+		return hash;
+	}
+
+	std::vector<uint8_t> ReadFile(const char* path) {
+		std::vector<uint8_t> bytes;
+		if (FILE* file = std::fopen(path, "rb")) {
+			uint8_t buffer[65536];
+			size_t read;
+			while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+				bytes.insert(bytes.end(), buffer, buffer + read);
+			}
+			std::fclose(file);
+		}
+		return bytes;
+	}
+
+}
+
+BENCHMARK_SUITE(Replay) {
+	// 60fpsで1分ぶん
+	const size_t frameCount = 3600;
+	std::mt19937 engine(options.seed);
+	std::vector<ReplayFrame> frames = MakeSession(engine, frameCount);
+
+	ReplayRecorder recorder;
+	recorder.Begin(kSettings);
+	for (const ReplayFrame& frame : frames) {
+		recorder.Add(frame);
+	}
+	const char* path = "replay_benchmark.mt3r";
+	Benchmark::Check("write replay", recorder.Write(path) ? 0.0 : 1.0, 0.0);
+
+	// 記録から読んだフレームは元のフレームとビット単位で同じ
+	ReplayReader reader;
+	Benchmark::Check("open replay", reader.Open(path) ? 0.0 : 1.0, 0.0);
+	size_t mismatches = 0;
+	ReplayFrame frame;
+	for (size_t i = 0; reader.Next(frame); ++i) {
+		const ReplayFrame& expected = frames[i];
+		mismatches += frame.frameSeconds != expected.frameSeconds || std::memcmp(frame.keys, expected.keys, sizeof(frame.keys)) != 0 ||
+			std::memcmp(&frame.direction, &expected.direction, sizeof(Vector3) * 4) != 0 || frame.paused != expected.paused || frame.reset != expected.reset;
+	}
+	Benchmark::Check("frames round trip", static_cast<double>(mismatches), 0.0);
+	Benchmark::Check("frame count", static_cast<double>(reader.GetFrameCount()) - static_cast<double>(frameCount), 0.0);
+
+	// 再生は直接流したときと同じ結果になり、何度回しても同じ
+	ReplayReport first = RunReplay(reader);
+	ReplayReport second = RunReplay(reader);
+	uint64_t live = RunLive(frames);
+	Benchmark::Check("replay matches live update", first.hash == live ? 0.0 : 1.0, 0.0);
+	Benchmark::Check("replay is deterministic", first.hash == second.hash ? 0.0 : 1.0, 0.0);
+	Benchmark::Check("replay runs every frame", static_cast<double>(first.frameMs.size()) - static_cast<double>(frameCount), 0.0);
+
+	// 1フレームだけ入力を変えると違うハッシュになる
+	std::vector<ReplayFrame> changed = frames;
+	changed[frameCount / 2].direction.x += 0.25f;
+	Benchmark::Check("changed input changes the hash", RunLive(changed) != live ? 0.0 : 1.0, 0.0);
+
+	// ESCを押したフレームで止まる
+	std::vector<ReplayFrame> escaped = frames;
+	escaped[100].keys[0] |= 0x02;// DIK_ESCAPE
+	recorder.Begin(kSettings);
+	for (const ReplayFrame& escapedFrame : escaped) {
+		recorder.Add(escapedFrame);
+	}
+	recorder.Write(path);
+	ReplayReader escapedReader;
+	escapedReader.Open(path);
+	Benchmark::Check("escape stops the replay", static_cast<double>(RunReplay(escapedReader).frameCount) - 101.0, 0.0);
+
+	// 壊れたファイルは開かない
+	std::vector<uint8_t> bytes = ReadFile(path);
+	size_t rejected = 0;
+	rejected += !ReplayReader().OpenMemory(std::span<const uint8_t>(bytes.data(), bytes.size() - 1));
+	std::vector<uint8_t> badMagic = bytes;
+	badMagic[0] = 'X';
+	rejected += !ReplayReader().OpenMemory(badMagic);
+	std::vector<uint8_t> badVersion = bytes;
+	badVersion[4] = static_cast<uint8_t>(kReplayVersion + 1);
+	rejected += !ReplayReader().OpenMemory(badVersion);
+	std::vector<uint8_t> trailing = bytes;
+	trailing.push_back(0);
+	rejected += !ReplayReader().OpenMemory(trailing);
+	rejected += !ReplayReader().Open("replay_benchmark_missing.mt3r");
+	Benchmark::Check("broken or missing files are rejected", 5.0 - static_cast<double>(rejected), 0.0);
+
+	std::printf("  %zu frames, %zu bytes (%.1f bytes/frame)\n", frameCount, bytes.size(), static_cast<double>(bytes.size()) / static_cast<double>(frameCount));
+	std::printf("  frame avg %.4f ms, p50 %.4f ms, p99 %.4f ms, max %.4f ms, hash %016llx\n",
+		first.averageMs, first.p50Ms, first.p99Ms, first.maxMs, static_cast<unsigned long long>(first.hash));
+	Benchmark::RunOnce("RunReplay (per frame)", frameCount, [&] {
+		Benchmark::DoNotOptimize(RunReplay(reader).hash);
+		});
+	Benchmark::RunOnce("ReplayRecorder::Add (per frame)", frameCount, [&] {
+		recorder.Begin(kSettings);
+		for (const ReplayFrame& sessionFrame : frames) {
+			recorder.Add(sessionFrame);
+		}
+		});
+	std::remove(path);
+}
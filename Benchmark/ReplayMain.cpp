@@ -0,0 +1,71 @@
+#include "Profiler.h"
+#include "Replay.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// MT3_2_3.exe --record で残した入力を、窓なしで再生して時間と結果のハッシュを表示する
+// (性能と結果の回帰をLinuxのバッチで確かめる用。--expect-hashと違えば終了コード1)
+
+namespace {
+
+	void PrintUsage(const char* program) {
+		std::printf("usage: %s [--trace file] [--csv file] [--expect-hash HEX] replay.mt3r\n", program);
+	}
+
+}
+
+int main(int argc, char** argv) {
+	const char* path = nullptr;
+	const char* tracePath = nullptr;
+	const char* csvPath = nullptr;
+	const char* expectedHash = nullptr;
+
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+			tracePath = argv[++i];
+		} else if (std::strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+			csvPath = argv[++i];
+		} else if (std::strcmp(argv[i], "--expect-hash") == 0 && i + 1 < argc) {
+			expectedHash = argv[++i];
+		} else if (argv[i][0] == '-' || path) {
+			PrintUsage(argv[0]);
+			return 2;
+		} else {
+			path = argv[i];
+		}
+	}
+	if (!path) {
+		PrintUsage(argv[0]);
+		return 2;
+	}
+
+	ReplayReader reader;
+	if (!reader.Open(path)) {
+		std::printf("cannot open replay \"%s\"\n", path);
+		return 2;
+	}
+
+	ReplayReport report = RunReplay(reader);
+	std::printf("%llu frames, %llu steps in %.3f s (%.0f frames/s), frame avg %.4f ms, p50 %.4f ms, p99 %.4f ms, max %.4f ms, hash %016llx\n",
+		static_cast<unsigned long long>(report.frameCount), static_cast<unsigned long long>(report.stepCount), report.seconds, report.framesPerSecond,
+		report.averageMs, report.p50Ms, report.p99Ms, report.maxMs, static_cast<unsigned long long>(report.hash));
+
+	if (tracePath) {
+		Profiler::Get().WriteChromeTrace(tracePath);
+	}
+	if (csvPath) {
+		if (FILE* file = std::fopen(csvPath, "w")) {
+			std::fprintf(file, "frame,ms\n");
+			for (size_t i = 0; i < report.frameMs.size(); ++i) {
+				std::fprintf(file, "%zu,%.6f\n", i, report.frameMs[i]);
+			}
+			std::fclose(file);
+		}
+	}
+	if (expectedHash && std::strtoull(expectedHash, nullptr, 16) != report.hash) {
+		std::printf("hash mismatch (expected %s)\n", expectedHash);
+		return 1;
+	}
+	return 0;
+}
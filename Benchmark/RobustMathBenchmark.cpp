@@ -0,0 +1,296 @@
+#include "Benchmark.h"
+#include "Collision.h"
+#include "MathFunction.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+	bool IsFinite(const Vector3& v) {
+		return std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z);
+	}
+
+	bool IsFinite(const Matrix4x4& matrix) {
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				if (!std::isfinite(matrix.m[row][column])) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool IsIdentity(const Matrix4x4& matrix) {
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				if (matrix.m[row][column] != (row == column ? 1.0f : 0.0f)) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool IsZero(const Vector3& v) {
+		return v.x == 0.0f && v.y == 0.0f && v.z == 0.0f;
+	}
+
+	// M * M^-1 と単位行列の差(要素の大きさで割った相対値)
+	double GetIdentityError(const Matrix4x4& matrix, const Matrix4x4& inverse) {
+		double error = 0.0;
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				double sum = 0.0;
+				double magnitude = 0.0;
+				for (int k = 0; k < 4; ++k) {
+					double term = static_cast<double>(matrix.m[row][k]) * inverse.m[k][column];
+					sum += term;
+					magnitude += std::fabs(term);
+				}
+				error = std::max(error, std::fabs(sum - (row == column ? 1.0 : 0.0)) / std::max(1.0, magnitude));
+			}
+		}
+		return error;
+	}
+
+	// 退化した成分(0, -0, 非正規化数, 極小, 極大, 無限大, NaN)
+	float DegenerateFloat(std::mt19937& engine) {
+		const float values[] = {
+			0.0f, -0.0f, 1.0e-40f, -1.0e-40f, 1.0e-20f, -1.0e-20f, 1.0e20f, -1.0e30f,
+			std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN(), 1.0f,
+		};
+		return values[engine() % (sizeof(values) / sizeof(values[0]))];
+	}
+
+	Vector3 DegenerateVector3(std::mt19937& engine) {
+		return { DegenerateFloat(engine), DegenerateFloat(engine), DegenerateFloat(engine) };
+	}
+
+	// 階数が落ちた行列(行の重複、0の行、列の重複、拡縮0)
+	Matrix4x4 SingularMatrix(std::mt19937& engine) {
+		Matrix4x4 matrix = Benchmark::RandomMatrix(engine, -2.0f, 2.0f);
+		int row = static_cast<int>(engine() % 4);
+		int other = (row + 1 + static_cast<int>(engine() % 3)) % 4;
+		float scale = Benchmark::RandomFloat(engine, -2.0f, 2.0f);
+		switch (engine() % 4) {
+		case 0:
+			for (int column = 0; column < 4; ++column) {
+				matrix.m[row][column] = scale * matrix.m[other][column];
+			}
+			break;
+		case 1:
+			for (int column = 0; column < 4; ++column) {
+				matrix.m[row][column] = 0.0f;
+			}
+			break;
+		case 2:
+			for (int r = 0; r < 4; ++r) {
+				matrix.m[r][row] = scale * matrix.m[r][other];
+			}
+			break;
+		default:
+			matrix = MakeAffineMatrix({ 0.0f, Benchmark::RandomFloat(engine, 0.1f, 2.0f), 1.0f }, Benchmark::RandomVector3(engine, -3.0f, 3.0f), Benchmark::RandomVector3(engine, -5.0f, 5.0f));
+			break;
+		}
+		return matrix;
+	}
+
+}
+
+BENCHMARK_SUITE(RobustMath) {
+	std::mt19937 engine(options.seed);
+	const size_t fuzzCount = 1u << 16;
+
+	// TryNormalize: 普通の入力は単位長で向きが変わらず、退化した入力は(0,0,0)とfalseになる
+	double normalizeError = 0.0;
+	size_t normalizeRejected = 0;
+	size_t degenerateNotFinite = 0;
+	size_t degenerateWrongFallback = 0;
+	for (size_t i = 0; i < fuzzCount; ++i) {
+		Vector3 v = Multiply(std::pow(10.0f, Benchmark::RandomFloat(engine, -12.0f, 12.0f)), Benchmark::RandomVector3(engine, -1.0f, 1.0f));
+		Vector3 normalized;
+		if (TryNormalize(v, normalized)) {
+			double length = std::sqrt(static_cast<double>(v.x) * v.x + static_cast<double>(v.y) * v.y + static_cast<double>(v.z) * v.z);
+			double cosine = (static_cast<double>(v.x) * normalized.x + static_cast<double>(v.y) * normalized.y + static_cast<double>(v.z) * normalized.z) / length;
+			normalizeError = std::max({ normalizeError, std::fabs(GetLength(normalized) - 1.0), std::fabs(cosine - 1.0) });
+		} else {
+			++normalizeRejected;
+		}
+
+		Vector3 degenerate = DegenerateVector3(engine);
+		bool valid = TryNormalize(degenerate, normalized);
+		degenerateNotFinite += !IsFinite(normalized);
+		degenerateWrongFallback += !valid && !IsZero(normalized);
+	}
+	Benchmark::Check("TryNormalize returns unit vectors", normalizeError, 1e-6);
+	Benchmark::Check("TryNormalize accepts 1e-12..1e12 inputs", static_cast<double>(normalizeRejected), 0.0);
+	Benchmark::Check("TryNormalize is finite on degenerate inputs", static_cast<double>(degenerateNotFinite), 0.0);
+	Benchmark::Check("TryNormalize failure returns zero", static_cast<double>(degenerateWrongFallback), 0.0);
+
+	// TryInverse: 正則なら逆行列(Inverseと同じ値)、特異なら単位行列とfalse、全体を拡縮しても判定は同じ
+	double inverseError = 0.0;
+	double inverseMismatch = 0.0;
+	size_t invertibleRejected = 0;
+	size_t singularAccepted = 0;
+	size_t scaleDependent = 0;
+	size_t inverseNotFinite = 0;
+	size_t inverseWrongFallback = 0;
+	for (size_t i = 0; i < fuzzCount; ++i) {
+		Matrix4x4 affine = MakeAffineMatrix(Benchmark::RandomVector3(engine, 0.1f, 3.0f), Benchmark::RandomVector3(engine, -3.0f, 3.0f), Benchmark::RandomVector3(engine, -10.0f, 10.0f));
+		Matrix4x4 inverse;
+		if (TryInverse(affine, inverse)) {
+			inverseError = std::max(inverseError, GetIdentityError(affine, inverse));
+			Matrix4x4 expected = Inverse(affine);
+			for (int row = 0; row < 4; ++row) {
+				for (int column = 0; column < 4; ++column) {
+					inverseMismatch = std::max(inverseMismatch, std::fabs(static_cast<double>(expected.m[row][column]) - inverse.m[row][column]));
+				}
+			}
+		} else {
+			++invertibleRejected;
+		}
+
+		Matrix4x4 singular = SingularMatrix(engine);
+		bool valid = TryInverse(singular, inverse);
+		singularAccepted += valid;
+		inverseWrongFallback += !valid && !IsIdentity(inverse);
+
+		// 同じ行列を拡縮しても結果(成功・失敗)は変わらない
+		Matrix4x4 random = Benchmark::RandomMatrix(engine, -2.0f, 2.0f);
+		Matrix4x4 scaled = random;
+		float factor = std::pow(10.0f, Benchmark::RandomFloat(engine, -8.0f, 8.0f));
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				scaled.m[row][column] *= factor;
+			}
+		}
+		Matrix4x4 scaledInverse;
+		scaleDependent += TryInverse(random, inverse) != TryInverse(scaled, scaledInverse);
+		inverseNotFinite += !IsFinite(inverse) || !IsFinite(scaledInverse);
+
+		Matrix4x4 degenerate;
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				degenerate.m[row][column] = (engine() % 4 == 0) ? DegenerateFloat(engine) : Benchmark::RandomFloat(engine, -2.0f, 2.0f);
+			}
+		}
+		valid = TryInverse(degenerate, inverse);
+		inverseNotFinite += !IsFinite(inverse);
+		inverseWrongFallback += !valid && !IsIdentity(inverse);
+	}
+	// 平行移動が大きいだけの剛体変換は正則(行列式は1)
+	size_t farRigidRejected = 0;
+	double farRigidError = 0.0;
+	for (size_t i = 0; i < 256; ++i) {
+		Vector3 translate = Benchmark::RandomVector3(engine, -1.0e6f, 1.0e6f);
+		Matrix4x4 rigid = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, Benchmark::RandomVector3(engine, -3.0f, 3.0f), translate);
+		Matrix4x4 inverse;
+		if (TryInverse(rigid, inverse)) {
+			// 平行移動ぶんの桁落ちがあるので、相手の大きさで割って比べる
+			Matrix4x4 expected = InverseRigid(rigid);
+			for (int row = 0; row < 4; ++row) {
+				for (int column = 0; column < 4; ++column) {
+					double scale = row == 3 ? std::max(1.0, static_cast<double>(GetLength(translate))) : 1.0;
+					farRigidError = std::max(farRigidError, std::fabs(static_cast<double>(expected.m[row][column]) - inverse.m[row][column]) / scale);
+				}
+			}
+		} else {
+			++farRigidRejected;
+		}
+	}
+	Benchmark::Check("TryInverse accepts rigid transforms translated by 1e6", static_cast<double>(farRigidRejected), 0.0);
+	Benchmark::Check("TryInverse of a far rigid transform ~= InverseRigid", farRigidError, 1e-4);
+	Benchmark::Check("TryInverse inverts affine matrices", inverseError, 1e-4);
+	Benchmark::Check("TryInverse matches Inverse when invertible", inverseMismatch, 0.0);
+	Benchmark::Check("TryInverse accepts every affine matrix", static_cast<double>(invertibleRejected), 0.0);
+	Benchmark::Check("TryInverse rejects singular matrices", static_cast<double>(singularAccepted), 0.0);
+	Benchmark::Check("TryInverse failure returns identity", static_cast<double>(inverseWrongFallback), 0.0);
+	Benchmark::Check("TryInverse is independent of uniform scale", static_cast<double>(scaleDependent), 0.0);
+	Benchmark::Check("TryInverse is always finite", static_cast<double>(inverseNotFinite), 0.0);
+
+	// TryTransform: wが0の点(カメラの面上)でも有限で、割れるときはTransformと同じ
+	// 透視投影のwはカメラ空間のz
+	Matrix4x4 projection = MakePerspectiveFovMatrix(0.45f, 1280.0f / 720.0f, 0.1f, 100.0f);
+	double transformError = 0.0;
+	size_t transformNotFinite = 0;
+	size_t transformWrongFallback = 0;
+	for (size_t i = 0; i < fuzzCount; ++i) {
+		Vector3 point = Benchmark::RandomVector3(engine, -10.0f, 10.0f);
+		// 半分はwが0(カメラと同じ奥行き)か、非正規化数になる点
+		if (i % 2 == 0) {
+			point.z = (i % 4 == 0) ? 0.0f : 1.0e-40f;
+		}
+		Vector3 result;
+		bool valid = TryTransform(point, projection, result);
+		transformNotFinite += !IsFinite(result);
+		transformWrongFallback += !valid && !IsZero(result);
+		if (valid && std::fabs(Dot(point, point)) > 0.0f) {
+			Vector3 expected = TransformScalar(point, projection);
+			if (IsFinite(expected)) {
+				transformError = std::max(transformError, static_cast<double>(GetLength(Subtract(expected, result))) / std::max(1.0f, GetLength(expected)));
+			}
+		}
+	}
+	Benchmark::Check("TryTransform matches Transform", transformError, 1e-5);
+	Benchmark::Check("TryTransform is finite when w is 0", static_cast<double>(transformNotFinite), 0.0);
+	Benchmark::Check("TryTransform failure returns zero", static_cast<double>(transformWrongFallback), 0.0);
+
+	// ClosestPoint: diffは終点。線分を細かく区切った総当たりより遠くならず、線分の外に出ない
+	double closestError = 0.0;
+	double outsideSegment = 0.0;
+	size_t degenerateSegmentErrors = 0;
+	for (size_t i = 0; i < 4096; ++i) {
+		Segment segment = { Benchmark::RandomVector3(engine, -5.0f, 5.0f), Benchmark::RandomVector3(engine, -5.0f, 5.0f) };
+		Vector3 point = Benchmark::RandomVector3(engine, -8.0f, 8.0f);
+		Vector3 closest = ClosestPoint(point, segment);
+
+		double bruteForce = INFINITY;
+		const int kSamples = 4096;
+		for (int sample = 0; sample <= kSamples; ++sample) {
+			float t = static_cast<float>(sample) / kSamples;
+			Vector3 onSegment = Add(segment.origin, Multiply(t, Subtract(segment.diff, segment.origin)));
+			bruteForce = std::min(bruteForce, static_cast<double>(GetLength(Subtract(point, onSegment))));
+		}
+		closestError = std::max(closestError, GetLength(Subtract(point, closest)) - bruteForce);
+
+		// 始点からの距離+終点からの距離が線分の長さと等しい(線分上にある)
+		double along = GetLength(Subtract(closest, segment.origin)) + GetLength(Subtract(segment.diff, closest));
+		outsideSegment = std::max(outsideSegment, along - GetLength(Subtract(segment.diff, segment.origin)));
+
+		Segment degenerate = { segment.origin, segment.origin };
+		Vector3 degenerateClosest = ClosestPoint(point, degenerate);
+		degenerateSegmentErrors += !IsFinite(degenerateClosest) || GetLength(Subtract(degenerateClosest, segment.origin)) != 0.0f;
+	}
+	Benchmark::Check("ClosestPoint is the nearest point on the segment", closestError, 1e-5);
+	Benchmark::Check("ClosestPoint stays on the segment", outsideSegment, 1e-5);
+	Benchmark::Check("ClosestPoint on zero-length segment is origin", static_cast<double>(degenerateSegmentErrors), 0.0);
+
+	// 通常版との速さの比較
+	std::vector<Vector3> vectors = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, -10.0f, 10.0f); });
+	std::vector<Matrix4x4> matrices = Benchmark::MakeInputs<Matrix4x4>(options, [&] { return Benchmark::RandomMatrix(engine, -2.0f, 2.0f); });
+	std::vector<Segment> segments = Benchmark::MakeInputs<Segment>(options, [&] {
+		return Segment{ Benchmark::RandomVector3(engine, -5.0f, 5.0f), Benchmark::RandomVector3(engine, -5.0f, 5.0f) };
+		});
+
+	Benchmark::Run("Normalize", options, [&](size_t i) { Benchmark::DoNotOptimize(Normalize(vectors[i])); });
+	Benchmark::Run("TryNormalize", options, [&](size_t i) {
+		Vector3 normalized;
+		Benchmark::DoNotOptimize(TryNormalize(vectors[i], normalized));
+		Benchmark::DoNotOptimize(normalized);
+		});
+	Benchmark::Run("Inverse", options, [&](size_t i) { Benchmark::DoNotOptimize(Inverse(matrices[i])); });
+	Benchmark::Run("TryInverse", options, [&](size_t i) {
+		Matrix4x4 inverse;
+		Benchmark::DoNotOptimize(TryInverse(matrices[i], inverse));
+		Benchmark::DoNotOptimize(inverse);
+		});
+	Benchmark::Run("Transform", options, [&](size_t i) { Benchmark::DoNotOptimize(Transform(vectors[i], projection)); });
+	Benchmark::Run("TryTransform", options, [&](size_t i) {
+		Vector3 result;
+		Benchmark::DoNotOptimize(TryTransform(vectors[i], projection, result));
+		Benchmark::DoNotOptimize(result);
+		});
+	Benchmark::Run("ClosestPoint (clamped)", options, [&](size_t i) { Benchmark::DoNotOptimize(ClosestPoint(vectors[i], segments[i])); });
+}
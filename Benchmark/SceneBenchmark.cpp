@@ -0,0 +1,142 @@
+#include "Benchmark.h"
+#include "Collision.h"
+#include "CollisionBatch.h"
+#include "MathFunction.h"
+#include "Scene.h"
+#include <algorithm>
+#include <cmath>
+
+BENCHMARK_SUITE(Scene) {
+	std::mt19937 engine(options.seed);
+	auto randomSphere = [&] { return Sphere{ Benchmark::RandomVector3(engine, -5.0f, 5.0f), Benchmark::RandomFloat(engine, 0.1f, 1.0f) }; };
+	auto randomSegment = [&] {
+		Vector3 origin = Benchmark::RandomVector3(engine, -5.0f, 5.0f);
+		return Segment{ origin, Add(origin, Benchmark::RandomVector3(engine, -3.0f, 3.0f)) };
+		};
+	auto randomPlane = [&] { return Plane{ Normalize(Benchmark::RandomVector3(engine, -1.0f, 1.0f)), Benchmark::RandomFloat(engine, -3.0f, 3.0f) }; };
+
+	// 追加・削除を混ぜて、ハンドルで引いた値が手元の記録と一致し続けるか
+	Scene scene;
+	std::vector<std::pair<Scene::Handle, Sphere>> live;
+	std::vector<Scene::Handle> removed;
+	std::uniform_int_distribution<int> operation(0, 2);
+	for (int step = 0; step < 20000; ++step) {
+		if (live.empty() || operation(engine) != 0) {
+			Sphere sphere = randomSphere();
+			live.push_back({ scene.Add(sphere), sphere });
+		} else {
+			size_t index = std::uniform_int_distribution<size_t>(0, live.size() - 1)(engine);
+			scene.Remove(live[index].first);
+			removed.push_back(live[index].first);
+			live[index] = live.back();
+			live.pop_back();
+		}
+	}
+
+	size_t valueMismatches = 0;
+	size_t indexMismatches = 0;
+	for (const std::pair<Scene::Handle, Sphere>& entry : live) {
+		Sphere sphere;
+		valueMismatches += !scene.Get(entry.first, sphere) || sphere.center.x != entry.second.center.x || sphere.center.y != entry.second.center.y ||
+			sphere.center.z != entry.second.center.z || sphere.radius != entry.second.radius;
+		indexMismatches += scene.GetHandle(Scene::ShapeType::kSphere, scene.GetIndex(entry.first)) != entry.first;
+	}
+	size_t staleAccepted = 0;
+	for (const Scene::Handle& handle : removed) {
+		Sphere sphere;
+		staleAccepted += scene.IsValid(handle) || scene.Get(handle, sphere) || scene.Remove(handle);
+	}
+	Benchmark::Check("count matches after random add/remove", static_cast<double>(scene.GetCount(Scene::ShapeType::kSphere)) - static_cast<double>(live.size()), 0.0);
+	Benchmark::Check("handles still reach their shapes", static_cast<double>(valueMismatches), 0.0);
+	Benchmark::Check("handle <-> index round trip", static_cast<double>(indexMismatches), 0.0);
+	Benchmark::Check("removed handles are rejected", static_cast<double>(staleAccepted), 0.0);
+
+	// 種類の違うハンドルでは読めない
+	Segment segment;
+	Benchmark::Check("type mismatch is rejected", scene.Get(live.front().first, segment) ? 1.0 : 0.0, 0.0);
+
+	Scene::Handle before = live.front().first;
+	scene.Clear();
+	Benchmark::Check("Clear invalidates every handle", scene.IsValid(before) || scene.GetCount(Scene::ShapeType::kSphere) != 0 ? 1.0 : 0.0, 0.0);
+
+	// 線分×平面をシーンの列のまま一括判定して、1組ずつの判定と比べる
+	const size_t segmentCount = 4096;
+	const size_t planeCount = 16;
+	Scene world;
+	world.Reserve(Scene::ShapeType::kSegment, segmentCount);
+	std::vector<Scene::Handle> segmentHandles;
+	for (size_t i = 0; i < segmentCount + 512; ++i) {
+		segmentHandles.push_back(world.Add(randomSegment()));
+	}
+	// 途中を削除して並びを入れ替えておく
+	for (size_t i = 0; i < 512; ++i) {
+		world.Remove(segmentHandles[i * 7]);
+	}
+	for (size_t j = 0; j < planeCount; ++j) {
+		world.Add(randomPlane());
+	}
+
+	std::vector<uint8_t> hit(segmentCount * planeCount);
+	IsCollisionBatch(world.GetSegments(), world.GetPlanes(), { hit, {} });
+	size_t batchMismatches = 0;
+	for (size_t j = 0; j < planeCount; ++j) {
+		Plane plane;
+		world.Get(world.GetHandle(Scene::ShapeType::kPlane, j), plane);
+		for (size_t i = 0; i < segmentCount; ++i) {
+			Segment sceneSegment;
+			world.Get(world.GetHandle(Scene::ShapeType::kSegment, i), sceneSegment);
+			batchMismatches += IsCollision(sceneSegment, plane) != (hit[j * segmentCount + i] != 0);
+		}
+	}
+	Benchmark::Check("batch over scene columns matches IsCollision", static_cast<double>(batchMismatches), 0.0);
+
+	// 列を書き換えると、ハンドルからも同じ値が見える
+	SegmentColumns columns = world.GetSegmentColumns();
+	for (size_t i = 0; i < segmentCount; ++i) {
+		columns.originY[i] += 1.0f;
+	}
+	Segment moved;
+	world.Get(world.GetHandle(Scene::ShapeType::kSegment, 0), moved);
+	Benchmark::Check("column writes are visible through handles", std::fabs(moved.origin.y - columns.originY[0]), 0.0);
+
+	// 追加と削除の往復(定常状態では配列を伸ばさない)
+	Scene churn;
+	churn.Reserve(Scene::ShapeType::kSphere, 1024);
+	std::vector<Scene::Handle> churnHandles(1024);
+	for (Scene::Handle& handle : churnHandles) {
+		handle = churn.Add(randomSphere());
+	}
+	std::vector<Sphere> inputs = Benchmark::MakeInputs<Sphere>(options, randomSphere);
+	const size_t mask = options.inputCount - 1;
+	Benchmark::Run("Remove + Add (swap-and-pop)", options, [&](size_t i) {
+		Scene::Handle& handle = churnHandles[i & 1023];
+		churn.Remove(handle);
+		handle = churn.Add(inputs[i & mask]);
+		});
+	Benchmark::Run("Get through handle", options, [&](size_t i) {
+		Sphere sphere;
+		churn.Get(churnHandles[i & 1023], sphere);
+		Benchmark::DoNotOptimize(sphere);
+		});
+
+	Benchmark::RunBatch("IsCollisionBatch on scene columns", options, segmentCount * planeCount, [&] {
+		Benchmark::DoNotOptimize(IsCollisionBatch(world.GetSegments(), world.GetPlanes(), { hit, {} }));
+		});
+	std::vector<Segment> segmentsAoS(segmentCount);
+	std::vector<Plane> planesAoS(planeCount);
+	for (size_t i = 0; i < segmentCount; ++i) {
+		world.Get(world.GetHandle(Scene::ShapeType::kSegment, i), segmentsAoS[i]);
+	}
+	for (size_t j = 0; j < planeCount; ++j) {
+		world.Get(world.GetHandle(Scene::ShapeType::kPlane, j), planesAoS[j]);
+	}
+	Benchmark::RunBatch("IsCollision per pair (AoS)", options, segmentCount * planeCount, [&] {
+		size_t hits = 0;
+		for (const Plane& plane : planesAoS) {
+			for (const Segment& s : segmentsAoS) {
+				hits += IsCollision(s, plane);
+			}
+		}
+		Benchmark::DoNotOptimize(hits);
+		});
+}
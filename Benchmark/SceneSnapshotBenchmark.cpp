@@ -0,0 +1,173 @@
+#include "Benchmark.h"
+#include "MathFunction.h"
+#include "Scene.h"
+#include "SceneSnapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace {
+
+	std::string ReadFile(const char* path) {
+		std::string text;
+		if (FILE* file = std::fopen(path, "rb")) {
+			char buffer[65536];
+			size_t read;
+			while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+				text.append(buffer, read);
+			}
+			std::fclose(file);
+		}
+		return text;
+	}
+
+	bool WriteFile(const char* path, const std::string& bytes) {
+		FILE* file = std::fopen(path, "wb");
+		if (!file) {
+			return false;
+		}
+		bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+		return std::fclose(file) == 0 && written;
+	}
+
+	// 2つの列がビット単位で同じか
+	size_t CountDifferences(std::span<const float> a, std::span<const float> b) {
+		if (a.size() != b.size()) {
+			return a.size() + b.size();
+		}
+		size_t differences = 0;
+		for (size_t i = 0; i < a.size(); ++i) {
+			differences += std::memcmp(&a[i], &b[i], sizeof(float)) != 0;
+		}
+		return differences;
+	}
+
+}
+
+BENCHMARK_SUITE(SceneSnapshot) {
+	// 回帰テスト用の10万形状のシーン
+	const size_t sphereCount = 40000;
+	const size_t segmentCount = 50000;
+	const size_t planeCount = 10000;
+	std::mt19937 engine(options.seed);
+	Scene scene;
+	scene.Reserve(Scene::ShapeType::kSphere, sphereCount);
+	scene.Reserve(Scene::ShapeType::kSegment, segmentCount);
+	scene.Reserve(Scene::ShapeType::kPlane, planeCount);
+	for (size_t i = 0; i < sphereCount; ++i) {
+		scene.Add(Sphere{ Benchmark::RandomVector3(engine, -50.0f, 50.0f), Benchmark::RandomFloat(engine, 0.1f, 2.0f) });
+	}
+	for (size_t i = 0; i < segmentCount; ++i) {
+		Vector3 origin = Benchmark::RandomVector3(engine, -50.0f, 50.0f);
+		scene.Add(Segment{ origin, Add(origin, Benchmark::RandomVector3(engine, -3.0f, 3.0f)) });
+	}
+	for (size_t i = 0; i < planeCount; ++i) {
+		scene.Add(Plane{ Normalize(Benchmark::RandomVector3(engine, -1.0f, 1.0f)), Benchmark::RandomFloat(engine, -50.0f, 50.0f) });
+	}
+	const SceneCamera camera = { { 0.26f, 0.0f, 0.0f }, { 0.0f, 1.9f, -6.49f } };
+
+	const char* path = "scene_snapshot_benchmark.mt3";
+	const char* textPath = "scene_snapshot_benchmark.txt";
+	const char* copiedPath = "scene_snapshot_benchmark_copied.mt3";
+	const char* copiedTextPath = "scene_snapshot_benchmark_copied.txt";
+	const char* brokenPath = "scene_snapshot_benchmark_broken.mt3";
+	Benchmark::Check("write snapshot", WriteSceneSnapshot(path, scene, camera) ? 0.0 : 1.0, 0.0);
+
+	// 開いた列がシーンの列とビット単位で同じで、ファイルの中を直接指している
+	SceneSnapshot snapshot;
+	Benchmark::Check("open snapshot", snapshot.Open(path) ? 0.0 : 1.0, 0.0);
+	SpheresSoA spheres = snapshot.GetSpheres();
+	SegmentsSoA segments = snapshot.GetSegments();
+	PlanesSoA planes = snapshot.GetPlanes();
+	SpheresSoA expectedSpheres = scene.GetSpheres();
+	SegmentsSoA expectedSegments = scene.GetSegments();
+	PlanesSoA expectedPlanes = scene.GetPlanes();
+	size_t differences = CountDifferences(spheres.centerX, expectedSpheres.centerX) + CountDifferences(spheres.centerY, expectedSpheres.centerY) +
+		CountDifferences(spheres.centerZ, expectedSpheres.centerZ) + CountDifferences(spheres.radius, expectedSpheres.radius) +
+		CountDifferences(segments.originX, expectedSegments.originX) + CountDifferences(segments.originY, expectedSegments.originY) +
+		CountDifferences(segments.originZ, expectedSegments.originZ) + CountDifferences(segments.endX, expectedSegments.endX) +
+		CountDifferences(segments.endY, expectedSegments.endY) + CountDifferences(segments.endZ, expectedSegments.endZ) +
+		CountDifferences(planes.normalX, expectedPlanes.normalX) + CountDifferences(planes.normalY, expectedPlanes.normalY) +
+		CountDifferences(planes.normalZ, expectedPlanes.normalZ) + CountDifferences(planes.distance, expectedPlanes.distance);
+	Benchmark::Check("columns round trip bit-exactly", static_cast<double>(differences), 0.0);
+	Benchmark::Check("camera round trip", std::memcmp(&snapshot.GetCamera(), &camera, sizeof(camera)) == 0 ? 0.0 : 1.0, 0.0);
+	Benchmark::Check("columns are 64-byte aligned", reinterpret_cast<uintptr_t>(segments.endZ.data()) % 64 == 0 ? 0.0 : 1.0, 0.0);
+
+	// Sceneへコピーしても同じ
+	Scene copied;
+	snapshot.CopyTo(copied);
+	Segment original;
+	Segment loaded;
+	scene.Get(scene.GetHandle(Scene::ShapeType::kSegment, segmentCount - 1), original);
+	copied.Get(copied.GetHandle(Scene::ShapeType::kSegment, segmentCount - 1), loaded);
+	Benchmark::Check("CopyTo rebuilds the scene",
+		(copied.GetCount(Scene::ShapeType::kPlane) == planeCount && std::memcmp(&original, &loaded, sizeof(Segment)) == 0) ? 0.0 : 1.0, 0.0);
+
+	// テキスト版は1形状1行で、同じシーンなら同じ内容
+	Benchmark::Check("write text", snapshot.WriteText(textPath) ? 0.0 : 1.0, 0.0);
+	std::string text = ReadFile(textPath);
+	size_t lineCount = 0;
+	for (char c : text) {
+		lineCount += c == '\n';
+	}
+	Benchmark::Check("text has one line per primitive", static_cast<double>(lineCount) - static_cast<double>(sphereCount + segmentCount + planeCount + 5), 0.0);
+	SceneSnapshot copiedSnapshot;
+	WriteSceneSnapshot(copiedPath, copied, camera);
+	copiedSnapshot.Open(copiedPath);
+	copiedSnapshot.WriteText(copiedTextPath);
+	Benchmark::Check("text export is deterministic", ReadFile(copiedTextPath) == text ? 0.0 : 1.0, 0.0);
+	copiedSnapshot.Close();
+
+	// 壊れたファイルは開かない
+	std::string bytes = ReadFile(path);
+	size_t rejected = 0;
+	std::string badMagic = bytes;
+	badMagic[0] = 'X';
+	WriteFile(brokenPath, badMagic);
+	rejected += !SceneSnapshot().Open(brokenPath);
+	std::string badVersion = bytes;
+	badVersion[4] = static_cast<char>(kSceneSnapshotVersion + 1);
+	WriteFile(brokenPath, badVersion);
+	rejected += !SceneSnapshot().Open(brokenPath);
+	WriteFile(brokenPath, bytes.substr(0, bytes.size() - 4));
+	rejected += !SceneSnapshot().Open(brokenPath);
+	WriteFile(brokenPath, bytes.substr(0, 16));
+	rejected += !SceneSnapshot().Open(brokenPath);
+	rejected += !SceneSnapshot().Open("scene_snapshot_benchmark_missing.mt3");
+	Benchmark::Check("broken or missing files are rejected", 5.0 - static_cast<double>(rejected), 0.0);
+
+	// 開いたままのファイルは上書きしない(割り当てた範囲が縮むとアクセスでSIGBUSになる)
+	std::printf("  %zu primitives, %zu bytes\n", sphereCount + segmentCount + planeCount, bytes.size());
+	Benchmark::RunOnce("WriteSceneSnapshot", sphereCount + segmentCount + planeCount, [&] {
+		WriteSceneSnapshot(copiedPath, scene, camera);
+		});
+	Benchmark::RunOnce("SceneSnapshot::Open (mmap)", sphereCount + segmentCount + planeCount, [&] {
+		snapshot.Open(path);
+		});
+	Benchmark::RunOnce("Open + touch every column", sphereCount + segmentCount + planeCount, [&] {
+		snapshot.Open(path);
+		float sum = 0.0f;
+		for (float value : snapshot.GetSegments().endZ) {
+			sum += value;
+		}
+		for (float value : snapshot.GetSpheres().radius) {
+			sum += value;
+		}
+		Benchmark::DoNotOptimize(sum);
+		});
+	Benchmark::RunOnce("SceneSnapshot::CopyTo (Scene)", sphereCount + segmentCount + planeCount, [&] {
+		Scene target;
+		snapshot.CopyTo(target);
+		Benchmark::DoNotOptimize(target.GetCount(Scene::ShapeType::kSphere));
+		});
+	Benchmark::RunOnce("SceneSnapshot::WriteText", sphereCount + segmentCount + planeCount, [&] {
+		snapshot.WriteText(textPath);
+		});
+
+	snapshot.Close();
+	std::remove(path);
+	std::remove(textPath);
+	std::remove(copiedPath);
+	std::remove(copiedTextPath);
+	std::remove(brokenPath);
+}
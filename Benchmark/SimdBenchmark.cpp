@@ -0,0 +1,84 @@
+#include "Benchmark.h"
+#include "MathFunction.h"
+#include "MathFunctionSimd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+	// 要素ごとの相対誤差の最大値
+	double MaxRelativeError(const Matrix4x4& expected, const Matrix4x4& actual) {
+		double maxError = 0.0;
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				double scale = std::max(1.0, std::fabs(static_cast<double>(expected.m[row][column])));
+				double error = std::fabs(static_cast<double>(expected.m[row][column]) - actual.m[row][column]) / scale;
+				maxError = std::max(maxError, error);
+			}
+		}
+		return maxError;
+	}
+
+	double MaxRelativeError(const Vector3& expected, const Vector3& actual) {
+		const float* e = &expected.x;
+		const float* a = &actual.x;
+		double maxError = 0.0;
+		for (int i = 0; i < 3; ++i) {
+			double scale = std::max(1.0, std::fabs(static_cast<double>(e[i])));
+			maxError = std::max(maxError, std::fabs(static_cast<double>(e[i]) - a[i]) / scale);
+		}
+		return maxError;
+	}
+
+	// 条件数の良い(逆行列が安定して求まる)ランダム行列
+	Matrix4x4 RandomInvertibleMatrix(std::mt19937& engine) {
+		Matrix4x4 matrix = Benchmark::RandomMatrix(engine, -1.0f, 1.0f);
+		for (int i = 0; i < 4; ++i) {
+			matrix.m[i][i] += 4.0f;
+		}
+		return matrix;
+	}
+
+}
+
+BENCHMARK_SUITE(Simd) {
+#if defined(MT3_SIMD_AVX)
+	std::printf("  kernel: AVX\n");
+#elif defined(MT3_SIMD_SSE)
+	std::printf("  kernel: SSE\n");
+#else
+	std::printf("  kernel: scalar fallback\n");
+#endif
+
+	std::mt19937 engine(options.seed);
+	std::vector<Matrix4x4> m1 = Benchmark::MakeInputs<Matrix4x4>(options, [&] { return RandomInvertibleMatrix(engine); });
+	std::vector<Matrix4x4> m2 = Benchmark::MakeInputs<Matrix4x4>(options, [&] { return Benchmark::RandomMatrix(engine, -2.0f, 2.0f); });
+	std::vector<Matrix4x4> affine = Benchmark::MakeInputs<Matrix4x4>(options, [&] {
+		return MakeAffineMatrix(Benchmark::RandomVector3(engine, 0.5f, 2.0f), Benchmark::RandomVector3(engine, -3.14f, 3.14f), Benchmark::RandomVector3(engine, -5.0f, 5.0f));
+		});
+	std::vector<Vector3> points = Benchmark::MakeInputs<Vector3>(options, [&] { return Benchmark::RandomVector3(engine, -10.0f, 10.0f); });
+
+	// スカラー版との一致を確認
+	double multiplyError = 0.0;
+	double inverseError = 0.0;
+	double transformError = 0.0;
+	for (size_t i = 0; i < options.inputCount; ++i) {
+		multiplyError = std::max(multiplyError, MaxRelativeError(MultiplyScalar(m1[i], m2[i]), MultiplySimd(m1[i], m2[i])));
+		inverseError = std::max(inverseError, MaxRelativeError(InverseScalar(m1[i]), InverseSimd(m1[i])));
+		inverseError = std::max(inverseError, MaxRelativeError(InverseScalar(affine[i]), InverseSimd(affine[i])));
+		transformError = std::max(transformError, MaxRelativeError(TransformScalar(points[i], affine[i]), TransformSimd(points[i], affine[i])));
+	}
+	Benchmark::Check("MultiplySimd == MultiplyScalar", multiplyError, 1e-6);
+	Benchmark::Check("InverseSimd ~= InverseScalar", inverseError, 1e-4);
+	Benchmark::Check("TransformSimd == TransformScalar", transformError, 1e-6);
+
+	double multiplyScalar = Benchmark::Run("MultiplyScalar", options, [&](size_t i) { Benchmark::DoNotOptimize(MultiplyScalar(m1[i], m2[i])); });
+	double multiplySimd = Benchmark::Run("MultiplySimd", options, [&](size_t i) { Benchmark::DoNotOptimize(MultiplySimd(m1[i], m2[i])); });
+	double inverseScalar = Benchmark::Run("InverseScalar", options, [&](size_t i) { Benchmark::DoNotOptimize(InverseScalar(m1[i])); });
+	double inverseSimd = Benchmark::Run("InverseSimd", options, [&](size_t i) { Benchmark::DoNotOptimize(InverseSimd(m1[i])); });
+	double transformScalar = Benchmark::Run("TransformScalar", options, [&](size_t i) { Benchmark::DoNotOptimize(TransformScalar(points[i], affine[i])); });
+	double transformSimd = Benchmark::Run("TransformSimd", options, [&](size_t i) { Benchmark::DoNotOptimize(TransformSimd(points[i], affine[i])); });
+
+	std::printf("  speedup: Multiply x%.2f, Inverse x%.2f, Transform x%.2f\n",
+		multiplyScalar / multiplySimd, inverseScalar / inverseSimd, transformScalar / transformSimd);
+}
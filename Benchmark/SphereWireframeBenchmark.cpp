@@ -0,0 +1,151 @@
+#include "Benchmark.h"
+#include "DebugDraw.h"
+#include "Frustum.h"
+#include "MathFunction.h"
+#include "Primitive.h"
+#include "SphereWireframe.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace {
+
+	const uint32_t kSubdivision = 20;
+	const uint32_t kOldPointCount = kSubdivision * kSubdivision * 3;
+
+	// 変更前のDrawSphereと同じ手順(セルごとにsin/cosを求めて3点ずつ変換する)
+	size_t TransformSphereByCell(const Vector3& center, float radius, const Matrix4x4& viewProjectionViewportMatrix, float* x, float* y, float* z, const ScreenPointsSoA& screen) {
+		const float kLatEvery = std::numbers::pi_v<float> / static_cast<float>(kSubdivision);
+		const float kLonEvery = 2.0f * std::numbers::pi_v<float> / static_cast<float>(kSubdivision);
+		for (uint32_t latIndex = 0; latIndex < kSubdivision; ++latIndex) {
+			float lat = -std::numbers::pi_v<float> / 2.0f + kLatEvery * latIndex;
+			for (uint32_t lonIndex = 0; lonIndex < kSubdivision; ++lonIndex) {
+				float lon = kLonEvery * lonIndex;
+				uint32_t a = (latIndex * kSubdivision + lonIndex) * 3;
+				x[a] = center.x + radius * cosf(lat) * cosf(lon);
+				y[a] = center.y + radius * sinf(lat);
+				z[a] = center.z + radius * cosf(lat) * sinf(lon);
+				x[a + 1] = center.x + radius * cosf(lat + kLatEvery) * cosf(lon);
+				y[a + 1] = center.y + radius * sinf(lat + kLatEvery);
+				z[a + 1] = center.z + radius * cosf(lat + kLatEvery) * sinf(lon);
+				x[a + 2] = center.x + radius * cosf(lat) * cosf(lon + kLonEvery);
+				y[a + 2] = center.y + radius * sinf(lat);
+				z[a + 2] = center.z + radius * cosf(lat) * sinf(lon + kLonEvery);
+			}
+		}
+		return TransformToScreen({ { x, kOldPointCount }, { y, kOldPointCount }, { z, kOldPointCount } }, viewProjectionViewportMatrix, screen);
+	}
+
+}
+
+BENCHMARK_SUITE(SphereWireframe) {
+	const Camera camera = Benchmark::MakeMainCamera();
+	const Matrix4x4& viewProjectionViewportMatrix = camera.GetViewProjectionViewportMatrix();
+
+	const SphereWireframe& wireframe = GetSphereWireframe(kSubdivision);
+	const size_t vertexCount = wireframe.x.size();
+
+	// 頂点が単位球上にあり、線の数が緯線+経線の数になっているか
+	double radiusError = 0.0;
+	for (size_t i = 0; i < vertexCount; ++i) {
+		float length = std::sqrt(wireframe.x[i] * wireframe.x[i] + wireframe.y[i] * wireframe.y[i] + wireframe.z[i] * wireframe.z[i]);
+		radiusError = std::max(radiusError, static_cast<double>(std::fabs(length - 1.0f)));
+	}
+	Benchmark::Check("wireframe vertices lie on the unit sphere", radiusError, 1e-6);
+	size_t expectedLines = (kSubdivision - 1) * kSubdivision + kSubdivision * kSubdivision;
+	Benchmark::Check("wireframe line count", std::fabs(static_cast<double>(wireframe.lines.size() / 2) - static_cast<double>(expectedLines)), 0.0);
+	Benchmark::Check("wireframe is cached", &GetSphereWireframe(kSubdivision) == &wireframe ? 0.0 : 1.0, 0.0);
+
+	// 半径と中心を行列に畳み込んだ変換が、頂点を動かしてから変換したものと一致するか
+	std::mt19937 engine(options.seed);
+	const size_t sphereCount = 256;
+	std::vector<Sphere> spheres(sphereCount);
+	for (Sphere& sphere : spheres) {
+		sphere = { Benchmark::RandomVector3(engine, -2.0f, 2.0f), Benchmark::RandomFloat(engine, 0.1f, 1.0f) };
+	}
+
+	std::vector<float> worldX(std::max<size_t>(vertexCount, kOldPointCount));
+	std::vector<float> worldY(worldX.size());
+	std::vector<float> worldZ(worldX.size());
+	std::vector<float> screenX(worldX.size()), screenY(worldX.size()), expectedX(worldX.size()), expectedY(worldX.size());
+	std::vector<uint8_t> visible(worldX.size()), expectedVisible(worldX.size());
+	double maxError = 0.0;
+	for (const Sphere& sphere : spheres) {
+		for (size_t i = 0; i < vertexCount; ++i) {
+			worldX[i] = sphere.center.x + sphere.radius * wireframe.x[i];
+			worldY[i] = sphere.center.y + sphere.radius * wireframe.y[i];
+			worldZ[i] = sphere.center.z + sphere.radius * wireframe.z[i];
+		}
+		TransformToScreen({ { worldX.data(), vertexCount }, { worldY.data(), vertexCount }, { worldZ.data(), vertexCount } }, viewProjectionViewportMatrix, { expectedX, expectedY, expectedVisible });
+		TransformSphereWireframe(wireframe, sphere.center, sphere.radius, viewProjectionViewportMatrix, { screenX, screenY, visible });
+		for (size_t i = 0; i < vertexCount; ++i) {
+			if (visible[i] != expectedVisible[i]) {
+				maxError = INFINITY;
+				continue;
+			}
+			double scale = std::max(1.0, std::max(std::fabs(static_cast<double>(expectedX[i])), std::fabs(static_cast<double>(expectedY[i]))));
+			maxError = std::max(maxError, std::fabs(static_cast<double>(expectedX[i]) - screenX[i]) / scale);
+			maxError = std::max(maxError, std::fabs(static_cast<double>(expectedY[i]) - screenY[i]) / scale);
+		}
+	}
+	Benchmark::Check("TransformSphereWireframe ~= scale/translate then transform", maxError, 1e-4);
+
+	// カメラをまたぐ球: 畳み込んだ行列で単位球を切った線が、ワールド座標で切った線と一致するか
+	// 近平面ぎりぎりの頂点は丸め誤差で見える/見えないが入れ替わるので、線の数が違う球は数だけ数える
+	DebugDraw clippedDraw, expectedDraw;
+	const size_t straddleCount = 64;
+	size_t countMismatches = 0;
+	double clipError = 0.0;
+	for (size_t n = 0; n < straddleCount; ++n) {
+		Vector3 center = Add(Vector3{ 0.0f, 1.9f, -6.49f }, Benchmark::RandomVector3(engine, -0.5f, 0.5f));
+		float radius = Benchmark::RandomFloat(engine, 0.5f, 2.0f);
+		for (size_t i = 0; i < vertexCount; ++i) {
+			worldX[i] = center.x + radius * wireframe.x[i];
+			worldY[i] = center.y + radius * wireframe.y[i];
+			worldZ[i] = center.z + radius * wireframe.z[i];
+		}
+		PointsSoA worldPoints = { { worldX.data(), vertexCount }, { worldY.data(), vertexCount }, { worldZ.data(), vertexCount } };
+		TransformToScreen(worldPoints, viewProjectionViewportMatrix, { expectedX, expectedY, expectedVisible });
+		AddClippedLines(expectedDraw, worldPoints, { expectedX, expectedY, expectedVisible }, wireframe.lines, viewProjectionViewportMatrix, 0xFFFFFFFF);
+
+		Matrix4x4 sphereMatrix = MakeSphereWireframeMatrix(center, radius, viewProjectionViewportMatrix);
+		PointsSoA unitPoints = { wireframe.x, wireframe.y, wireframe.z };
+		TransformToScreen(unitPoints, sphereMatrix, { screenX, screenY, visible });
+		AddClippedLines(clippedDraw, unitPoints, { screenX, screenY, visible }, wireframe.lines, sphereMatrix, 0xFFFFFFFF);
+
+		std::span<const DebugLine> lines = clippedDraw.GetLines();
+		std::span<const DebugLine> expectedLines = expectedDraw.GetLines();
+		if (lines.empty() || lines.size() != expectedLines.size()) {
+			++countMismatches;
+		} else {
+			for (size_t i = 0; i < lines.size(); ++i) {
+				const float values[4][2] = {
+					{ lines[i].startX, expectedLines[i].startX }, { lines[i].startY, expectedLines[i].startY },
+					{ lines[i].endX, expectedLines[i].endX }, { lines[i].endY, expectedLines[i].endY } };
+				for (const auto& value : values) {
+					double scale = std::max(1.0, std::fabs(static_cast<double>(value[1])));
+					clipError = std::max(clipError, std::fabs(static_cast<double>(value[0]) - value[1]) / scale);
+				}
+			}
+		}
+		clippedDraw.Flush();
+		expectedDraw.Flush();
+	}
+	// 近平面で切った端点はwが小さいので、行列の丸め方の違いが数百分の1ピクセル程度出る
+	Benchmark::Check("sphere clipped with MakeSphereWireframeMatrix ~= clipped in world space", clipError, 0.05);
+	Benchmark::Check("straddling spheres with a different line count", static_cast<double>(countMismatches) / straddleCount, 0.1);
+
+	// 1球あたりマイクロ秒単位なので回数を抑える
+	Benchmark::Options sphereOptions = options;
+	sphereOptions.iterations = std::min(options.iterations, sphereCount * 256);
+	Benchmark::RunBatch("per-cell sinf/cosf + transform (old)", sphereOptions, sphereCount, [&] {
+		for (const Sphere& sphere : spheres) {
+			Benchmark::DoNotOptimize(TransformSphereByCell(sphere.center, sphere.radius, viewProjectionViewportMatrix, worldX.data(), worldY.data(), worldZ.data(), { screenX, screenY, visible }));
+		}
+		});
+	Benchmark::RunBatch("cached wireframe + transform", sphereOptions, sphereCount, [&] {
+		for (const Sphere& sphere : spheres) {
+			Benchmark::DoNotOptimize(TransformSphereWireframe(GetSphereWireframe(kSubdivision), sphere.center, sphere.radius, viewProjectionViewportMatrix, { screenX, screenY, visible }));
+		}
+		});
+}
@@ -0,0 +1,59 @@
+#include "Benchmark.h"
+#include "MathFunction.h"
+#include "TransformBatch.h"
+#include <algorithm>
+#include <cmath>
+
+BENCHMARK_SUITE(TransformBatch) {
+	const Camera camera = Benchmark::MakeMainCamera();
+	const Matrix4x4& viewProjectionMatrix = camera.GetViewProjectionMatrix();
+	const Matrix4x4& viewportMatrix = camera.GetViewportMatrix();
+	const Matrix4x4& viewProjectionViewportMatrix = camera.GetViewProjectionViewportMatrix();
+
+	std::mt19937 engine(options.seed);
+	const size_t count = options.inputCount;
+	std::vector<float> x(count), y(count), z(count);
+	std::vector<Vector3> aos(count);
+	for (size_t i = 0; i < count; ++i) {
+		aos[i] = Benchmark::RandomVector3(engine, -4.0f, 4.0f);
+		x[i] = aos[i].x;
+		y[i] = aos[i].y;
+		z[i] = aos[i].z;
+	}
+	std::vector<float> screenX(count), screenY(count);
+	std::vector<uint8_t> visible(count);
+
+	// 2回変換した結果との一致を確認(カメラの前の点のみ)
+	TransformToScreen({ x, y, z }, viewProjectionViewportMatrix, { screenX, screenY, visible });
+	double maxError = 0.0;
+	size_t mismatchedVisibility = 0;
+	for (size_t i = 0; i < count; ++i) {
+		float w = aos[i].x * viewProjectionMatrix.m[0][3] + aos[i].y * viewProjectionMatrix.m[1][3] + aos[i].z * viewProjectionMatrix.m[2][3] + viewProjectionMatrix.m[3][3];
+		bool front = w > 1.0e-6f;
+		if (front != (visible[i] != 0)) {
+			++mismatchedVisibility;
+			continue;
+		}
+		if (!front) {
+			continue;
+		}
+		Vector3 expected = Transform(Transform(aos[i], viewProjectionMatrix), viewportMatrix);
+		double scale = std::max(1.0, std::max(std::fabs(static_cast<double>(expected.x)), std::fabs(static_cast<double>(expected.y))));
+		maxError = std::max(maxError, std::fabs(static_cast<double>(expected.x) - screenX[i]) / scale);
+		maxError = std::max(maxError, std::fabs(static_cast<double>(expected.y) - screenY[i]) / scale);
+	}
+	Benchmark::Check("TransformToScreen ~= Transform(Transform())", maxError, 1e-4);
+	Benchmark::Check("TransformToScreen visibility flags", static_cast<double>(mismatchedVisibility), 0.0);
+
+	Benchmark::RunBatch("Transform(Transform(p, vp), viewport)", options, count, [&] {
+		for (size_t i = 0; i < count; ++i) {
+			Vector3 screen = Transform(Transform(aos[i], viewProjectionMatrix), viewportMatrix);
+			screenX[i] = screen.x;
+			screenY[i] = screen.y;
+		}
+		Benchmark::DoNotOptimize(screenX[0]);
+		});
+	Benchmark::RunBatch("TransformToScreen (SoA)", options, count, [&] {
+		Benchmark::DoNotOptimize(TransformToScreen({ x, y, z }, viewProjectionViewportMatrix, { screenX, screenY, visible }));
+		});
+}
@@ -0,0 +1,100 @@
+#include "BroadPhase.h"
+
+BroadPhase::Handle BroadPhase::AllocateProxy(ShapeType type, uint32_t userData)
+{
+	uint32_t slot;
+	if (freeList_ != kInvalidSlot) {
+		slot = freeList_;
+		freeList_ = proxies_[slot].nextFree;
+	} else {
+		slot = static_cast<uint32_t>(proxies_.size());
+		proxies_.push_back({});
+		proxies_[slot].generation = 1;
+	}
+
+	Proxy& proxy = proxies_[slot];
+	proxy.type = type;
+	proxy.node = DynamicAABBTree::kNullNode;
+	proxy.userData = userData;
+	proxy.planeSlot = 0;
+	proxy.nextFree = kInvalidSlot;
+	++count_;
+
+	return MakeHandle(slot);
+}
+
+BroadPhase::Handle BroadPhase::Add(const Sphere& sphere, uint32_t userData)
+{
+	Handle handle = AllocateProxy(ShapeType::kSphere, userData);
+	proxies_[handle.slot].node = tree_.CreateProxy(MakeAABB(sphere), handle.slot);
+	return handle;
+}
+
+BroadPhase::Handle BroadPhase::Add(const Segment& segment, uint32_t userData)
+{
+	Handle handle = AllocateProxy(ShapeType::kSegment, userData);
+	proxies_[handle.slot].node = tree_.CreateProxy(MakeAABB(segment), handle.slot);
+	return handle;
+}
+
+BroadPhase::Handle BroadPhase::Add(const Plane& plane, uint32_t userData)
+{
+	Handle handle = AllocateProxy(ShapeType::kPlane, userData);
+	proxies_[handle.slot].plane = plane;
+	proxies_[handle.slot].planeSlot = static_cast<uint32_t>(planes_.size());
+	planes_.push_back(handle.slot);
+	return handle;
+}
+
+bool BroadPhase::Remove(Handle handle)
+{
+	if (!IsValid(handle)) {
+		return false;
+	}
+	Proxy& proxy = proxies_[handle.slot];
+
+	if (proxy.type == ShapeType::kPlane) {
+		// 末尾と入れ替えて詰める
+		uint32_t last = planes_.back();
+		planes_[proxy.planeSlot] = last;
+		proxies_[last].planeSlot = proxy.planeSlot;
+		planes_.pop_back();
+	} else {
+		tree_.DestroyProxy(proxy.node);
+		proxy.node = DynamicAABBTree::kNullNode;
+	}
+
+	// スロットは世代を進めて空きリストへ
+	++proxy.generation;
+	proxy.nextFree = freeList_;
+	freeList_ = handle.slot;
+	--count_;
+	return true;
+}
+
+bool BroadPhase::Update(Handle handle, const Sphere& sphere)
+{
+	if (!IsValid(handle) || proxies_[handle.slot].type != ShapeType::kSphere) {
+		return false;
+	}
+	tree_.MoveProxy(proxies_[handle.slot].node, MakeAABB(sphere));
+	return true;
+}
+
+bool BroadPhase::Update(Handle handle, const Segment& segment)
+{
+	if (!IsValid(handle) || proxies_[handle.slot].type != ShapeType::kSegment) {
+		return false;
+	}
+	tree_.MoveProxy(proxies_[handle.slot].node, MakeAABB(segment));
+	return true;
+}
+
+bool BroadPhase::Update(Handle handle, const Plane& plane)
+{
+	if (!IsValid(handle) || proxies_[handle.slot].type != ShapeType::kPlane) {
+		return false;
+	}
+	proxies_[handle.slot].plane = plane;
+	return true;
+}
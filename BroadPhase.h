@@ -0,0 +1,173 @@
+#pragma once
+#include "Collision.h"
+#include "DynamicAABBTree.h"
+#include <cmath>
+
+/// <summary>
+/// Sphere/Segment/Planeをまとめて管理するブロードフェーズ
+/// 球と線分は動的AABBツリーに入れ、無限に広がる平面は別の配列で毎回判定する
+/// クエリが返すのはAABBが重なった候補なので、厳密な判定は呼び出し側で行う
+/// (平面だけはここで厳密に判定する)
+/// </summary>
+class BroadPhase {
+public:
+	// 登録した形状の種類
+	enum class ShapeType : uint8_t {
+		kSphere,
+		kSegment,
+		kPlane,
+	};
+
+	static const uint32_t kInvalidSlot = 0xFFFFFFFFu;
+
+	/// <summary>
+	/// 登録した形状を指すハンドル(スロット番号と世代、Scene::Handleと同じ仕組み)
+	/// 削除するとスロットの世代が進むので、二重の削除や古いハンドルはIsValidでfalseになる
+	/// </summary>
+	struct Handle {
+		uint32_t slot = kInvalidSlot;
+		uint32_t generation = 0;
+
+		bool operator==(const Handle& other) const { return slot == other.slot && generation == other.generation; }
+		bool operator!=(const Handle& other) const { return !(*this == other); }
+	};
+
+	Handle Add(const Sphere& sphere, uint32_t userData);
+	Handle Add(const Segment& segment, uint32_t userData);
+	Handle Add(const Plane& plane, uint32_t userData);
+
+	// 古いハンドル(削除済みを含む)なら何もせずfalse
+	bool Remove(Handle handle);
+
+	bool IsValid(Handle handle) const {
+		return handle.slot < proxies_.size() && proxies_[handle.slot].generation == handle.generation;
+	}
+
+	/// <summary>
+	/// 形状を更新する(種類は登録時と同じもの)
+	/// 球と線分はfat AABBからはみ出したときだけツリーを組み替える
+	/// 古いハンドルや種類の違う形状なら何もせずfalse
+	/// </summary>
+	bool Update(Handle handle, const Sphere& sphere);
+	bool Update(Handle handle, const Segment& segment);
+	bool Update(Handle handle, const Plane& plane);
+
+	// クエリで受け取った(有効な)ハンドル用なので、確かめるのはassertだけ
+	ShapeType GetShapeType(Handle handle) const {
+		assert(IsValid(handle));
+		return proxies_[handle.slot].type;
+	}
+	uint32_t GetUserData(Handle handle) const {
+		assert(IsValid(handle));
+		return proxies_[handle.slot].userData;
+	}
+	size_t GetCount() const { return count_; }
+	const DynamicAABBTree& GetTree() const { return tree_; }
+
+	/// <summary>
+	/// AABBと重なる候補を列挙する
+	/// callback(handle)がfalseを返したら打ち切る
+	/// </summary>
+	template<typename Callback>
+	void QueryOverlap(const AABB& aabb, Callback&& callback) const;
+
+	/// <summary>
+	/// 線分(始点と終点)が通る候補を列挙する
+	/// callback(handle)がfalseを返したら打ち切る
+	/// </summary>
+	template<typename Callback>
+	void QuerySegment(const Segment& segment, Callback&& callback) const;
+
+	/// <summary>
+	/// 半直線 origin + t * direction (0 <= t <= maxT) が通る候補を列挙する
+	/// callback(handle, maxT)は新しいmaxTを返す(DynamicAABBTree::RayCastと同じ)
+	/// </summary>
+	template<typename Callback>
+	void QueryRay(const Vector3& origin, const Vector3& direction, float maxT, Callback&& callback) const;
+
+private:
+	struct Proxy {
+		ShapeType type;
+		int32_t node;// ツリーの葉(平面はkNullNode)
+		uint32_t userData;
+		uint32_t planeSlot;// planes_の中の位置(平面のみ)
+		uint32_t generation;// スロットの世代
+		uint32_t nextFree;
+		Plane plane;
+	};
+
+	Handle AllocateProxy(ShapeType type, uint32_t userData);
+
+	// ツリーの葉と平面の配列にはスロット番号を入れておき、返すときに今の世代を付ける
+	Handle MakeHandle(uint32_t slot) const { return { slot, proxies_[slot].generation }; }
+
+	DynamicAABBTree tree_;
+	std::vector<Proxy> proxies_;
+	std::vector<uint32_t> planes_;
+	uint32_t freeList_ = kInvalidSlot;
+	size_t count_ = 0;
+};
+
+template<typename Callback>
+inline void BroadPhase::QueryOverlap(const AABB& aabb, Callback&& callback) const {
+	bool running = true;
+	tree_.Query(aabb, [&](int32_t proxyId) {
+		running = callback(MakeHandle(tree_.GetUserData(proxyId)));
+		return running;
+		});
+
+	for (size_t i = 0; running && i < planes_.size(); ++i) {
+		if (IsCollision(aabb, proxies_[planes_[i]].plane)) {
+			running = callback(MakeHandle(planes_[i]));
+		}
+	}
+}
+
+template<typename Callback>
+inline void BroadPhase::QuerySegment(const Segment& segment, Callback&& callback) const {
+	bool running = true;
+	Vector3 direction = { segment.diff.x - segment.origin.x, segment.diff.y - segment.origin.y, segment.diff.z - segment.origin.z };
+	tree_.RayCast(segment.origin, direction, 1.0f, [&](int32_t proxyId, float maxT) {
+		running = callback(MakeHandle(tree_.GetUserData(proxyId)));
+		return running ? maxT : 0.0f;
+		});
+
+	for (size_t i = 0; running && i < planes_.size(); ++i) {
+		if (IsCollision(segment, proxies_[planes_[i]].plane)) {
+			running = callback(MakeHandle(planes_[i]));
+		}
+	}
+}
+
+template<typename Callback>
+inline void BroadPhase::QueryRay(const Vector3& origin, const Vector3& direction, float maxT, Callback&& callback) const {
+	tree_.RayCast(origin, direction, maxT, [&](int32_t proxyId, float currentMaxT) {
+		float newMaxT = callback(MakeHandle(tree_.GetUserData(proxyId)), currentMaxT);
+		if (newMaxT < maxT) {
+			maxT = newMaxT;
+		}
+		return newMaxT;
+		});
+	if (maxT <= 0.0f) {
+		return;
+	}
+
+	for (size_t i = 0; i < planes_.size(); ++i) {
+		const Plane& plane = proxies_[planes_[i]].plane;
+		float denominator = plane.normal.x * direction.x + plane.normal.y * direction.y + plane.normal.z * direction.z;
+		if (denominator == 0.0f) {
+			continue;
+		}
+		float t = (plane.distance - (plane.normal.x * origin.x + plane.normal.y * origin.y + plane.normal.z * origin.z)) / denominator;
+		if (t < 0.0f || t > maxT) {
+			continue;
+		}
+		float newMaxT = callback(MakeHandle(planes_[i]), maxT);
+		if (newMaxT <= 0.0f) {
+			return;
+		}
+		if (newMaxT < maxT) {
+			maxT = newMaxT;
+		}
+	}
+}
@@ -0,0 +1,145 @@
+#include "Camera.h"
+#include "MathFunction.h"
+#include "Profiler.h"
+
+namespace {
+
+	bool Equals(const Vector3& a, const Vector3& b) {
+		return a.x == b.x && a.y == b.y && a.z == b.z;
+	}
+
+	// 全部作り直す
+	const uint32_t kAllDirty = 0xFFFFFFFFu;
+
+}
+
+Camera::Camera()
+	: rotate_{ 0.0f, 0.0f, 0.0f }
+	, translate_{ 0.0f, 0.0f, 0.0f }
+	, fovY_(0.45f)
+	, aspectRatio_(1280.0f / 720.0f)
+	, nearClip_(0.1f)
+	, farClip_(100.0f)
+	, viewportLeft_(0.0f)
+	, viewportTop_(0.0f)
+	, viewportWidth_(1280.0f)
+	, viewportHeight_(720.0f)
+	, minDepth_(0.0f)
+	, maxDepth_(1.0f)
+	, dirty_(kAllDirty)
+{
+}
+
+void Camera::SetRotate(const Vector3& rotate)
+{
+	if (Equals(rotate_, rotate)) {
+		return;
+	}
+	rotate_ = rotate;
+	MarkDirty(kViewDirty | kViewProjectionDirty | kViewProjectionViewportDirty | kFrustumDirty);
+}
+
+void Camera::SetTranslate(const Vector3& translate)
+{
+	if (Equals(translate_, translate)) {
+		return;
+	}
+	translate_ = translate;
+	MarkDirty(kViewDirty | kViewProjectionDirty | kViewProjectionViewportDirty | kFrustumDirty);
+}
+
+void Camera::SetPerspective(float fovY, float aspectRatio, float nearClip, float farClip)
+{
+	if (fovY_ == fovY && aspectRatio_ == aspectRatio && nearClip_ == nearClip && farClip_ == farClip) {
+		return;
+	}
+	fovY_ = fovY;
+	aspectRatio_ = aspectRatio;
+	nearClip_ = nearClip;
+	farClip_ = farClip;
+	MarkDirty(kProjectionDirty | kViewProjectionDirty | kViewProjectionViewportDirty | kFrustumDirty);
+}
+
+void Camera::SetViewport(float left, float top, float width, float height, float minDepth, float maxDepth)
+{
+	if (viewportLeft_ == left && viewportTop_ == top && viewportWidth_ == width && viewportHeight_ == height && minDepth_ == minDepth && maxDepth_ == maxDepth) {
+		return;
+	}
+	viewportLeft_ = left;
+	viewportTop_ = top;
+	viewportWidth_ = width;
+	viewportHeight_ = height;
+	minDepth_ = minDepth;
+	maxDepth_ = maxDepth;
+	// 視錐台はビューポートに依存しない
+	MarkDirty(kViewportDirty | kViewProjectionViewportDirty);
+}
+
+void Camera::MarkDirty(uint32_t flags)
+{
+	dirty_ |= flags;
+	++revision_;
+}
+
+const Matrix4x4& Camera::GetCameraMatrix() const
+{
+	GetViewMatrix();
+	return cameraMatrix_;
+}
+
+const Matrix4x4& Camera::GetViewMatrix() const
+{
+	if (dirty_ & kViewDirty) {
+		PROFILE_SCOPE("Camera::RebuildView");
+		cameraMatrix_ = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, rotate_, translate_);
+		// カメラは回転と平行移動だけなので転置で逆行列が求まる
+		viewMatrix_ = InverseRigid(cameraMatrix_);
+		dirty_ &= ~kViewDirty;
+	}
+	return viewMatrix_;
+}
+
+const Matrix4x4& Camera::GetProjectionMatrix() const
+{
+	if (dirty_ & kProjectionDirty) {
+		projectionMatrix_ = MakePerspectiveFovMatrix(fovY_, aspectRatio_, nearClip_, farClip_);
+		dirty_ &= ~kProjectionDirty;
+	}
+	return projectionMatrix_;
+}
+
+const Matrix4x4& Camera::GetViewportMatrix() const
+{
+	if (dirty_ & kViewportDirty) {
+		viewportMatrix_ = MakeViewportMatrix(viewportLeft_, viewportTop_, viewportWidth_, viewportHeight_, minDepth_, maxDepth_);
+		dirty_ &= ~kViewportDirty;
+	}
+	return viewportMatrix_;
+}
+
+const Matrix4x4& Camera::GetViewProjectionMatrix() const
+{
+	if (dirty_ & kViewProjectionDirty) {
+		viewProjectionMatrix_ = Multiply(GetViewMatrix(), GetProjectionMatrix());
+		dirty_ &= ~kViewProjectionDirty;
+	}
+	return viewProjectionMatrix_;
+}
+
+const Matrix4x4& Camera::GetViewProjectionViewportMatrix() const
+{
+	if (dirty_ & kViewProjectionViewportDirty) {
+		viewProjectionViewportMatrix_ = Multiply(GetViewProjectionMatrix(), GetViewportMatrix());
+		dirty_ &= ~kViewProjectionViewportDirty;
+	}
+	return viewProjectionViewportMatrix_;
+}
+
+const Frustum& Camera::GetFrustum() const
+{
+	if (dirty_ & kFrustumDirty) {
+		frustum_ = MakeFrustum(GetViewProjectionMatrix());
+		dirty_ &= ~kFrustumDirty;
+	}
+	return frustum_;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "Frustum.h"
+#include <Matrix4x4.h>
+#include <Vector3.h>
+#include <cstdint>
+
+/// <summary>
+/// ビュー・射影・ビューポート行列と、それらを掛けた行列をまとめて持つカメラ
+/// Set系で値が変わったものだけを汚し、Get系で必要になったときに汚れた行列だけを作り直す
+/// (同じ値を毎フレームSetしても何も計算しない)
+/// Get系はconstだが内部のキャッシュを書き換えるので、1つのカメラを複数スレッドから同時に読まないこと
+/// </summary>
+class Camera {
+public:
+	Camera();
+
+	// カメラの姿勢(拡縮は1で固定)
+	void SetRotate(const Vector3& rotate);
+	void SetTranslate(const Vector3& translate);
+
+	// MakePerspectiveFovMatrixの引数
+	void SetPerspective(float fovY, float aspectRatio, float nearClip, float farClip);
+
+	// MakeViewportMatrixの引数
+	void SetViewport(float left, float top, float width, float height, float minDepth, float maxDepth);
+
+	const Vector3& GetRotate() const { return rotate_; }
+	const Vector3& GetTranslate() const { return translate_; }
+
+	const Matrix4x4& GetCameraMatrix() const;
+	const Matrix4x4& GetViewMatrix() const;
+	const Matrix4x4& GetProjectionMatrix() const;
+	const Matrix4x4& GetViewportMatrix() const;
+	const Matrix4x4& GetViewProjectionMatrix() const;
+
+	/// <summary>
+	/// Multiply(GetViewProjectionMatrix(), GetViewportMatrix())
+	/// TransformToScreenなどにそのまま渡す行列
+	/// </summary>
+	const Matrix4x4& GetViewProjectionViewportMatrix() const;
+
+	/// <summary>
+	/// GetViewProjectionMatrix()から取り出した視錐台
+	/// </summary>
+	const Frustum& GetFrustum() const;
+
+	/// <summary>
+	/// どれかの行列が変わるたびに増える番号
+	/// 利用側で変換結果をキャッシュするときに、前回の番号と比べて作り直すかを決める
+	/// </summary>
+	uint32_t GetRevision() const { return revision_; }
+
+private:
+	// 作り直しが必要なもの
+	enum DirtyFlag : uint32_t {
+		kViewDirty = 1u << 0,
+		kProjectionDirty = 1u << 1,
+		kViewportDirty = 1u << 2,
+		kViewProjectionDirty = 1u << 3,
+		kViewProjectionViewportDirty = 1u << 4,
+		kFrustumDirty = 1u << 5,
+	};
+
+	void MarkDirty(uint32_t flags);
+
+	Vector3 rotate_;
+	Vector3 translate_;
+	float fovY_;
+	float aspectRatio_;
+	float nearClip_;
+	float farClip_;
+	float viewportLeft_;
+	float viewportTop_;
+	float viewportWidth_;
+	float viewportHeight_;
+	float minDepth_;
+	float maxDepth_;
+
+	mutable uint32_t dirty_;
+	uint32_t revision_ = 0;
+
+	mutable Matrix4x4 cameraMatrix_;
+	mutable Matrix4x4 viewMatrix_;
+	mutable Matrix4x4 projectionMatrix_;
+	mutable Matrix4x4 viewportMatrix_;
+	mutable Matrix4x4 viewProjectionMatrix_;
+	mutable Matrix4x4 viewProjectionViewportMatrix_;
+	mutable Frustum frustum_;
+};
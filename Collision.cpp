@@ -0,0 +1,126 @@
+#include "Collision.h"
+#include "MathFunction.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+Vector3 ClosestPoint(const Vector3& point, const Segment& segment)
+{
+	// diffは終点なので、始点から終点への向きに射影して線分の範囲[0, 1]に収める
+	// 長さ0の線分は分母を最小の正規化数にして割る(内積も0なのでtは0になり始点を返す)
+	float directionX = segment.diff.x - segment.origin.x;
+	float directionY = segment.diff.y - segment.origin.y;
+	float directionZ = segment.diff.z - segment.origin.z;
+	float lengthSq = directionX * directionX + directionY * directionY + directionZ * directionZ;
+	float dot = (point.x - segment.origin.x) * directionX + (point.y - segment.origin.y) * directionY + (point.z - segment.origin.z) * directionZ;
+	float t = std::min(std::max(dot / std::max(lengthSq, FLT_MIN), 0.0f), 1.0f);
+
+	return { segment.origin.x + t * directionX, segment.origin.y + t * directionY, segment.origin.z + t * directionZ };
+}
+
+bool IsCollision(const Segment& segment, const Plane& plane)
+{
+	// 始点と終点の平面からの距離
+	float dotA = Dot(plane.normal, segment.origin) - plane.distance;
+	float dotB = Dot(plane.normal, segment.diff) - plane.distance;
+
+	// 端点が平面の反対側にある → 符号が異なる（または片方が0）
+	if (dotA * dotB <= 0.0f) {
+		return true;
+	}
+
+	return false;
+}
+
+bool IsCollision(const Segment& segment, const Sphere& sphere)
+{
+	// 線分上で球の中心に最も近い点を求める
+	Vector3 direction = Subtract(segment.diff, segment.origin);
+	float lengthSq = Dot(direction, direction);
+	float t = 0.0f;
+	if (lengthSq > 0.0f) {
+		t = std::clamp(Dot(Subtract(sphere.center, segment.origin), direction) / lengthSq, 0.0f, 1.0f);
+	}
+
+	Vector3 closest = Add(segment.origin, { direction.x * t, direction.y * t, direction.z * t });
+	Vector3 offset = Subtract(closest, sphere.center);
+
+	return Dot(offset, offset) <= sphere.radius * sphere.radius;
+}
+
+AABB MakeAABB(const Sphere& sphere)
+{
+	return {
+		{ sphere.center.x - sphere.radius, sphere.center.y - sphere.radius, sphere.center.z - sphere.radius },
+		{ sphere.center.x + sphere.radius, sphere.center.y + sphere.radius, sphere.center.z + sphere.radius },
+	};
+}
+
+AABB MakeAABB(const Segment& segment)
+{
+	return {
+		{ std::min(segment.origin.x, segment.diff.x), std::min(segment.origin.y, segment.diff.y), std::min(segment.origin.z, segment.diff.z) },
+		{ std::max(segment.origin.x, segment.diff.x), std::max(segment.origin.y, segment.diff.y), std::max(segment.origin.z, segment.diff.z) },
+	};
+}
+
+bool IsCollision(const AABB& aabb1, const AABB& aabb2)
+{
+	return
+		aabb1.min.x <= aabb2.max.x && aabb1.max.x >= aabb2.min.x &&
+		aabb1.min.y <= aabb2.max.y && aabb1.max.y >= aabb2.min.y &&
+		aabb1.min.z <= aabb2.max.z && aabb1.max.z >= aabb2.min.z;
+}
+
+bool IsCollision(const AABB& aabb, const Plane& plane)
+{
+	// 中心と半径(法線方向への投影)で比較する
+	Vector3 center = {
+		(aabb.min.x + aabb.max.x) * 0.5f,
+		(aabb.min.y + aabb.max.y) * 0.5f,
+		(aabb.min.z + aabb.max.z) * 0.5f,
+	};
+	Vector3 extent = Subtract(aabb.max, center);
+
+	float radius =
+		extent.x * std::fabs(plane.normal.x) +
+		extent.y * std::fabs(plane.normal.y) +
+		extent.z * std::fabs(plane.normal.z);
+
+	return std::fabs(Dot(plane.normal, center) - plane.distance) <= radius;
+}
+
+bool IntersectRayAABB(const Vector3& origin, const Vector3& inverseDirection, const AABB& aabb, float maxT, float& tEnter)
+{
+	float tMin = 0.0f;
+	float tMax = maxT;
+
+	const float* o = &origin.x;
+	const float* inverse = &inverseDirection.x;
+	const float* boxMin = &aabb.min.x;
+	const float* boxMax = &aabb.max.x;
+
+	for (int axis = 0; axis < 3; ++axis) {
+		// 軸と平行な方向では逆数が±infになり、始点がスラブの面の上にあると0*infでNaNになる
+		// なのでこの軸は始点がスラブの中か(面の上も含む)だけで決める
+		if (inverse[axis] == INFINITY || inverse[axis] == -INFINITY) {
+			if (!(boxMin[axis] <= o[axis] && o[axis] <= boxMax[axis])) {
+				return false;
+			}
+			continue;
+		}
+
+		float t1 = (boxMin[axis] - o[axis]) * inverse[axis];
+		float t2 = (boxMax[axis] - o[axis]) * inverse[axis];
+
+		tMin = std::max(tMin, std::min(t1, t2));
+		tMax = std::min(tMax, std::max(t1, t2));
+	}
+
+	if (!(tMin <= tMax)) {
+		return false;
+	}
+
+	tEnter = tMin;
+	return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "Primitive.h"
+
+/// <summary>
+/// 線分(始点originから終点diff)上で点に最も近い点
+/// 長さ0の線分では始点を返す
+/// </summary>
+Vector3 ClosestPoint(const Vector3& point, const Segment& segment);
+
+bool IsCollision(const Segment& segment, const Plane& plane);
+
+bool IsCollision(const Segment& segment, const Sphere& sphere);
+
+/// <summary>
+/// 球を囲むAABBを求める
+/// </summary>
+AABB MakeAABB(const Sphere& sphere);
+
+/// <summary>
+/// 線分(始点と終点)を囲むAABBを求める
+/// </summary>
+AABB MakeAABB(const Segment& segment);
+
+bool IsCollision(const AABB& aabb1, const AABB& aabb2);
+
+/// <summary>
+/// AABBが平面をまたいでいるか(平面に触れているか)
+/// </summary>
+bool IsCollision(const AABB& aabb, const Plane& plane);
+
+/// <summary>
+/// 半直線 origin + t * direction (0 <= t <= maxT) とAABBの交差判定(スラブ法)
+/// </summary>
+/// <param name="origin">始点</param>
+/// <param name="inverseDirection">方向ベクトルの各成分の逆数</param>
+/// <param name="aabb">AABB</param>
+/// <param name="maxT">tの上限</param>
+/// <param name="tEnter">AABBに入るt(交差したときのみ)</param>
+/// <returns>交差していればtrue</returns>
+bool IntersectRayAABB(const Vector3& origin, const Vector3& inverseDirection, const AABB& aabb, float maxT, float& tEnter);
@@ -0,0 +1,147 @@
+#include "CollisionBatch.h"
+#include "SimdFloat.h"
+#include <assert.h>
+
+namespace {
+
+	// 線分i..i+幅と1枚の平面
+	template<typename F>
+	uint32_t SegmentPlaneKernel(const SegmentsSoA& segments, size_t i, F normalX, F normalY, F normalZ, F distance, uint8_t* hit, float* t) {
+		F originX = F::Load(&segments.originX[i]);
+		F originY = F::Load(&segments.originY[i]);
+		F originZ = F::Load(&segments.originZ[i]);
+		F endX = F::Load(&segments.endX[i]);
+		F endY = F::Load(&segments.endY[i]);
+		F endZ = F::Load(&segments.endZ[i]);
+
+		// 始点と終点の平面からの符号付き距離
+		F distanceA = normalX * originX + normalY * originY + normalZ * originZ - distance;
+		F distanceB = normalX * endX + normalY * endY + normalZ * endZ - distance;
+
+		F zero = F::Broadcast(0.0f);
+		typename F::Mask isHit = distanceA * distanceB <= zero;
+
+		if (t) {
+			// 両端とも平面上(分母0)なら始点で当たったことにする
+			F denominator = distanceA - distanceB;
+			F safeDenominator = F::Select(denominator != zero, denominator, F::Broadcast(1.0f));
+			F hitT = F::Select(denominator != zero, distanceA / safeDenominator, zero);
+			F::Select(isHit, hitT, zero).Store(t);
+		}
+
+		return StoreMaskBytes(isHit, F::kWidth, hit);
+	}
+
+	// 線分i..i+幅と1個の球
+	template<typename F>
+	uint32_t SegmentSphereKernel(const SegmentsSoA& segments, size_t i, F centerX, F centerY, F centerZ, F radius, uint8_t* hit, float* t) {
+		F originX = F::Load(&segments.originX[i]);
+		F originY = F::Load(&segments.originY[i]);
+		F originZ = F::Load(&segments.originZ[i]);
+		F directionX = F::Load(&segments.endX[i]) - originX;
+		F directionY = F::Load(&segments.endY[i]) - originY;
+		F directionZ = F::Load(&segments.endZ[i]) - originZ;
+
+		// |o + t*d - c|^2 = r^2 を解く
+		F offsetX = originX - centerX;
+		F offsetY = originY - centerY;
+		F offsetZ = originZ - centerZ;
+		F a = directionX * directionX + directionY * directionY + directionZ * directionZ;
+		F b = directionX * offsetX + directionY * offsetY + directionZ * offsetZ;
+		F c = offsetX * offsetX + offsetY * offsetY + offsetZ * offsetZ - radius * radius;
+		F discriminant = b * b - a * c;
+
+		F zero = F::Broadcast(0.0f);
+		F one = F::Broadcast(1.0f);
+
+		typename F::Mask inside = c <= zero;
+		typename F::Mask valid = (discriminant >= zero) & (a > zero);
+		F safeA = F::Select(valid, a, one);
+		F entryT = (zero - b - F::Sqrt(F::Max(discriminant, zero))) / safeA;
+		typename F::Mask crosses = valid & (entryT >= zero) & (entryT <= one);
+
+		typename F::Mask isHit = inside | crosses;
+		if (t) {
+			F::Select(inside, zero, F::Select(crosses, entryT, zero)).Store(t);
+		}
+
+		return StoreMaskBytes(isHit, F::kWidth, hit);
+	}
+
+	void CheckSizes([[maybe_unused]] const SegmentsSoA& segments, [[maybe_unused]] size_t otherCount, [[maybe_unused]] const SegmentHitsSoA& hits) {
+		[[maybe_unused]] const size_t count = segments.originX.size();
+		assert(segments.originY.size() == count && segments.originZ.size() == count);
+		assert(segments.endX.size() == count && segments.endY.size() == count && segments.endZ.size() == count);
+		assert(hits.hit.size() >= count * otherCount);
+		assert(hits.t.empty() || hits.t.size() >= count * otherCount);
+	}
+
+}
+
+size_t IsCollisionBatch(const SegmentsSoA& segments, const PlanesSoA& planes, const SegmentHitsSoA& hits)
+{
+	const size_t count = segments.originX.size();
+	const size_t planeCount = planes.distance.size();
+	CheckSizes(segments, planeCount, hits);
+
+	size_t hitCount = 0;
+	for (size_t j = 0; j < planeCount; ++j) {
+		uint8_t* hit = hits.hit.data() + j * count;
+		float* t = hits.t.empty() ? nullptr : hits.t.data() + j * count;
+
+		size_t i = 0;
+		{
+			VectorFloat normalX = VectorFloat::Broadcast(planes.normalX[j]);
+			VectorFloat normalY = VectorFloat::Broadcast(planes.normalY[j]);
+			VectorFloat normalZ = VectorFloat::Broadcast(planes.normalZ[j]);
+			VectorFloat distance = VectorFloat::Broadcast(planes.distance[j]);
+			for (; i + VectorFloat::kWidth <= count; i += VectorFloat::kWidth) {
+				hitCount += SegmentPlaneKernel(segments, i, normalX, normalY, normalZ, distance, hit + i, t ? t + i : nullptr);
+			}
+		}
+
+		ScalarFloat normalX = ScalarFloat::Broadcast(planes.normalX[j]);
+		ScalarFloat normalY = ScalarFloat::Broadcast(planes.normalY[j]);
+		ScalarFloat normalZ = ScalarFloat::Broadcast(planes.normalZ[j]);
+		ScalarFloat distance = ScalarFloat::Broadcast(planes.distance[j]);
+		for (; i < count; ++i) {
+			hitCount += SegmentPlaneKernel(segments, i, normalX, normalY, normalZ, distance, hit + i, t ? t + i : nullptr);
+		}
+	}
+
+	return hitCount;
+}
+
+size_t IsCollisionBatch(const SegmentsSoA& segments, const SpheresSoA& spheres, const SegmentHitsSoA& hits)
+{
+	const size_t count = segments.originX.size();
+	const size_t sphereCount = spheres.radius.size();
+	CheckSizes(segments, sphereCount, hits);
+
+	size_t hitCount = 0;
+	for (size_t j = 0; j < sphereCount; ++j) {
+		uint8_t* hit = hits.hit.data() + j * count;
+		float* t = hits.t.empty() ? nullptr : hits.t.data() + j * count;
+
+		size_t i = 0;
+		{
+			VectorFloat centerX = VectorFloat::Broadcast(spheres.centerX[j]);
+			VectorFloat centerY = VectorFloat::Broadcast(spheres.centerY[j]);
+			VectorFloat centerZ = VectorFloat::Broadcast(spheres.centerZ[j]);
+			VectorFloat radius = VectorFloat::Broadcast(spheres.radius[j]);
+			for (; i + VectorFloat::kWidth <= count; i += VectorFloat::kWidth) {
+				hitCount += SegmentSphereKernel(segments, i, centerX, centerY, centerZ, radius, hit + i, t ? t + i : nullptr);
+			}
+		}
+
+		ScalarFloat centerX = ScalarFloat::Broadcast(spheres.centerX[j]);
+		ScalarFloat centerY = ScalarFloat::Broadcast(spheres.centerY[j]);
+		ScalarFloat centerZ = ScalarFloat::Broadcast(spheres.centerZ[j]);
+		ScalarFloat radius = ScalarFloat::Broadcast(spheres.radius[j]);
+		for (; i < count; ++i) {
+			hitCount += SegmentSphereKernel(segments, i, centerX, centerY, centerZ, radius, hit + i, t ? t + i : nullptr);
+		}
+	}
+
+	return hitCount;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/// <summary>
+/// SoA形式の線分列(始点と終点)
+/// </summary>
+struct SegmentsSoA {
+	std::span<const float> originX;
+	std::span<const float> originY;
+	std::span<const float> originZ;
+	std::span<const float> endX;
+	std::span<const float> endY;
+	std::span<const float> endZ;
+};
+
+/// <summary>
+/// SoA形式の平面列
+/// </summary>
+struct PlanesSoA {
+	std::span<const float> normalX;
+	std::span<const float> normalY;
+	std::span<const float> normalZ;
+	std::span<const float> distance;
+};
+
+/// <summary>
+/// SoA形式の球列
+/// </summary>
+struct SpheresSoA {
+	std::span<const float> centerX;
+	std::span<const float> centerY;
+	std::span<const float> centerZ;
+	std::span<const float> radius;
+};
+
+/// <summary>
+/// 判定結果の出力先(N本の線分 × M個の相手)
+/// 要素の並びは相手ごとに線分を並べたもの(index = other * N + segment)
+/// tを使わない場合はtを空にする。tは当たった組の要素だけが有効
+/// </summary>
+struct SegmentHitsSoA {
+	std::span<uint8_t> hit;
+	std::span<float> t;
+};
+
+/// <summary>
+/// N本の線分とM枚の平面の判定を一括で行う
+/// IsCollision(Segment, Plane)と同じ判定(端点が平面の両側、または平面上)
+/// tは線分上で平面と交わる位置(0:始点, 1:終点)
+/// </summary>
+/// <returns>当たった組の数</returns>
+size_t IsCollisionBatch(const SegmentsSoA& segments, const PlanesSoA& planes, const SegmentHitsSoA& hits);
+
+/// <summary>
+/// N本の線分とM個の球の判定を一括で行う
+/// tは線分が球に入る位置(始点が球の中なら0)
+/// </summary>
+/// <returns>当たった組の数</returns>
+size_t IsCollisionBatch(const SegmentsSoA& segments, const SpheresSoA& spheres, const SegmentHitsSoA& hits);
@@ -0,0 +1,847 @@
+#include "Contact.h"
+#include "Collision.h"
+#include "MathFunction.h"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace {
+
+	// 正規化できないとみなす長さ
+	const float kDegenerateLength = 1.0e-6f;
+
+	Vector3 Negate(const Vector3& v) {
+		return { -v.x, -v.y, -v.z };
+	}
+
+	Vector3 Midpoint(const Vector3& a, const Vector3& b) {
+		return { (a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f, (a.z + b.z) * 0.5f };
+	}
+
+	// 方向ベクトルに垂直な単位ベクトル(方向が0ならY軸)
+	Vector3 AnyPerpendicular(const Vector3& direction) {
+		if (Dot(direction, direction) <= kDegenerateLength * kDegenerateLength) {
+			return { 0.0f, 1.0f, 0.0f };
+		}
+		return Normalize(Perpendicular(direction));
+	}
+
+	OBB ToOBB(const AABB& aabb) {
+		return {
+			Midpoint(aabb.min, aabb.max),
+			{ { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+			Multiply(0.5f, Subtract(aabb.max, aabb.min)),
+		};
+	}
+
+	float Extent(const OBB& obb, int axis) {
+		return (&obb.size.x)[axis];
+	}
+
+	Vector3 TriangleNormal(const Triangle& triangle) {
+		Vector3 edge1 = Subtract(triangle.vertices[1], triangle.vertices[0]);
+		Vector3 edge2 = Subtract(triangle.vertices[2], triangle.vertices[0]);
+		Vector3 normal;
+		return TryNormalize(Cross(edge1, edge2), normal) ? normal : Vector3{ 0.0f, 1.0f, 0.0f };
+	}
+
+	Vector3 Centroid(const Triangle& triangle) {
+		Vector3 sum = Add(Add(triangle.vertices[0], triangle.vertices[1]), triangle.vertices[2]);
+		return Multiply(1.0f / 3.0f, sum);
+	}
+
+	// OBB上(内部を含む)で点に最も近い点
+	Vector3 ClosestPointOnOBB(const Vector3& point, const OBB& obb) {
+		Vector3 offset = Subtract(point, obb.center);
+		Vector3 result = obb.center;
+		for (int axis = 0; axis < 3; ++axis) {
+			float extent = Extent(obb, axis);
+			float distance = std::clamp(Dot(offset, obb.orientations[axis]), -extent, extent);
+			result = Add(result, Multiply(distance, obb.orientations[axis]));
+		}
+		return result;
+	}
+
+	// 三角形上で点に最も近い点(頂点・辺・面のボロノイ領域で場合分け)
+	Vector3 ClosestPointOnTriangle(const Vector3& point, const Triangle& triangle) {
+		const Vector3& a = triangle.vertices[0];
+		const Vector3& b = triangle.vertices[1];
+		const Vector3& c = triangle.vertices[2];
+		Vector3 ab = Subtract(b, a);
+		Vector3 ac = Subtract(c, a);
+
+		Vector3 ap = Subtract(point, a);
+		float d1 = Dot(ab, ap);
+		float d2 = Dot(ac, ap);
+		if (d1 <= 0.0f && d2 <= 0.0f) {
+			return a;
+		}
+
+		Vector3 bp = Subtract(point, b);
+		float d3 = Dot(ab, bp);
+		float d4 = Dot(ac, bp);
+		if (d3 >= 0.0f && d4 <= d3) {
+			return b;
+		}
+
+		float vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+			return Add(a, Multiply(d1 / (d1 - d3), ab));
+		}
+
+		Vector3 cp = Subtract(point, c);
+		float d5 = Dot(ab, cp);
+		float d6 = Dot(ac, cp);
+		if (d6 >= 0.0f && d5 <= d6) {
+			return c;
+		}
+
+		float vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+			return Add(a, Multiply(d2 / (d2 - d6), ac));
+		}
+
+		float va = d3 * d6 - d5 * d4;
+		if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+			float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+			return Add(b, Multiply(w, Subtract(c, b)));
+		}
+
+		float denominator = 1.0f / (va + vb + vc);
+		return Add(a, Add(Multiply(vb * denominator, ab), Multiply(vc * denominator, ac)));
+	}
+
+	// 2線分の最近接点
+	void ClosestPointsOnSegments(const Segment& segment1, const Segment& segment2, Vector3& closest1, Vector3& closest2) {
+		const float kEpsilon = 1.0e-12f;
+		Vector3 direction1 = Subtract(segment1.diff, segment1.origin);
+		Vector3 direction2 = Subtract(segment2.diff, segment2.origin);
+		Vector3 r = Subtract(segment1.origin, segment2.origin);
+		float a = Dot(direction1, direction1);
+		float e = Dot(direction2, direction2);
+		float f = Dot(direction2, r);
+
+		float s = 0.0f;
+		float t = 0.0f;
+		if (a <= kEpsilon && e <= kEpsilon) {
+			// どちらも点
+		} else if (a <= kEpsilon) {
+			t = std::clamp(f / e, 0.0f, 1.0f);
+		} else {
+			float c = Dot(direction1, r);
+			if (e <= kEpsilon) {
+				s = std::clamp(-c / a, 0.0f, 1.0f);
+			} else {
+				float b = Dot(direction1, direction2);
+				float denominator = a * e - b * b;
+				// 平行なときは始点側から決める
+				s = denominator != 0.0f ? std::clamp((b * f - c * e) / denominator, 0.0f, 1.0f) : 0.0f;
+				t = (b * s + f) / e;
+				if (t < 0.0f) {
+					t = 0.0f;
+					s = std::clamp(-c / a, 0.0f, 1.0f);
+				} else if (t > 1.0f) {
+					t = 1.0f;
+					s = std::clamp((b - c) / a, 0.0f, 1.0f);
+				}
+			}
+		}
+
+		closest1 = Add(segment1.origin, Multiply(s, direction1));
+		closest2 = Add(segment2.origin, Multiply(t, direction2));
+	}
+
+	// 球と、球の外から見た相手の最近接点から接触を作る
+	bool SphereContactFromClosestPoint(const Sphere& sphere, const Vector3& closest, const Vector3& fallbackNormal, Contact& contact) {
+		Vector3 offset = Subtract(closest, sphere.center);
+		float distanceSq = Dot(offset, offset);
+		if (distanceSq > sphere.radius * sphere.radius) {
+			return false;
+		}
+
+		float distance = std::sqrt(distanceSq);
+		contact.normal = distance > kDegenerateLength ? Multiply(1.0f / distance, offset) : fallbackNormal;
+		contact.depth = sphere.radius - distance;
+		contact.point = closest;
+		return true;
+	}
+
+	// 軸への投影区間(箱は中心と半径から直接求める)
+	void ProjectOntoAxis(const OBB& obb, const Vector3& axis, float& min, float& max) {
+		float center = Dot(obb.center, axis);
+		float radius =
+			obb.size.x * std::fabs(Dot(obb.orientations[0], axis)) +
+			obb.size.y * std::fabs(Dot(obb.orientations[1], axis)) +
+			obb.size.z * std::fabs(Dot(obb.orientations[2], axis));
+		min = center - radius;
+		max = center + radius;
+	}
+
+	void ProjectOntoAxis(const Triangle& triangle, const Vector3& axis, float& min, float& max) {
+		float d0 = Dot(triangle.vertices[0], axis);
+		float d1 = Dot(triangle.vertices[1], axis);
+		float d2 = Dot(triangle.vertices[2], axis);
+		min = std::min({ d0, d1, d2 });
+		max = std::max({ d0, d1, d2 });
+	}
+
+	/// <summary>
+	/// 候補軸すべてに投影して、分離していなければ押し出し量が最小の軸を返す
+	/// 長さが0に近い軸(平行な辺どうしの外積)は飛ばす
+	/// </summary>
+	template<typename A, typename B>
+	bool FindMinimumPenetration(const A& a, const B& b, const Vector3* axes, int axisCount, Vector3& normal, float& depth) {
+		depth = INFINITY;
+		for (int i = 0; i < axisCount; ++i) {
+			float lengthSq = Dot(axes[i], axes[i]);
+			if (lengthSq <= kDegenerateLength * kDegenerateLength) {
+				continue;
+			}
+			Vector3 axis = Multiply(1.0f / std::sqrt(lengthSq), axes[i]);
+
+			float minA, maxA, minB, maxB;
+			ProjectOntoAxis(a, axis, minA, maxA);
+			ProjectOntoAxis(b, axis, minB, maxB);
+
+			// Bを+軸方向/-軸方向に押し出す量
+			float positive = maxA - minB;
+			float negative = maxB - minA;
+			if (positive < 0.0f || negative < 0.0f) {
+				return false;
+			}
+
+			if (positive < depth) {
+				depth = positive;
+				normal = axis;
+			}
+			if (negative < depth) {
+				depth = negative;
+				normal = Negate(axis);
+			}
+		}
+		return depth != INFINITY;
+	}
+
+	// 押し出し量が小さい方向を選ぶ(1軸ぶん)
+	void AxisPenetration(float minA, float maxA, float minB, float maxB, float& depth, float& sign) {
+		float positive = maxA - minB;
+		float negative = maxB - minA;
+		if (positive <= negative) {
+			depth = positive;
+			sign = 1.0f;
+		} else {
+			depth = negative;
+			sign = -1.0f;
+		}
+	}
+
+	// 平面への射影での接触(相手の半径radiusと中心の符号付き距離signedDistance)
+	bool PlaneContact(const Plane& plane, const Vector3& center, float radius, Contact& contact) {
+		float signedDistance = Dot(plane.normal, center) - plane.distance;
+		if (std::fabs(signedDistance) > radius) {
+			return false;
+		}
+
+		contact.normal = signedDistance >= 0.0f ? plane.normal : Negate(plane.normal);
+		contact.depth = radius - std::fabs(signedDistance);
+		contact.point = Subtract(center, Multiply(signedDistance, plane.normal));
+		return true;
+	}
+
+	// 線分と三角形の面が平行とみなす角度のsin
+	const float kParallelSine = 1.0e-6f;
+
+	/// <summary>
+	/// 三角形の面と平行な線分との接触(面からkContactEpsilon以内で、三角形と重なる区間があるとき)
+	/// 線分を三角形の3辺の内側の半平面で切り詰め、残った区間の中点を接触点にする
+	/// </summary>
+	bool ComputeCoplanarContact(const Segment& segment, const Triangle& triangle, Contact& contact) {
+		Vector3 normal;
+		Vector3 edge1 = Subtract(triangle.vertices[1], triangle.vertices[0]);
+		Vector3 edge2 = Subtract(triangle.vertices[2], triangle.vertices[0]);
+		if (!TryNormalize(Cross(edge1, edge2), normal)) {
+			return false;
+		}
+		float distanceStart = Dot(normal, Subtract(segment.origin, triangle.vertices[0]));
+		float distanceEnd = Dot(normal, Subtract(segment.diff, triangle.vertices[0]));
+		if (std::fabs(distanceStart) > kContactEpsilon || std::fabs(distanceEnd) > kContactEpsilon) {
+			return false;
+		}
+
+		// 辺iの内側を向く面内の法線との符号付き距離がどちらも-kContactEpsilon以上になるtの範囲
+		Vector3 direction = Subtract(segment.diff, segment.origin);
+		float tEnter = 0.0f;
+		float tExit = 1.0f;
+		for (int i = 0; i < 3; ++i) {
+			const Vector3& vertex = triangle.vertices[i];
+			Vector3 edge = Subtract(triangle.vertices[(i + 1) % 3], vertex);
+			Vector3 inward;
+			if (!TryNormalize(Cross(normal, edge), inward)) {
+				return false;
+			}
+			float start = Dot(inward, Subtract(segment.origin, vertex)) + kContactEpsilon;
+			float rate = Dot(inward, direction);
+			if (rate == 0.0f) {
+				if (start < 0.0f) {
+					return false;
+				}
+				continue;
+			}
+			float t = -start / rate;
+			if (rate > 0.0f) {
+				tEnter = std::max(tEnter, t);
+			} else {
+				tExit = std::min(tExit, t);
+			}
+			if (tEnter > tExit) {
+				return false;
+			}
+		}
+
+		contact.normal = normal;
+		contact.depth = 0.0f;
+		contact.point = Add(segment.origin, Multiply((tEnter + tExit) * 0.5f, direction));
+		return true;
+	}
+
+	typedef bool (*ContactFunction)(const Shape& a, const Shape& b, Contact& contact);
+
+	template<typename T>
+	const T& Get(const Shape& shape) {
+		if constexpr (std::is_same_v<T, Sphere>) {
+			return shape.sphere;
+		} else if constexpr (std::is_same_v<T, Plane>) {
+			return shape.plane;
+		} else if constexpr (std::is_same_v<T, Segment>) {
+			return shape.segment;
+		} else if constexpr (std::is_same_v<T, AABB>) {
+			return shape.aabb;
+		} else if constexpr (std::is_same_v<T, OBB>) {
+			return shape.obb;
+		} else {
+			static_assert(std::is_same_v<T, Triangle>);
+			return shape.triangle;
+		}
+	}
+
+	template<typename A, typename B>
+	bool Dispatch(const Shape& a, const Shape& b, Contact& contact) {
+		return ComputeContact(Get<A>(a), Get<B>(b), contact);
+	}
+
+	// (B, A)の組を(A, B)の関数で判定して法線を反転する
+	template<typename A, typename B>
+	bool DispatchSwapped(const Shape& b, const Shape& a, Contact& contact) {
+		if (!ComputeContact(Get<A>(a), Get<B>(b), contact)) {
+			return false;
+		}
+		contact.normal = Negate(contact.normal);
+		return true;
+	}
+
+	const int kShapeTypeCount = static_cast<int>(Shape::Type::kCount);
+
+	// [Aの種類][Bの種類]
+	const ContactFunction kContactTable[kShapeTypeCount][kShapeTypeCount] = {
+		{ Dispatch<Sphere, Sphere>, Dispatch<Sphere, Plane>, Dispatch<Sphere, Segment>, Dispatch<Sphere, AABB>, Dispatch<Sphere, OBB>, Dispatch<Sphere, Triangle> },
+		{ DispatchSwapped<Sphere, Plane>, Dispatch<Plane, Plane>, Dispatch<Plane, Segment>, Dispatch<Plane, AABB>, Dispatch<Plane, OBB>, Dispatch<Plane, Triangle> },
+		{ DispatchSwapped<Sphere, Segment>, DispatchSwapped<Plane, Segment>, Dispatch<Segment, Segment>, Dispatch<Segment, AABB>, Dispatch<Segment, OBB>, Dispatch<Segment, Triangle> },
+		{ DispatchSwapped<Sphere, AABB>, DispatchSwapped<Plane, AABB>, DispatchSwapped<Segment, AABB>, Dispatch<AABB, AABB>, Dispatch<AABB, OBB>, Dispatch<AABB, Triangle> },
+		{ DispatchSwapped<Sphere, OBB>, DispatchSwapped<Plane, OBB>, DispatchSwapped<Segment, OBB>, DispatchSwapped<AABB, OBB>, Dispatch<OBB, OBB>, Dispatch<OBB, Triangle> },
+		{ DispatchSwapped<Sphere, Triangle>, DispatchSwapped<Plane, Triangle>, DispatchSwapped<Segment, Triangle>, DispatchSwapped<AABB, Triangle>, DispatchSwapped<OBB, Triangle>, Dispatch<Triangle, Triangle> },
+	};
+
+}
+
+Shape MakeShape(const Sphere& sphere)
+{
+	Shape shape;
+	shape.type = Shape::Type::kSphere;
+	shape.sphere = sphere;
+	return shape;
+}
+
+Shape MakeShape(const Plane& plane)
+{
+	Shape shape;
+	shape.type = Shape::Type::kPlane;
+	shape.plane = plane;
+	return shape;
+}
+
+Shape MakeShape(const Segment& segment)
+{
+	Shape shape;
+	shape.type = Shape::Type::kSegment;
+	shape.segment = segment;
+	return shape;
+}
+
+Shape MakeShape(const AABB& aabb)
+{
+	Shape shape;
+	shape.type = Shape::Type::kAABB;
+	shape.aabb = aabb;
+	return shape;
+}
+
+Shape MakeShape(const OBB& obb)
+{
+	Shape shape;
+	shape.type = Shape::Type::kOBB;
+	shape.obb = obb;
+	return shape;
+}
+
+Shape MakeShape(const Triangle& triangle)
+{
+	Shape shape;
+	shape.type = Shape::Type::kTriangle;
+	shape.triangle = triangle;
+	return shape;
+}
+
+bool ComputeContact(const Shape& a, const Shape& b, Contact& contact)
+{
+	return kContactTable[static_cast<int>(a.type)][static_cast<int>(b.type)](a, b, contact);
+}
+
+bool ComputeContact(const Sphere& a, const Sphere& b, Contact& contact)
+{
+	Vector3 offset = Subtract(b.center, a.center);
+	float radiusSum = a.radius + b.radius;
+	float distanceSq = Dot(offset, offset);
+	if (distanceSq > radiusSum * radiusSum) {
+		return false;
+	}
+
+	float distance = std::sqrt(distanceSq);
+	contact.normal = distance > kDegenerateLength ? Multiply(1.0f / distance, offset) : Vector3{ 0.0f, 1.0f, 0.0f };
+	contact.depth = radiusSum - distance;
+	// めり込んだ領域の真ん中
+	contact.point = Add(a.center, Multiply(a.radius - contact.depth * 0.5f, contact.normal));
+	return true;
+}
+
+bool ComputeContact(const Sphere& a, const Plane& b, Contact& contact)
+{
+	if (!PlaneContact(b, a.center, a.radius, contact)) {
+		return false;
+	}
+	contact.normal = Negate(contact.normal);
+	return true;
+}
+
+bool ComputeContact(const Sphere& a, const Segment& b, Contact& contact)
+{
+	Vector3 closest = ClosestPoint(a.center, b);
+	return SphereContactFromClosestPoint(a, closest, AnyPerpendicular(Subtract(b.diff, b.origin)), contact);
+}
+
+bool ComputeContact(const Sphere& a, const AABB& b, Contact& contact)
+{
+	return ComputeContact(a, ToOBB(b), contact);
+}
+
+bool ComputeContact(const Sphere& a, const OBB& b, Contact& contact)
+{
+	Vector3 offset = Subtract(a.center, b.center);
+	float local[3];
+	bool inside = true;
+	for (int axis = 0; axis < 3; ++axis) {
+		local[axis] = Dot(offset, b.orientations[axis]);
+		inside = inside && std::fabs(local[axis]) <= Extent(b, axis);
+	}
+
+	if (!inside) {
+		return SphereContactFromClosestPoint(a, ClosestPointOnOBB(a.center, b), { 0.0f, 1.0f, 0.0f }, contact);
+	}
+
+	// 中心が箱の中にあるときは一番近い面から押し出す
+	int nearest = 0;
+	float nearestDistance = INFINITY;
+	for (int axis = 0; axis < 3; ++axis) {
+		float distance = Extent(b, axis) - std::fabs(local[axis]);
+		if (distance < nearestDistance) {
+			nearestDistance = distance;
+			nearest = axis;
+		}
+	}
+
+	Vector3 faceNormal = local[nearest] >= 0.0f ? b.orientations[nearest] : Negate(b.orientations[nearest]);
+	contact.normal = Negate(faceNormal);
+	contact.depth = a.radius + nearestDistance;
+	contact.point = a.center;
+	return true;
+}
+
+bool ComputeContact(const Sphere& a, const Triangle& b, Contact& contact)
+{
+	Vector3 closest = ClosestPointOnTriangle(a.center, b);
+	return SphereContactFromClosestPoint(a, closest, TriangleNormal(b), contact);
+}
+
+bool ComputeContact(const Plane& a, const Plane& b, Contact& contact)
+{
+	Vector3 direction = Cross(a.normal, b.normal);
+	float lengthSq = Dot(direction, direction);
+	if (lengthSq <= kDegenerateLength * kDegenerateLength) {
+		// 平行なときは同じ平面のときだけ接触
+		float distanceB = Dot(a.normal, b.normal) >= 0.0f ? b.distance : -b.distance;
+		if (std::fabs(distanceB - a.distance) > kContactEpsilon) {
+			return false;
+		}
+		contact.point = Multiply(a.distance, a.normal);
+	} else {
+		// 交線上の点
+		Vector3 numerator = Subtract(Multiply(a.distance, b.normal), Multiply(b.distance, a.normal));
+		contact.point = Multiply(1.0f / lengthSq, Cross(numerator, direction));
+	}
+
+	contact.normal = a.normal;
+	contact.depth = 0.0f;
+	return true;
+}
+
+bool ComputeContact(const Plane& a, const Segment& b, Contact& contact)
+{
+	float distanceStart = Dot(a.normal, b.origin) - a.distance;
+	float distanceEnd = Dot(a.normal, b.diff) - a.distance;
+	if (distanceStart * distanceEnd > 0.0f) {
+		return false;
+	}
+
+	// 平面から遠い方の端点がある側へ押し出す
+	float side = std::fabs(distanceStart) >= std::fabs(distanceEnd) ? distanceStart : distanceEnd;
+	contact.normal = side >= 0.0f ? a.normal : Negate(a.normal);
+	contact.depth = std::min(std::fabs(distanceStart), std::fabs(distanceEnd));
+
+	float denominator = distanceStart - distanceEnd;
+	float t = denominator != 0.0f ? distanceStart / denominator : 0.0f;
+	contact.point = Add(b.origin, Multiply(t, Subtract(b.diff, b.origin)));
+	return true;
+}
+
+bool ComputeContact(const Plane& a, const AABB& b, Contact& contact)
+{
+	// AABBの平面法線方向の半径
+	Vector3 center = Midpoint(b.min, b.max);
+	Vector3 extent = Multiply(0.5f, Subtract(b.max, b.min));
+	float radius = extent.x * std::fabs(a.normal.x) + extent.y * std::fabs(a.normal.y) + extent.z * std::fabs(a.normal.z);
+	return PlaneContact(a, center, radius, contact);
+}
+
+bool ComputeContact(const Plane& a, const OBB& b, Contact& contact)
+{
+	float radius = 0.0f;
+	for (int axis = 0; axis < 3; ++axis) {
+		radius += Extent(b, axis) * std::fabs(Dot(a.normal, b.orientations[axis]));
+	}
+	return PlaneContact(a, b.center, radius, contact);
+}
+
+bool ComputeContact(const Plane& a, const Triangle& b, Contact& contact)
+{
+	float distances[3];
+	float sum = 0.0f;
+	for (int i = 0; i < 3; ++i) {
+		distances[i] = Dot(a.normal, b.vertices[i]) - a.distance;
+		sum += distances[i];
+	}
+	float minDistance = std::min({ distances[0], distances[1], distances[2] });
+	float maxDistance = std::max({ distances[0], distances[1], distances[2] });
+	if (minDistance > 0.0f || maxDistance < 0.0f) {
+		return false;
+	}
+
+	// 頂点が多く残っている側へ押し出す
+	bool positive = sum >= 0.0f;
+	contact.normal = positive ? a.normal : Negate(a.normal);
+	contact.depth = positive ? -minDistance : maxDistance;
+
+	// 辺と平面の交点の平均
+	Vector3 sumPoint = { 0.0f, 0.0f, 0.0f };
+	int count = 0;
+	for (int i = 0; i < 3; ++i) {
+		int j = (i + 1) % 3;
+		if (distances[i] * distances[j] > 0.0f) {
+			continue;
+		}
+		float denominator = distances[i] - distances[j];
+		float t = denominator != 0.0f ? distances[i] / denominator : 0.0f;
+		sumPoint = Add(sumPoint, Add(b.vertices[i], Multiply(t, Subtract(b.vertices[j], b.vertices[i]))));
+		++count;
+	}
+	contact.point = Multiply(1.0f / static_cast<float>(count), sumPoint);
+	return true;
+}
+
+bool ComputeContact(const Segment& a, const Segment& b, Contact& contact)
+{
+	Vector3 closestA, closestB;
+	ClosestPointsOnSegments(a, b, closestA, closestB);
+
+	Vector3 offset = Subtract(closestB, closestA);
+	float distanceSq = Dot(offset, offset);
+	if (distanceSq > kContactEpsilon * kContactEpsilon) {
+		return false;
+	}
+
+	// 交差しているときは2本に垂直な向きを法線にする
+	Vector3 directionA = Subtract(a.diff, a.origin);
+	Vector3 fallback;
+	if (!TryNormalize(Cross(directionA, Subtract(b.diff, b.origin)), fallback)) {
+		fallback = AnyPerpendicular(directionA);
+	}
+	float distance = std::sqrt(distanceSq);
+	contact.normal = distance > kDegenerateLength ? Multiply(1.0f / distance, offset) : fallback;
+	contact.depth = kContactEpsilon - distance;
+	contact.point = Midpoint(closestA, closestB);
+	return true;
+}
+
+bool ComputeContact(const Segment& a, const AABB& b, Contact& contact)
+{
+	return ComputeContact(a, ToOBB(b), contact);
+}
+
+bool ComputeContact(const Segment& a, const OBB& b, Contact& contact)
+{
+	// OBBのローカル座標でスラブ法
+	Vector3 start = Subtract(a.origin, b.center);
+	Vector3 end = Subtract(a.diff, b.center);
+	float origin[3];
+	float direction[3];
+	for (int axis = 0; axis < 3; ++axis) {
+		origin[axis] = Dot(start, b.orientations[axis]);
+		direction[axis] = Dot(end, b.orientations[axis]) - origin[axis];
+	}
+
+	float tEnter = 0.0f;
+	float tExit = 1.0f;
+	int enterAxis = -1;
+	for (int axis = 0; axis < 3; ++axis) {
+		float extent = Extent(b, axis);
+		if (std::fabs(direction[axis]) <= kDegenerateLength) {
+			if (std::fabs(origin[axis]) > extent) {
+				return false;
+			}
+			continue;
+		}
+
+		float inverse = 1.0f / direction[axis];
+		float t0 = (-extent - origin[axis]) * inverse;
+		float t1 = (extent - origin[axis]) * inverse;
+		if (t0 > t1) {
+			std::swap(t0, t1);
+		}
+		if (t0 > tEnter) {
+			tEnter = t0;
+			enterAxis = axis;
+		}
+		tExit = std::min(tExit, t1);
+		if (tEnter > tExit) {
+			return false;
+		}
+	}
+
+	// 入った面(始点が中にあるときは始点に一番近い面)
+	int axis = enterAxis;
+	float faceSign;
+	if (axis < 0) {
+		float nearestDistance = INFINITY;
+		for (int i = 0; i < 3; ++i) {
+			float distance = Extent(b, i) - std::fabs(origin[i]);
+			if (distance < nearestDistance) {
+				nearestDistance = distance;
+				axis = i;
+			}
+		}
+		faceSign = origin[axis] >= 0.0f ? 1.0f : -1.0f;
+	} else {
+		faceSign = direction[axis] > 0.0f ? -1.0f : 1.0f;
+	}
+
+	// 面より奥に入った端点の深さ(箱の厚みまで)
+	float extent = Extent(b, axis);
+	float depthStart = extent - faceSign * origin[axis];
+	float depthEnd = extent - faceSign * (origin[axis] + direction[axis]);
+	contact.depth = std::clamp(std::max(depthStart, depthEnd), 0.0f, 2.0f * extent);
+	contact.normal = Multiply(-faceSign, b.orientations[axis]);
+	contact.point = Add(a.origin, Multiply(tEnter, Subtract(a.diff, a.origin)));
+	return true;
+}
+
+bool ComputeContact(const Segment& a, const Triangle& b, Contact& contact)
+{
+	// Möller–Trumbore
+	Vector3 direction = Subtract(a.diff, a.origin);
+	Vector3 edge1 = Subtract(b.vertices[1], b.vertices[0]);
+	Vector3 edge2 = Subtract(b.vertices[2], b.vertices[0]);
+	Vector3 p = Cross(direction, edge2);
+	float determinant = Dot(edge1, p);
+
+	// determinant = direction・(edge2×edge1)なので、長さの積と比べて平行かを決める(大きさによらない)
+	Vector3 faceNormal = Cross(edge1, edge2);
+	float scale = std::sqrt(Dot(direction, direction) * Dot(faceNormal, faceNormal));
+	if (!(std::fabs(determinant) > kParallelSine * scale)) {
+		return ComputeCoplanarContact(a, b, contact);
+	}
+
+	float inverse = 1.0f / determinant;
+	Vector3 s = Subtract(a.origin, b.vertices[0]);
+	float u = Dot(s, p) * inverse;
+	if (u < 0.0f || u > 1.0f) {
+		return false;
+	}
+	Vector3 q = Cross(s, edge1);
+	float v = Dot(direction, q) * inverse;
+	if (v < 0.0f || u + v > 1.0f) {
+		return false;
+	}
+	float t = Dot(edge2, q) * inverse;
+	if (t < 0.0f || t > 1.0f) {
+		return false;
+	}
+
+	// 線分の長い方が残る側から三角形を押し出す
+	Vector3 normal = TriangleNormal(b);
+	float distanceStart = Dot(normal, s);
+	float distanceEnd = Dot(normal, Subtract(a.diff, b.vertices[0]));
+	float side = std::fabs(distanceStart) >= std::fabs(distanceEnd) ? distanceStart : distanceEnd;
+	contact.normal = side >= 0.0f ? Negate(normal) : normal;
+	contact.depth = std::min(std::fabs(distanceStart), std::fabs(distanceEnd));
+	contact.point = Add(a.origin, Multiply(t, direction));
+	return true;
+}
+
+bool ComputeContact(const AABB& a, const AABB& b, Contact& contact)
+{
+	const float* minA = &a.min.x;
+	const float* maxA = &a.max.x;
+	const float* minB = &b.min.x;
+	const float* maxB = &b.max.x;
+
+	float depth = INFINITY;
+	int axis = 0;
+	float sign = 1.0f;
+	for (int i = 0; i < 3; ++i) {
+		if (minA[i] > maxB[i] || minB[i] > maxA[i]) {
+			return false;
+		}
+		float axisDepth, axisSign;
+		AxisPenetration(minA[i], maxA[i], minB[i], maxB[i], axisDepth, axisSign);
+		if (axisDepth < depth) {
+			depth = axisDepth;
+			axis = i;
+			sign = axisSign;
+		}
+	}
+
+	contact.normal = { 0.0f, 0.0f, 0.0f };
+	(&contact.normal.x)[axis] = sign;
+	contact.depth = depth;
+	// 重なっている箱の中心
+	contact.point = Midpoint(
+		{ std::max(a.min.x, b.min.x), std::max(a.min.y, b.min.y), std::max(a.min.z, b.min.z) },
+		{ std::min(a.max.x, b.max.x), std::min(a.max.y, b.max.y), std::min(a.max.z, b.max.z) });
+	return true;
+}
+
+bool ComputeContact(const AABB& a, const OBB& b, Contact& contact)
+{
+	return ComputeContact(ToOBB(a), b, contact);
+}
+
+bool ComputeContact(const AABB& a, const Triangle& b, Contact& contact)
+{
+	return ComputeContact(ToOBB(a), b, contact);
+}
+
+bool ComputeContact(const OBB& a, const OBB& b, Contact& contact)
+{
+	// 面法線6本 + 辺どうしの外積9本
+	Vector3 axes[15];
+	int count = 0;
+	for (int i = 0; i < 3; ++i) {
+		axes[count++] = a.orientations[i];
+		axes[count++] = b.orientations[i];
+	}
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			axes[count++] = Cross(a.orientations[i], b.orientations[j]);
+		}
+	}
+
+	if (!FindMinimumPenetration(a, b, axes, count, contact.normal, contact.depth)) {
+		return false;
+	}
+
+	Vector3 closestA = ClosestPointOnOBB(b.center, a);
+	contact.point = Midpoint(closestA, ClosestPointOnOBB(closestA, b));
+	return true;
+}
+
+bool ComputeContact(const OBB& a, const Triangle& b, Contact& contact)
+{
+	// 箱の面法線3本 + 三角形の法線 + 辺どうしの外積9本
+	Vector3 edges[3] = {
+		Subtract(b.vertices[1], b.vertices[0]),
+		Subtract(b.vertices[2], b.vertices[1]),
+		Subtract(b.vertices[0], b.vertices[2]),
+	};
+	Vector3 axes[13];
+	int count = 0;
+	for (int i = 0; i < 3; ++i) {
+		axes[count++] = a.orientations[i];
+	}
+	axes[count++] = Cross(edges[0], edges[1]);
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			axes[count++] = Cross(a.orientations[i], edges[j]);
+		}
+	}
+
+	if (!FindMinimumPenetration(a, b, axes, count, contact.normal, contact.depth)) {
+		return false;
+	}
+
+	Vector3 closestB = ClosestPointOnTriangle(a.center, b);
+	contact.point = Midpoint(ClosestPointOnOBB(closestB, a), closestB);
+	return true;
+}
+
+bool ComputeContact(const Triangle& a, const Triangle& b, Contact& contact)
+{
+	// 法線2本 + 辺どうしの外積9本 + 同一平面上で重なるとき用の面内の辺法線6本
+	Vector3 edgesA[3];
+	Vector3 edgesB[3];
+	for (int i = 0; i < 3; ++i) {
+		edgesA[i] = Subtract(a.vertices[(i + 1) % 3], a.vertices[i]);
+		edgesB[i] = Subtract(b.vertices[(i + 1) % 3], b.vertices[i]);
+	}
+	Vector3 normalA = Cross(edgesA[0], edgesA[1]);
+	Vector3 normalB = Cross(edgesB[0], edgesB[1]);
+
+	Vector3 axes[17];
+	int count = 0;
+	axes[count++] = normalA;
+	axes[count++] = normalB;
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			axes[count++] = Cross(edgesA[i], edgesB[j]);
+		}
+	}
+	for (int i = 0; i < 3; ++i) {
+		axes[count++] = Cross(normalA, edgesA[i]);
+		axes[count++] = Cross(normalB, edgesB[i]);
+	}
+
+	if (!FindMinimumPenetration(a, b, axes, count, contact.normal, contact.depth)) {
+		return false;
+	}
+
+	Vector3 closestA = ClosestPointOnTriangle(Centroid(b), a);
+	contact.point = Midpoint(closestA, ClosestPointOnTriangle(closestA, b));
+	return true;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "Primitive.h"
+#include <cstdint>
+
+/// <summary>
+/// 2つの形状の接触情報
+/// normalはAからBへ向かう単位ベクトルで、Bをnormal * depthだけ動かすと離れる
+/// </summary>
+typedef struct Contact {
+	Vector3 point;// 接触点
+	Vector3 normal;// 法線(A→B)
+	float depth;// めり込み量(接しているだけなら0)
+}Contact;
+
+/// <summary>
+/// 種類つきの形状
+/// 仮想関数は使わず、ComputeContactが種類の組からテーブルを引いて関数を呼び分ける
+/// </summary>
+typedef struct Shape {
+	// 形状の種類(接触判定テーブルの添え字。BroadPhase::ShapeType/Scene::ShapeTypeとは並びが違う)
+	enum class Type : uint8_t {
+		kSphere,
+		kPlane,
+		kSegment,
+		kAABB,
+		kOBB,
+		kTriangle,
+		kCount,
+	};
+
+	Type type;
+	union {
+		Sphere sphere;
+		Plane plane;
+		Segment segment;
+		AABB aabb;
+		OBB obb;
+		Triangle triangle;
+	};
+}Shape;
+
+Shape MakeShape(const Sphere& sphere);
+Shape MakeShape(const Plane& plane);
+Shape MakeShape(const Segment& segment);
+Shape MakeShape(const AABB& aabb);
+Shape MakeShape(const OBB& obb);
+Shape MakeShape(const Triangle& triangle);
+
+/// <summary>
+/// 種類の組から接触判定を呼び分ける
+/// </summary>
+/// <returns>接触していればtrue(falseのときcontactは不定)</returns>
+bool ComputeContact(const Shape& a, const Shape& b, Contact& contact);
+
+// 線分同士のように厚みのない組み合わせで、接触とみなす距離
+const float kContactEpsilon = 1.0e-4f;
+
+// 以下は型ごとの接触判定(Shape::Typeの順で A <= B の組だけ用意し、逆の組はテーブルで法線を反転する)
+// 平面は両面とも表として扱い、法線は平面から相手のある側を向く
+
+bool ComputeContact(const Sphere& a, const Sphere& b, Contact& contact);
+bool ComputeContact(const Sphere& a, const Plane& b, Contact& contact);
+bool ComputeContact(const Sphere& a, const Segment& b, Contact& contact);
+bool ComputeContact(const Sphere& a, const AABB& b, Contact& contact);
+bool ComputeContact(const Sphere& a, const OBB& b, Contact& contact);
+bool ComputeContact(const Sphere& a, const Triangle& b, Contact& contact);
+
+/// <summary>
+/// 平行でない2平面は必ず交わるので、交線上の点とdepth=0を返す
+/// </summary>
+bool ComputeContact(const Plane& a, const Plane& b, Contact& contact);
+bool ComputeContact(const Plane& a, const Segment& b, Contact& contact);
+bool ComputeContact(const Plane& a, const AABB& b, Contact& contact);
+bool ComputeContact(const Plane& a, const OBB& b, Contact& contact);
+bool ComputeContact(const Plane& a, const Triangle& b, Contact& contact);
+
+/// <summary>
+/// 最近接点どうしの距離がkContactEpsilon以下なら接触とみなす
+/// </summary>
+bool ComputeContact(const Segment& a, const Segment& b, Contact& contact);
+bool ComputeContact(const Segment& a, const AABB& b, Contact& contact);
+bool ComputeContact(const Segment& a, const OBB& b, Contact& contact);
+
+/// <summary>
+/// 三角形の面と平行な線分は、面からkContactEpsilon以内にあって三角形と重なるときだけ接触とする
+/// そのときはdepth=0、法線は三角形の法線(表側)、接触点は重なっている区間の中点
+/// 面積が0の三角形とは接触しない
+/// </summary>
+bool ComputeContact(const Segment& a, const Triangle& b, Contact& contact);
+
+bool ComputeContact(const AABB& a, const AABB& b, Contact& contact);
+bool ComputeContact(const AABB& a, const OBB& b, Contact& contact);
+bool ComputeContact(const AABB& a, const Triangle& b, Contact& contact);
+
+/// <summary>
+/// 分離軸判定。接触点は両者の最近接点の中点による近似
+/// </summary>
+bool ComputeContact(const OBB& a, const OBB& b, Contact& contact);
+bool ComputeContact(const OBB& a, const Triangle& b, Contact& contact);
+
+bool ComputeContact(const Triangle& a, const Triangle& b, Contact& contact);
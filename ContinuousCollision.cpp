@@ -0,0 +1,245 @@
+#include "ContinuousCollision.h"
+#include "MathFunction.h"
+#include "SimdFloat.h"
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+
+namespace {
+
+	// 球i..i+幅と1枚の平面
+	template<typename F>
+	uint32_t SweptSpherePlaneKernel(const SpheresSoA& spheres, const PointsSoA& displacements, size_t i, F normalX, F normalY, F normalZ, F distance, uint8_t* hit, float* timeOfImpact) {
+		F centerX = F::Load(&spheres.centerX[i]);
+		F centerY = F::Load(&spheres.centerY[i]);
+		F centerZ = F::Load(&spheres.centerZ[i]);
+		F radius = F::Load(&spheres.radius[i]);
+		F displacementX = F::Load(&displacements.x[i]);
+		F displacementY = F::Load(&displacements.y[i]);
+		F displacementZ = F::Load(&displacements.z[i]);
+
+		F zero = F::Broadcast(0.0f);
+		F one = F::Broadcast(1.0f);
+
+		// 開始時の符号付き距離と、1フレームで近づく量(中心のある側から平面へ向かう速さ)
+		F startDistance = normalX * centerX + normalY * centerY + normalZ * centerZ - distance;
+		F speed = normalX * displacementX + normalY * displacementY + normalZ * displacementZ;
+		typename F::Mask front = startDistance >= zero;
+		F gap = F::Select(front, startDistance, zero - startDistance) - radius;
+		F closing = F::Select(front, zero - speed, speed);
+
+		typename F::Mask touching = gap <= zero;
+		typename F::Mask approaching = closing > zero;
+		F t = gap / F::Select(approaching, closing, one);
+		typename F::Mask reaches = approaching & (t <= one);
+
+		typename F::Mask isHit = touching | reaches;
+		if (timeOfImpact) {
+			F::Select(touching, zero, F::Select(reaches, t, zero)).Store(timeOfImpact);
+		}
+		return StoreMaskBytes(isHit, F::kWidth, hit);
+	}
+
+	// 線分i..i+幅と1枚の平面
+	template<typename F>
+	uint32_t SweptSegmentPlaneKernel(const SegmentsSoA& starts, const SegmentsSoA& ends, size_t i, F normalX, F normalY, F normalZ, F distance, uint8_t* hit, float* timeOfImpact) {
+		// 各端点の開始時と終了時の符号付き距離(時刻tでは線形補間になる)
+		F originStart = normalX * F::Load(&starts.originX[i]) + normalY * F::Load(&starts.originY[i]) + normalZ * F::Load(&starts.originZ[i]) - distance;
+		F endStart = normalX * F::Load(&starts.endX[i]) + normalY * F::Load(&starts.endY[i]) + normalZ * F::Load(&starts.endZ[i]) - distance;
+		F originEnd = normalX * F::Load(&ends.originX[i]) + normalY * F::Load(&ends.originY[i]) + normalZ * F::Load(&ends.originZ[i]) - distance;
+		F endEnd = normalX * F::Load(&ends.endX[i]) + normalY * F::Load(&ends.endY[i]) + normalZ * F::Load(&ends.endZ[i]) - distance;
+
+		F zero = F::Broadcast(0.0f);
+		F one = F::Broadcast(1.0f);
+
+		// 開始時に平面をまたいでいれば0
+		typename F::Mask touching = originStart * endStart <= zero;
+
+		// またいでいなければ両端は同じ側にあるので、その側を正にそろえて、どちらかの端点が0になる時刻を求める
+		typename F::Mask front = originStart >= zero;
+		F originFrom = F::Select(front, originStart, zero - originStart);
+		F originTo = F::Select(front, originEnd, zero - originEnd);
+		F endFrom = F::Select(front, endStart, zero - endStart);
+		F endTo = F::Select(front, endEnd, zero - endEnd);
+
+		typename F::Mask originCrosses = originTo <= zero;
+		typename F::Mask endCrosses = endTo <= zero;
+		F originT = originFrom / F::Select(originCrosses, originFrom - originTo, one);
+		F endT = endFrom / F::Select(endCrosses, endFrom - endTo, one);
+		F t = F::Min(F::Select(originCrosses, originT, one), F::Select(endCrosses, endT, one));
+
+		typename F::Mask reaches = originCrosses | endCrosses;
+		typename F::Mask isHit = touching | reaches;
+		if (timeOfImpact) {
+			F::Select(touching, zero, F::Select(reaches, t, zero)).Store(timeOfImpact);
+		}
+		return StoreMaskBytes(isHit, F::kWidth, hit);
+	}
+
+	// 平面ごとに、動く形状をSIMD幅ずつ判定する
+	template<typename Kernel>
+	size_t ForEachPlane(size_t count, const PlanesSoA& planes, const SweepHitsSoA& hits, Kernel&& kernel) {
+		const size_t planeCount = planes.distance.size();
+		assert(hits.hit.size() >= count * planeCount);
+		assert(hits.timeOfImpact.empty() || hits.timeOfImpact.size() >= count * planeCount);
+
+		size_t hitCount = 0;
+		for (size_t j = 0; j < planeCount; ++j) {
+			uint8_t* hit = hits.hit.data() + j * count;
+			float* timeOfImpact = hits.timeOfImpact.empty() ? nullptr : hits.timeOfImpact.data() + j * count;
+
+			size_t i = 0;
+			{
+				VectorFloat normalX = VectorFloat::Broadcast(planes.normalX[j]);
+				VectorFloat normalY = VectorFloat::Broadcast(planes.normalY[j]);
+				VectorFloat normalZ = VectorFloat::Broadcast(planes.normalZ[j]);
+				VectorFloat distance = VectorFloat::Broadcast(planes.distance[j]);
+				for (; i + VectorFloat::kWidth <= count; i += VectorFloat::kWidth) {
+					hitCount += kernel(i, normalX, normalY, normalZ, distance, hit + i, timeOfImpact ? timeOfImpact + i : nullptr);
+				}
+			}
+
+			ScalarFloat normalX = ScalarFloat::Broadcast(planes.normalX[j]);
+			ScalarFloat normalY = ScalarFloat::Broadcast(planes.normalY[j]);
+			ScalarFloat normalZ = ScalarFloat::Broadcast(planes.normalZ[j]);
+			ScalarFloat distance = ScalarFloat::Broadcast(planes.distance[j]);
+			for (; i < count; ++i) {
+				hitCount += kernel(i, normalX, normalY, normalZ, distance, hit + i, timeOfImpact ? timeOfImpact + i : nullptr);
+			}
+		}
+		return hitCount;
+	}
+
+	AABB MakeBounds(const Vector3& a, const Vector3& b) {
+		return {
+			{ std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z) },
+			{ std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z) },
+		};
+	}
+
+	AABB Merge(const AABB& a, const AABB& b) {
+		return {
+			{ std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z) },
+			{ std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z) },
+		};
+	}
+
+}
+
+bool ComputeTimeOfImpact(const Sphere& sphere, const Vector3& displacement, const Plane& plane, float& timeOfImpact)
+{
+	float centerX = sphere.center.x, centerY = sphere.center.y, centerZ = sphere.center.z, radius = sphere.radius;
+	float displacementX = displacement.x, displacementY = displacement.y, displacementZ = displacement.z;
+	SpheresSoA spheres = { { &centerX, 1 }, { &centerY, 1 }, { &centerZ, 1 }, { &radius, 1 } };
+	PointsSoA displacements = { { &displacementX, 1 }, { &displacementY, 1 }, { &displacementZ, 1 } };
+
+	uint8_t hit = 0;
+	float t = 0.0f;
+	SweptSpherePlaneKernel(spheres, displacements, 0,
+		ScalarFloat::Broadcast(plane.normal.x), ScalarFloat::Broadcast(plane.normal.y), ScalarFloat::Broadcast(plane.normal.z), ScalarFloat::Broadcast(plane.distance),
+		&hit, &t);
+	if (hit) {
+		timeOfImpact = t;
+	}
+	return hit != 0;
+}
+
+bool ComputeTimeOfImpact(const Sphere& sphere1, const Vector3& displacement1, const Sphere& sphere2, const Vector3& displacement2, float& timeOfImpact)
+{
+	// sphere2から見たsphere1の相対運動で |offset + t * velocity| = r1 + r2 を解く
+	Vector3 offset = Subtract(sphere1.center, sphere2.center);
+	Vector3 velocity = Subtract(displacement1, displacement2);
+	float radius = sphere1.radius + sphere2.radius;
+
+	float c = Dot(offset, offset) - radius * radius;
+	if (c <= 0.0f) {
+		timeOfImpact = 0.0f;
+		return true;
+	}
+
+	float a = Dot(velocity, velocity);
+	float b = Dot(offset, velocity);
+	if (a == 0.0f || b >= 0.0f) {
+		// 動いていないか、離れていく
+		return false;
+	}
+
+	float discriminant = b * b - a * c;
+	if (discriminant < 0.0f) {
+		return false;
+	}
+
+	float t = (-b - std::sqrt(discriminant)) / a;
+	if (t > 1.0f) {
+		return false;
+	}
+	timeOfImpact = t;
+	return true;
+}
+
+bool ComputeTimeOfImpact(const Segment& start, const Segment& end, const Plane& plane, float& timeOfImpact)
+{
+	float values[4][6] = {
+		{ start.origin.x, start.origin.y, start.origin.z, start.diff.x, start.diff.y, start.diff.z },
+		{ end.origin.x, end.origin.y, end.origin.z, end.diff.x, end.diff.y, end.diff.z },
+	};
+	SegmentsSoA starts = { { &values[0][0], 1 }, { &values[0][1], 1 }, { &values[0][2], 1 }, { &values[0][3], 1 }, { &values[0][4], 1 }, { &values[0][5], 1 } };
+	SegmentsSoA ends = { { &values[1][0], 1 }, { &values[1][1], 1 }, { &values[1][2], 1 }, { &values[1][3], 1 }, { &values[1][4], 1 }, { &values[1][5], 1 } };
+
+	uint8_t hit = 0;
+	float t = 0.0f;
+	SweptSegmentPlaneKernel(starts, ends, 0,
+		ScalarFloat::Broadcast(plane.normal.x), ScalarFloat::Broadcast(plane.normal.y), ScalarFloat::Broadcast(plane.normal.z), ScalarFloat::Broadcast(plane.distance),
+		&hit, &t);
+	if (hit) {
+		timeOfImpact = t;
+	}
+	return hit != 0;
+}
+
+AABB MakeSweptAABB(const Sphere& sphere, const Vector3& displacement)
+{
+	AABB aabb = MakeBounds(sphere.center, Add(sphere.center, displacement));
+	aabb.min = { aabb.min.x - sphere.radius, aabb.min.y - sphere.radius, aabb.min.z - sphere.radius };
+	aabb.max = { aabb.max.x + sphere.radius, aabb.max.y + sphere.radius, aabb.max.z + sphere.radius };
+	return aabb;
+}
+
+AABB MakeSweptAABB(const Segment& start, const Segment& end)
+{
+	// 端点は直線的に動くので、4つの端点を囲めば途中の線分もすべて入る
+	return Merge(MakeBounds(start.origin, start.diff), MakeBounds(end.origin, end.diff));
+}
+
+size_t ComputeTimeOfImpactBatch(const SpheresSoA& spheres, const PointsSoA& displacements, const PlanesSoA& planes, const SweepHitsSoA& hits)
+{
+	const size_t count = spheres.radius.size();
+	assert(spheres.centerX.size() == count && spheres.centerY.size() == count && spheres.centerZ.size() == count);
+	assert(displacements.x.size() == count && displacements.y.size() == count && displacements.z.size() == count);
+
+	return ForEachPlane(count, planes, hits, [&](size_t i, auto normalX, auto normalY, auto normalZ, auto distance, uint8_t* hit, float* timeOfImpact) {
+		return SweptSpherePlaneKernel(spheres, displacements, i, normalX, normalY, normalZ, distance, hit, timeOfImpact);
+		});
+}
+
+size_t ComputeTimeOfImpactBatch(const SegmentsSoA& starts, const SegmentsSoA& ends, const PlanesSoA& planes, const SweepHitsSoA& hits)
+{
+	const size_t count = starts.originX.size();
+	assert(ends.originX.size() == count);
+
+	return ForEachPlane(count, planes, hits, [&](size_t i, auto normalX, auto normalY, auto normalZ, auto distance, uint8_t* hit, float* timeOfImpact) {
+		return SweptSegmentPlaneKernel(starts, ends, i, normalX, normalY, normalZ, distance, hit, timeOfImpact);
+		});
+}
+
+void QuerySweptSpheres(const BroadPhase& broadPhase, std::span<const Sphere> spheres, std::span<const Vector3> displacements, std::vector<SweepCandidate>& candidates)
+{
+	assert(displacements.size() == spheres.size());
+	candidates.clear();
+	for (size_t i = 0; i < spheres.size(); ++i) {
+		broadPhase.QueryOverlap(MakeSweptAABB(spheres[i], displacements[i]), [&](BroadPhase::Handle handle) {
+			candidates.push_back({ static_cast<uint32_t>(i), handle });
+			return true;
+			});
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "BroadPhase.h"
+#include "CollisionBatch.h"
+#include "Primitive.h"
+#include "TransformBatch.h"
+#include <span>
+#include <vector>
+
+// 連続衝突判定(CCD)
+// 1フレームの間に形状が直線的に動くとして、最初に触れる時刻(0:フレーム開始, 1:フレーム終了)を求める
+// 端点だけを見る判定と違い、速く動く物体が薄い相手をすり抜けない
+// 平面はどちらの側からでも当たる(IsCollision(Segment, Plane)と同じく表裏を区別しない)
+
+/// <summary>
+/// 動く球と平面
+/// </summary>
+/// <param name="sphere">フレーム開始時の球</param>
+/// <param name="displacement">1フレームの移動量</param>
+/// <param name="plane">平面</param>
+/// <param name="timeOfImpact">最初に触れる時刻(当たったときのみ。開始時に触れていれば0)</param>
+/// <returns>フレーム内に触れればtrue</returns>
+bool ComputeTimeOfImpact(const Sphere& sphere, const Vector3& displacement, const Plane& plane, float& timeOfImpact);
+
+/// <summary>
+/// 動く球どうし(相対運動で解く)
+/// </summary>
+bool ComputeTimeOfImpact(const Sphere& sphere1, const Vector3& displacement1, const Sphere& sphere2, const Vector3& displacement2, float& timeOfImpact);
+
+/// <summary>
+/// 2つの姿勢の間を動く線分と平面
+/// 各端点はstartからendへ直線的に動く(時刻tの線分は端点を補間したもの)
+/// </summary>
+/// <param name="start">フレーム開始時の線分</param>
+/// <param name="end">フレーム終了時の線分</param>
+/// <param name="plane">平面</param>
+/// <param name="timeOfImpact">最初に触れる時刻(当たったときのみ)</param>
+/// <returns>フレーム内に触れればtrue</returns>
+bool ComputeTimeOfImpact(const Segment& start, const Segment& end, const Plane& plane, float& timeOfImpact);
+
+/// <summary>
+/// 動く球が1フレームで通る範囲を囲むAABB(ブロードフェーズの問い合わせ用)
+/// </summary>
+AABB MakeSweptAABB(const Sphere& sphere, const Vector3& displacement);
+
+/// <summary>
+/// 2つの姿勢の間を動く線分が通る範囲を囲むAABB
+/// </summary>
+AABB MakeSweptAABB(const Segment& start, const Segment& end);
+
+/// <summary>
+/// CCDの一括判定の出力先(N個の動く形状 × M個の相手)
+/// 要素の並びはSegmentHitsSoAと同じ(index = other * N + shape)
+/// timeOfImpactは当たった組の要素だけが有効
+/// </summary>
+struct SweepHitsSoA {
+	std::span<uint8_t> hit;
+	std::span<float> timeOfImpact;
+};
+
+/// <summary>
+/// N個の動く球とM枚の平面を一括で判定する
+/// </summary>
+/// <param name="spheres">フレーム開始時の球</param>
+/// <param name="displacements">球ごとの移動量(spheresと同じ要素数)</param>
+/// <param name="planes">平面</param>
+/// <param name="hits">出力</param>
+/// <returns>当たった組の数</returns>
+size_t ComputeTimeOfImpactBatch(const SpheresSoA& spheres, const PointsSoA& displacements, const PlanesSoA& planes, const SweepHitsSoA& hits);
+
+/// <summary>
+/// 2つの姿勢の間を動くN本の線分とM枚の平面を一括で判定する
+/// </summary>
+/// <returns>当たった組の数</returns>
+size_t ComputeTimeOfImpactBatch(const SegmentsSoA& starts, const SegmentsSoA& ends, const PlanesSoA& planes, const SweepHitsSoA& hits);
+
+// 動く形状とブロードフェーズの候補の組
+struct SweepCandidate {
+	uint32_t index;// 動く形状の添え字
+	BroadPhase::Handle handle;
+};
+
+/// <summary>
+/// 動く球ごとにMakeSweptAABBでブロードフェーズに問い合わせ、候補を集める
+/// 候補に対してComputeTimeOfImpactを呼べば、すり抜けなしで当たりを求められる
+/// </summary>
+/// <param name="broadPhase">ブロードフェーズ</param>
+/// <param name="spheres">フレーム開始時の球</param>
+/// <param name="displacements">球ごとの移動量</param>
+/// <param name="candidates">出力(球の順)</param>
+void QuerySweptSpheres(const BroadPhase& broadPhase, std::span<const Sphere> spheres, std::span<const Vector3> displacements, std::vector<SweepCandidate>& candidates);
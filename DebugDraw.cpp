@@ -0,0 +1,36 @@
+#include "DebugDraw.h"
+#include "Profiler.h"
+
+size_t DebugDraw::AddLines(const float* screenX, const float* screenY, const uint8_t* visible, std::span<const uint32_t> indices, uint32_t color)
+{
+	size_t added = 0;
+	for (size_t i = 0; i + 1 < indices.size(); i += 2) {
+		uint32_t start = indices[i];
+		uint32_t end = indices[i + 1];
+		if (!visible[start] || !visible[end]) {
+			continue;
+		}
+		lines_.push_back({ screenX[start], screenY[start], screenX[end], screenY[end], color });
+		++added;
+	}
+	return added;
+}
+
+size_t DebugDraw::Flush()
+{
+	PROFILE_SCOPE("DebugDraw::Flush");
+	size_t count = lines_.size();
+	if (submit_ && count != 0) {
+		submit_(context_, lines_);
+	}
+	lines_.clear();
+	return count;
+}
+
+void DebugDrawRecorder::Submit(void* context, std::span<const DebugLine> lines)
+{
+	DebugDrawRecorder* recorder = static_cast<DebugDrawRecorder*>(context);
+	recorder->lines.assign(lines.begin(), lines.end());
+	++recorder->submitCount;
+	recorder->totalLineCount += lines.size();
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// スクリーン座標の線分1本(小数のまま保持する)
+/// </summary>
+struct DebugLine {
+	float startX;
+	float startY;
+	float endX;
+	float endY;
+	uint32_t color;
+};
+
+/// <summary>
+/// 1フレーム分のデバッグ線をためて、Flushでまとめて描画側へ渡すキュー
+/// 描画側(バックエンド)は関数ポインタで差し替える(Noviceでの描画、ヘッドレスでの記録など)
+/// Flush後もバッファの容量は残すので、定常状態ではメモリを確保しない
+/// </summary>
+class DebugDraw {
+public:
+	// linesを描画する。contextはSetBackendで渡したもの
+	typedef void (*SubmitFunction)(void* context, std::span<const DebugLine> lines);
+
+	void SetBackend(SubmitFunction submit, void* context) {
+		submit_ = submit;
+		context_ = context;
+	}
+
+	void Reserve(size_t lineCount) { lines_.reserve(lineCount); }
+
+	void AddLine(float startX, float startY, float endX, float endY, uint32_t color) {
+		lines_.push_back({ startX, startY, endX, endY, color });
+	}
+
+	/// <summary>
+	/// TransformToScreenで変換済みの点を、添え字の組(2つで1本)で結んで追加する
+	/// どちらかの端点が見えていない線は追加しない
+	/// </summary>
+	/// <param name="screenX">スクリーンX座標</param>
+	/// <param name="screenY">スクリーンY座標</param>
+	/// <param name="visible">TransformToScreenの可視フラグ</param>
+	/// <param name="indices">線の端点の添え字(2つずつ)</param>
+	/// <param name="color">色</param>
+	/// <returns>追加した線の数</returns>
+	size_t AddLines(const float* screenX, const float* screenY, const uint8_t* visible, std::span<const uint32_t> indices, uint32_t color);
+
+	/// <summary>
+	/// たまった線をバックエンドへ1回で渡して空にする(バックエンドが無ければ捨てる)
+	/// </summary>
+	/// <returns>渡した線の数</returns>
+	size_t Flush();
+
+	std::span<const DebugLine> GetLines() const { return lines_; }
+	size_t GetCapacity() const { return lines_.capacity(); }
+
+private:
+	std::vector<DebugLine> lines_;
+	SubmitFunction submit_ = nullptr;
+	void* context_ = nullptr;
+};
+
+/// <summary>
+/// ヘッドレス用のバックエンド。渡された線をそのまま記録する
+/// SetBackend(&DebugDrawRecorder::Submit, &recorder)で使う
+/// </summary>
+struct DebugDrawRecorder {
+	std::vector<DebugLine> lines;// 最後に渡された線
+	size_t submitCount = 0;// 渡された回数
+	size_t totalLineCount = 0;// これまでに渡された線の合計
+
+	static void Submit(void* context, std::span<const DebugLine> lines);
+};
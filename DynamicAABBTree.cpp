@@ -0,0 +1,339 @@
+#include "DynamicAABBTree.h"
+#include <algorithm>
+
+namespace {
+
+	AABB Union(const AABB& a, const AABB& b) {
+		return {
+			{ std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z) },
+			{ std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z) },
+		};
+	}
+
+	// 表面積(挿入先を選ぶコストに使う)
+	float SurfaceArea(const AABB& aabb) {
+		float dx = aabb.max.x - aabb.min.x;
+		float dy = aabb.max.y - aabb.min.y;
+		float dz = aabb.max.z - aabb.min.z;
+		return 2.0f * (dx * dy + dy * dz + dz * dx);
+	}
+
+	bool Contains(const AABB& outer, const AABB& inner) {
+		return
+			outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+			inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+	}
+
+	AABB Fatten(const AABB& aabb) {
+		const float margin = DynamicAABBTree::kAABBMargin;
+		return {
+			{ aabb.min.x - margin, aabb.min.y - margin, aabb.min.z - margin },
+			{ aabb.max.x + margin, aabb.max.y + margin, aabb.max.z + margin },
+		};
+	}
+
+}
+
+DynamicAABBTree::DynamicAABBTree()
+	: root_(kNullNode), freeList_(kNullNode), proxyCount_(0)
+{
+}
+
+int32_t DynamicAABBTree::CreateProxy(const AABB& aabb, uint32_t userData)
+{
+	int32_t proxyId = AllocateNode();
+	Node& node = nodes_[proxyId];
+	node.aabb = Fatten(aabb);
+	node.userData = userData;
+	node.height = 0;
+
+	InsertLeaf(proxyId);
+	++proxyCount_;
+
+	return proxyId;
+}
+
+void DynamicAABBTree::DestroyProxy(int32_t proxyId)
+{
+	assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+	assert(nodes_[proxyId].IsLeaf());
+
+	RemoveLeaf(proxyId);
+	FreeNode(proxyId);
+	--proxyCount_;
+}
+
+bool DynamicAABBTree::MoveProxy(int32_t proxyId, const AABB& aabb)
+{
+	assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+	assert(nodes_[proxyId].IsLeaf());
+
+	if (Contains(nodes_[proxyId].aabb, aabb)) {
+		return false;
+	}
+
+	RemoveLeaf(proxyId);
+	nodes_[proxyId].aabb = Fatten(aabb);
+	InsertLeaf(proxyId);
+
+	return true;
+}
+
+int32_t DynamicAABBTree::GetHeight() const
+{
+	if (root_ == kNullNode) {
+		return 0;
+	}
+	return nodes_[root_].height;
+}
+
+int32_t DynamicAABBTree::AllocateNode()
+{
+	if (freeList_ == kNullNode) {
+		Node node = {};
+		node.parent = kNullNode;
+		node.child1 = kNullNode;
+		node.child2 = kNullNode;
+		node.height = -1;
+		nodes_.push_back(node);
+		return static_cast<int32_t>(nodes_.size() - 1);
+	}
+
+	int32_t nodeId = freeList_;
+	Node& node = nodes_[nodeId];
+	freeList_ = node.parent;
+	node.parent = kNullNode;
+	node.child1 = kNullNode;
+	node.child2 = kNullNode;
+	node.height = 0;
+	node.userData = 0;
+	return nodeId;
+}
+
+void DynamicAABBTree::FreeNode(int32_t nodeId)
+{
+	nodes_[nodeId].parent = freeList_;
+	nodes_[nodeId].height = -1;
+	freeList_ = nodeId;
+}
+
+void DynamicAABBTree::InsertLeaf(int32_t leaf)
+{
+	if (root_ == kNullNode) {
+		root_ = leaf;
+		nodes_[root_].parent = kNullNode;
+		return;
+	}
+
+	// 表面積の増加が最小になる兄弟を探す
+	AABB leafAABB = nodes_[leaf].aabb;
+	int32_t index = root_;
+	while (!nodes_[index].IsLeaf()) {
+		int32_t child1 = nodes_[index].child1;
+		int32_t child2 = nodes_[index].child2;
+
+		float area = SurfaceArea(nodes_[index].aabb);
+		float combinedArea = SurfaceArea(Union(nodes_[index].aabb, leafAABB));
+
+		// ここに新しい親を作るコスト
+		float cost = 2.0f * combinedArea;
+
+		// これより下に入れる場合に祖先が大きくなる分
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto descendCost = [&](int32_t child) {
+			AABB aabb = Union(leafAABB, nodes_[child].aabb);
+			if (nodes_[child].IsLeaf()) {
+				return SurfaceArea(aabb) + inheritanceCost;
+			}
+			return SurfaceArea(aabb) - SurfaceArea(nodes_[child].aabb) + inheritanceCost;
+		};
+		float cost1 = descendCost(child1);
+		float cost2 = descendCost(child2);
+
+		if (cost < cost1 && cost < cost2) {
+			break;
+		}
+
+		index = cost1 < cost2 ? child1 : child2;
+	}
+
+	int32_t sibling = index;
+
+	// 兄弟と新しい葉をまとめる親を作る
+	int32_t oldParent = nodes_[sibling].parent;
+	int32_t newParent = AllocateNode();
+	nodes_[newParent].parent = oldParent;
+	nodes_[newParent].aabb = Union(leafAABB, nodes_[sibling].aabb);
+	nodes_[newParent].height = nodes_[sibling].height + 1;
+	nodes_[newParent].child1 = sibling;
+	nodes_[newParent].child2 = leaf;
+	nodes_[sibling].parent = newParent;
+	nodes_[leaf].parent = newParent;
+
+	if (oldParent != kNullNode) {
+		if (nodes_[oldParent].child1 == sibling) {
+			nodes_[oldParent].child1 = newParent;
+		} else {
+			nodes_[oldParent].child2 = newParent;
+		}
+	} else {
+		root_ = newParent;
+	}
+
+	// 根までAABBと高さを直しながら回転する
+	index = nodes_[leaf].parent;
+	while (index != kNullNode) {
+		index = Balance(index);
+
+		int32_t child1 = nodes_[index].child1;
+		int32_t child2 = nodes_[index].child2;
+		nodes_[index].height = 1 + std::max(nodes_[child1].height, nodes_[child2].height);
+		nodes_[index].aabb = Union(nodes_[child1].aabb, nodes_[child2].aabb);
+
+		index = nodes_[index].parent;
+	}
+}
+
+void DynamicAABBTree::RemoveLeaf(int32_t leaf)
+{
+	if (leaf == root_) {
+		root_ = kNullNode;
+		return;
+	}
+
+	int32_t parent = nodes_[leaf].parent;
+	int32_t grandParent = nodes_[parent].parent;
+	int32_t sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+	if (grandParent == kNullNode) {
+		root_ = sibling;
+		nodes_[sibling].parent = kNullNode;
+		FreeNode(parent);
+		return;
+	}
+
+	// 親を消して兄弟を祖父につなぐ
+	if (nodes_[grandParent].child1 == parent) {
+		nodes_[grandParent].child1 = sibling;
+	} else {
+		nodes_[grandParent].child2 = sibling;
+	}
+	nodes_[sibling].parent = grandParent;
+	FreeNode(parent);
+
+	int32_t index = grandParent;
+	while (index != kNullNode) {
+		index = Balance(index);
+
+		int32_t child1 = nodes_[index].child1;
+		int32_t child2 = nodes_[index].child2;
+		nodes_[index].aabb = Union(nodes_[child1].aabb, nodes_[child2].aabb);
+		nodes_[index].height = 1 + std::max(nodes_[child1].height, nodes_[child2].height);
+
+		index = nodes_[index].parent;
+	}
+}
+
+int32_t DynamicAABBTree::Balance(int32_t iA)
+{
+	// 左右の高さの差が2以上なら高い方の子を持ち上げる
+	// Aの子をB,C、Cの子をF,G(Bの子をD,E)とする
+	Node* A = &nodes_[iA];
+	if (A->IsLeaf() || A->height < 2) {
+		return iA;
+	}
+
+	int32_t iB = A->child1;
+	int32_t iC = A->child2;
+	Node* B = &nodes_[iB];
+	Node* C = &nodes_[iC];
+
+	int32_t balance = C->height - B->height;
+
+	// Cを持ち上げる
+	if (balance > 1) {
+		int32_t iF = C->child1;
+		int32_t iG = C->child2;
+		Node* F = &nodes_[iF];
+		Node* G = &nodes_[iG];
+
+		C->child1 = iA;
+		C->parent = A->parent;
+		A->parent = iC;
+
+		if (C->parent != kNullNode) {
+			if (nodes_[C->parent].child1 == iA) {
+				nodes_[C->parent].child1 = iC;
+			} else {
+				nodes_[C->parent].child2 = iC;
+			}
+		} else {
+			root_ = iC;
+		}
+
+		if (F->height > G->height) {
+			C->child2 = iF;
+			A->child2 = iG;
+			G->parent = iA;
+			A->aabb = Union(B->aabb, G->aabb);
+			C->aabb = Union(A->aabb, F->aabb);
+			A->height = 1 + std::max(B->height, G->height);
+			C->height = 1 + std::max(A->height, F->height);
+		} else {
+			C->child2 = iG;
+			A->child2 = iF;
+			F->parent = iA;
+			A->aabb = Union(B->aabb, F->aabb);
+			C->aabb = Union(A->aabb, G->aabb);
+			A->height = 1 + std::max(B->height, F->height);
+			C->height = 1 + std::max(A->height, G->height);
+		}
+
+		return iC;
+	}
+
+	// Bを持ち上げる
+	if (balance < -1) {
+		int32_t iD = B->child1;
+		int32_t iE = B->child2;
+		Node* D = &nodes_[iD];
+		Node* E = &nodes_[iE];
+
+		B->child1 = iA;
+		B->parent = A->parent;
+		A->parent = iB;
+
+		if (B->parent != kNullNode) {
+			if (nodes_[B->parent].child1 == iA) {
+				nodes_[B->parent].child1 = iB;
+			} else {
+				nodes_[B->parent].child2 = iB;
+			}
+		} else {
+			root_ = iB;
+		}
+
+		if (D->height > E->height) {
+			B->child2 = iD;
+			A->child1 = iE;
+			E->parent = iA;
+			A->aabb = Union(C->aabb, E->aabb);
+			B->aabb = Union(A->aabb, D->aabb);
+			A->height = 1 + std::max(C->height, E->height);
+			B->height = 1 + std::max(A->height, D->height);
+		} else {
+			B->child2 = iE;
+			A->child1 = iD;
+			D->parent = iA;
+			A->aabb = Union(C->aabb, D->aabb);
+			B->aabb = Union(A->aabb, E->aabb);
+			A->height = 1 + std::max(C->height, D->height);
+			B->height = 1 + std::max(A->height, E->height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
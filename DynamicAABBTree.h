@@ -0,0 +1,207 @@
+#pragma once
+#include "Primitive.h"
+#include <assert.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 動的AABBツリー(ブロードフェーズ用のBVH)
+/// 葉は少し広げたAABB(fat AABB)を持ち、移動が小さいうちは組み替えずに済ませる
+/// 挿入時は表面積が最小になる兄弟を選び、AVL木と同じ回転で高さを保つ
+/// </summary>
+class DynamicAABBTree {
+public:
+	static const int32_t kNullNode = -1;
+
+	// 葉のAABBを広げる量
+	static constexpr float kAABBMargin = 0.1f;
+
+	DynamicAABBTree();
+
+	/// <summary>
+	/// 葉を追加する
+	/// </summary>
+	/// <param name="aabb">囲むAABB</param>
+	/// <param name="userData">呼び出し側の識別子</param>
+	/// <returns>葉のID</returns>
+	int32_t CreateProxy(const AABB& aabb, uint32_t userData);
+
+	/// <summary>
+	/// 葉を削除する
+	/// </summary>
+	void DestroyProxy(int32_t proxyId);
+
+	/// <summary>
+	/// 葉のAABBを更新する(fat AABBに収まっていれば何もしない)
+	/// </summary>
+	/// <returns>組み替えが起きたらtrue</returns>
+	bool MoveProxy(int32_t proxyId, const AABB& aabb);
+
+	uint32_t GetUserData(int32_t proxyId) const {
+		assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+		return nodes_[proxyId].userData;
+	}
+
+	const AABB& GetFatAABB(int32_t proxyId) const {
+		assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+		return nodes_[proxyId].aabb;
+	}
+
+	// 木の高さ(葉だけなら0)
+	int32_t GetHeight() const;
+
+	size_t GetProxyCount() const { return proxyCount_; }
+
+	/// <summary>
+	/// aabbと重なる葉をすべて列挙する
+	/// callback(proxyId)がfalseを返したら打ち切る
+	/// </summary>
+	template<typename Callback>
+	void Query(const AABB& aabb, Callback&& callback) const;
+
+	/// <summary>
+	/// 半直線 origin + t * direction (0 <= t <= maxT) が通る葉を列挙する
+	/// callback(proxyId, maxT)は新しいmaxTを返す(0で打ち切り、そのまま返せば続行、小さくすれば以降の探索を絞る)
+	/// 線分の判定はdirection = 終点 - 始点, maxT = 1 で行う
+	/// </summary>
+	template<typename Callback>
+	void RayCast(const Vector3& origin, const Vector3& direction, float maxT, Callback&& callback) const;
+
+private:
+	struct Node {
+		AABB aabb;
+		int32_t parent;// 空きノードのときは次の空きノード
+		int32_t child1;
+		int32_t child2;
+		int32_t height;// 葉は0、空きノードは-1
+		uint32_t userData;
+
+		bool IsLeaf() const { return child1 == kNullNode; }
+	};
+
+	// 探索用スタックの配列の大きさ(バランスしていれば十分。溢れた分はヒープへ移す)
+	static const int32_t kStackCapacity = 256;
+
+	/// <summary>
+	/// 探索用スタック(普段は配列だけを使い、深い木でも壊れないよう溢れた分はvectorに積む)
+	/// </summary>
+	class TraversalStack {
+	public:
+		bool IsEmpty() const { return size_ == 0; }
+
+		void Push(int32_t nodeId) {
+			if (size_ < kStackCapacity) {
+				local_[size_] = nodeId;
+			} else {
+				overflow_.push_back(nodeId);
+			}
+			++size_;
+		}
+
+		int32_t Pop() {
+			--size_;
+			if (size_ < kStackCapacity) {
+				return local_[size_];
+			}
+			int32_t nodeId = overflow_.back();
+			overflow_.pop_back();
+			return nodeId;
+		}
+
+	private:
+		int32_t local_[kStackCapacity];
+		std::vector<int32_t> overflow_;
+		int32_t size_ = 0;
+	};
+
+	int32_t AllocateNode();
+	void FreeNode(int32_t nodeId);
+	void InsertLeaf(int32_t leaf);
+	void RemoveLeaf(int32_t leaf);
+	int32_t Balance(int32_t nodeId);
+
+	std::vector<Node> nodes_;
+	int32_t root_;
+	int32_t freeList_;
+	size_t proxyCount_;
+};
+
+template<typename Callback>
+inline void DynamicAABBTree::Query(const AABB& aabb, Callback&& callback) const {
+	TraversalStack stack;
+	if (root_ != kNullNode) {
+		stack.Push(root_);
+	}
+
+	while (!stack.IsEmpty()) {
+		const Node& node = nodes_[stack.Pop()];
+
+		if (!(node.aabb.min.x <= aabb.max.x && node.aabb.max.x >= aabb.min.x &&
+			node.aabb.min.y <= aabb.max.y && node.aabb.max.y >= aabb.min.y &&
+			node.aabb.min.z <= aabb.max.z && node.aabb.max.z >= aabb.min.z)) {
+			continue;
+		}
+
+		if (node.IsLeaf()) {
+			if (!callback(static_cast<int32_t>(&node - nodes_.data()))) {
+				return;
+			}
+		} else {
+			stack.Push(node.child1);
+			stack.Push(node.child2);
+		}
+	}
+}
+
+template<typename Callback>
+inline void DynamicAABBTree::RayCast(const Vector3& origin, const Vector3& direction, float maxT, Callback&& callback) const {
+	const Vector3 inverseDirection = { 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+
+	TraversalStack stack;
+	if (root_ != kNullNode) {
+		stack.Push(root_);
+	}
+
+	while (!stack.IsEmpty()) {
+		int32_t nodeId = stack.Pop();
+		const Node& node = nodes_[nodeId];
+
+		// 各軸のスラブに入る/出るtの範囲が重なっているか
+		// 軸と平行な方向(逆数が±inf)は始点がスラブの中か(面の上も含む)だけを見る
+		// (そのまま掛けると始点が面の上のとき0*infでNaNになる)
+		float tMin = 0.0f;
+		float tMax = maxT;
+		const float* o = &origin.x;
+		const float* inverse = &inverseDirection.x;
+		const float* boxMin = &node.aabb.min.x;
+		const float* boxMax = &node.aabb.max.x;
+		for (int axis = 0; axis < 3; ++axis) {
+			if (inverse[axis] == INFINITY || inverse[axis] == -INFINITY) {
+				if (!(boxMin[axis] <= o[axis] && o[axis] <= boxMax[axis])) {
+					tMax = -1.0f;
+				}
+				continue;
+			}
+			float t1 = (boxMin[axis] - o[axis]) * inverse[axis];
+			float t2 = (boxMax[axis] - o[axis]) * inverse[axis];
+			tMin = t1 < t2 ? (t1 > tMin ? t1 : tMin) : (t2 > tMin ? t2 : tMin);
+			tMax = t1 < t2 ? (t2 < tMax ? t2 : tMax) : (t1 < tMax ? t1 : tMax);
+		}
+		if (!(tMin <= tMax)) {
+			continue;
+		}
+
+		if (node.IsLeaf()) {
+			float newMaxT = callback(nodeId, maxT);
+			if (newMaxT <= 0.0f) {
+				return;
+			}
+			maxT = newMaxT < maxT ? newMaxT : maxT;
+		} else {
+			stack.Push(node.child1);
+			stack.Push(node.child2);
+		}
+	}
+}
@@ -0,0 +1,103 @@
+#include "FixedTimestep.h"
+#include <algorithm>
+#include <assert.h>
+
+FixedTimestep::FixedTimestep(double stepSeconds, uint32_t maxStepsPerFrame)
+	: stepSeconds_(stepSeconds)
+	, maxStepsPerFrame_(maxStepsPerFrame)
+	, accumulator_(0.0)
+	, stepCount_(0)
+	, droppedStepCount_(0)
+{
+	assert(stepSeconds > 0.0);
+	assert(maxStepsPerFrame > 0);
+}
+
+uint32_t FixedTimestep::Advance(double elapsedSeconds)
+{
+	// 時計が戻ったときは進めない
+	accumulator_ += std::max(elapsedSeconds, 0.0);
+
+	uint32_t steps = 0;
+	while (accumulator_ >= stepSeconds_ && steps < maxStepsPerFrame_) {
+		accumulator_ -= stepSeconds_;
+		++steps;
+	}
+
+	// 上限で追いつけなかった分は捨てて、補間係数を[0, 1)に保つ
+	if (accumulator_ >= stepSeconds_) {
+		uint64_t dropped = static_cast<uint64_t>(accumulator_ / stepSeconds_);
+		droppedStepCount_ += dropped;
+		accumulator_ -= static_cast<double>(dropped) * stepSeconds_;
+		// 割り算の丸めで1ステップ分残ったときの補正
+		if (accumulator_ >= stepSeconds_) {
+			accumulator_ -= stepSeconds_;
+			++droppedStepCount_;
+		}
+		accumulator_ = std::max(accumulator_, 0.0);
+	}
+
+	stepCount_ += steps;
+	return steps;
+}
+
+void FixedTimestep::Reset()
+{
+	accumulator_ = 0.0;
+	stepCount_ = 0;
+	droppedStepCount_ = 0;
+}
+
+FrameTimer::FrameTimer()
+	: started_(false)
+	, samples_{}
+	, next_(0)
+	, count_(0)
+{
+}
+
+double FrameTimer::Tick()
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (!started_) {
+		started_ = true;
+		last_ = now;
+		return 0.0;
+	}
+
+	double seconds = std::chrono::duration<double>(now - last_).count();
+	last_ = now;
+	AddSample(seconds);
+	return seconds;
+}
+
+void FrameTimer::AddSample(double seconds)
+{
+	samples_[next_] = seconds;
+	next_ = (next_ + 1) % kHistorySize;
+	count_ = std::min(count_ + 1, kHistorySize);
+}
+
+FrameTimeStats FrameTimer::GetStats() const
+{
+	FrameTimeStats stats = { 0.0f, 0.0f, 0.0f, 0.0f, count_ };
+	if (count_ == 0) {
+		return stats;
+	}
+
+	double sum = 0.0;
+	double minSeconds = GetSample(0);
+	double maxSeconds = GetSample(0);
+	for (uint32_t i = 0; i < count_; ++i) {
+		double seconds = GetSample(i);
+		sum += seconds;
+		minSeconds = std::min(minSeconds, seconds);
+		maxSeconds = std::max(maxSeconds, seconds);
+	}
+
+	stats.lastMs = static_cast<float>(GetSample(count_ - 1) * 1000.0);
+	stats.averageMs = static_cast<float>(sum / count_ * 1000.0);
+	stats.minMs = static_cast<float>(minSeconds * 1000.0);
+	stats.maxMs = static_cast<float>(maxSeconds * 1000.0);
+	return stats;
+}
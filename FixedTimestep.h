@@ -0,0 +1,101 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+/// <summary>
+/// 更新を固定刻みで回し、描画とは切り離すためのアキュムレータ
+/// 毎フレームの経過時間をためて、刻み幅ぶんたまるごとに1回更新する
+/// 余りはGetAlphaで前の状態と今の状態の補間に使う(描画は最大1ステップ遅れる)
+/// </summary>
+class FixedTimestep {
+public:
+	/// <param name="stepSeconds">1回の更新で進める時間</param>
+	/// <param name="maxStepsPerFrame">1フレームで回す更新の上限(重いフレームの後に更新が雪だるま式に増えないように)</param>
+	explicit FixedTimestep(double stepSeconds = 1.0 / 60.0, uint32_t maxStepsPerFrame = 8);
+
+	/// <summary>
+	/// 経過時間をためて、このフレームで回す更新の回数を返す
+	/// 上限を超えた分は捨てる(シミュレーションが実時間より遅れる)
+	/// </summary>
+	/// <param name="elapsedSeconds">前のフレームからの経過時間</param>
+	/// <returns>更新の回数</returns>
+	uint32_t Advance(double elapsedSeconds);
+
+	// 前の状態から今の状態への補間係数[0, 1)
+	// (floatへの丸めで1にならないように抑える)
+	float GetAlpha() const { return std::min(static_cast<float>(accumulator_ / stepSeconds_), 0.99999994f); }
+
+	float GetStepSeconds() const { return static_cast<float>(stepSeconds_); }
+
+	// これまでに回した更新の回数
+	uint64_t GetStepCount() const { return stepCount_; }
+
+	// 上限を超えて捨てた更新の回数
+	uint64_t GetDroppedStepCount() const { return droppedStepCount_; }
+
+	void Reset();
+
+private:
+	double stepSeconds_;
+	uint32_t maxStepsPerFrame_;
+	double accumulator_;
+	uint64_t stepCount_;
+	uint64_t droppedStepCount_;
+};
+
+/// <summary>
+/// 経過時間をためて、回すべき回数だけupdate(stepSeconds)を呼ぶ
+/// </summary>
+/// <returns>呼んだ回数</returns>
+template<typename Update>
+inline uint32_t RunFixedSteps(FixedTimestep& timestep, double elapsedSeconds, Update&& update) {
+	uint32_t steps = timestep.Advance(elapsedSeconds);
+	for (uint32_t step = 0; step < steps; ++step) {
+		update(timestep.GetStepSeconds());
+	}
+	return steps;
+}
+
+/// <summary>
+/// 直近のフレーム時間の集計(ミリ秒)
+/// </summary>
+struct FrameTimeStats {
+	float lastMs;
+	float averageMs;
+	float minMs;
+	float maxMs;
+	uint32_t sampleCount;
+};
+
+/// <summary>
+/// フレーム時間を計測して、直近kHistorySize個をリングバッファに残す
+/// </summary>
+class FrameTimer {
+public:
+	static constexpr uint32_t kHistorySize = 128;
+
+	FrameTimer();
+
+	/// <summary>
+	/// 前回のTickからの経過時間を記録して返す(初回は0で、記録しない)
+	/// </summary>
+	/// <returns>経過秒</returns>
+	double Tick();
+
+	// 別に計測した時間を記録する(区間の計測やヘッドレス実行用)
+	void AddSample(double seconds);
+
+	FrameTimeStats GetStats() const;
+
+	// 古い順にi番目の記録(秒)
+	double GetSample(uint32_t i) const { return samples_[(next_ + kHistorySize - count_ + i) % kHistorySize]; }
+	uint32_t GetSampleCount() const { return count_; }
+
+private:
+	std::chrono::steady_clock::time_point last_;
+	bool started_;
+	double samples_[kHistorySize];
+	uint32_t next_;
+	uint32_t count_;
+};
@@ -0,0 +1,80 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <assert.h>
+
+namespace {
+
+	size_t AlignUp(size_t value, size_t alignment) {
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+}
+
+FrameArena::FrameArena(size_t capacityBytes)
+	: buffer_(new std::byte[capacityBytes])
+	, capacity_(capacityBytes)
+	, offset_(0)
+	, overflowBlocks_()
+	, overflowCapacity_(0)
+	, overflowOffset_(0)
+	, usedBytes_(0)
+	, peakBytes_(0)
+	, growCount_(0)
+{
+}
+
+void* FrameArena::Allocate(size_t bytes, size_t alignment)
+{
+	assert((alignment & (alignment - 1)) == 0);
+	alignment = std::max(alignment, kMinAlignment);
+
+	// new std::byte[]の先頭はkMinAlignmentにそろっているとは限らないので、アドレスでそろえる
+	auto tryAllocate = [&](std::byte* base, size_t capacity, size_t& offset) -> void* {
+		uintptr_t address = reinterpret_cast<uintptr_t>(base) + offset;
+		size_t padding = AlignUp(address, alignment) - address;
+		if (offset + padding + bytes > capacity) {
+			return nullptr;
+		}
+		offset += padding + bytes;
+		usedBytes_ += padding + bytes;
+		return base + offset - bytes;
+		};
+
+	if (overflowBlocks_.empty()) {
+		if (void* memory = tryAllocate(buffer_.get(), capacity_, offset_)) {
+			peakBytes_ = std::max(peakBytes_, usedBytes_);
+			return memory;
+		}
+	} else if (void* memory = tryAllocate(overflowBlocks_.back().get(), overflowCapacity_, overflowOffset_)) {
+		peakBytes_ = std::max(peakBytes_, usedBytes_);
+		return memory;
+	}
+
+	// 収まらなければ追加のブロックを作る(このフレームだけ)
+	overflowCapacity_ = std::max(capacity_, bytes + alignment);
+	overflowBlocks_.push_back(std::unique_ptr<std::byte[]>(new std::byte[overflowCapacity_]));
+	overflowOffset_ = 0;
+	++growCount_;
+	void* memory = tryAllocate(overflowBlocks_.back().get(), overflowCapacity_, overflowOffset_);
+	peakBytes_ = std::max(peakBytes_, usedBytes_);
+	return memory;
+}
+
+void FrameArena::Reset()
+{
+	if (!overflowBlocks_.empty()) {
+		// 一番多く使ったフレームが1つのブロックに収まるように作り直す
+		overflowBlocks_.clear();
+		capacity_ = std::max(capacity_ * 2, AlignUp(peakBytes_, kMinAlignment) * 2);
+		buffer_.reset(new std::byte[capacity_]);
+	}
+	offset_ = 0;
+	overflowOffset_ = 0;
+	usedBytes_ = 0;
+}
+
+FrameArena& GetFrameArena()
+{
+	static FrameArena arena;
+	return arena;
+}
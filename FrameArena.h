@@ -0,0 +1,113 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+/// <summary>
+/// 1フレームの間だけ使う作業領域を先頭から順に切り出すアロケータ
+/// 個別の解放はせず、フレームの始めのResetでまとめて捨てる
+/// 足りなくなったフレームは追加のブロックでしのぎ、次のResetで1つの大きなブロックにまとめ直すので、
+/// 使う量が落ち着けば定常状態ではメモリを確保しない
+/// 1つのアリーナを複数スレッドから同時に使わないこと
+/// </summary>
+class FrameArena {
+public:
+	// 切り出す領域の最小のアライメント(SIMDでまとめて読めるように)
+	static constexpr size_t kMinAlignment = 16;
+
+	explicit FrameArena(size_t capacityBytes = 1u << 20);
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	/// <summary>
+	/// 領域を切り出す(中身は初期化しない)
+	/// </summary>
+	/// <param name="bytes">バイト数</param>
+	/// <param name="alignment">アライメント(2の累乗、kMinAlignment未満はkMinAlignmentにする)</param>
+	/// <returns>次のResetまで有効な領域</returns>
+	void* Allocate(size_t bytes, size_t alignment = kMinAlignment);
+
+	/// <summary>
+	/// 要素数countの配列を切り出す(中身は初期化しないので、デストラクタの要らない型だけ)
+	/// </summary>
+	template<typename T>
+	std::span<T> AllocateArray(size_t count) {
+		static_assert(std::is_trivially_destructible_v<T>, "FrameArena never runs destructors");
+		return { static_cast<T*>(Allocate(count * sizeof(T), alignof(T))), count };
+	}
+
+	/// <summary>
+	/// 切り出した領域をすべて捨てる(フレームの始めに呼ぶ)
+	/// 前のフレームで追加のブロックを使っていたら、使った量が収まる1つのブロックに作り直す
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// 作ってから破棄するまでに切り出した領域を、破棄のときにまとめて戻す(関数の中だけで使う作業領域用)
+	/// 間で追加のブロックを使ったときは戻さずにResetに任せる
+	/// </summary>
+	class Scope {
+	public:
+		explicit Scope(FrameArena& arena)
+			: arena_(arena)
+			, offset_(arena.offset_)
+			, overflowBlockCount_(arena.overflowBlocks_.size())
+			, overflowOffset_(arena.overflowOffset_)
+			, usedBytes_(arena.usedBytes_)
+		{
+		}
+
+		~Scope() {
+			if (arena_.overflowBlocks_.size() == overflowBlockCount_) {
+				arena_.offset_ = offset_;
+				arena_.overflowOffset_ = overflowOffset_;
+				arena_.usedBytes_ = usedBytes_;
+			}
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		FrameArena& arena_;
+		size_t offset_;
+		size_t overflowBlockCount_;
+		size_t overflowOffset_;
+		size_t usedBytes_;
+	};
+
+	// 今のフレームで切り出したバイト数(アライメントの詰め物を含む)
+	size_t GetUsedBytes() const { return usedBytes_; }
+
+	// 1フレームで切り出した最大のバイト数
+	size_t GetPeakBytes() const { return peakBytes_; }
+
+	size_t GetCapacity() const { return capacity_; }
+
+	// 追加のブロックを確保した回数(定常状態では増えない)
+	uint64_t GetGrowCount() const { return growCount_; }
+
+private:
+	std::unique_ptr<std::byte[]> buffer_;
+	size_t capacity_;
+	size_t offset_;
+
+	// bufferに収まらなかった分(次のResetでまとめる)
+	std::vector<std::unique_ptr<std::byte[]>> overflowBlocks_;
+	size_t overflowCapacity_;
+	size_t overflowOffset_;
+
+	size_t usedBytes_;
+	size_t peakBytes_;
+	uint64_t growCount_;
+};
+
+/// <summary>
+/// メインスレッドのフレーム用の共有アリーナ
+/// メインループではNovice::BeginFrameの直後にResetする
+/// </summary>
+FrameArena& GetFrameArena();
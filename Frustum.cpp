@@ -0,0 +1,177 @@
+#include "Frustum.h"
+#include "MathFunction.h"
+#include <cmath>
+
+namespace {
+
+	// 行ベクトル v * M の列columnの係数を取り出す
+	void GetColumn(const Matrix4x4& matrix, int column, float coefficients[4]) {
+		for (int row = 0; row < 4; ++row) {
+			coefficients[row] = matrix.m[row][column];
+		}
+	}
+
+	// a*x + b*y + c*z + d >= 0 を、単位法線の Dot(normal, p) >= distance に直す
+	Plane MakeInsidePlane(const float coefficients[4]) {
+		Vector3 normal = { coefficients[0], coefficients[1], coefficients[2] };
+		float length = GetLength(normal);
+		float inverseLength = length > 0.0f ? 1.0f / length : 0.0f;
+		return { Multiply(inverseLength, normal), -coefficients[3] * inverseLength };
+	}
+
+	struct ClipPoint {
+		float x;
+		float y;
+		float z;
+		float w;
+	};
+
+	ClipPoint TransformHomogeneous(const Vector3& vector, const Matrix4x4& matrix) {
+		return {
+			vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + matrix.m[3][0],
+			vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + matrix.m[3][1],
+			vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + matrix.m[3][2],
+			vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + matrix.m[3][3],
+		};
+	}
+
+	ClipPoint Lerp(const ClipPoint& a, const ClipPoint& b, float t) {
+		return {
+			a.x + (b.x - a.x) * t,
+			a.y + (b.y - a.y) * t,
+			a.z + (b.z - a.z) * t,
+			a.w + (b.w - a.w) * t,
+		};
+	}
+
+	// 近平面で切った後でもwがこれ以下なら写さない(正射影などで近平面がw=0を含む場合)
+	const float kMinW = 1.0e-6f;
+
+}
+
+Frustum MakeFrustum(const Matrix4x4& viewProjectionMatrix)
+{
+	float x[4], y[4], z[4], w[4];
+	GetColumn(viewProjectionMatrix, 0, x);
+	GetColumn(viewProjectionMatrix, 1, y);
+	GetColumn(viewProjectionMatrix, 2, z);
+	GetColumn(viewProjectionMatrix, 3, w);
+
+	float left[4], right[4], bottom[4], top[4], farPlane[4];
+	for (int i = 0; i < 4; ++i) {
+		left[i] = w[i] + x[i];
+		right[i] = w[i] - x[i];
+		bottom[i] = w[i] + y[i];
+		top[i] = w[i] - y[i];
+		farPlane[i] = w[i] - z[i];
+	}
+
+	Frustum frustum;
+	frustum.planes[Frustum::kLeft] = MakeInsidePlane(left);
+	frustum.planes[Frustum::kRight] = MakeInsidePlane(right);
+	frustum.planes[Frustum::kBottom] = MakeInsidePlane(bottom);
+	frustum.planes[Frustum::kTop] = MakeInsidePlane(top);
+	frustum.planes[Frustum::kNear] = MakeInsidePlane(z);
+	frustum.planes[Frustum::kFar] = MakeInsidePlane(farPlane);
+	return frustum;
+}
+
+bool IsVisible(const Frustum& frustum, const Sphere& sphere)
+{
+	for (const Plane& plane : frustum.planes) {
+		if (Dot(plane.normal, sphere.center) - plane.distance < -sphere.radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool IsVisible(const Frustum& frustum, const AABB& aabb)
+{
+	for (const Plane& plane : frustum.planes) {
+		// 法線方向に最も進んだ頂点
+		Vector3 farthest = {
+			plane.normal.x >= 0.0f ? aabb.max.x : aabb.min.x,
+			plane.normal.y >= 0.0f ? aabb.max.y : aabb.min.y,
+			plane.normal.z >= 0.0f ? aabb.max.z : aabb.min.z,
+		};
+		if (Dot(plane.normal, farthest) < plane.distance) {
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t CullSpheres(const Frustum& frustum, const SpheresSoA& spheres, std::span<uint8_t> visible)
+{
+	const size_t count = spheres.radius.size();
+	const float* centerX = spheres.centerX.data();
+	const float* centerY = spheres.centerY.data();
+	const float* centerZ = spheres.centerZ.data();
+	const float* radius = spheres.radius.data();
+	uint8_t* output = visible.data();
+
+	// 球ごとに6枚を分岐なしで判定する(ループはベクトル化できる)
+	size_t visibleCount = 0;
+	for (size_t i = 0; i < count; ++i) {
+		bool inside = true;
+		for (const Plane& plane : frustum.planes) {
+			float signedDistance = plane.normal.x * centerX[i] + plane.normal.y * centerY[i] + plane.normal.z * centerZ[i] - plane.distance;
+			inside &= signedDistance >= -radius[i];
+		}
+		output[i] = static_cast<uint8_t>(inside);
+		visibleCount += inside;
+	}
+	return visibleCount;
+}
+
+bool ClipLineToScreen(const Vector3& start, const Vector3& end, const Matrix4x4& viewProjectionViewportMatrix, DebugLine& line, float minDepth)
+{
+	ClipPoint a = TransformHomogeneous(start, viewProjectionViewportMatrix);
+	ClipPoint b = TransformHomogeneous(end, viewProjectionViewportMatrix);
+
+	// 近平面 z - minDepth * w >= 0 の側を残す
+	float distanceA = a.z - minDepth * a.w;
+	float distanceB = b.z - minDepth * b.w;
+	if (distanceA < 0.0f && distanceB < 0.0f) {
+		return false;
+	}
+	if (distanceA < 0.0f) {
+		a = Lerp(a, b, distanceA / (distanceA - distanceB));
+	} else if (distanceB < 0.0f) {
+		b = Lerp(a, b, distanceA / (distanceA - distanceB));
+	}
+
+	if (a.w <= kMinW || b.w <= kMinW) {
+		return false;
+	}
+
+	line.startX = a.x / a.w;
+	line.startY = a.y / a.w;
+	line.endX = b.x / b.w;
+	line.endY = b.y / b.w;
+	return true;
+}
+
+size_t AddClippedLines(DebugDraw& debugDraw, const PointsSoA& points, const ScreenPointsSoA& screen, std::span<const uint32_t> indices, const Matrix4x4& viewProjectionViewportMatrix, uint32_t color)
+{
+	size_t added = 0;
+	for (size_t i = 0; i + 1 < indices.size(); i += 2) {
+		uint32_t start = indices[i];
+		uint32_t end = indices[i + 1];
+		if (screen.visible[start] && screen.visible[end]) {
+			debugDraw.AddLine(screen.x[start], screen.y[start], screen.x[end], screen.y[end], color);
+			++added;
+			continue;
+		}
+
+		DebugLine line = { 0.0f, 0.0f, 0.0f, 0.0f, color };
+		Vector3 startPoint = { points.x[start], points.y[start], points.z[start] };
+		Vector3 endPoint = { points.x[end], points.y[end], points.z[end] };
+		if (ClipLineToScreen(startPoint, endPoint, viewProjectionViewportMatrix, line)) {
+			debugDraw.AddLine(line.startX, line.startY, line.endX, line.endY, color);
+			++added;
+		}
+	}
+	return added;
+}
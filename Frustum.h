@@ -0,0 +1,74 @@
+#pragma once
+#include "CollisionBatch.h"
+#include "DebugDraw.h"
+#include "Primitive.h"
+#include "TransformBatch.h"
+#include <Matrix4x4.h>
+#include <span>
+
+/// <summary>
+/// 視錐台(6枚の平面)
+/// 法線は内側向きで、Dot(normal, p) >= distance の側が内側
+/// </summary>
+struct Frustum {
+	enum {
+		kLeft,
+		kRight,
+		kBottom,
+		kTop,
+		kNear,
+		kFar,
+		kPlaneCount,
+	};
+	Plane planes[kPlaneCount];
+};
+
+/// <summary>
+/// ビュー射影行列(Multiply(view, MakePerspectiveFovMatrix(...)))から視錐台の平面を取り出す
+/// クリップ空間の -w<=x<=w, -w<=y<=w, 0<=z<=w をワールド座標に戻したもの
+/// </summary>
+Frustum MakeFrustum(const Matrix4x4& viewProjectionMatrix);
+
+/// <summary>
+/// 球が視錐台と重なる可能性があるか(外側と判定したものは確実に見えない)
+/// </summary>
+bool IsVisible(const Frustum& frustum, const Sphere& sphere);
+
+/// <summary>
+/// AABBが視錐台と重なる可能性があるか(各平面で法線方向に最も進んだ頂点を調べる)
+/// </summary>
+bool IsVisible(const Frustum& frustum, const AABB& aabb);
+
+/// <summary>
+/// 球の列をまとめて視錐台で判定する
+/// </summary>
+/// <param name="frustum">視錐台</param>
+/// <param name="spheres">球の列</param>
+/// <param name="visible">出力(見える可能性があれば1)</param>
+/// <returns>見える可能性がある球の数</returns>
+size_t CullSpheres(const Frustum& frustum, const SpheresSoA& spheres, std::span<uint8_t> visible);
+
+/// <summary>
+/// 線分をクリップ空間の近平面で切ってからスクリーンへ写す
+/// 片方の端点がカメラの後ろにあっても、近平面との交点までの線を返す
+/// </summary>
+/// <param name="start">始点(ワールド座標)</param>
+/// <param name="end">終点(ワールド座標)</param>
+/// <param name="viewProjectionViewportMatrix">Multiply(viewProjectionMatrix, viewportMatrix)</param>
+/// <param name="line">スクリーン座標の出力(colorは変更しない)</param>
+/// <param name="minDepth">MakeViewportMatrixに渡したminDepth(近平面はz = minDepth * w)</param>
+/// <returns>近平面より手前に残る部分があればtrue</returns>
+bool ClipLineToScreen(const Vector3& start, const Vector3& end, const Matrix4x4& viewProjectionViewportMatrix, DebugLine& line, float minDepth = 0.0f);
+
+/// <summary>
+/// TransformToScreenの結果を添え字の組(2つで1本)で結んでDebugDrawへ追加する
+/// 片方の端点だけがカメラの後ろにある線は、捨てずにClipLineToScreenで近平面まで切って追加する
+/// </summary>
+/// <param name="debugDraw">追加先</param>
+/// <param name="points">ワールド座標(切るときに使う)</param>
+/// <param name="screen">pointsをTransformToScreenで変換した結果</param>
+/// <param name="indices">線の端点の添え字(2つずつ)</param>
+/// <param name="viewProjectionViewportMatrix">変換に使った行列</param>
+/// <param name="color">色</param>
+/// <returns>追加した線の数</returns>
+size_t AddClippedLines(DebugDraw& debugDraw, const PointsSoA& points, const ScreenPointsSoA& screen, std::span<const uint32_t> indices, const Matrix4x4& viewProjectionViewportMatrix, uint32_t color);
@@ -0,0 +1,9 @@
+#pragma once
+
+/// <summary>
+/// 4x4行列
+/// KamataEngineが無い環境(ヘッドレスビルド)用の同一レイアウト定義
+/// </summary>
+struct Matrix4x4 final {
+	float m[4][4];
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+/// <summary>
+/// 3次元ベクトル
+/// KamataEngineが無い環境(ヘッドレスビルド)用の同一レイアウト定義
+/// </summary>
+struct Vector3 final {
+	float x;
+	float y;
+	float z;
+};
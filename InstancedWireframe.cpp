@@ -0,0 +1,171 @@
+#include "InstancedWireframe.h"
+#include "DebugDraw.h"
+#include "FrameArena.h"
+#include "MathFunction.h"
+#include "SphereWireframe.h"
+#include "TransformBatch.h"
+#include <algorithm>
+
+namespace {
+
+	const float kWhite[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+	void AddVertex(WireframeMesh& mesh, float x, float y, float z, const float color[4]) {
+		mesh.vertices.push_back({ { x, y, z, 1.0f }, { color[0], color[1], color[2], color[3] } });
+		mesh.x.push_back(x);
+		mesh.y.push_back(y);
+		mesh.z.push_back(z);
+	}
+
+}
+
+WireframeMesh MakeSphereWireframeMesh(uint32_t subdivision)
+{
+	const SphereWireframe& wireframe = GetSphereWireframe(subdivision);
+
+	WireframeMesh mesh;
+	mesh.vertices.reserve(wireframe.x.size());
+	for (size_t i = 0; i < wireframe.x.size(); ++i) {
+		AddVertex(mesh, wireframe.x[i], wireframe.y[i], wireframe.z[i], kWhite);
+	}
+	mesh.indices = wireframe.lines;
+	return mesh;
+}
+
+WireframeMesh MakeGridWireframeMesh(float halfWidth, uint32_t subdivision)
+{
+	const float every = (halfWidth * 2.0f) / static_cast<float>(subdivision);
+	float black[4];
+	float gray[4];
+	ColorToFloat4(0x000000FF, black);
+	ColorToFloat4(0xAAAAAAFF, gray);
+
+	WireframeMesh mesh;
+	for (uint32_t i = 0; i <= subdivision; ++i) {
+		float offset = -halfWidth + i * every;
+		const float* color = (offset == 0.0f) ? black : gray;
+		uint32_t first = static_cast<uint32_t>(mesh.vertices.size());
+
+		// Z方向（X軸に平行）とX方向（Z軸に平行）
+		AddVertex(mesh, -halfWidth, 0.0f, offset, color);
+		AddVertex(mesh, halfWidth, 0.0f, offset, color);
+		AddVertex(mesh, offset, 0.0f, -halfWidth, color);
+		AddVertex(mesh, offset, 0.0f, halfWidth, color);
+		mesh.indices.insert(mesh.indices.end(), { first, first + 1, first + 2, first + 3 });
+	}
+	return mesh;
+}
+
+WireframeMesh MakePlaneWireframeMesh()
+{
+	WireframeMesh mesh;
+	AddVertex(mesh, 1.0f, 0.0f, 0.0f, kWhite);
+	AddVertex(mesh, -1.0f, 0.0f, 0.0f, kWhite);
+	AddVertex(mesh, 0.0f, 0.0f, 1.0f, kWhite);
+	AddVertex(mesh, 0.0f, 0.0f, -1.0f, kWhite);
+	mesh.indices = { 0, 2, 2, 1, 1, 3, 3, 0 };
+	return mesh;
+}
+
+Matrix4x4 MakeSphereInstanceMatrix(const Vector3& center, float radius)
+{
+	return {
+		radius, 0.0f, 0.0f, 0.0f,
+		0.0f, radius, 0.0f, 0.0f,
+		0.0f, 0.0f, radius, 0.0f,
+		center.x, center.y, center.z, 1.0f,
+	};
+}
+
+Matrix4x4 MakePlaneInstanceMatrix(const Plane& plane)
+{
+	// X軸 → 法線と垂直なベクトル、Y軸 → 法線、Z軸 → 法線とのクロス積(どちらも長さ2)
+	Vector3 perpendicular = Normalize(Perpendicular(plane.normal));
+	Vector3 cross = Cross(plane.normal, perpendicular);
+	Vector3 center = Multiply(plane.distance, plane.normal);
+	return {
+		2.0f * perpendicular.x, 2.0f * perpendicular.y, 2.0f * perpendicular.z, 0.0f,
+		plane.normal.x, plane.normal.y, plane.normal.z, 0.0f,
+		2.0f * cross.x, 2.0f * cross.y, 2.0f * cross.z, 0.0f,
+		center.x, center.y, center.z, 1.0f,
+	};
+}
+
+void ColorToFloat4(uint32_t color, float rgba[4])
+{
+	for (int channel = 0; channel < 4; ++channel) {
+		rgba[channel] = static_cast<float>((color >> (24 - channel * 8)) & 0xFFu) / 255.0f;
+	}
+}
+
+uint32_t Float4ToColor(const float rgba[4])
+{
+	uint32_t color = 0;
+	for (int channel = 0; channel < 4; ++channel) {
+		float value = std::clamp(rgba[channel], 0.0f, 1.0f);
+		color |= static_cast<uint32_t>(value * 255.0f + 0.5f) << (24 - channel * 8);
+	}
+	return color;
+}
+
+void WireframeInstanceBuffer::Add(const Matrix4x4& world, uint32_t color)
+{
+	WireframeInstance& instance = instances_.emplace_back();
+	instance.world = world;
+	ColorToFloat4(color, instance.color);
+}
+
+size_t AddVisibleSpheres(WireframeInstanceBuffer& buffer, const Frustum& frustum, const SpheresSoA& spheres, std::span<uint8_t> visible, uint32_t color)
+{
+	size_t visibleCount = CullSpheres(frustum, spheres, visible);
+	for (size_t i = 0; i < spheres.radius.size(); ++i) {
+		if (visible[i]) {
+			buffer.AddSphere({ spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i] }, spheres.radius[i], color);
+		}
+	}
+	return visibleCount;
+}
+
+size_t DrawWireframeInstancesCpu(const WireframeMesh& mesh, std::span<const WireframeInstance> instances, const Matrix4x4& viewProjectionViewportMatrix, DebugDraw& debugDraw)
+{
+	const size_t vertexCount = mesh.x.size();
+
+	// 変換結果の置き場(この関数を抜けたらアリーナに戻す)
+	FrameArena& arena = GetFrameArena();
+	FrameArena::Scope scope(arena);
+	std::span<float> screenX = arena.AllocateArray<float>(vertexCount);
+	std::span<float> screenY = arena.AllocateArray<float>(vertexCount);
+	std::span<uint8_t> visible = arena.AllocateArray<uint8_t>(vertexCount);
+
+	size_t lineCount = 0;
+	for (const WireframeInstance& instance : instances) {
+		// 色は頂点の色 × インスタンスの色(線の色は始点で決め、頂点の色が前の線と同じなら使い回す)
+		const float* lastVertexColor = nullptr;
+		uint32_t lineColor = 0;
+
+		// 頂点シェーダーと同じく world × viewProjection(ここではviewportまで)を1つの行列にする
+		Matrix4x4 matrix = Multiply(instance.world, viewProjectionViewportMatrix);
+		TransformToScreen({ mesh.x, mesh.y, mesh.z }, matrix, { screenX, screenY, visible });
+
+		for (size_t i = 0; i + 1 < mesh.indices.size(); i += 2) {
+			uint32_t start = mesh.indices[i];
+			uint32_t end = mesh.indices[i + 1];
+			if (!visible[start] || !visible[end]) {
+				continue;
+			}
+
+			const float* vertexColor = mesh.vertices[start].color;
+			if (!lastVertexColor || !std::equal(vertexColor, vertexColor + 4, lastVertexColor)) {
+				float color[4];
+				for (int channel = 0; channel < 4; ++channel) {
+					color[channel] = vertexColor[channel] * instance.color[channel];
+				}
+				lineColor = Float4ToColor(color);
+				lastVertexColor = vertexColor;
+			}
+			debugDraw.AddLine(screenX[start], screenY[start], screenX[end], screenY[end], lineColor);
+			++lineCount;
+		}
+	}
+	return lineCount;
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "CollisionBatch.h"
+#include "Frustum.h"
+#include "Primitive.h"
+#include <Matrix4x4.h>
+#include <Vector3.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class DebugDraw;
+
+/// <summary>
+/// インスタンス描画用の頂点(Primitive.hlsliの入力 POSITION, COLOR と同じ並び)
+/// </summary>
+struct WireframeVertex {
+	float position[4];// ローカル座標(w = 1)
+	float color[4];// RGBA(0~1)。インスタンスの色と掛け合わせる
+};
+
+/// <summary>
+/// 一度だけGPUへ送るローカル座標の形状(線リスト)
+/// x, y, zはCPUで同じ計算をするとき(フォールバック・検証)用にverticesの座標をSoAで持つ
+/// </summary>
+struct WireframeMesh {
+	std::vector<WireframeVertex> vertices;
+	std::vector<uint32_t> indices;// 2つずつで1本の線
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+};
+
+/// <summary>
+/// 単位球(GetSphereWireframeと同じ頂点と線、色は白)
+/// </summary>
+WireframeMesh MakeSphereWireframeMesh(uint32_t subdivision);
+
+/// <summary>
+/// XZ平面のグリッド(DrawGridと同じ線、中央線だけ黒で他は灰色)
+/// </summary>
+WireframeMesh MakeGridWireframeMesh(float halfWidth = 2.0f, uint32_t subdivision = 10);
+
+/// <summary>
+/// 平面の4頂点を結ぶ菱形(色は白)
+/// 頂点は +X, -X, +Z, -Z で、MakePlaneInstanceMatrixで法線と垂直な向きへ伸ばす
+/// </summary>
+WireframeMesh MakePlaneWireframeMesh();
+
+// 単位球を中心・半径の球にするワールド行列
+Matrix4x4 MakeSphereInstanceMatrix(const Vector3& center, float radius);
+
+// 菱形をDrawPlaneと同じ4頂点(中心から法線と垂直に2ずつ)へ写すワールド行列
+Matrix4x4 MakePlaneInstanceMatrix(const Plane& plane);
+
+// 0xRRGGBBAAをRGBA(0~1)へ
+void ColorToFloat4(uint32_t color, float rgba[4]);
+
+// RGBA(0~1)を0xRRGGBBAAへ(範囲外は丸める)
+uint32_t Float4ToColor(const float rgba[4]);
+
+/// <summary>
+/// インスタンス1つ分のデータ(頂点バッファの2つ目のスロットにそのまま送る)
+/// </summary>
+struct WireframeInstance {
+	Matrix4x4 world;// WORLD0~WORLD3
+	float color[4];// INSTANCE_COLOR
+};
+static_assert(sizeof(WireframeInstance) == 80, "WireframeInstance must match the instance input layout");
+
+/// <summary>
+/// 1フレーム分のインスタンスをためるバッファ
+/// 形状の頂点はGPUに置いたままなので、CPUの仕事は頂点数ではなくインスタンス数に比例する
+/// Clear後も容量は残すので、定常状態ではメモリを確保しない
+/// </summary>
+class WireframeInstanceBuffer {
+public:
+	void Clear() { instances_.clear(); }
+	void Reserve(size_t instanceCount) { instances_.reserve(instanceCount); }
+
+	void Add(const Matrix4x4& world, uint32_t color);
+	void AddSphere(const Vector3& center, float radius, uint32_t color) { Add(MakeSphereInstanceMatrix(center, radius), color); }
+	void AddPlane(const Plane& plane, uint32_t color) { Add(MakePlaneInstanceMatrix(plane), color); }
+
+	std::span<const WireframeInstance> GetInstances() const { return instances_; }
+	size_t GetByteSize() const { return instances_.size() * sizeof(WireframeInstance); }
+	size_t GetCapacity() const { return instances_.capacity(); }
+
+private:
+	std::vector<WireframeInstance> instances_;
+};
+
+/// <summary>
+/// 視錐台に入る球だけをインスタンスとして追加する
+/// </summary>
+/// <param name="buffer">追加先</param>
+/// <param name="frustum">視錐台</param>
+/// <param name="spheres">球の列</param>
+/// <param name="visible">CullSpheresの作業領域(球と同じ要素数)</param>
+/// <param name="color">色</param>
+/// <returns>追加した数</returns>
+size_t AddVisibleSpheres(WireframeInstanceBuffer& buffer, const Frustum& frustum, const SpheresSoA& spheres, std::span<uint8_t> visible, uint32_t color);
+
+/// <summary>
+/// InstancedPrimitiveVS.hlslと同じ計算をCPUで行い、線をDebugDrawへ追加する(GPUが使えないときと検証用)
+/// 端点のどちらかがカメラの後ろにある線は追加しない(GPUは近平面で切って描く)
+/// </summary>
+/// <param name="mesh">形状</param>
+/// <param name="instances">インスタンス</param>
+/// <param name="viewProjectionViewportMatrix">Multiply(viewProjectionMatrix, viewportMatrix)</param>
+/// <param name="debugDraw">追加先</param>
+/// <returns>追加した線の数</returns>
+size_t DrawWireframeInstancesCpu(const WireframeMesh& mesh, std::span<const WireframeInstance> instances, const Matrix4x4& viewProjectionViewportMatrix, DebugDraw& debugDraw);
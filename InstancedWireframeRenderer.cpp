@@ -0,0 +1,227 @@
+#include "InstancedWireframeRenderer.h"
+#include <algorithm>
+#include <cstring>
+#include <d3dcompiler.h>
+#include <string>
+
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+using Microsoft::WRL::ComPtr;
+
+namespace {
+
+	// Primitive.hlsliのcbuffer ViewProjection(定数バッファは256バイト単位)
+	struct ViewProjectionConstants {
+		Matrix4x4 view;
+		Matrix4x4 projection;
+		Vector3 cameraPos;
+	};
+	const UINT kConstantBufferSize = (sizeof(ViewProjectionConstants) + 255) & ~255u;
+
+	// CPUから書き込めるバッファを作る
+	ComPtr<ID3D12Resource> CreateUploadBuffer(ID3D12Device* device, UINT64 size) {
+		D3D12_HEAP_PROPERTIES heapProperties = {};
+		heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+		D3D12_RESOURCE_DESC desc = {};
+		desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+		desc.Width = size;
+		desc.Height = 1;
+		desc.DepthOrArraySize = 1;
+		desc.MipLevels = 1;
+		desc.SampleDesc.Count = 1;
+		desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+		ComPtr<ID3D12Resource> buffer;
+		if (FAILED(device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &desc,
+			D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&buffer)))) {
+			return nullptr;
+		}
+		return buffer;
+	}
+
+	ComPtr<ID3DBlob> CompileShader(const std::wstring& path, const char* profile) {
+		ComPtr<ID3DBlob> blob;
+		ComPtr<ID3DBlob> errors;
+		HRESULT result = D3DCompileFromFile(path.c_str(), nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE,
+			"main", profile, D3DCOMPILE_ENABLE_STRICTNESS, 0, &blob, &errors);
+		if (FAILED(result)) {
+			if (errors) {
+				OutputDebugStringA(static_cast<const char*>(errors->GetBufferPointer()));
+			}
+			return nullptr;
+		}
+		return blob;
+	}
+
+}
+
+bool InstancedWireframeRenderer::Initialize(ID3D12Device* device, uint32_t sphereSubdivision,
+	DXGI_FORMAT renderTargetFormat, DXGI_FORMAT depthFormat, const wchar_t* shaderDirectory)
+{
+	if (!device) {
+		return false;
+	}
+
+	// ルートシグネチャ(b0にViewProjectionのCBVを1つだけ)
+	D3D12_ROOT_PARAMETER rootParameter = {};
+	rootParameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+	rootParameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+	rootParameter.Descriptor.ShaderRegister = 0;
+
+	D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+	rootSignatureDesc.NumParameters = 1;
+	rootSignatureDesc.pParameters = &rootParameter;
+	rootSignatureDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+	ComPtr<ID3DBlob> signature;
+	ComPtr<ID3DBlob> errors;
+	if (FAILED(D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &errors)) ||
+		FAILED(device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&rootSignature_)))) {
+		return false;
+	}
+
+	std::wstring directory = shaderDirectory;
+	ComPtr<ID3DBlob> vertexShader = CompileShader(directory + L"InstancedPrimitiveVS.hlsl", "vs_5_0");
+	ComPtr<ID3DBlob> pixelShader = CompileShader(directory + L"PrimitivePS.hlsl", "ps_5_0");
+	if (!vertexShader || !pixelShader) {
+		return false;
+	}
+
+	// スロット0は形状の頂点、スロット1はインスタンス(WireframeInstanceの並び)
+	const D3D12_INPUT_ELEMENT_DESC inputLayout[] = {
+		{ "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 16, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{ "WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{ "WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{ "WORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{ "INSTANCE_COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 64, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+	};
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC pipelineDesc = {};
+	pipelineDesc.pRootSignature = rootSignature_.Get();
+	pipelineDesc.VS = { vertexShader->GetBufferPointer(), vertexShader->GetBufferSize() };
+	pipelineDesc.PS = { pixelShader->GetBufferPointer(), pixelShader->GetBufferSize() };
+	pipelineDesc.InputLayout = { inputLayout, _countof(inputLayout) };
+	pipelineDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE;
+	pipelineDesc.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
+	pipelineDesc.SampleDesc.Count = 1;
+
+	// 線は裏表が無いのでカリングしない
+	pipelineDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+	pipelineDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+	pipelineDesc.RasterizerState.DepthClipEnable = TRUE;
+
+	// 色はアルファブレンド
+	D3D12_RENDER_TARGET_BLEND_DESC& blend = pipelineDesc.BlendState.RenderTarget[0];
+	blend.BlendEnable = TRUE;
+	blend.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+	blend.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+	blend.BlendOp = D3D12_BLEND_OP_ADD;
+	blend.SrcBlendAlpha = D3D12_BLEND_ONE;
+	blend.DestBlendAlpha = D3D12_BLEND_ZERO;
+	blend.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+	blend.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+	pipelineDesc.NumRenderTargets = 1;
+	pipelineDesc.RTVFormats[0] = renderTargetFormat;
+	pipelineDesc.DSVFormat = depthFormat;
+	pipelineDesc.DepthStencilState.DepthEnable = depthFormat != DXGI_FORMAT_UNKNOWN;
+	pipelineDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+	pipelineDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
+
+	if (FAILED(device->CreateGraphicsPipelineState(&pipelineDesc, IID_PPV_ARGS(&pipelineState_)))) {
+		return false;
+	}
+
+	// 形状は1度だけ送る(頂点数が少ないのでUPLOADヒープに置いたまま使う)
+	if (!CreateMeshBuffer(device, MakeSphereWireframeMesh(sphereSubdivision), meshes_[static_cast<size_t>(Shape::kSphere)]) ||
+		!CreateMeshBuffer(device, MakeGridWireframeMesh(), meshes_[static_cast<size_t>(Shape::kGrid)]) ||
+		!CreateMeshBuffer(device, MakePlaneWireframeMesh(), meshes_[static_cast<size_t>(Shape::kPlane)])) {
+		pipelineState_.Reset();
+		return false;
+	}
+
+	// 定数とインスタンスはマップしたまま毎フレーム書き換える
+	constantBuffer_ = CreateUploadBuffer(device, kConstantBufferSize);
+	instanceBuffer_ = CreateUploadBuffer(device, static_cast<UINT64>(kMaxInstances) * sizeof(WireframeInstance));
+	if (!constantBuffer_ || !instanceBuffer_ ||
+		FAILED(constantBuffer_->Map(0, nullptr, &constantData_)) ||
+		FAILED(instanceBuffer_->Map(0, nullptr, reinterpret_cast<void**>(&instanceData_)))) {
+		pipelineState_.Reset();
+		return false;
+	}
+	return true;
+}
+
+void InstancedWireframeRenderer::BeginFrame(const Matrix4x4& viewMatrix, const Matrix4x4& projectionMatrix, const Vector3& cameraPosition)
+{
+	instanceOffset_ = 0;
+	if (!constantData_) {
+		return;
+	}
+	ViewProjectionConstants constants = { viewMatrix, projectionMatrix, cameraPosition };
+	std::memcpy(constantData_, &constants, sizeof(constants));
+}
+
+uint32_t InstancedWireframeRenderer::Draw(ID3D12GraphicsCommandList* commandList, Shape shape, std::span<const WireframeInstance> instances)
+{
+	if (!IsInitialized() || !commandList) {
+		return 0;
+	}
+
+	uint32_t instanceCount = static_cast<uint32_t>(std::min<size_t>(instances.size(), kMaxInstances - instanceOffset_));
+	if (instanceCount == 0) {
+		return 0;
+	}
+
+	// このフレームで前に描いた分の後ろへ書き足す
+	std::memcpy(instanceData_ + instanceOffset_, instances.data(), instanceCount * sizeof(WireframeInstance));
+	D3D12_VERTEX_BUFFER_VIEW views[2];
+	const MeshBuffer& mesh = meshes_[static_cast<size_t>(shape)];
+	views[0] = mesh.vertexBufferView;
+	views[1].BufferLocation = instanceBuffer_->GetGPUVirtualAddress() + instanceOffset_ * sizeof(WireframeInstance);
+	views[1].SizeInBytes = instanceCount * sizeof(WireframeInstance);
+	views[1].StrideInBytes = sizeof(WireframeInstance);
+	instanceOffset_ += instanceCount;
+
+	commandList->SetGraphicsRootSignature(rootSignature_.Get());
+	commandList->SetPipelineState(pipelineState_.Get());
+	commandList->SetGraphicsRootConstantBufferView(0, constantBuffer_->GetGPUVirtualAddress());
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
+	commandList->IASetVertexBuffers(0, 2, views);
+	commandList->IASetIndexBuffer(&mesh.indexBufferView);
+	commandList->DrawIndexedInstanced(mesh.indexCount, instanceCount, 0, 0, 0);
+	return instanceCount;
+}
+
+bool InstancedWireframeRenderer::CreateMeshBuffer(ID3D12Device* device, const WireframeMesh& mesh, MeshBuffer& buffer)
+{
+	const UINT vertexBytes = static_cast<UINT>(mesh.vertices.size() * sizeof(WireframeVertex));
+	const UINT indexBytes = static_cast<UINT>(mesh.indices.size() * sizeof(uint32_t));
+	buffer.vertexBuffer = CreateUploadBuffer(device, vertexBytes);
+	buffer.indexBuffer = CreateUploadBuffer(device, indexBytes);
+	if (!buffer.vertexBuffer || !buffer.indexBuffer) {
+		return false;
+	}
+
+	void* data = nullptr;
+	if (FAILED(buffer.vertexBuffer->Map(0, nullptr, &data))) {
+		return false;
+	}
+	std::memcpy(data, mesh.vertices.data(), vertexBytes);
+	buffer.vertexBuffer->Unmap(0, nullptr);
+
+	if (FAILED(buffer.indexBuffer->Map(0, nullptr, &data))) {
+		return false;
+	}
+	std::memcpy(data, mesh.indices.data(), indexBytes);
+	buffer.indexBuffer->Unmap(0, nullptr);
+
+	buffer.vertexBufferView = { buffer.vertexBuffer->GetGPUVirtualAddress(), vertexBytes, sizeof(WireframeVertex) };
+	buffer.indexBufferView = { buffer.indexBuffer->GetGPUVirtualAddress(), indexBytes, DXGI_FORMAT_R32_UINT };
+	buffer.indexCount = static_cast<uint32_t>(mesh.indices.size());
+	return true;
+}
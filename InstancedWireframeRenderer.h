@@ -0,0 +1,83 @@
+#pragma once
+#include "InstancedWireframe.h"
+#include <Matrix4x4.h>
+#include <Vector3.h>
+#include <cstddef>
+#include <cstdint>
+#include <d3d12.h>
+#include <span>
+#include <wrl.h>
+
+/// <summary>
+/// WireframeInstanceBufferの中身をDrawIndexedInstancedで描くD3D12の描画側(Windowsのみ)
+/// 形状(球・グリッド・平面)の頂点はInitializeで1度だけ送り、毎フレーム送るのはインスタンスと
+/// ViewProjectionの定数だけ。頂点シェーダーはInstancedPrimitiveVS.hlsl、ピクセルシェーダーはPrimitivePS.hlsl
+/// インスタンス用のバッファはフレームごとに先頭から使うので、前のフレームのGPU処理を待ってからBeginFrameを呼ぶこと
+/// </summary>
+class InstancedWireframeRenderer {
+public:
+	// 1フレームに描けるインスタンスの合計
+	static const uint32_t kMaxInstances = 4096;
+
+	enum class Shape {
+		kSphere,
+		kGrid,
+		kPlane,
+		kCount,
+	};
+
+	/// <summary>
+	/// シェーダーのコンパイルとパイプライン・形状のバッファの作成
+	/// </summary>
+	/// <param name="device">デバイス</param>
+	/// <param name="sphereSubdivision">球の分割数</param>
+	/// <param name="renderTargetFormat">描画先の形式</param>
+	/// <param name="depthFormat">深度バッファの形式(無ければDXGI_FORMAT_UNKNOWN)</param>
+	/// <param name="shaderDirectory">シェーダーの置き場所</param>
+	/// <returns>すべて作れたらtrue(falseのときはDrawWireframeInstancesCpuで描く)</returns>
+	bool Initialize(ID3D12Device* device, uint32_t sphereSubdivision = 8,
+		DXGI_FORMAT renderTargetFormat = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DXGI_FORMAT depthFormat = DXGI_FORMAT_D32_FLOAT,
+		const wchar_t* shaderDirectory = L"NoviceResources/shaders/");
+
+	bool IsInitialized() const { return pipelineState_ != nullptr; }
+
+	// フレームの始めにインスタンス用のバッファを先頭に戻し、ViewProjectionを書き込む
+	void BeginFrame(const Matrix4x4& viewMatrix, const Matrix4x4& projectionMatrix, const Vector3& cameraPosition);
+
+	/// <summary>
+	/// インスタンスをアップロードして描画コマンドを積む(描画先と深度はすでに設定されていること)
+	/// </summary>
+	/// <param name="commandList">コマンドリスト</param>
+	/// <param name="shape">形状</param>
+	/// <param name="instances">インスタンス</param>
+	/// <returns>描いたインスタンスの数(kMaxInstancesを超えた分は描かない)</returns>
+	uint32_t Draw(ID3D12GraphicsCommandList* commandList, Shape shape, std::span<const WireframeInstance> instances);
+
+	// このフレームでアップロードしたインスタンスのバイト数
+	size_t GetUploadedBytes() const { return instanceOffset_ * sizeof(WireframeInstance); }
+
+private:
+	struct MeshBuffer {
+		Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer;
+		Microsoft::WRL::ComPtr<ID3D12Resource> indexBuffer;
+		D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
+		D3D12_INDEX_BUFFER_VIEW indexBufferView;
+		uint32_t indexCount;
+	};
+
+	bool CreateMeshBuffer(ID3D12Device* device, const WireframeMesh& mesh, MeshBuffer& buffer);
+
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature_;
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineState_;
+
+	MeshBuffer meshes_[static_cast<size_t>(Shape::kCount)] = {};
+
+	// ViewProjection定数(Primitive.hlsliのcbuffer ViewProjection)
+	Microsoft::WRL::ComPtr<ID3D12Resource> constantBuffer_;
+	void* constantData_ = nullptr;
+
+	// インスタンス(kMaxInstances個分をマップしたまま使う)
+	Microsoft::WRL::ComPtr<ID3D12Resource> instanceBuffer_;
+	WireframeInstance* instanceData_ = nullptr;
+	uint32_t instanceOffset_ = 0;
+};
@@ -0,0 +1,152 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+namespace {
+
+	// 今のスレッドがワーカーとして属しているシステムとキュー
+	thread_local const JobSystem* currentSystem = nullptr;
+	thread_local uint32_t currentQueueIndex = 0;
+
+}
+
+JobSystem::JobSystem(uint32_t workerCount)
+{
+	queues_.reserve(workerCount + 1);
+	for (uint32_t i = 0; i < workerCount + 1; ++i) {
+		queues_.push_back(std::make_unique<Queue>());
+	}
+
+	threads_.reserve(workerCount);
+	for (uint32_t i = 0; i < workerCount; ++i) {
+		threads_.emplace_back(&JobSystem::WorkerMain, this, i + 1);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		quit_ = true;
+	}
+	wake_.notify_all();
+
+	for (std::thread& thread : threads_) {
+		thread.join();
+	}
+}
+
+uint32_t JobSystem::GetDefaultWorkerCount()
+{
+	uint32_t hardwareThreads = std::thread::hardware_concurrency();
+	return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+uint32_t JobSystem::GetCurrentQueueIndex() const
+{
+	return currentSystem == this ? currentQueueIndex : 0;
+}
+
+void JobSystem::Dispatch(JobFunction function, void* context, size_t count, size_t grainSize)
+{
+	size_t chunkCount = GetChunkCount(count, grainSize);
+	if (chunkCount == 0) {
+		return;
+	}
+
+	// ワーカーがいない、または塊が1つなら積まずにその場で実行する
+	if (threads_.empty() || chunkCount == 1) {
+		for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+			size_t begin = chunk * grainSize;
+			function(context, begin, std::min(begin + grainSize, count));
+		}
+		return;
+	}
+
+	std::atomic<size_t> remaining = chunkCount;
+
+	// 連続した塊をまとめて各キューへ配る(盗まれなければ各スレッドが連続した範囲を処理する)
+	size_t queueCount = queues_.size();
+	size_t chunksPerQueue = (chunkCount + queueCount - 1) / queueCount;
+	for (size_t queue = 0; queue < queueCount; ++queue) {
+		size_t firstChunk = queue * chunksPerQueue;
+		size_t lastChunk = std::min(firstChunk + chunksPerQueue, chunkCount);
+		if (firstChunk >= lastChunk) {
+			break;
+		}
+
+		std::lock_guard<std::mutex> lock(queues_[queue]->mutex);
+		// 末尾から取り出すので、後ろの塊から積んで先頭の塊から実行されるようにする
+		for (size_t chunk = lastChunk; chunk-- > firstChunk;) {
+			size_t begin = chunk * grainSize;
+			queues_[queue]->jobs.push_back({ function, context, begin, std::min(begin + grainSize, count), &remaining });
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		queuedJobs_.fetch_add(chunkCount);
+	}
+	wake_.notify_all();
+
+	// 終わるまで呼び出し側も実行に加わる
+	uint32_t queueIndex = GetCurrentQueueIndex();
+	while (remaining.load(std::memory_order_acquire) != 0) {
+		if (!TryRunJob(queueIndex)) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+bool JobSystem::TryRunJob(uint32_t queueIndex)
+{
+	Job job;
+	bool found = false;
+
+	{
+		Queue& own = *queues_[queueIndex];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.jobs.empty()) {
+			job = own.jobs.back();
+			own.jobs.pop_back();
+			found = true;
+		}
+	}
+
+	uint32_t queueCount = static_cast<uint32_t>(queues_.size());
+	for (uint32_t offset = 1; !found && offset < queueCount; ++offset) {
+		Queue& victim = *queues_[(queueIndex + offset) % queueCount];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.jobs.empty()) {
+			job = victim.jobs.front();
+			victim.jobs.pop_front();
+			found = true;
+		}
+	}
+
+	if (!found) {
+		return false;
+	}
+
+	queuedJobs_.fetch_sub(1);
+	job.function(job.context, job.begin, job.end);
+	job.remaining->fetch_sub(1, std::memory_order_release);
+	return true;
+}
+
+void JobSystem::WorkerMain(uint32_t queueIndex)
+{
+	currentSystem = this;
+	currentQueueIndex = queueIndex;
+
+	for (;;) {
+		if (TryRunJob(queueIndex)) {
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex_);
+		wake_.wait(lock, [this] { return quit_ || queuedJobs_.load() != 0; });
+		if (quit_) {
+			return;
+		}
+	}
+}
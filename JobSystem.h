@@ -0,0 +1,116 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/// <summary>
+/// ワークスティーリング方式のジョブシステム
+/// スレッドごとにジョブのキューを持ち、自分のキューが空になったら他のキューから盗む
+/// ParallelForは範囲をgrainSizeごとの固定の塊に分けるので、塊の切れ目はスレッド数に依存しない
+/// (塊ごとに別の出力先へ書けば、結果はスレッド数によらず同じになる)
+/// </summary>
+class JobSystem {
+public:
+	/// <summary>
+	/// ワーカースレッドを起動する
+	/// </summary>
+	/// <param name="workerCount">ワーカー数(呼び出し側のスレッドは含まない)。0ならワーカーなしで呼び出し側だけが実行する</param>
+	explicit JobSystem(uint32_t workerCount);
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	/// <summary>
+	/// 論理コア数 - 1 (呼び出し側のスレッドを除いたワーカー数の目安)
+	/// </summary>
+	static uint32_t GetDefaultWorkerCount();
+
+	// 呼び出し側を含めた実行スレッド数
+	uint32_t GetThreadCount() const { return static_cast<uint32_t>(queues_.size()); }
+
+	/// <summary>
+	/// [0, count)をgrainSizeごとに分けてfunction(begin, end)を並列に呼ぶ
+	/// すべての塊が終わるまで戻らない(待っている間は呼び出し側も塊を実行する)
+	/// </summary>
+	template<typename Function>
+	void ParallelFor(size_t count, size_t grainSize, Function&& function);
+
+	/// <summary>
+	/// 塊ごとにfunction(begin, end, results)で結果を集め、塊の順に連結する
+	/// 結果の並びは逐次実行したときと同じになる
+	/// </summary>
+	template<typename T, typename Function>
+	void ParallelCollect(size_t count, size_t grainSize, std::vector<T>& results, Function&& function);
+
+	static size_t GetChunkCount(size_t count, size_t grainSize) {
+		return grainSize == 0 ? (count == 0 ? 0 : 1) : (count + grainSize - 1) / grainSize;
+	}
+
+private:
+	typedef void (*JobFunction)(void* context, size_t begin, size_t end);
+
+	struct Job {
+		JobFunction function;
+		void* context;
+		size_t begin;
+		size_t end;
+		std::atomic<size_t>* remaining;// 同じParallelForの残り塊数
+	};
+
+	// キューごとにロックを持つ(偽共有を避けるためキャッシュライン単位に置く)
+	struct alignas(64) Queue {
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	void Dispatch(JobFunction function, void* context, size_t count, size_t grainSize);
+
+	/// <summary>
+	/// 自分のキューの末尾から取り出し、空なら他のキューの先頭から盗んで1つ実行する
+	/// </summary>
+	/// <returns>実行したらtrue</returns>
+	bool TryRunJob(uint32_t queueIndex);
+
+	void WorkerMain(uint32_t queueIndex);
+
+	// 今のスレッドが使うキュー(このシステムのワーカーでなければ0)
+	uint32_t GetCurrentQueueIndex() const;
+
+	std::vector<std::unique_ptr<Queue>> queues_;// [0]は呼び出し側のスレッド用
+	std::vector<std::thread> threads_;
+
+	std::mutex sleepMutex_;
+	std::condition_variable wake_;
+	std::atomic<size_t> queuedJobs_ = 0;
+	bool quit_ = false;
+};
+
+template<typename Function>
+inline void JobSystem::ParallelFor(size_t count, size_t grainSize, Function&& function) {
+	typedef std::remove_reference_t<Function> FunctionType;
+	JobFunction invoke = [](void* context, size_t begin, size_t end) {
+		(*static_cast<FunctionType*>(context))(begin, end);
+		};
+	Dispatch(invoke, const_cast<void*>(static_cast<const void*>(&function)), count, grainSize);
+}
+
+template<typename T, typename Function>
+inline void JobSystem::ParallelCollect(size_t count, size_t grainSize, std::vector<T>& results, Function&& function) {
+	std::vector<std::vector<T>> chunks(GetChunkCount(count, grainSize));
+	ParallelFor(count, grainSize, [&](size_t begin, size_t end) {
+		function(begin, end, chunks[grainSize == 0 ? 0 : begin / grainSize]);
+		});
+
+	results.clear();
+	for (const std::vector<T>& chunk : chunks) {
+		results.insert(results.end(), chunk.begin(), chunk.end());
+	}
+}
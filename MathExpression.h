@@ -0,0 +1,352 @@
+#pragma once
+#include <Matrix4x4.h>
+#include <Vector3.h>
+#include <cmath>
+#include <concepts>
+#include <limits>
+#include <type_traits>
+
+// コンパイル時にも使える(constexpr)ベクトル・行列の計算と演算子
+// ベクトルの演算子は式テンプレートを返し、Vector3へ代入した時点で成分ごとに1回で計算する
+//   Vector3 p = origin + t * direction;// 途中のVector3を作らない
+// 式は値(Vector3)をコピーして持つので、autoで受け取っても元の変数の寿命には依存しない
+namespace Math {
+
+	template<typename T>
+	concept VectorExpression = std::same_as<std::remove_cvref_t<T>, Vector3> || requires { std::remove_cvref_t<T>::kIsVectorExpression; };
+
+	constexpr float Get(const Vector3& v, int index) {
+		return index == 0 ? v.x : (index == 1 ? v.y : v.z);
+	}
+
+	template<VectorExpression E>
+		requires (!std::same_as<E, Vector3>)
+	constexpr float Get(const E& expression, int index) {
+		return expression.Get(index);
+	}
+
+	/// <summary>
+	/// 式を計算してVector3にする
+	/// </summary>
+	template<VectorExpression E>
+	constexpr Vector3 Evaluate(const E& expression) {
+		return { Get(expression, 0), Get(expression, 1), Get(expression, 2) };
+	}
+
+	// 式のノード(演算子から作られるので直接使うことは無い)
+	struct AddOperation {
+		static constexpr float Apply(float a, float b) { return a + b; }
+	};
+
+	struct SubtractOperation {
+		static constexpr float Apply(float a, float b) { return a - b; }
+	};
+
+	template<typename Left, typename Right, typename Operation>
+	struct BinaryExpression {
+		static constexpr bool kIsVectorExpression = true;
+		Left left;
+		Right right;
+
+		constexpr float Get(int index) const { return Operation::Apply(Math::Get(left, index), Math::Get(right, index)); }
+		constexpr operator Vector3() const { return Evaluate(*this); }
+	};
+
+	template<typename Operand>
+	struct ScaleExpression {
+		static constexpr bool kIsVectorExpression = true;
+		float scalar;
+		Operand operand;
+
+		constexpr float Get(int index) const { return scalar * Math::Get(operand, index); }
+		constexpr operator Vector3() const { return Evaluate(*this); }
+	};
+
+	/// <summary>
+	/// 平方根(コンパイル時はニュートン法、実行時はstd::sqrt)
+	/// </summary>
+	constexpr float Sqrt(float value) {
+		if (!std::is_constant_evaluated()) {
+			return std::sqrt(value);
+		}
+		if (!(value > 0.0f)) {
+			return value == 0.0f ? 0.0f : std::numeric_limits<float>::quiet_NaN();
+		}
+		double x = value;
+		double previous = 0.0;
+		for (int i = 0; i < 64 && x != previous; ++i) {
+			previous = x;
+			x = 0.5 * (x + value / x);
+		}
+		return static_cast<float>(x);
+	}
+
+	template<VectorExpression A, VectorExpression B>
+	constexpr float Dot(const A& a, const B& b) {
+		return Get(a, 0) * Get(b, 0) + Get(a, 1) * Get(b, 1) + Get(a, 2) * Get(b, 2);
+	}
+
+	template<VectorExpression A, VectorExpression B>
+	constexpr Vector3 Cross(const A& a, const B& b) {
+		// 各成分を2回ずつ読むので、先に1回だけ計算しておく
+		const Vector3 u = Evaluate(a);
+		const Vector3 v = Evaluate(b);
+		return { u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x };
+	}
+
+	template<VectorExpression E>
+	constexpr float GetLengthSquared(const E& v) {
+		const Vector3 u = Evaluate(v);
+		return Dot(u, u);
+	}
+
+	template<VectorExpression E>
+	constexpr float GetLength(const E& v) {
+		return Sqrt(GetLengthSquared(v));
+	}
+
+	/// <summary>
+	/// 正規化(MathFunctionのNormalizeと同じく、長さ0のチェックはしない)
+	/// </summary>
+	template<VectorExpression E>
+	constexpr Vector3 Normalize(const E& v) {
+		const Vector3 u = Evaluate(v);
+		const float length = Sqrt(Dot(u, u));
+		return { u.x / length, u.y / length, u.z / length };
+	}
+
+	/// <summary>
+	/// v1をv2へ射影する(v2が0ならゼロベクトル)
+	/// </summary>
+	template<VectorExpression A, VectorExpression B>
+	constexpr Vector3 Project(const A& v1, const B& v2) {
+		const Vector3 u = Evaluate(v1);
+		const Vector3 v = Evaluate(v2);
+		const float normSquared = Dot(v, v);
+		if (normSquared == 0.0f) {
+			return { 0.0f, 0.0f, 0.0f };
+		}
+		const float scale = Dot(u, v) / normSquared;
+		return { scale * v.x, scale * v.y, scale * v.z };
+	}
+
+	constexpr Matrix4x4 MakeIdentityMatrix() {
+		return { {
+			{ 1.0f, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, 1.0f, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, 1.0f, 0.0f },
+			{ 0.0f, 0.0f, 0.0f, 1.0f },
+		} };
+	}
+
+	constexpr Matrix4x4 kIdentityMatrix = MakeIdentityMatrix();
+
+	constexpr Matrix4x4 MakeScaleMatrix(const Vector3& scale) {
+		return { {
+			{ scale.x, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, scale.y, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, scale.z, 0.0f },
+			{ 0.0f, 0.0f, 0.0f, 1.0f },
+		} };
+	}
+
+	constexpr Matrix4x4 MakeTranslateMatrix(const Vector3& translate) {
+		return { {
+			{ 1.0f, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, 1.0f, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, 1.0f, 0.0f },
+			{ translate.x, translate.y, translate.z, 1.0f },
+		} };
+	}
+
+	/// <summary>
+	/// ::MakeViewportMatrixと同じ行列(固定の画面サイズならコンパイル時に作れる)
+	/// </summary>
+	constexpr Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth) {
+		return { {
+			{ width / 2.0f, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, -height / 2.0f, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, maxDepth - minDepth, 0.0f },
+			{ left + width / 2.0f, top + height / 2.0f, minDepth, 1.0f },
+		} };
+	}
+
+	constexpr Matrix4x4 Transpose(const Matrix4x4& matrix) {
+		Matrix4x4 result = {};
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				result.m[row][column] = matrix.m[column][row];
+			}
+		}
+		return result;
+	}
+
+	constexpr Matrix4x4 Multiply(const Matrix4x4& matrix1, const Matrix4x4& matrix2) {
+		Matrix4x4 result = {};
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				result.m[row][column] =
+					matrix1.m[row][0] * matrix2.m[0][column] + matrix1.m[row][1] * matrix2.m[1][column] +
+					matrix1.m[row][2] * matrix2.m[2][column] + matrix1.m[row][3] * matrix2.m[3][column];
+			}
+		}
+		return result;
+	}
+
+	/// <summary>
+	/// 4x4逆行列(2x2の小行列式から求める)
+	/// 行列式が0なら単位行列を返す
+	/// 定数を作るためのもので、実行時はSIMD版がある::Inverseの方が速い
+	/// </summary>
+	constexpr Matrix4x4 Inverse(const Matrix4x4& matrix) {
+		const float (&m)[4][4] = matrix.m;
+
+		// 上2行と下2行の2x2小行列式
+		const float s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+		const float s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+		const float s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+		const float s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+		const float s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+		const float s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+
+		const float c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+		const float c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+		const float c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+		const float c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+		const float c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+		const float c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+
+		const float determinant = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+		if (determinant == 0.0f) {
+			return kIdentityMatrix;
+		}
+		const float inverseDeterminant = 1.0f / determinant;
+
+		Matrix4x4 result = {};
+		result.m[0][0] = (m[1][1] * c5 - m[1][2] * c4 + m[1][3] * c3) * inverseDeterminant;
+		result.m[0][1] = (-m[0][1] * c5 + m[0][2] * c4 - m[0][3] * c3) * inverseDeterminant;
+		result.m[0][2] = (m[3][1] * s5 - m[3][2] * s4 + m[3][3] * s3) * inverseDeterminant;
+		result.m[0][3] = (-m[2][1] * s5 + m[2][2] * s4 - m[2][3] * s3) * inverseDeterminant;
+
+		result.m[1][0] = (-m[1][0] * c5 + m[1][2] * c2 - m[1][3] * c1) * inverseDeterminant;
+		result.m[1][1] = (m[0][0] * c5 - m[0][2] * c2 + m[0][3] * c1) * inverseDeterminant;
+		result.m[1][2] = (-m[3][0] * s5 + m[3][2] * s2 - m[3][3] * s1) * inverseDeterminant;
+		result.m[1][3] = (m[2][0] * s5 - m[2][2] * s2 + m[2][3] * s1) * inverseDeterminant;
+
+		result.m[2][0] = (m[1][0] * c4 - m[1][1] * c2 + m[1][3] * c0) * inverseDeterminant;
+		result.m[2][1] = (-m[0][0] * c4 + m[0][1] * c2 - m[0][3] * c0) * inverseDeterminant;
+		result.m[2][2] = (m[3][0] * s4 - m[3][1] * s2 + m[3][3] * s0) * inverseDeterminant;
+		result.m[2][3] = (-m[2][0] * s4 + m[2][1] * s2 - m[2][3] * s0) * inverseDeterminant;
+
+		result.m[3][0] = (-m[1][0] * c3 + m[1][1] * c1 - m[1][2] * c0) * inverseDeterminant;
+		result.m[3][1] = (m[0][0] * c3 - m[0][1] * c1 + m[0][2] * c0) * inverseDeterminant;
+		result.m[3][2] = (-m[3][0] * s3 + m[3][1] * s1 - m[3][2] * s0) * inverseDeterminant;
+		result.m[3][3] = (m[2][0] * s3 - m[2][1] * s1 + m[2][2] * s0) * inverseDeterminant;
+		return result;
+	}
+
+	/// <summary>
+	/// 点を変換してwで割る(::Transformと同じ。wが0のときは割らない)
+	/// </summary>
+	template<VectorExpression E>
+	constexpr Vector3 Transform(const E& point, const Matrix4x4& matrix) {
+		const Vector3 v = Evaluate(point);
+		const float (&m)[4][4] = matrix.m;
+		const float x = v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0] + m[3][0];
+		const float y = v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1] + m[3][1];
+		const float z = v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2] + m[3][2];
+		const float w = v.x * m[0][3] + v.y * m[1][3] + v.z * m[2][3] + m[3][3];
+		if (w == 0.0f) {
+			return { x, y, z };
+		}
+		return { x / w, y / w, z / w };
+	}
+
+	/// <summary>
+	/// 方向ベクトルを変換する(平行移動とwを無視する)
+	/// </summary>
+	template<VectorExpression E>
+	constexpr Vector3 TransformDirection(const E& direction, const Matrix4x4& matrix) {
+		const Vector3 v = Evaluate(direction);
+		const float (&m)[4][4] = matrix.m;
+		return {
+			v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0],
+			v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1],
+			v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2],
+		};
+	}
+
+	constexpr bool Equals(const Vector3& a, const Vector3& b) {
+		return a.x == b.x && a.y == b.y && a.z == b.z;
+	}
+
+	constexpr bool Equals(const Matrix4x4& a, const Matrix4x4& b) {
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				if (a.m[row][column] != b.m[row][column]) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+}
+
+// Vector3とMatrix4x4はグローバル名前空間の型なので、演算子もグローバルに置く
+template<Math::VectorExpression L, Math::VectorExpression R>
+constexpr Math::BinaryExpression<std::remove_cvref_t<L>, std::remove_cvref_t<R>, Math::AddOperation> operator+(const L& left, const R& right) {
+	return { left, right };
+}
+
+template<Math::VectorExpression L, Math::VectorExpression R>
+constexpr Math::BinaryExpression<std::remove_cvref_t<L>, std::remove_cvref_t<R>, Math::SubtractOperation> operator-(const L& left, const R& right) {
+	return { left, right };
+}
+
+template<Math::VectorExpression E>
+constexpr Math::ScaleExpression<std::remove_cvref_t<E>> operator*(float scalar, const E& vector) {
+	return { scalar, vector };
+}
+
+template<Math::VectorExpression E>
+constexpr Math::ScaleExpression<std::remove_cvref_t<E>> operator*(const E& vector, float scalar) {
+	return { scalar, vector };
+}
+
+template<Math::VectorExpression E>
+constexpr Math::ScaleExpression<std::remove_cvref_t<E>> operator/(const E& vector, float scalar) {
+	return { 1.0f / scalar, vector };
+}
+
+template<Math::VectorExpression E>
+constexpr Math::ScaleExpression<std::remove_cvref_t<E>> operator-(const E& vector) {
+	return { -1.0f, vector };
+}
+
+template<Math::VectorExpression E>
+constexpr Vector3& operator+=(Vector3& vector, const E& expression) {
+	// 右辺がvector自身を含んでいても壊れないように、先に計算してから書き込む
+	vector = Math::Evaluate(vector + expression);
+	return vector;
+}
+
+template<Math::VectorExpression E>
+constexpr Vector3& operator-=(Vector3& vector, const E& expression) {
+	vector = Math::Evaluate(vector - expression);
+	return vector;
+}
+
+constexpr Vector3& operator*=(Vector3& vector, float scalar) {
+	vector = { vector.x * scalar, vector.y * scalar, vector.z * scalar };
+	return vector;
+}
+
+constexpr Matrix4x4 operator*(const Matrix4x4& matrix1, const Matrix4x4& matrix2) {
+	return Math::Multiply(matrix1, matrix2);
+}
+
+constexpr Matrix4x4& operator*=(Matrix4x4& matrix1, const Matrix4x4& matrix2) {
+	matrix1 = Math::Multiply(matrix1, matrix2);
+	return matrix1;
+}
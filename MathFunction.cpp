@@ -0,0 +1,798 @@
+#include "MathFunction.h"
+#include "MathFunctionSimd.h"
+#include <algorithm>
+#include <cmath>
+#include <assert.h>
+#include <bit>
+#include <cstdint>
+
+namespace {
+
+	// TryNormalizeで受け付ける長さの2乗の範囲(下は非正規化数を避ける)
+	const float kMinNormalizeLengthSq = 1.0e-30f;
+	const float kMaxNormalizeLengthSq = 3.0e38f;
+
+	// TryTransformで割ってよいwの大きさ
+	const float kMinTransformW = 1.0e-12f;
+
+}
+
+Vector3 Project(const Vector3& v1, const Vector3& v2) {
+	float dot = v1.x * v2.x + v1.y * v2.y + v1.z * v2.z; // v1・v2
+	float normSq = v2.x * v2.x + v2.y * v2.y + v2.z * v2.z; // ||v2||^2
+
+	if (normSq == 0.0f) {
+		return Vector3{ 0.0f, 0.0f, 0.0f }; // ゼロベクトルへの射影はゼロ
+	}
+
+	float scale = dot / normSq;
+	return Vector3{
+		scale * v2.x,
+		scale * v2.y,
+		scale * v2.z
+	};
+}
+
+Vector3 Subtract(const Vector3& v1, const Vector3& v2)
+{
+	Vector3 result;
+
+	result = { v1.x - v2.x,v1.y - v2.y ,v1.z - v2.z };
+
+	return result;
+}
+
+Vector3 Add(const Vector3& v1, const Vector3& v2)
+{
+	Vector3 result;
+
+	result = { v1.x + v2.x,v1.y + v2.y ,v1.z + v2.z };
+
+	return result;
+}
+
+Vector3 Multiply(float scalar, const Vector3& v)
+{
+	return { scalar * v.x, scalar * v.y, scalar * v.z };
+}
+
+float Dot(const Vector3& v1, const Vector3& v2)
+{
+	float dot =
+		v1.x * v2.x +
+		v1.y * v2.y +
+		v1.z * v2.z;
+
+	return dot;
+}
+
+float GetLength(const Vector3& v1)
+{
+	float length = sqrtf(v1.x * v1.x + v1.y * v1.y + v1.z * v1.z);
+
+	return length;
+}
+
+Vector3 Perpendicular(const Vector3& vector)
+{
+	if (vector.x != 0.0f || vector.y != 0.0f) {
+		return{ -vector.y,vector.x,0.0f };
+	}
+
+	return { 0.0f,-vector.z,vector.y };
+}
+
+Vector3 Normalize(const Vector3& v)
+{
+	Vector3 normalised;
+	float nolm;
+
+	nolm = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+
+	normalised = { v.x / nolm,v.y / nolm, v.z / nolm };
+
+	return normalised;
+}
+
+bool TryNormalize(const Vector3& v, Vector3& normalized)
+{
+	float lengthSq = v.x * v.x + v.y * v.y + v.z * v.z;
+	// NaNは比較がすべて偽になるので失敗側へ落ちる
+	bool valid = lengthSq >= kMinNormalizeLengthSq && lengthSq <= kMaxNormalizeLengthSq;
+
+	// 失敗したときも割る値は1にして、NaNや無限大を作らない
+	// (成分が無限大のときは0を掛けるとNaNになるので、結果も選び直す)
+	float inverseLength = 1.0f / std::sqrt(valid ? lengthSq : 1.0f);
+	normalized = {
+		valid ? v.x * inverseLength : 0.0f,
+		valid ? v.y * inverseLength : 0.0f,
+		valid ? v.z * inverseLength : 0.0f,
+	};
+	return valid;
+}
+
+Vector3 Cross(const Vector3& v1, const Vector3& v2)
+{
+	Vector3 result;
+
+	result.x = (v1.y * v2.z) - (v1.z * v2.y);
+	result.y = (v1.z * v2.x) - (v1.x * v2.z);
+	result.z = (v1.x * v2.y) - (v1.y * v2.x);
+
+	return result;
+}
+
+Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix)
+{
+#if defined(MT3_SIMD)
+	return TransformSimd(vector, matrix);
+#else
+	return TransformScalar(vector, matrix);
+#endif
+}
+
+bool TryTransform(const Vector3& vector, const Matrix4x4& matrix, Vector3& result)
+{
+	float x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + matrix.m[3][0];
+	float y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + matrix.m[3][1];
+	float z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + matrix.m[3][2];
+	float w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + matrix.m[3][3];
+
+	bool valid = std::fabs(w) >= kMinTransformW;
+	float inverseW = 1.0f / (valid ? w : 1.0f);
+	inverseW = valid ? inverseW : 0.0f;
+
+	result = { x * inverseW, y * inverseW, z * inverseW };
+	return valid;
+}
+
+Vector3 TransformScalar(const Vector3& vector, const Matrix4x4& matrix)
+{
+	Vector3 resultVector3;
+
+	resultVector3.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + 1.0f * matrix.m[3][0];
+	resultVector3.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + 1.0f * matrix.m[3][1];
+	resultVector3.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + 1.0f * matrix.m[3][2];
+
+	float w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + 1.0f * matrix.m[3][3];
+
+	assert(w != 0.0f);
+
+	resultVector3.x /= w;
+	resultVector3.y /= w;
+	resultVector3.z /= w;
+
+	return resultVector3;
+}
+
+float Cotangent(float theta)
+{
+	float cotngent;
+
+	cotngent = 1.0f / tanf(theta);
+
+	return cotngent;
+}
+
+void SinCos(float theta, float& sin, float& cos)
+{
+	float x = std::fabs(theta);
+	if (!(x <= kSinCosMaxAngle)) {
+		// 範囲外(NaNも)は3段階の引き算では誤差が大きいので標準関数に任せる
+		sin = sinf(theta);
+		cos = cosf(theta);
+		return;
+	}
+
+	// π/4単位の象限を1回だけ求め、sinとcosで使い回す(SinCos4と同じ手順)
+	int quadrant = static_cast<int>(x * 1.27323954473516f);
+	quadrant = (quadrant + 1) & ~1;
+	float y = static_cast<float>(quadrant);
+
+	// x - y*π/4 を3段階に分けて誤差を抑える
+	x = ((x - y * 0.78515625f) - y * 2.4187564849853515625e-4f) - y * 3.77489497744594108e-8f;
+	float z = x * x;
+
+	float polyCos = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - 0.5f * z + 1.0f;
+	float polySin = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * x + x;
+
+	// 象限で入れ替えと符号を決める(乱数の角度でも分岐予測を外さないようビット演算で選ぶ)
+	uint32_t sinBits = std::bit_cast<uint32_t>(polySin);
+	uint32_t cosBits = std::bit_cast<uint32_t>(polyCos);
+	uint32_t swap = (quadrant & 2) ? ~0u : 0u;
+	uint32_t sinValue = (sinBits & ~swap) | (cosBits & swap);
+	uint32_t cosValue = (cosBits & ~swap) | (sinBits & swap);
+
+	// sinは元の角度の符号も掛ける
+	uint32_t signSin = (std::bit_cast<uint32_t>(theta) & 0x80000000u) ^ (static_cast<uint32_t>(quadrant & 4) << 29);
+	uint32_t signCos = static_cast<uint32_t>(~(quadrant - 2) & 4) << 29;
+	sin = std::bit_cast<float>(sinValue ^ signSin);
+	cos = std::bit_cast<float>(cosValue ^ signCos);
+}
+
+Matrix4x4 MakeAffineMatrix(Vector3 scale, Vector3 rotate, Vector3 translate)
+{
+	// 各軸のsin/cosは1回ずつ
+	float sinX, cosX, sinY, cosY, sinZ, cosZ;
+	SinCos(rotate.x, sinX, cosX);
+	SinCos(rotate.y, sinY, cosY);
+	SinCos(rotate.z, sinZ, cosZ);
+
+	// 拡縮 * (X回転 * Y回転 * Z回転) * 移動 を展開したもの
+	Matrix4x4 affineMatrix4x4;
+	affineMatrix4x4.m[0][0] = scale.x * (cosY * cosZ);
+	affineMatrix4x4.m[0][1] = scale.x * (cosY * sinZ);
+	affineMatrix4x4.m[0][2] = scale.x * (-sinY);
+	affineMatrix4x4.m[0][3] = 0.0f;
+
+	affineMatrix4x4.m[1][0] = scale.y * (sinX * sinY * cosZ - cosX * sinZ);
+	affineMatrix4x4.m[1][1] = scale.y * (sinX * sinY * sinZ + cosX * cosZ);
+	affineMatrix4x4.m[1][2] = scale.y * (sinX * cosY);
+	affineMatrix4x4.m[1][3] = 0.0f;
+
+	affineMatrix4x4.m[2][0] = scale.z * (cosX * sinY * cosZ + sinX * sinZ);
+	affineMatrix4x4.m[2][1] = scale.z * (cosX * sinY * sinZ - sinX * cosZ);
+	affineMatrix4x4.m[2][2] = scale.z * (cosX * cosY);
+	affineMatrix4x4.m[2][3] = 0.0f;
+
+	affineMatrix4x4.m[3][0] = translate.x;
+	affineMatrix4x4.m[3][1] = translate.y;
+	affineMatrix4x4.m[3][2] = translate.z;
+	affineMatrix4x4.m[3][3] = 1.0f;
+
+	return affineMatrix4x4;
+}
+
+Matrix4x4 MakeAffineMatrixByMultiply(Vector3 scale, Vector3 rotate, Vector3 translate)
+{
+	//====================
+	// 拡縮の行列の作成
+	//====================
+	Matrix4x4 scaleMatrix4x4;
+	scaleMatrix4x4.m[0][0] = scale.x;
+	scaleMatrix4x4.m[0][1] = 0.0f;
+	scaleMatrix4x4.m[0][2] = 0.0f;
+	scaleMatrix4x4.m[0][3] = 0.0f;
+
+	scaleMatrix4x4.m[1][0] = 0.0f;
+	scaleMatrix4x4.m[1][1] = scale.y;
+	scaleMatrix4x4.m[1][2] = 0.0f;
+	scaleMatrix4x4.m[1][3] = 0.0f;
+
+	scaleMatrix4x4.m[2][0] = 0.0f;
+	scaleMatrix4x4.m[2][1] = 0.0f;
+	scaleMatrix4x4.m[2][2] = scale.z;
+	scaleMatrix4x4.m[2][3] = 0.0f;
+
+	scaleMatrix4x4.m[3][0] = 0.0f;
+	scaleMatrix4x4.m[3][1] = 0.0f;
+	scaleMatrix4x4.m[3][2] = 0.0f;
+	scaleMatrix4x4.m[3][3] = 1.0f;
+
+	//===================
+	// 回転の行列の作成
+	//===================
+	// Xの回転行列
+	Matrix4x4 rotateMatrixX;
+	rotateMatrixX.m[0][0] = 1.0f;
+	rotateMatrixX.m[0][1] = 0.0f;
+	rotateMatrixX.m[0][2] = 0.0f;
+	rotateMatrixX.m[0][3] = 0.0f;
+
+	rotateMatrixX.m[1][0] = 0.0f;
+	rotateMatrixX.m[1][1] = cosf(rotate.x);
+	rotateMatrixX.m[1][2] = sinf(rotate.x);
+	rotateMatrixX.m[1][3] = 0.0f;
+
+	rotateMatrixX.m[2][0] = 0.0f;
+	rotateMatrixX.m[2][1] = -sinf(rotate.x);
+	rotateMatrixX.m[2][2] = cosf(rotate.x);
+	rotateMatrixX.m[2][3] = 0.0f;
+
+	rotateMatrixX.m[3][0] = 0.0f;
+	rotateMatrixX.m[3][1] = 0.0f;
+	rotateMatrixX.m[3][2] = 0.0f;
+	rotateMatrixX.m[3][3] = 1.0f;
+
+	// Yの回転行列
+	Matrix4x4 rotateMatrixY;
+	rotateMatrixY.m[0][0] = cosf(rotate.y);
+	rotateMatrixY.m[0][1] = 0.0f;
+	rotateMatrixY.m[0][2] = -sinf(rotate.y);
+	rotateMatrixY.m[0][3] = 0.0f;
+
+	rotateMatrixY.m[1][0] = 0.0f;
+	rotateMatrixY.m[1][1] = 1.0f;
+	rotateMatrixY.m[1][2] = 0.0f;
+	rotateMatrixY.m[1][3] = 0.0f;
+
+	rotateMatrixY.m[2][0] = sinf(rotate.y);
+	rotateMatrixY.m[2][1] = 0.0f;
+	rotateMatrixY.m[2][2] = cosf(rotate.y);
+	rotateMatrixY.m[2][3] = 0.0f;
+
+	rotateMatrixY.m[3][0] = 0.0f;
+	rotateMatrixY.m[3][1] = 0.0f;
+	rotateMatrixY.m[3][2] = 0.0f;
+	rotateMatrixY.m[3][3] = 1.0f;
+
+	// Zの回転行列
+	Matrix4x4 rotateMatrixZ;
+	rotateMatrixZ.m[0][0] = cosf(rotate.z);
+	rotateMatrixZ.m[0][1] = sinf(rotate.z);
+	rotateMatrixZ.m[0][2] = 0.0f;
+	rotateMatrixZ.m[0][3] = 0.0f;
+
+	rotateMatrixZ.m[1][0] = -sinf(rotate.z);
+	rotateMatrixZ.m[1][1] = cosf(rotate.z);
+	rotateMatrixZ.m[1][2] = 0.0f;
+	rotateMatrixZ.m[1][3] = 0.0f;
+
+	rotateMatrixZ.m[2][0] = 0.0f;
+	rotateMatrixZ.m[2][1] = 0.0f;
+	rotateMatrixZ.m[2][2] = 1.0f;
+	rotateMatrixZ.m[2][3] = 0.0f;
+
+	rotateMatrixZ.m[3][0] = 0.0f;
+	rotateMatrixZ.m[3][1] = 0.0f;
+	rotateMatrixZ.m[3][2] = 0.0f;
+	rotateMatrixZ.m[3][3] = 1.0f;
+
+	// 回転行列の作成
+	Matrix4x4 rotateMatrix4x4;
+
+	rotateMatrix4x4 = Multiply(rotateMatrixX, Multiply(rotateMatrixY, rotateMatrixZ));
+
+	//==================
+	// 移動の行列の作成
+	//==================
+	Matrix4x4 translateMatrix4x4;
+	translateMatrix4x4.m[0][0] = 1.0f;
+	translateMatrix4x4.m[0][1] = 0.0f;
+	translateMatrix4x4.m[0][2] = 0.0f;
+	translateMatrix4x4.m[0][3] = 0.0f;
+
+	translateMatrix4x4.m[1][0] = 0.0f;
+	translateMatrix4x4.m[1][1] = 1.0f;
+	translateMatrix4x4.m[1][2] = 0.0f;
+	translateMatrix4x4.m[1][3] = 0.0f;
+
+	translateMatrix4x4.m[2][0] = 0.0f;
+	translateMatrix4x4.m[2][1] = 0.0f;
+	translateMatrix4x4.m[2][2] = 1.0f;
+	translateMatrix4x4.m[2][3] = 0.0f;
+
+	translateMatrix4x4.m[3][0] = translate.x;
+	translateMatrix4x4.m[3][1] = translate.y;
+	translateMatrix4x4.m[3][2] = translate.z;
+	translateMatrix4x4.m[3][3] = 1.0f;
+
+	//====================
+	// アフィン行列の作成
+	//====================
+	// 上で作った行列からアフィン行列を作る
+	// アフィン行列の作成（スケール→回転→移動の順）
+	Matrix4x4 affineMatrix4x4;
+	affineMatrix4x4 = Multiply(scaleMatrix4x4, Multiply(rotateMatrix4x4, translateMatrix4x4));
+
+	return  affineMatrix4x4;
+}
+
+Matrix4x4 Inverse(const Matrix4x4& matrix4x4)
+{
+#if defined(MT3_SIMD)
+	return InverseSimd(matrix4x4);
+#else
+	return InverseScalar(matrix4x4);
+#endif
+}
+
+bool TryInverse(const Matrix4x4& matrix4x4, Matrix4x4& inverse, float epsilon)
+{
+	// 逆行列と行列式を1回で求める
+	float determinant;
+#if defined(MT3_SIMD)
+	Matrix4x4 result = InverseSimd(matrix4x4, &determinant);
+#else
+	Matrix4x4 result = InverseScalar(matrix4x4, &determinant);
+#endif
+
+	// 2乗どうしで比べる(doubleなので要素が大きくても溢れない)
+	double rowLengthSqProduct = 1.0;
+	for (int row = 0; row < 3; ++row) {
+		const float* r = matrix4x4.m[row];
+		rowLengthSqProduct *= static_cast<double>(r[0]) * r[0] + static_cast<double>(r[1]) * r[1] + static_cast<double>(r[2]) * r[2] + static_cast<double>(r[3]) * r[3];
+	}
+	// 4列目の上3つが0(アフィン行列など)なら|M| = |3x3部分| * m33で、4行目の平行移動は行列式に効かない
+	// このときは4行目をm33だけで測り、平行移動が大きいだけの剛体変換を特異と見なさないようにする
+	const float* lastRow = matrix4x4.m[3];
+	bool lastColumnZero = matrix4x4.m[0][3] == 0.0f && matrix4x4.m[1][3] == 0.0f && matrix4x4.m[2][3] == 0.0f;
+	double lastRowLengthSq = static_cast<double>(lastRow[3]) * lastRow[3];
+	if (!lastColumnZero) {
+		lastRowLengthSq += static_cast<double>(lastRow[0]) * lastRow[0] + static_cast<double>(lastRow[1]) * lastRow[1] + static_cast<double>(lastRow[2]) * lastRow[2];
+	}
+	rowLengthSqProduct *= lastRowLengthSq;
+	double determinantSq = static_cast<double>(determinant) * determinant;
+
+	// NaNや無限大を含めば比較が偽になる
+	bool valid = determinantSq > static_cast<double>(epsilon) * epsilon * rowLengthSqProduct && rowLengthSqProduct < INFINITY;
+
+	// 要素が極端に大きいと途中の余因子が溢れるので、結果も有限か確かめる(x - xは有限なら0、それ以外はNaN)
+	for (int row = 0; row < 4; ++row) {
+		for (int column = 0; column < 4; ++column) {
+			valid &= result.m[row][column] - result.m[row][column] == 0.0f;
+		}
+	}
+
+	for (int row = 0; row < 4; ++row) {
+		for (int column = 0; column < 4; ++column) {
+			float identity = row == column ? 1.0f : 0.0f;
+			inverse.m[row][column] = valid ? result.m[row][column] : identity;
+		}
+	}
+	return valid;
+}
+
+Matrix4x4 InverseScalar(const Matrix4x4& matrix4x4, float* determinant)
+{
+	// 行列式|A|を求める
+	float bottom =
+		(matrix4x4.m[0][0] * matrix4x4.m[1][1] * matrix4x4.m[2][2] * matrix4x4.m[3][3])
+		+ (matrix4x4.m[0][0] * matrix4x4.m[1][2] * matrix4x4.m[2][3] * matrix4x4.m[3][1])
+		+ (matrix4x4.m[0][0] * matrix4x4.m[1][3] * matrix4x4.m[2][1] * matrix4x4.m[3][2])
+		- (matrix4x4.m[0][0] * matrix4x4.m[1][3] * matrix4x4.m[2][2] * matrix4x4.m[3][1])
+		- (matrix4x4.m[0][0] * matrix4x4.m[1][2] * matrix4x4.m[2][1] * matrix4x4.m[3][3])
+		- (matrix4x4.m[0][0] * matrix4x4.m[1][1] * matrix4x4.m[2][3] * matrix4x4.m[3][2])
+		- (matrix4x4.m[0][1] * matrix4x4.m[1][0] * matrix4x4.m[2][2] * matrix4x4.m[3][3])
+		- (matrix4x4.m[0][2] * matrix4x4.m[1][0] * matrix4x4.m[2][3] * matrix4x4.m[3][1])
+		- (matrix4x4.m[0][3] * matrix4x4.m[1][0] * matrix4x4.m[2][1] * matrix4x4.m[3][2])
+		+ (matrix4x4.m[0][3] * matrix4x4.m[1][0] * matrix4x4.m[2][2] * matrix4x4.m[3][1])
+		+ (matrix4x4.m[0][2] * matrix4x4.m[1][0] * matrix4x4.m[2][1] * matrix4x4.m[3][3])
+		+ (matrix4x4.m[0][1] * matrix4x4.m[1][0] * matrix4x4.m[2][3] * matrix4x4.m[3][2])
+		+ (matrix4x4.m[0][1] * matrix4x4.m[1][2] * matrix4x4.m[2][0] * matrix4x4.m[3][3])
+		+ (matrix4x4.m[0][2] * matrix4x4.m[1][3] * matrix4x4.m[2][0] * matrix4x4.m[3][1])
+		+ (matrix4x4.m[0][3] * matrix4x4.m[1][1] * matrix4x4.m[2][0] * matrix4x4.m[3][2])
+		- (matrix4x4.m[0][3] * matrix4x4.m[1][2] * matrix4x4.m[2][0] * matrix4x4.m[3][1])
+		- (matrix4x4.m[0][2] * matrix4x4.m[1][1] * matrix4x4.m[2][0] * matrix4x4.m[3][3])
+		- (matrix4x4.m[0][1] * matrix4x4.m[1][3] * matrix4x4.m[2][0] * matrix4x4.m[3][2])
+		- (matrix4x4.m[0][1] * matrix4x4.m[1][2] * matrix4x4.m[2][3] * matrix4x4.m[3][0])
+		- (matrix4x4.m[0][2] * matrix4x4.m[1][3] * matrix4x4.m[2][1] * matrix4x4.m[3][0])
+		- (matrix4x4.m[0][3] * matrix4x4.m[1][1] * matrix4x4.m[2][2] * matrix4x4.m[3][0])
+		+ (matrix4x4.m[0][3] * matrix4x4.m[1][2] * matrix4x4.m[2][1] * matrix4x4.m[3][0])
+		+ (matrix4x4.m[0][2] * matrix4x4.m[1][1] * matrix4x4.m[2][3] * matrix4x4.m[3][0])
+		+ (matrix4x4.m[0][1] * matrix4x4.m[1][3] * matrix4x4.m[2][2] * matrix4x4.m[3][0]);
+
+	if (determinant) {
+		*determinant = bottom;
+	}
+
+	Matrix4x4 resoultMatrix;
+
+	// 1行目
+	resoultMatrix.m[0][0] = 1.0f / bottom * (
+		(matrix4x4.m[1][1] * matrix4x4.m[2][2] * matrix4x4.m[3][3])
+		+ (matrix4x4.m[1][2] * matrix4x4.m[2][3] * matrix4x4.m[3][1])
+		+ (matrix4x4.m[1][3] * matrix4x4.m[2][1] * matrix4x4.m[3][2])
+		- (matrix4x4.m[1][3] * matrix4x4.m[2][2] * matrix4x4.m[3][1])
+		- (matrix4x4.m[1][2] * matrix4x4.m[2][1] * matrix4x4.m[3][3])
+		- (matrix4x4.m[1][1] * matrix4x4.m[2][3] * matrix4x4.m[3][2]));
+
+	resoultMatrix.m[0][1] = 1.0f / bottom * (
+		-(matrix4x4.m[0][1] * matrix4x4.m[2][2] * matrix4x4.m[3][3])
+		- (matrix4x4.m[0][2] * matrix4x4.m[2][3] * matrix4x4.m[3][1])
+		- (matrix4x4.m[0][3] * matrix4x4.m[2][1] * matrix4x4.m[3][2])
+		+ (matrix4x4.m[0][3] * matrix4x4.m[2][2] * matrix4x4.m[3][1])
+		+ (matrix4x4.m[0][2] * matrix4x4.m[2][1] * matrix4x4.m[3][3])
+		+ (matrix4x4.m[0][1] * matrix4x4.m[2][3] * matrix4x4.m[3][2]));
+
+	resoultMatrix.m[0][2] = 1.0f / bottom * (
+		(matrix4x4.m[0][1] * matrix4x4.m[1][2] * matrix4x4.m[3][3])
+		+ (matrix4x4.m[0][2] * matrix4x4.m[1][3] * matrix4x4.m[3][1])
+		+ (matrix4x4.m[0][3] * matrix4x4.m[1][1] * matrix4x4.m[3][2])
+		- (matrix4x4.m[0][3] * matrix4x4.m[1][2] * matrix4x4.m[3][1])
+		- (matrix4x4.m[0][2] * matrix4x4.m[1][1] * matrix4x4.m[3][3])
+		- (matrix4x4.m[0][1] * matrix4x4.m[1][3] * matrix4x4.m[3][2]));
+
+	resoultMatrix.m[0][3] = 1.0f / bottom * (
+		-(matrix4x4.m[0][1] * matrix4x4.m[1][2] * matrix4x4.m[2][3])
+		- (matrix4x4.m[0][2] * matrix4x4.m[1][3] * matrix4x4.m[2][1])
+		- (matrix4x4.m[0][3] * matrix4x4.m[1][1] * matrix4x4.m[2][2])
+		+ (matrix4x4.m[0][3] * matrix4x4.m[1][2] * matrix4x4.m[2][1])
+		+ (matrix4x4.m[0][2] * matrix4x4.m[1][1] * matrix4x4.m[2][3])
+		+ (matrix4x4.m[0][1] * matrix4x4.m[1][3] * matrix4x4.m[2][2]));
+
+	// 2行目
+	resoultMatrix.m[1][0] = 1.0f / bottom * (
+		-(matrix4x4.m[1][0] * matrix4x4.m[2][2] * matrix4x4.m[3][3])
+		- (matrix4x4.m[1][2] * matrix4x4.m[2][3] * matrix4x4.m[3][0])
+		- (matrix4x4.m[1][3] * matrix4x4.m[2][0] * matrix4x4.m[3][2])
+		+ (matrix4x4.m[1][3] * matrix4x4.m[2][2] * matrix4x4.m[3][0])
+		+ (matrix4x4.m[1][2] * matrix4x4.m[2][0] * matrix4x4.m[3][3])
+		+ (matrix4x4.m[1][0] * matrix4x4.m[2][3] * matrix4x4.m[3][2]));
+
+	resoultMatrix.m[1][1] = 1.0f / bottom * (
+		(matrix4x4.m[0][0] * matrix4x4.m[2][2] * matrix4x4.m[3][3])
+		+ (matrix4x4.m[0][2] * matrix4x4.m[2][3] * matrix4x4.m[3][0])
+		+ (matrix4x4.m[0][3] * matrix4x4.m[2][0] * matrix4x4.m[3][2])
+		- (matrix4x4.m[0][3] * matrix4x4.m[2][2] * matrix4x4.m[3][0])
+		- (matrix4x4.m[0][2] * matrix4x4.m[2][0] * matrix4x4.m[3][3])
+		- (matrix4x4.m[0][0] * matrix4x4.m[2][3] * matrix4x4.m[3][2]));
+
+	resoultMatrix.m[1][2] = 1.0f / bottom * (
+		-(matrix4x4.m[0][0] * matrix4x4.m[1][2] * matrix4x4.m[3][3])
+		- (matrix4x4.m[0][2] * matrix4x4.m[1][3] * matrix4x4.m[3][0])
+		- (matrix4x4.m[0][3] * matrix4x4.m[1][0] * matrix4x4.m[3][2])
+		+ (matrix4x4.m[0][3] * matrix4x4.m[1][2] * matrix4x4.m[3][0])
+		+ (matrix4x4.m[0][2] * matrix4x4.m[1][0] * matrix4x4.m[3][3])
+		+ (matrix4x4.m[0][0] * matrix4x4.m[1][3] * matrix4x4.m[3][2]));
+
+	resoultMatrix.m[1][3] = 1.0f / bottom * (
+		(matrix4x4.m[0][0] * matrix4x4.m[1][2] * matrix4x4.m[2][3])
+		+ (matrix4x4.m[0][2] * matrix4x4.m[1][3] * matrix4x4.m[2][0])
+		+ (matrix4x4.m[0][3] * matrix4x4.m[1][0] * matrix4x4.m[2][2])
+		- (matrix4x4.m[0][3] * matrix4x4.m[1][2] * matrix4x4.m[2][0])
+		- (matrix4x4.m[0][2] * matrix4x4.m[1][0] * matrix4x4.m[2][3])
+		- (matrix4x4.m[0][0] * matrix4x4.m[1][3] * matrix4x4.m[2][2]));
+
+	// 3行目
+	resoultMatrix.m[2][0] = 1.0f / bottom * (
+		(matrix4x4.m[1][0] * matrix4x4.m[2][1] * matrix4x4.m[3][3])
+		+ (matrix4x4.m[1][1] * matrix4x4.m[2][3] * matrix4x4.m[3][0])
+		+ (matrix4x4.m[1][3] * matrix4x4.m[2][0] * matrix4x4.m[3][1])
+		- (matrix4x4.m[1][3] * matrix4x4.m[2][1] * matrix4x4.m[3][0])
+		- (matrix4x4.m[1][1] * matrix4x4.m[2][0] * matrix4x4.m[3][3])
+		- (matrix4x4.m[1][0] * matrix4x4.m[2][3] * matrix4x4.m[3][1]));
+
+	resoultMatrix.m[2][1] = 1.0f / bottom * (
+		-(matrix4x4.m[0][0] * matrix4x4.m[2][1] * matrix4x4.m[3][3])
+		- (matrix4x4.m[0][1] * matrix4x4.m[2][3] * matrix4x4.m[3][0])
+		- (matrix4x4.m[0][3] * matrix4x4.m[2][0] * matrix4x4.m[3][1])
+		+ (matrix4x4.m[0][3] * matrix4x4.m[2][1] * matrix4x4.m[3][0])
+		+ (matrix4x4.m[0][1] * matrix4x4.m[2][0] * matrix4x4.m[3][3])
+		+ (matrix4x4.m[0][0] * matrix4x4.m[2][3] * matrix4x4.m[3][1]));
+
+	resoultMatrix.m[2][2] = 1.0f / bottom * (
+		(matrix4x4.m[0][0] * matrix4x4.m[1][1] * matrix4x4.m[3][3])
+		+ (matrix4x4.m[0][1] * matrix4x4.m[1][3] * matrix4x4.m[3][0])
+		+ (matrix4x4.m[0][3] * matrix4x4.m[1][0] * matrix4x4.m[3][1])
+		- (matrix4x4.m[0][3] * matrix4x4.m[1][1] * matrix4x4.m[3][0])
+		- (matrix4x4.m[0][1] * matrix4x4.m[1][0] * matrix4x4.m[3][3])
+		- (matrix4x4.m[0][0] * matrix4x4.m[1][3] * matrix4x4.m[3][1]));
+
+	resoultMatrix.m[2][3] = 1.0f / bottom * (
+		-(matrix4x4.m[0][0] * matrix4x4.m[1][1] * matrix4x4.m[2][3])
+		- (matrix4x4.m[0][1] * matrix4x4.m[1][3] * matrix4x4.m[2][0])
+		- (matrix4x4.m[0][3] * matrix4x4.m[1][0] * matrix4x4.m[2][1])
+		+ (matrix4x4.m[0][3] * matrix4x4.m[1][1] * matrix4x4.m[2][0])
+		+ (matrix4x4.m[0][1] * matrix4x4.m[1][0] * matrix4x4.m[2][3])
+		+ (matrix4x4.m[0][0] * matrix4x4.m[1][3] * matrix4x4.m[2][1]));
+
+	// 4行目
+	resoultMatrix.m[3][0] = 1.0f / bottom * (
+		-(matrix4x4.m[1][0] * matrix4x4.m[2][1] * matrix4x4.m[3][2])
+		- (matrix4x4.m[1][1] * matrix4x4.m[2][2] * matrix4x4.m[3][0])
+		- (matrix4x4.m[1][2] * matrix4x4.m[2][0] * matrix4x4.m[3][1])
+		+ (matrix4x4.m[1][2] * matrix4x4.m[2][1] * matrix4x4.m[3][0])
+		+ (matrix4x4.m[1][1] * matrix4x4.m[2][0] * matrix4x4.m[3][2])
+		+ (matrix4x4.m[1][0] * matrix4x4.m[2][2] * matrix4x4.m[3][1]));
+
+	resoultMatrix.m[3][1] = 1.0f / bottom * (
+		(matrix4x4.m[0][0] * matrix4x4.m[2][1] * matrix4x4.m[3][2])
+		+ (matrix4x4.m[0][1] * matrix4x4.m[2][2] * matrix4x4.m[3][0])
+		+ (matrix4x4.m[0][2] * matrix4x4.m[2][0] * matrix4x4.m[3][1])
+		- (matrix4x4.m[0][2] * matrix4x4.m[2][1] * matrix4x4.m[3][0])
+		- (matrix4x4.m[0][1] * matrix4x4.m[2][0] * matrix4x4.m[3][2])
+		- (matrix4x4.m[0][0] * matrix4x4.m[2][2] * matrix4x4.m[3][1]));
+
+	resoultMatrix.m[3][2] = 1.0f / bottom * (
+		-(matrix4x4.m[0][0] * matrix4x4.m[1][1] * matrix4x4.m[3][2])
+		- (matrix4x4.m[0][1] * matrix4x4.m[1][2] * matrix4x4.m[3][0])
+		- (matrix4x4.m[0][2] * matrix4x4.m[1][0] * matrix4x4.m[3][1])
+		+ (matrix4x4.m[0][2] * matrix4x4.m[1][1] * matrix4x4.m[3][0])
+		+ (matrix4x4.m[0][1] * matrix4x4.m[1][0] * matrix4x4.m[3][2])
+		+ (matrix4x4.m[0][0] * matrix4x4.m[1][2] * matrix4x4.m[3][1]));
+
+	resoultMatrix.m[3][3] = 1.0f / bottom * (
+		(matrix4x4.m[0][0] * matrix4x4.m[1][1] * matrix4x4.m[2][2])
+		+ (matrix4x4.m[0][1] * matrix4x4.m[1][2] * matrix4x4.m[2][0])
+		+ (matrix4x4.m[0][2] * matrix4x4.m[1][0] * matrix4x4.m[2][1])
+		- (matrix4x4.m[0][2] * matrix4x4.m[1][1] * matrix4x4.m[2][0])
+		- (matrix4x4.m[0][1] * matrix4x4.m[1][0] * matrix4x4.m[2][2])
+		- (matrix4x4.m[0][0] * matrix4x4.m[1][2] * matrix4x4.m[2][1]));
+
+	return resoultMatrix;
+}
+
+namespace {
+
+	// TryInverseAffine/InverseAffineの本体(結果は戻り値で返し、呼び出し側で余計な複写をしない)
+	Matrix4x4 InverseAffineChecked(const Matrix4x4& matrix4x4, float epsilon, bool& valid)
+	{
+		const float (*m)[4] = matrix4x4.m;
+
+		// 3x3部分の余因子
+		float cofactor00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+		float cofactor01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+		float cofactor02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+
+		float determinant = m[0][0] * cofactor00 + m[0][1] * cofactor01 + m[0][2] * cofactor02;
+
+		// TryInverseと同じく3x3の行の長さの積(行列式の上限)と比べるので、全体の拡縮によらない
+		double rowLengthSqProduct = 1.0;
+		for (int row = 0; row < 3; ++row) {
+			rowLengthSqProduct *= static_cast<double>(m[row][0]) * m[row][0] + static_cast<double>(m[row][1]) * m[row][1] + static_cast<double>(m[row][2]) * m[row][2];
+		}
+		double determinantSq = static_cast<double>(determinant) * determinant;
+
+		Matrix4x4 resultMatrix = {};
+
+		// NaNや無限大を含めば比較が偽になる
+		valid = determinantSq > static_cast<double>(epsilon) * epsilon * rowLengthSqProduct && rowLengthSqProduct < INFINITY;
+		if (!valid) {
+			// 潰れた(スケール0の)行列は逆行列が無いので単位行列にしておく
+			resultMatrix.m[0][0] = 1.0f;
+			resultMatrix.m[1][1] = 1.0f;
+			resultMatrix.m[2][2] = 1.0f;
+			resultMatrix.m[3][3] = 1.0f;
+			return resultMatrix;
+		}
+
+		float inverseDeterminant = 1.0f / determinant;
+
+		// 3x3の逆行列 = 余因子行列の転置 / 行列式
+		resultMatrix.m[0][0] = cofactor00 * inverseDeterminant;
+		resultMatrix.m[1][0] = cofactor01 * inverseDeterminant;
+		resultMatrix.m[2][0] = cofactor02 * inverseDeterminant;
+
+		resultMatrix.m[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * inverseDeterminant;
+		resultMatrix.m[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * inverseDeterminant;
+		resultMatrix.m[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * inverseDeterminant;
+
+		resultMatrix.m[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * inverseDeterminant;
+		resultMatrix.m[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * inverseDeterminant;
+		resultMatrix.m[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * inverseDeterminant;
+
+		// 平行移動は -t * A^-1
+		for (int column = 0; column < 3; ++column) {
+			resultMatrix.m[3][column] = -(m[3][0] * resultMatrix.m[0][column] + m[3][1] * resultMatrix.m[1][column] + m[3][2] * resultMatrix.m[2][column]);
+		}
+		resultMatrix.m[3][3] = 1.0f;
+
+		return resultMatrix;
+	}
+
+}
+
+bool TryInverseAffine(const Matrix4x4& matrix4x4, Matrix4x4& inverse, float epsilon)
+{
+	bool valid;
+	inverse = InverseAffineChecked(matrix4x4, epsilon, valid);
+	return valid;
+}
+
+Matrix4x4 InverseAffine(const Matrix4x4& matrix4x4)
+{
+	bool valid;
+	return InverseAffineChecked(matrix4x4, 1.0e-6f, valid);
+}
+
+Matrix4x4 InverseRigid(const Matrix4x4& matrix4x4)
+{
+	const float (*m)[4] = matrix4x4.m;
+	Matrix4x4 resultMatrix;
+
+	// 回転部分は転置
+	for (int row = 0; row < 3; ++row) {
+		for (int column = 0; column < 3; ++column) {
+			resultMatrix.m[row][column] = m[column][row];
+		}
+		resultMatrix.m[row][3] = 0.0f;
+	}
+
+	// 平行移動は -t * R^T (tと回転の各行との内積)
+	for (int column = 0; column < 3; ++column) {
+		resultMatrix.m[3][column] = -(m[3][0] * m[column][0] + m[3][1] * m[column][1] + m[3][2] * m[column][2]);
+	}
+	resultMatrix.m[3][3] = 1.0f;
+
+	return resultMatrix;
+}
+
+Matrix4x4 Multiply(const Matrix4x4& matrix1, const Matrix4x4& matrix2)
+{
+#if defined(MT3_SIMD)
+	return MultiplySimd(matrix1, matrix2);
+#else
+	return MultiplyScalar(matrix1, matrix2);
+#endif
+}
+
+Matrix4x4 MultiplyScalar(const Matrix4x4& matrix1, const Matrix4x4& matrix2)
+{
+	Matrix4x4 resoultMatrix4x4;
+
+	resoultMatrix4x4.m[0][0] = matrix1.m[0][0] * matrix2.m[0][0] + matrix1.m[0][1] * matrix2.m[1][0] + matrix1.m[0][2] * matrix2.m[2][0] + matrix1.m[0][3] * matrix2.m[3][0];
+	resoultMatrix4x4.m[0][1] = matrix1.m[0][0] * matrix2.m[0][1] + matrix1.m[0][1] * matrix2.m[1][1] + matrix1.m[0][2] * matrix2.m[2][1] + matrix1.m[0][3] * matrix2.m[3][1];
+	resoultMatrix4x4.m[0][2] = matrix1.m[0][0] * matrix2.m[0][2] + matrix1.m[0][1] * matrix2.m[1][2] + matrix1.m[0][2] * matrix2.m[2][2] + matrix1.m[0][3] * matrix2.m[3][2];
+	resoultMatrix4x4.m[0][3] = matrix1.m[0][0] * matrix2.m[0][3] + matrix1.m[0][1] * matrix2.m[1][3] + matrix1.m[0][2] * matrix2.m[2][3] + matrix1.m[0][3] * matrix2.m[3][3];
+
+	resoultMatrix4x4.m[1][0] = matrix1.m[1][0] * matrix2.m[0][0] + matrix1.m[1][1] * matrix2.m[1][0] + matrix1.m[1][2] * matrix2.m[2][0] + matrix1.m[1][3] * matrix2.m[3][0];
+	resoultMatrix4x4.m[1][1] = matrix1.m[1][0] * matrix2.m[0][1] + matrix1.m[1][1] * matrix2.m[1][1] + matrix1.m[1][2] * matrix2.m[2][1] + matrix1.m[1][3] * matrix2.m[3][1];
+	resoultMatrix4x4.m[1][2] = matrix1.m[1][0] * matrix2.m[0][2] + matrix1.m[1][1] * matrix2.m[1][2] + matrix1.m[1][2] * matrix2.m[2][2] + matrix1.m[1][3] * matrix2.m[3][2];
+	resoultMatrix4x4.m[1][3] = matrix1.m[1][0] * matrix2.m[0][3] + matrix1.m[1][1] * matrix2.m[1][3] + matrix1.m[1][2] * matrix2.m[2][3] + matrix1.m[1][3] * matrix2.m[3][3];
+
+	resoultMatrix4x4.m[2][0] = matrix1.m[2][0] * matrix2.m[0][0] + matrix1.m[2][1] * matrix2.m[1][0] + matrix1.m[2][2] * matrix2.m[2][0] + matrix1.m[2][3] * matrix2.m[3][0];
+	resoultMatrix4x4.m[2][1] = matrix1.m[2][0] * matrix2.m[0][1] + matrix1.m[2][1] * matrix2.m[1][1] + matrix1.m[2][2] * matrix2.m[2][1] + matrix1.m[2][3] * matrix2.m[3][1];
+	resoultMatrix4x4.m[2][2] = matrix1.m[2][0] * matrix2.m[0][2] + matrix1.m[2][1] * matrix2.m[1][2] + matrix1.m[2][2] * matrix2.m[2][2] + matrix1.m[2][3] * matrix2.m[3][2];
+	resoultMatrix4x4.m[2][3] = matrix1.m[2][0] * matrix2.m[0][3] + matrix1.m[2][1] * matrix2.m[1][3] + matrix1.m[2][2] * matrix2.m[2][3] + matrix1.m[2][3] * matrix2.m[3][3];
+
+	resoultMatrix4x4.m[3][0] = matrix1.m[3][0] * matrix2.m[0][0] + matrix1.m[3][1] * matrix2.m[1][0] + matrix1.m[3][2] * matrix2.m[2][0] + matrix1.m[3][3] * matrix2.m[3][0];
+	resoultMatrix4x4.m[3][1] = matrix1.m[3][0] * matrix2.m[0][1] + matrix1.m[3][1] * matrix2.m[1][1] + matrix1.m[3][2] * matrix2.m[2][1] + matrix1.m[3][3] * matrix2.m[3][1];
+	resoultMatrix4x4.m[3][2] = matrix1.m[3][0] * matrix2.m[0][2] + matrix1.m[3][1] * matrix2.m[1][2] + matrix1.m[3][2] * matrix2.m[2][2] + matrix1.m[3][3] * matrix2.m[3][2];
+	resoultMatrix4x4.m[3][3] = matrix1.m[3][0] * matrix2.m[0][3] + matrix1.m[3][1] * matrix2.m[1][3] + matrix1.m[3][2] * matrix2.m[2][3] + matrix1.m[3][3] * matrix2.m[3][3];
+
+	return resoultMatrix4x4;
+}
+
+Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth)
+{
+	Matrix4x4 viewportMatrix4x4;
+
+	viewportMatrix4x4.m[0][0] = width / 2.0f;
+	viewportMatrix4x4.m[0][1] = 0.0f;
+	viewportMatrix4x4.m[0][2] = 0.0f;
+	viewportMatrix4x4.m[0][3] = 0.0f;
+
+	viewportMatrix4x4.m[1][0] = 0.0f;
+	viewportMatrix4x4.m[1][1] = -height / 2.0f;
+	viewportMatrix4x4.m[1][2] = 0.0f;
+	viewportMatrix4x4.m[1][3] = 0.0f;
+
+	viewportMatrix4x4.m[2][0] = 0.0f;
+	viewportMatrix4x4.m[2][1] = 0.0f;
+	viewportMatrix4x4.m[2][2] = maxDepth - minDepth;
+	viewportMatrix4x4.m[2][3] = 0.0f;
+
+	viewportMatrix4x4.m[3][0] = left + width / 2.0f;
+	viewportMatrix4x4.m[3][1] = top + height / 2.0f;
+	viewportMatrix4x4.m[3][2] = minDepth;
+	viewportMatrix4x4.m[3][3] = 1.0f;
+
+	return viewportMatrix4x4;
+}
+
+Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip)
+{
+	Matrix4x4 perspectiveFovMatrix;
+
+	perspectiveFovMatrix.m[0][0] = 1.0f / aspectRatio * Cotangent(fovY / 2.0f);
+	perspectiveFovMatrix.m[0][1] = 0.0f;
+	perspectiveFovMatrix.m[0][2] = 0.0f;
+	perspectiveFovMatrix.m[0][3] = 0.0f;
+
+	perspectiveFovMatrix.m[1][0] = 0.0f;
+	perspectiveFovMatrix.m[1][1] = Cotangent(fovY / 2.0f);
+	perspectiveFovMatrix.m[1][2] = 0.0f;
+	perspectiveFovMatrix.m[1][3] = 0.0f;
+
+	perspectiveFovMatrix.m[2][0] = 0.0f;
+	perspectiveFovMatrix.m[2][1] = 0.0f;
+	perspectiveFovMatrix.m[2][2] = farClip / (farClip - nearClip);
+	perspectiveFovMatrix.m[2][3] = 1.0f;
+
+	perspectiveFovMatrix.m[3][0] = 0.0f;
+	perspectiveFovMatrix.m[3][1] = 0.0f;
+	perspectiveFovMatrix.m[3][2] = (-nearClip * farClip) / (farClip - nearClip);
+	perspectiveFovMatrix.m[3][3] = 0.0f;
+
+	return perspectiveFovMatrix;
+}
+
+Vector3 TransformWithoutW(const Vector3& vector, const Matrix4x4& matrix)
+{
+	Vector3 result;
+	result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + matrix.m[3][0];
+	result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + matrix.m[3][1];
+	result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + matrix.m[3][2];
+	return result;
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include <Matrix4x4.h>
+#include <Vector3.h>
+
+// 行列をベクトルに変換する関数
+Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix);
+
+/// <summary>
+/// wが0に近くてもassertせずに変換する関数(分岐なし)
+/// </summary>
+/// <param name="vector">変換する座標</param>
+/// <param name="matrix">変換行列</param>
+/// <param name="result">wで割った座標(失敗したら(0,0,0))</param>
+/// <returns>|w|が十分大きく、割れたらtrue</returns>
+bool TryTransform(const Vector3& vector, const Matrix4x4& matrix, Vector3& result);
+
+/// <summary>
+/// cotangent(余接)を求める関数
+/// </summary>
+/// <param name="theta">θ(シータ)</param>
+/// <returns>cotangent</returns>
+float Cotangent(float theta);
+
+// SinCos/SinCos4で多項式近似を使える角度の大きさ(これより大きいと範囲の縮約の誤差が大きくなる)
+constexpr float kSinCosMaxAngle = 8192.0f;
+
+/// <summary>
+/// sinとcosをまとめて求める関数
+/// π/4単位への範囲の縮約を1回だけ行い、Cephesのsinfとcosfの多項式を両方計算する
+/// |θ|がkSinCosMaxAngleを超える(NaNも)ときはsinf/cosfを呼ぶ
+/// </summary>
+/// <param name="theta">θ(シータ)</param>
+/// <param name="sin">sinθの出力先</param>
+/// <param name="cos">cosθの出力先</param>
+void SinCos(float theta, float& sin, float& cos);
+
+/// <summary>
+/// アフィン行列作成関数
+/// 拡縮*回転(X→Y→Z)*移動を展開した式で直接書き込む
+/// </summary>
+/// <param name="scale">縮尺</param>
+/// <param name="rotate">thetaを求めるための数値</param>
+/// <param name="translate">三次元座標でのx,y,zの移動量</param>
+/// <returns>アフィン行列</returns>
+Matrix4x4 MakeAffineMatrix(Vector3 scale, Vector3 rotate, Vector3 translate);
+
+// 拡縮・回転・移動の行列を掛け合わせて作る従来版(MakeAffineMatrixとの比較用)
+Matrix4x4 MakeAffineMatrixByMultiply(Vector3 scale, Vector3 rotate, Vector3 translate);
+
+/// <summary>
+/// 4x4逆行列を求める関数
+/// </summary>
+/// <param name="matrix4x4">逆行列を求めたい行列</param>
+/// <returns>4x4逆行列</returns>
+Matrix4x4 Inverse(const Matrix4x4& matrix4x4);
+
+/// <summary>
+/// 特異(行列式が0に近い)かを確かめてから逆行列を求める関数
+/// 判定は各行の長さの積に対する相対値 |det| > epsilon * |row0||row1||row2||row3| で、
+/// 左辺は右辺の積を超えない(アダマールの不等式)ので0から1の比で見ることになり、行ごとの拡縮に左右されない
+/// 4列目の上3つが0(アフィン行列)なら|row3|の代わりに|m33|を使い、平行移動の大きさでは判定が変わらない
+/// NaNや無限大を含む行列も特異として扱う
+/// </summary>
+/// <param name="matrix4x4">逆行列を求めたい行列</param>
+/// <param name="inverse">逆行列(特異なら単位行列)</param>
+/// <param name="epsilon">相対的な行列式のしきい値</param>
+/// <returns>逆行列が求まればtrue</returns>
+bool TryInverse(const Matrix4x4& matrix4x4, Matrix4x4& inverse, float epsilon = 1.0e-6f);
+
+/// <summary>
+/// アフィン行列(最後の列が(0,0,0,1))の逆行列を求める関数
+/// 3x3部分だけを余因子で反転し、平行移動は-t*A^-1で求める
+/// 3x3部分が特異かはTryInverseと同じく相対的に判定する(一様な拡縮では判定が変わらない)
+/// </summary>
+/// <param name="matrix4x4">逆行列を求めたいアフィン行列</param>
+/// <param name="inverse">逆行列(特異なら単位行列)</param>
+/// <param name="epsilon">相対的な行列式のしきい値</param>
+/// <returns>逆行列が求まればtrue</returns>
+bool TryInverseAffine(const Matrix4x4& matrix4x4, Matrix4x4& inverse, float epsilon = 1.0e-6f);
+
+/// <summary>
+/// TryInverseAffineの結果だけを返す関数(特異なら単位行列)
+/// 特異になり得る行列ではTryInverseAffineで失敗を確かめること
+/// </summary>
+/// <param name="matrix4x4">逆行列を求めたいアフィン行列</param>
+/// <returns>4x4逆行列</returns>
+Matrix4x4 InverseAffine(const Matrix4x4& matrix4x4);
+
+/// <summary>
+/// 回転と平行移動だけの行列(剛体変換)の逆行列を求める関数
+/// 回転部分は転置、平行移動は内積で求めるので除算をしない
+/// </summary>
+/// <param name="matrix4x4">逆行列を求めたい剛体変換行列</param>
+/// <returns>4x4逆行列</returns>
+Matrix4x4 InverseRigid(const Matrix4x4& matrix4x4);
+
+/// <summary>
+/// 4x4行列の積を求める関数
+/// </summary>
+/// <param name="matrix1">1つ目の行列</param>
+/// <param name="matrix2">1つ目の行列</param>
+/// <returns>4x4行列の積</returns>
+Matrix4x4 Multiply(const Matrix4x4& matrix1, const Matrix4x4& matrix2);
+
+/// <summary>
+/// 投視投影行列作成関数
+/// </summary>
+/// <param name="fovY">縦の画角</param>
+/// <param name="aspectRatio">アスペクト比</param>
+/// <param name="nearClip">近平面への距離</param>
+/// <param name="farClip">遠平面への距離</param>
+/// <returns>投視投影行列</returns>
+Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip);
+
+// SIMD版(MathFunctionSimd.h)と比較するためのスカラー実装
+// Transform/Inverse/Multiplyはコンパイル時に使える方を呼び出す
+Vector3 TransformScalar(const Vector3& vector, const Matrix4x4& matrix);
+
+Matrix4x4 InverseScalar(const Matrix4x4& matrix4x4, float* determinant = nullptr);
+
+Matrix4x4 MultiplyScalar(const Matrix4x4& matrix1, const Matrix4x4& matrix2);
+
+Vector3 TransformWithoutW(const Vector3& vector, const Matrix4x4& matrix);
+
+/// <summary>
+/// ビューポート行列作成関数
+/// </summary>
+/// <param name="left">左側の座標</param>
+/// <param name="top">上側の座標</param>
+/// <param name="width">切り取るスクリーンの幅</param>
+/// <param name="height">切り取るスクリーンの高さ</param>
+/// <param name="minDepth">最小深度値</param>
+/// <param name="maxDepth">最大深度値</param>
+/// <returns></returns>
+Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth);
+
+Vector3 Project(const Vector3& v1, const Vector3& v2);
+
+Vector3 Subtract(const Vector3& v1, const Vector3& v2);
+
+Vector3 Add(const Vector3& v1, const Vector3& v2);
+
+/// <summary>
+/// スカラー倍
+/// </summary>
+Vector3 Multiply(float scalar, const Vector3& v);
+
+float Dot(const Vector3& v1, const Vector3& v2);
+
+float GetLength(const Vector3& v1);
+
+Vector3 Perpendicular(const Vector3& vector);
+
+Vector3 Normalize(const Vector3& v);
+
+/// <summary>
+/// 長さが0に近くてもNaNにならない正規化(分岐なし)
+/// 長さの2乗が小さすぎる(非正規化数になる)とき、大きすぎる(floatで表せない)とき、NaNを含むときは失敗する
+/// </summary>
+/// <param name="v">正規化するベクトル</param>
+/// <param name="normalized">単位ベクトル(失敗したら(0,0,0))</param>
+/// <returns>正規化できたらtrue</returns>
+bool TryNormalize(const Vector3& v, Vector3& normalized);
+
+Vector3 Cross(const Vector3& v1, const Vector3& v2);
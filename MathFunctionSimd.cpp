@@ -0,0 +1,174 @@
+#include "MathFunctionSimd.h"
+#include "MathFunction.h"
+#include <assert.h>
+
+#if defined(MT3_SIMD_SSE)
+#include <immintrin.h>
+
+// _MM_SHUFFLEを逆順(x,y,z,wの順)に書けるようにしたもの
+// (関数にすると最適化なしのビルドでは即値として扱われないのでマクロにする)
+#define MT3_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define MT3_SHUFFLE(vec1, vec2, x, y, z, w) _mm_shuffle_ps(vec1, vec2, MT3_SHUFFLE_MASK(x, y, z, w))
+#define MT3_SWIZZLE(vec, x, y, z, w) _mm_shuffle_ps(vec, vec, MT3_SHUFFLE_MASK(x, y, z, w))
+
+namespace {
+
+	// 2x2行列(行優先で1本の__m128に詰めたもの)の積 A*B
+	inline __m128 Mat2Mul(__m128 a, __m128 b) {
+		return _mm_add_ps(
+			_mm_mul_ps(a, MT3_SWIZZLE(b, 0, 3, 0, 3)),
+			_mm_mul_ps(MT3_SWIZZLE(a, 1, 0, 3, 2), MT3_SWIZZLE(b, 2, 1, 2, 1)));
+	}
+
+	// 2x2行列の余因子行列との積 adj(A)*B
+	inline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+		return _mm_sub_ps(
+			_mm_mul_ps(MT3_SWIZZLE(a, 3, 3, 0, 0), b),
+			_mm_mul_ps(MT3_SWIZZLE(a, 1, 1, 2, 2), MT3_SWIZZLE(b, 2, 3, 0, 1)));
+	}
+
+	// 2x2行列と余因子行列の積 A*adj(B)
+	inline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+		return _mm_sub_ps(
+			_mm_mul_ps(a, MT3_SWIZZLE(b, 3, 0, 3, 0)),
+			_mm_mul_ps(MT3_SWIZZLE(a, 1, 0, 3, 2), MT3_SWIZZLE(b, 2, 1, 2, 1)));
+	}
+
+}
+
+Matrix4x4 MultiplySimd(const Matrix4x4& matrix1, const Matrix4x4& matrix2)
+{
+	Matrix4x4 result;
+
+#if defined(MT3_SIMD_AVX)
+	// 2行ずつ(下位レーン=偶数行、上位レーン=奇数行)計算する
+	const __m256 row0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix2.m[0]));
+	const __m256 row1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix2.m[1]));
+	const __m256 row2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix2.m[2]));
+	const __m256 row3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix2.m[3]));
+
+	for (int row = 0; row < 4; row += 2) {
+		__m256 a = _mm256_loadu_ps(matrix1.m[row]);
+		__m256 r = _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x00), row0);
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x55), row1));
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xAA), row2));
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xFF), row3));
+		_mm256_storeu_ps(result.m[row], r);
+	}
+#else
+	const __m128 row0 = _mm_loadu_ps(matrix2.m[0]);
+	const __m128 row1 = _mm_loadu_ps(matrix2.m[1]);
+	const __m128 row2 = _mm_loadu_ps(matrix2.m[2]);
+	const __m128 row3 = _mm_loadu_ps(matrix2.m[3]);
+
+	for (int row = 0; row < 4; ++row) {
+		__m128 r = _mm_mul_ps(_mm_set1_ps(matrix1.m[row][0]), row0);
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(matrix1.m[row][1]), row1));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(matrix1.m[row][2]), row2));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(matrix1.m[row][3]), row3));
+		_mm_storeu_ps(result.m[row], r);
+	}
+#endif
+
+	return result;
+}
+
+Matrix4x4 InverseSimd(const Matrix4x4& matrix4x4, float* determinant)
+{
+	const __m128 row0 = _mm_loadu_ps(matrix4x4.m[0]);
+	const __m128 row1 = _mm_loadu_ps(matrix4x4.m[1]);
+	const __m128 row2 = _mm_loadu_ps(matrix4x4.m[2]);
+	const __m128 row3 = _mm_loadu_ps(matrix4x4.m[3]);
+
+	// |A B|
+	// |C D| に分ける
+	__m128 a = _mm_movelh_ps(row0, row1);
+	__m128 b = _mm_movehl_ps(row1, row0);
+	__m128 c = _mm_movelh_ps(row2, row3);
+	__m128 d = _mm_movehl_ps(row3, row2);
+
+	// 各小行列の行列式(|A|,|B|,|C|,|D|)
+	__m128 detSub = _mm_sub_ps(
+		_mm_mul_ps(MT3_SHUFFLE(row0, row2, 0, 2, 0, 2), MT3_SHUFFLE(row1, row3, 1, 3, 1, 3)),
+		_mm_mul_ps(MT3_SHUFFLE(row0, row2, 1, 3, 1, 3), MT3_SHUFFLE(row1, row3, 0, 2, 0, 2)));
+	__m128 detA = MT3_SWIZZLE(detSub, 0, 0, 0, 0);
+	__m128 detB = MT3_SWIZZLE(detSub, 1, 1, 1, 1);
+	__m128 detC = MT3_SWIZZLE(detSub, 2, 2, 2, 2);
+	__m128 detD = MT3_SWIZZLE(detSub, 3, 3, 3, 3);
+
+	__m128 dc = Mat2AdjMul(d, c);
+	__m128 ab = Mat2AdjMul(a, b);
+
+	// 逆行列の各ブロック(余因子行列のまま)
+	__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Mat2Mul(b, dc));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Mat2Mul(c, ab));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MulAdj(d, ab));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MulAdj(a, dc));
+
+	// |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+	__m128 det = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+	__m128 trace = _mm_mul_ps(ab, MT3_SWIZZLE(dc, 0, 2, 1, 3));
+	trace = _mm_add_ps(trace, MT3_SWIZZLE(trace, 1, 0, 3, 2));
+	trace = _mm_add_ps(trace, MT3_SWIZZLE(trace, 2, 3, 0, 1));
+	det = _mm_sub_ps(det, trace);
+	if (determinant) {
+		*determinant = _mm_cvtss_f32(det);
+	}
+
+	// 除算はここの1回だけ
+	const __m128 adjugateSign = _mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f);
+	__m128 inverseDet = _mm_div_ps(adjugateSign, det);
+
+	x = _mm_mul_ps(x, inverseDet);
+	y = _mm_mul_ps(y, inverseDet);
+	z = _mm_mul_ps(z, inverseDet);
+	w = _mm_mul_ps(w, inverseDet);
+
+	Matrix4x4 result;
+	_mm_storeu_ps(result.m[0], MT3_SHUFFLE(x, y, 3, 1, 3, 1));
+	_mm_storeu_ps(result.m[1], MT3_SHUFFLE(x, y, 2, 0, 2, 0));
+	_mm_storeu_ps(result.m[2], MT3_SHUFFLE(z, w, 3, 1, 3, 1));
+	_mm_storeu_ps(result.m[3], MT3_SHUFFLE(z, w, 2, 0, 2, 0));
+
+	return result;
+}
+
+Vector3 TransformSimd(const Vector3& vector, const Matrix4x4& matrix)
+{
+	__m128 r = _mm_mul_ps(_mm_set1_ps(vector.x), _mm_loadu_ps(matrix.m[0]));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(vector.y), _mm_loadu_ps(matrix.m[1])));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(vector.z), _mm_loadu_ps(matrix.m[2])));
+	r = _mm_add_ps(r, _mm_loadu_ps(matrix.m[3]));
+
+	__m128 w = MT3_SWIZZLE(r, 3, 3, 3, 3);
+	assert(_mm_cvtss_f32(w) != 0.0f);
+	r = _mm_div_ps(r, w);
+
+	float result[4];
+	_mm_storeu_ps(result, r);
+	return { result[0], result[1], result[2] };
+}
+
+#undef MT3_SHUFFLE_MASK
+#undef MT3_SHUFFLE
+#undef MT3_SWIZZLE
+
+#else
+
+// SIMDが使えない環境ではスカラー版をそのまま使う
+Matrix4x4 MultiplySimd(const Matrix4x4& matrix1, const Matrix4x4& matrix2)
+{
+	return MultiplyScalar(matrix1, matrix2);
+}
+
+Matrix4x4 InverseSimd(const Matrix4x4& matrix4x4, float* determinant)
+{
+	return InverseScalar(matrix4x4, determinant);
+}
+
+Vector3 TransformSimd(const Vector3& vector, const Matrix4x4& matrix)
+{
+	return TransformScalar(vector, matrix);
+}
+
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+#include <Matrix4x4.h>
+#include <Vector3.h>
+
+// SIMD命令セットの選択(コンパイル時)
+// MT3_DISABLE_SIMDを定義するとスカラー実装だけになる
+#if !defined(MT3_DISABLE_SIMD) && (defined(_M_X64) || defined(__SSE2__))
+#define MT3_SIMD_SSE 1
+#if defined(__AVX__)
+#define MT3_SIMD_AVX 1
+#endif
+#endif
+
+#if defined(MT3_SIMD_SSE)
+#define MT3_SIMD 1
+#endif
+
+/// <summary>
+/// 4x4行列の積を求める関数(SSE/AVX版)
+/// 加算の順序はスカラー版と同じなので結果も一致する
+/// </summary>
+/// <param name="matrix1">1つ目の行列</param>
+/// <param name="matrix2">2つ目の行列</param>
+/// <returns>4x4行列の積</returns>
+Matrix4x4 MultiplySimd(const Matrix4x4& matrix1, const Matrix4x4& matrix2);
+
+/// <summary>
+/// 4x4逆行列を求める関数(SSE版)
+/// 2x2の小行列に分けて余因子を計算し、除算は1回だけ行う
+/// </summary>
+/// <param name="matrix4x4">逆行列を求めたい行列</param>
+/// <param name="determinant">行列式の出力先(不要ならnullptr)</param>
+/// <returns>4x4逆行列</returns>
+Matrix4x4 InverseSimd(const Matrix4x4& matrix4x4, float* determinant = nullptr);
+
+/// <summary>
+/// 座標変換(SSE版)
+/// </summary>
+/// <param name="vector">変換する座標</param>
+/// <param name="matrix">変換行列</param>
+/// <returns>wで割った変換後の座標</returns>
+Vector3 TransformSimd(const Vector3& vector, const Matrix4x4& matrix);
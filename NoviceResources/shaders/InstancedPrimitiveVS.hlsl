@@ -0,0 +1,22 @@
+#include "Primitive.hlsli"
+
+// 頂点はローカル座標の形状(単位球など)、ワールド行列と色はインスタンスごとに受け取る
+// ピクセルシェーダーはPrimitivePS.hlslをそのまま使う
+struct VSInput {
+	float4 pos : POSITION;        // ローカル座標
+	float4 color : COLOR;         // 頂点の色(RGBA)
+	float4 world0 : WORLD0;       // ワールド行列の1行目
+	float4 world1 : WORLD1;       // 2行目
+	float4 world2 : WORLD2;       // 3行目
+	float4 world3 : WORLD3;       // 4行目(移動)
+	float4 instanceColor : INSTANCE_COLOR; // インスタンスの色(RGBA)
+};
+
+VSOutput main(VSInput input) {
+	VSOutput output; // ピクセルシェーダーに渡す値
+	float4x4 world = float4x4(input.world0, input.world1, input.world2, input.world3);
+	output.svpos = mul(mul(input.pos, world), mul(view, projection));
+	output.color = input.color * input.instanceColor;
+
+	return output;
+}
@@ -0,0 +1,100 @@
+#include "ParallelBatch.h"
+#include <algorithm>
+#include <assert.h>
+#include <atomic>
+
+namespace {
+
+	// 1つの塊で処理する要素数(ジョブの受け渡しの手間が見えなくなる程度)
+	const size_t kPointGrainSize = 4096;
+	const size_t kMatrixGrainSize = 1024;
+	const size_t kPairGrainSize = 16384;
+	const size_t kQueryGrainSize = 64;
+
+	std::span<const float> Slice(std::span<const float> values, size_t begin, size_t end) {
+		return values.subspan(begin, end - begin);
+	}
+
+	// 組の出力を相手[begin, end)の範囲に切り出す
+	SegmentHitsSoA SliceHits(const SegmentHitsSoA& hits, size_t segmentCount, size_t begin, size_t end) {
+		size_t offset = begin * segmentCount;
+		size_t count = (end - begin) * segmentCount;
+		return {
+			hits.hit.subspan(offset, count),
+			hits.t.empty() ? std::span<float>() : hits.t.subspan(offset, count),
+		};
+	}
+
+}
+
+size_t TransformToScreen(JobSystem& jobs, const PointsSoA& points, const Matrix4x4& viewProjectionViewportMatrix, const ScreenPointsSoA& screen)
+{
+	std::atomic<size_t> visibleCount = 0;
+	jobs.ParallelFor(points.x.size(), kPointGrainSize, [&](size_t begin, size_t end) {
+		size_t count = end - begin;
+		size_t visible = TransformToScreen(
+			{ Slice(points.x, begin, end), Slice(points.y, begin, end), Slice(points.z, begin, end) },
+			viewProjectionViewportMatrix,
+			{ screen.x.subspan(begin, count), screen.y.subspan(begin, count), screen.visible.subspan(begin, count) });
+		visibleCount.fetch_add(visible, std::memory_order_relaxed);
+		});
+	return visibleCount.load();
+}
+
+void MakeAffineMatrices(JobSystem& jobs, const TransformsSoA& transforms, std::span<Matrix4x4> matrices)
+{
+	// 出力は変換の数以上あればよい(余った分は書かない)
+	const size_t count = transforms.scaleX.size();
+	assert(matrices.size() >= count);
+	jobs.ParallelFor(count, kMatrixGrainSize, [&](size_t begin, size_t end) {
+		MakeAffineMatrices({
+			Slice(transforms.scaleX, begin, end), Slice(transforms.scaleY, begin, end), Slice(transforms.scaleZ, begin, end),
+			Slice(transforms.rotateX, begin, end), Slice(transforms.rotateY, begin, end), Slice(transforms.rotateZ, begin, end),
+			Slice(transforms.translateX, begin, end), Slice(transforms.translateY, begin, end), Slice(transforms.translateZ, begin, end),
+			}, matrices.subspan(begin, end - begin));
+		});
+}
+
+size_t IsCollisionBatch(JobSystem& jobs, const SegmentsSoA& segments, const PlanesSoA& planes, const SegmentHitsSoA& hits)
+{
+	size_t segmentCount = segments.originX.size();
+	size_t grainSize = std::max<size_t>(1, kPairGrainSize / std::max<size_t>(1, segmentCount));
+
+	std::atomic<size_t> hitCount = 0;
+	jobs.ParallelFor(planes.distance.size(), grainSize, [&](size_t begin, size_t end) {
+		size_t count = IsCollisionBatch(
+			segments,
+			PlanesSoA{ Slice(planes.normalX, begin, end), Slice(planes.normalY, begin, end), Slice(planes.normalZ, begin, end), Slice(planes.distance, begin, end) },
+			SliceHits(hits, segmentCount, begin, end));
+		hitCount.fetch_add(count, std::memory_order_relaxed);
+		});
+	return hitCount.load();
+}
+
+size_t IsCollisionBatch(JobSystem& jobs, const SegmentsSoA& segments, const SpheresSoA& spheres, const SegmentHitsSoA& hits)
+{
+	size_t segmentCount = segments.originX.size();
+	size_t grainSize = std::max<size_t>(1, kPairGrainSize / std::max<size_t>(1, segmentCount));
+
+	std::atomic<size_t> hitCount = 0;
+	jobs.ParallelFor(spheres.radius.size(), grainSize, [&](size_t begin, size_t end) {
+		size_t count = IsCollisionBatch(
+			segments,
+			SpheresSoA{ Slice(spheres.centerX, begin, end), Slice(spheres.centerY, begin, end), Slice(spheres.centerZ, begin, end), Slice(spheres.radius, begin, end) },
+			SliceHits(hits, segmentCount, begin, end));
+		hitCount.fetch_add(count, std::memory_order_relaxed);
+		});
+	return hitCount.load();
+}
+
+void QuerySegments(JobSystem& jobs, const BroadPhase& broadPhase, std::span<const Segment> segments, std::vector<SegmentCandidate>& candidates)
+{
+	jobs.ParallelCollect(segments.size(), kQueryGrainSize, candidates, [&](size_t begin, size_t end, std::vector<SegmentCandidate>& results) {
+		for (size_t i = begin; i < end; ++i) {
+			broadPhase.QuerySegment(segments[i], [&](BroadPhase::Handle handle) {
+				results.push_back({ static_cast<uint32_t>(i), handle });
+				return true;
+				});
+		}
+		});
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "BroadPhase.h"
+#include "CollisionBatch.h"
+#include "JobSystem.h"
+#include "TransformBatch.h"
+#include <span>
+#include <vector>
+
+// 一括処理をJobSystemで並列に実行する版
+// どれも入力を固定の塊に分けて、塊ごとに出力の別の範囲へ書くだけなので、結果はスレッド数によらず逐次版と同じ
+
+/// <summary>
+/// TransformToScreenを点の塊ごとに並列実行する
+/// </summary>
+/// <returns>画面に映る点の数</returns>
+size_t TransformToScreen(JobSystem& jobs, const PointsSoA& points, const Matrix4x4& viewProjectionViewportMatrix, const ScreenPointsSoA& screen);
+
+/// <summary>
+/// MakeAffineMatricesを塊ごとに並列実行する
+/// </summary>
+void MakeAffineMatrices(JobSystem& jobs, const TransformsSoA& transforms, std::span<Matrix4x4> matrices);
+
+/// <summary>
+/// IsCollisionBatchを相手(平面)の塊ごとに並列実行する
+/// </summary>
+/// <returns>当たった組の数</returns>
+size_t IsCollisionBatch(JobSystem& jobs, const SegmentsSoA& segments, const PlanesSoA& planes, const SegmentHitsSoA& hits);
+
+/// <summary>
+/// IsCollisionBatchを相手(球)の塊ごとに並列実行する
+/// </summary>
+/// <returns>当たった組の数</returns>
+size_t IsCollisionBatch(JobSystem& jobs, const SegmentsSoA& segments, const SpheresSoA& spheres, const SegmentHitsSoA& hits);
+
+// 線分とブロードフェーズの候補の組
+struct SegmentCandidate {
+	uint32_t segment;// segmentsの添え字
+	BroadPhase::Handle handle;
+};
+
+/// <summary>
+/// 各線分でBroadPhase::QuerySegmentを並列に行い、候補を集める
+/// 並びは線分の順、同じ線分の中ではQuerySegmentが返した順
+/// </summary>
+void QuerySegments(JobSystem& jobs, const BroadPhase& broadPhase, std::span<const Segment> segments, std::vector<SegmentCandidate>& candidates);
@@ -0,0 +1,32 @@
+#pragma once
+#include <Vector3.h>
+
+typedef struct Segment {
+	Vector3 origin;// 始点
+	Vector3 diff;// 終点
+}Segment;
+
+typedef struct Sphere {
+	Vector3 center;// 中心点
+	float radius;// 半径
+}Sphere;
+
+typedef struct Plane {
+	Vector3 normal;// 法線
+	float distance;// 距離
+}Plane;
+
+typedef struct AABB {
+	Vector3 min;// 最小点
+	Vector3 max;// 最大点
+}AABB;
+
+typedef struct OBB {
+	Vector3 center;// 中心点
+	Vector3 orientations[3];// 座標軸(正規化・直交)
+	Vector3 size;// 座標軸方向の長さの半分
+}OBB;
+
+typedef struct Triangle {
+	Vector3 vertices[3];// 頂点
+}Triangle;
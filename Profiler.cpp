@@ -0,0 +1,141 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <assert.h>
+#include <cstdio>
+#include <cstring>
+
+Profiler& Profiler::Get()
+{
+	static Profiler profiler;
+	return profiler;
+}
+
+Profiler::Profiler()
+	: epoch_(std::chrono::steady_clock::now())
+	, names_{}
+	, scopeCount_(0)
+	, frameScope_(0)
+	, frameTotalNs_{}
+	, frameCallCount_{}
+	, lastCallCount_{}
+	, frameStartNs_(0)
+	, history_(static_cast<size_t>(kHistoryFrames) * kMaxScopes, 0.0f)
+	, nextFrame_(0)
+	, frameCount_(0)
+	, events_(kMaxEvents)
+	, nextEvent_(0)
+	, eventCount_(0)
+{
+	frameScope_ = RegisterScope("Frame");
+}
+
+uint32_t Profiler::RegisterScope(const char* name)
+{
+	for (uint32_t scope = 0; scope < scopeCount_; ++scope) {
+		if (std::strcmp(names_[scope], name) == 0) {
+			return scope;
+		}
+	}
+
+	// 足りなくなったら最後の区間にまとめる
+	assert(scopeCount_ < kMaxScopes);
+	if (scopeCount_ == kMaxScopes) {
+		return kMaxScopes - 1;
+	}
+	names_[scopeCount_] = name;
+	return scopeCount_++;
+}
+
+void Profiler::End(uint32_t scope, int64_t startNs)
+{
+	int64_t durationNs = Now() - startNs;
+	frameTotalNs_[scope] += durationNs;
+	++frameCallCount_[scope];
+	PushEvent(scope, startNs, durationNs);
+}
+
+void Profiler::BeginFrame()
+{
+	frameStartNs_ = Now();
+}
+
+void Profiler::EndFrame()
+{
+	if (enabled_) {
+		End(frameScope_, frameStartNs_);
+	}
+
+	float* row = &history_[static_cast<size_t>(nextFrame_) * kMaxScopes];
+	for (uint32_t scope = 0; scope < kMaxScopes; ++scope) {
+		row[scope] = static_cast<float>(static_cast<double>(frameTotalNs_[scope]) * 1e-6);
+		lastCallCount_[scope] = frameCallCount_[scope];
+		frameTotalNs_[scope] = 0;
+		frameCallCount_[scope] = 0;
+	}
+	nextFrame_ = (nextFrame_ + 1) % kHistoryFrames;
+	frameCount_ = std::min(frameCount_ + 1, kHistoryFrames);
+}
+
+Profiler::ScopeStats Profiler::GetStats(uint32_t scope) const
+{
+	ScopeStats stats = { scope < scopeCount_ ? names_[scope] : "", 0.0f, 0.0f, 0.0f, 0 };
+	if (scope >= scopeCount_ || frameCount_ == 0) {
+		return stats;
+	}
+
+	// 履歴の並びは関係ないので、残っているフレームをそのまま並べ替える
+	float samples[kHistoryFrames];
+	double sum = 0.0;
+	for (uint32_t frame = 0; frame < frameCount_; ++frame) {
+		samples[frame] = history_[static_cast<size_t>(frame) * kMaxScopes + scope];
+		sum += samples[frame];
+	}
+	uint32_t p99Index = (frameCount_ * 99 + 99) / 100 - 1;
+	std::nth_element(samples, samples + p99Index, samples + frameCount_);
+
+	stats.averageMs = static_cast<float>(sum / frameCount_);
+	stats.p99Ms = samples[p99Index];
+	stats.maxMs = *std::max_element(samples + p99Index, samples + frameCount_);
+	stats.lastCallCount = lastCallCount_[scope];
+	return stats;
+}
+
+bool Profiler::WriteChromeTrace(const char* path) const
+{
+	FILE* file = std::fopen(path, "wb");
+	if (!file) {
+		return false;
+	}
+
+	// 時間はマイクロ秒。区間はすべて完了イベント("X")で、入れ子は時間の包含で表示される
+	std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main\"}}");
+	for (size_t i = 0; i < eventCount_; ++i) {
+		const Event& event = GetEvent(i);
+		std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+			names_[event.scope], event.scope == frameScope_ ? "frame" : "scope",
+			static_cast<double>(event.startNs) * 1e-3, static_cast<double>(event.durationNs) * 1e-3);
+	}
+	std::fprintf(file, "\n]}\n");
+
+	return std::fclose(file) == 0;
+}
+
+void Profiler::Clear()
+{
+	std::fill(history_.begin(), history_.end(), 0.0f);
+	std::fill(std::begin(frameTotalNs_), std::end(frameTotalNs_), 0);
+	std::fill(std::begin(frameCallCount_), std::end(frameCallCount_), 0u);
+	std::fill(std::begin(lastCallCount_), std::end(lastCallCount_), 0u);
+	nextFrame_ = 0;
+	frameCount_ = 0;
+	nextEvent_ = 0;
+	eventCount_ = 0;
+}
+
+void Profiler::PushEvent(uint32_t scope, int64_t startNs, int64_t durationNs)
+{
+	events_[nextEvent_] = { scope, startNs, durationNs };
+	nextEvent_ = (nextEvent_ + 1) % kMaxEvents;
+	eventCount_ = std::min(eventCount_ + 1, static_cast<size_t>(kMaxEvents));
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 区間ごとのCPU時間を測るプロファイラ
+/// PROFILE_SCOPE("名前")を置いた区間の時間を、フレームごとの合計としてkHistoryFrames個の
+/// リングバッファに残し、平均とp99を出す。個々の計測はChrome trace(JSON)に書き出せる
+/// 計測はメインスレッドからだけ行うこと(JobSystemのワーカーの中には置かない)
+/// 無効にすると各区間はフラグを1回読むだけになり、MT3_DISABLE_PROFILERを定義すると区間ごと消える
+/// </summary>
+class Profiler {
+public:
+	static const uint32_t kMaxScopes = 64;
+	static constexpr uint32_t kHistoryFrames = 256;
+	static const uint32_t kMaxEvents = 1u << 16;
+
+	// 1区間の集計(ミリ秒、直近kHistoryFramesフレームでの1フレームあたりの合計)
+	struct ScopeStats {
+		const char* name;
+		float averageMs;
+		float p99Ms;
+		float maxMs;
+		uint32_t lastCallCount;// 直前のフレームで呼ばれた回数
+	};
+
+	// 1回の計測(Chrome traceの1イベント)
+	struct Event {
+		uint32_t scope;
+		int64_t startNs;// プロファイラを作った時刻から
+		int64_t durationNs;
+	};
+
+	// 共有のプロファイラ
+	static Profiler& Get();
+
+	static bool IsEnabled() { return enabled_; }
+	static void SetEnabled(bool enabled) { enabled_ = enabled; }
+
+	/// <summary>
+	/// 区間の名前を登録して番号を返す(同じ名前は同じ番号)
+	/// 名前の文字列は登録後も残しておくこと(文字列リテラルを渡す)
+	/// </summary>
+	uint32_t RegisterScope(const char* name);
+
+	// 区間の開始時刻
+	int64_t Begin() const { return Now(); }
+
+	// 区間の終了(Beginの戻り値を渡す)
+	void End(uint32_t scope, int64_t startNs);
+
+	// フレームの区切り(EndFrameでそのフレームの合計を履歴に入れる)
+	void BeginFrame();
+	void EndFrame();
+
+	uint32_t GetScopeCount() const { return scopeCount_; }
+	ScopeStats GetStats(uint32_t scope) const;
+
+	// 記録したフレーム数(kHistoryFramesで頭打ち)
+	uint32_t GetFrameCount() const { return frameCount_; }
+
+	// リングバッファに残っている計測(古い順)
+	size_t GetEventCount() const { return eventCount_; }
+	const Event& GetEvent(size_t i) const { return events_[(nextEvent_ + kMaxEvents - eventCount_ + i) % kMaxEvents]; }
+
+	/// <summary>
+	/// 残っている計測とフレームの区切りをChrome trace形式(chrome://tracing, Perfetto)で書き出す
+	/// </summary>
+	/// <param name="path">出力先</param>
+	/// <returns>書き込めたらtrue</returns>
+	bool WriteChromeTrace(const char* path) const;
+
+	// 履歴と計測を捨てる(登録した区間は残す)
+	void Clear();
+
+private:
+	Profiler();
+
+	int64_t Now() const {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch_).count();
+	}
+
+	void PushEvent(uint32_t scope, int64_t startNs, int64_t durationNs);
+
+	static inline bool enabled_ = true;
+
+	std::chrono::steady_clock::time_point epoch_;
+
+	const char* names_[kMaxScopes];
+	uint32_t scopeCount_;
+	uint32_t frameScope_;// フレーム全体を表す区間
+
+	// 今のフレームの区間ごとの合計と回数
+	int64_t frameTotalNs_[kMaxScopes];
+	uint32_t frameCallCount_[kMaxScopes];
+	uint32_t lastCallCount_[kMaxScopes];
+	int64_t frameStartNs_;
+
+	// フレームごとの合計の履歴(history_[frame * kMaxScopes + scope])
+	std::vector<float> history_;
+	uint32_t nextFrame_;
+	uint32_t frameCount_;
+
+	std::vector<Event> events_;
+	size_t nextEvent_;
+	size_t eventCount_;
+};
+
+/// <summary>
+/// スコープを抜けるまでの時間を計測する(PROFILE_SCOPEから使う)
+/// </summary>
+class ProfileScope {
+public:
+	explicit ProfileScope(uint32_t scope)
+		: scope_(scope)
+		, startNs_(Profiler::IsEnabled() ? Profiler::Get().Begin() : -1)
+	{
+	}
+
+	~ProfileScope() {
+		if (startNs_ >= 0) {
+			Profiler::Get().End(scope_, startNs_);
+		}
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	uint32_t scope_;
+	int64_t startNs_;
+};
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+// ここからスコープの終わりまでを名前付きで計測する
+#if defined(MT3_DISABLE_PROFILER)
+#define PROFILE_SCOPE(name) ((void)0)
+#else
+#define PROFILE_SCOPE(name) \
+	static const uint32_t PROFILE_CONCAT(profileScopeId_, __LINE__) = Profiler::Get().RegisterScope(name); \
+	ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(PROFILE_CONCAT(profileScopeId_, __LINE__))
+#endif
@@ -0,0 +1,193 @@
+#include "Quaternion.h"
+#include "MathFunction.h"
+#include <assert.h>
+#include <cmath>
+
+namespace {
+
+	// これより内積が大きい(ほぼ同じ向き)ときはSlerpの代わりにNlerpを使う
+	const float kSlerpThreshold = 0.9995f;
+
+	// 単位クォータニオンの回転部分を、拡縮を掛けて行列の3x3部分へ書き込む
+	void WriteScaledRotation(float x, float y, float z, float w, float scaleX, float scaleY, float scaleZ, float (*m)[4]) {
+		float xx = x * x, yy = y * y, zz = z * z;
+		float xy = x * y, xz = x * z, yz = y * z;
+		float wx = w * x, wy = w * y, wz = w * z;
+
+		m[0][0] = scaleX * (1.0f - 2.0f * (yy + zz));
+		m[0][1] = scaleX * (2.0f * (xy + wz));
+		m[0][2] = scaleX * (2.0f * (xz - wy));
+		m[0][3] = 0.0f;
+
+		m[1][0] = scaleY * (2.0f * (xy - wz));
+		m[1][1] = scaleY * (1.0f - 2.0f * (xx + zz));
+		m[1][2] = scaleY * (2.0f * (yz + wx));
+		m[1][3] = 0.0f;
+
+		m[2][0] = scaleZ * (2.0f * (xz + wy));
+		m[2][1] = scaleZ * (2.0f * (yz - wx));
+		m[2][2] = scaleZ * (1.0f - 2.0f * (xx + yy));
+		m[2][3] = 0.0f;
+	}
+
+}
+
+Quaternion MakeIdentityQuaternion()
+{
+	return { 0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle)
+{
+	float sin, cos;
+	SinCos(angle * 0.5f, sin, cos);
+	return { axis.x * sin, axis.y * sin, axis.z * sin, cos };
+}
+
+Quaternion MakeRotateQuaternion(const Vector3& rotate)
+{
+	// X→Y→Zの順に回すので Z * Y * X
+	Quaternion rotateX = MakeRotateAxisAngleQuaternion({ 1.0f, 0.0f, 0.0f }, rotate.x);
+	Quaternion rotateY = MakeRotateAxisAngleQuaternion({ 0.0f, 1.0f, 0.0f }, rotate.y);
+	Quaternion rotateZ = MakeRotateAxisAngleQuaternion({ 0.0f, 0.0f, 1.0f }, rotate.z);
+	return Multiply(rotateZ, Multiply(rotateY, rotateX));
+}
+
+Quaternion Multiply(const Quaternion& lhs, const Quaternion& rhs)
+{
+	return {
+		lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y,
+		lhs.w * rhs.y - lhs.x * rhs.z + lhs.y * rhs.w + lhs.z * rhs.x,
+		lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x + lhs.z * rhs.w,
+		lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z,
+	};
+}
+
+Quaternion Conjugate(const Quaternion& quaternion)
+{
+	return { -quaternion.x, -quaternion.y, -quaternion.z, quaternion.w };
+}
+
+float Dot(const Quaternion& q1, const Quaternion& q2)
+{
+	return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+}
+
+float GetLength(const Quaternion& quaternion)
+{
+	return std::sqrt(Dot(quaternion, quaternion));
+}
+
+Quaternion Normalize(const Quaternion& quaternion)
+{
+	float length = GetLength(quaternion);
+	if (length == 0.0f) {
+		return MakeIdentityQuaternion();
+	}
+	float inverseLength = 1.0f / length;
+	return { quaternion.x * inverseLength, quaternion.y * inverseLength, quaternion.z * inverseLength, quaternion.w * inverseLength };
+}
+
+Quaternion Inverse(const Quaternion& quaternion)
+{
+	float lengthSquared = Dot(quaternion, quaternion);
+	if (lengthSquared == 0.0f) {
+		return MakeIdentityQuaternion();
+	}
+	float inverseLengthSquared = 1.0f / lengthSquared;
+	Quaternion conjugate = Conjugate(quaternion);
+	return { conjugate.x * inverseLengthSquared, conjugate.y * inverseLengthSquared, conjugate.z * inverseLengthSquared, conjugate.w * inverseLengthSquared };
+}
+
+Vector3 RotateVector(const Vector3& vector, const Quaternion& quaternion)
+{
+	// q * v * q^-1 を展開したもの
+	// t = 2 * (qv × v), v' = v + w * t + qv × t
+	float tx = 2.0f * (quaternion.y * vector.z - quaternion.z * vector.y);
+	float ty = 2.0f * (quaternion.z * vector.x - quaternion.x * vector.z);
+	float tz = 2.0f * (quaternion.x * vector.y - quaternion.y * vector.x);
+	return {
+		vector.x + quaternion.w * tx + (quaternion.y * tz - quaternion.z * ty),
+		vector.y + quaternion.w * ty + (quaternion.z * tx - quaternion.x * tz),
+		vector.z + quaternion.w * tz + (quaternion.x * ty - quaternion.y * tx),
+	};
+}
+
+Matrix4x4 MakeRotateMatrix(const Quaternion& quaternion)
+{
+	Matrix4x4 rotateMatrix;
+	WriteScaledRotation(quaternion.x, quaternion.y, quaternion.z, quaternion.w, 1.0f, 1.0f, 1.0f, rotateMatrix.m);
+	rotateMatrix.m[3][0] = 0.0f;
+	rotateMatrix.m[3][1] = 0.0f;
+	rotateMatrix.m[3][2] = 0.0f;
+	rotateMatrix.m[3][3] = 1.0f;
+	return rotateMatrix;
+}
+
+Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Quaternion& rotate, const Vector3& translate)
+{
+	Matrix4x4 affineMatrix4x4;
+	WriteScaledRotation(rotate.x, rotate.y, rotate.z, rotate.w, scale.x, scale.y, scale.z, affineMatrix4x4.m);
+	affineMatrix4x4.m[3][0] = translate.x;
+	affineMatrix4x4.m[3][1] = translate.y;
+	affineMatrix4x4.m[3][2] = translate.z;
+	affineMatrix4x4.m[3][3] = 1.0f;
+	return affineMatrix4x4;
+}
+
+Quaternion Slerp(const Quaternion& q1, const Quaternion& q2, float t)
+{
+	// qと-qは同じ回転なので、内積が負なら反転して短い方の弧を通る
+	float dot = Dot(q1, q2);
+	Quaternion end = q2;
+	if (dot < 0.0f) {
+		dot = -dot;
+		end = { -q2.x, -q2.y, -q2.z, -q2.w };
+	}
+
+	// ほぼ同じ向きだとsinθが0に近づいて不安定になる
+	if (dot > kSlerpThreshold) {
+		return Nlerp(q1, end, t);
+	}
+
+	float theta = std::acos(dot);
+	float inverseSinTheta = 1.0f / std::sin(theta);
+	float scale1 = std::sin((1.0f - t) * theta) * inverseSinTheta;
+	float scale2 = std::sin(t * theta) * inverseSinTheta;
+	return {
+		scale1 * q1.x + scale2 * end.x,
+		scale1 * q1.y + scale2 * end.y,
+		scale1 * q1.z + scale2 * end.z,
+		scale1 * q1.w + scale2 * end.w,
+	};
+}
+
+Quaternion Nlerp(const Quaternion& q1, const Quaternion& q2, float t)
+{
+	float scale2 = Dot(q1, q2) < 0.0f ? -t : t;
+	float scale1 = 1.0f - t;
+	return Normalize({
+		scale1 * q1.x + scale2 * q2.x,
+		scale1 * q1.y + scale2 * q2.y,
+		scale1 * q1.z + scale2 * q2.z,
+		scale1 * q1.w + scale2 * q2.w,
+		});
+}
+
+void MakeAffineMatrices(const QuaternionTransformsSoA& transforms, std::span<Matrix4x4> matrices)
+{
+	const size_t count = transforms.scaleX.size();
+	assert(matrices.size() >= count);
+
+	// sin/cosが無く分岐もないので、そのまま1個ずつ書き込む
+	for (size_t i = 0; i < count; ++i) {
+		float (*m)[4] = matrices[i].m;
+		WriteScaledRotation(
+			transforms.rotateX[i], transforms.rotateY[i], transforms.rotateZ[i], transforms.rotateW[i],
+			transforms.scaleX[i], transforms.scaleY[i], transforms.scaleZ[i], m);
+		m[3][0] = transforms.translateX[i];
+		m[3][1] = transforms.translateY[i];
+		m[3][2] = transforms.translateZ[i];
+		m[3][3] = 1.0f;
+	}
+}
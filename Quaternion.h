@@ -0,0 +1,107 @@
+#pragma once
+#include <Matrix4x4.h>
+#include <Vector3.h>
+#include <span>
+
+/// <summary>
+/// 回転を表すクォータニオン(x, y, zが虚部、wが実部)
+/// 回転に使うものは単位クォータニオン(長さ1)にしておく
+/// </summary>
+struct Quaternion {
+	float x;
+	float y;
+	float z;
+	float w;
+};
+
+Quaternion MakeIdentityQuaternion();
+
+/// <summary>
+/// 任意軸回転のクォータニオン
+/// </summary>
+/// <param name="axis">回転軸(正規化済み)</param>
+/// <param name="angle">回転角(ラジアン)</param>
+Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle);
+
+/// <summary>
+/// オイラー角からクォータニオンを作る
+/// MakeAffineMatrixと同じくX→Y→Zの順に回す
+/// </summary>
+Quaternion MakeRotateQuaternion(const Vector3& rotate);
+
+/// <summary>
+/// クォータニオンの積(ハミルトン積 lhs * rhs)
+/// rhsで回してからlhsで回す回転になる(行列ではMultiply(MakeRotateMatrix(rhs), MakeRotateMatrix(lhs)))
+/// </summary>
+Quaternion Multiply(const Quaternion& lhs, const Quaternion& rhs);
+
+Quaternion Conjugate(const Quaternion& quaternion);
+
+float Dot(const Quaternion& q1, const Quaternion& q2);
+
+float GetLength(const Quaternion& quaternion);
+
+/// <summary>
+/// 正規化(長さ0なら単位クォータニオンを返す)
+/// </summary>
+Quaternion Normalize(const Quaternion& quaternion);
+
+/// <summary>
+/// 逆クォータニオン(単位クォータニオンなら共役と同じ)
+/// </summary>
+Quaternion Inverse(const Quaternion& quaternion);
+
+/// <summary>
+/// ベクトルを直接回転させる(行列を作らない)
+/// </summary>
+Vector3 RotateVector(const Vector3& vector, const Quaternion& quaternion);
+
+/// <summary>
+/// 回転行列を作る(行ベクトル v * M 用)
+/// </summary>
+Matrix4x4 MakeRotateMatrix(const Quaternion& quaternion);
+
+/// <summary>
+/// 拡縮*回転*移動のアフィン行列を作る(回転をクォータニオンで渡す版)
+/// sin/cosを使わないので、オイラー角版より軽い
+/// </summary>
+Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Quaternion& rotate, const Vector3& translate);
+
+/// <summary>
+/// 球面線形補間(短い方の弧を通る)
+/// 2つがほぼ同じ向きのときはNlerpで求める
+/// </summary>
+/// <param name="q1">t = 0のときの回転</param>
+/// <param name="q2">t = 1のときの回転</param>
+/// <param name="t">補間係数</param>
+Quaternion Slerp(const Quaternion& q1, const Quaternion& q2, float t);
+
+/// <summary>
+/// 線形補間してから正規化する(短い方の弧を通る)
+/// 角速度は一定にならないが、acos/sinを使わないのでSlerpより軽い
+/// </summary>
+Quaternion Nlerp(const Quaternion& q1, const Quaternion& q2, float t);
+
+/// <summary>
+/// SoA形式で並べたSRT(回転はクォータニオン)の列
+/// すべての配列は同じ要素数にする
+/// </summary>
+struct QuaternionTransformsSoA {
+	std::span<const float> scaleX;
+	std::span<const float> scaleY;
+	std::span<const float> scaleZ;
+	std::span<const float> rotateX;
+	std::span<const float> rotateY;
+	std::span<const float> rotateZ;
+	std::span<const float> rotateW;
+	std::span<const float> translateX;
+	std::span<const float> translateY;
+	std::span<const float> translateZ;
+};
+
+/// <summary>
+/// N個のSRTからワールド行列を一括で作る(回転はクォータニオン)
+/// </summary>
+/// <param name="transforms">SRTの列</param>
+/// <param name="matrices">出力先(transformsと同じ要素数以上)</param>
+void MakeAffineMatrices(const QuaternionTransformsSoA& transforms, std::span<Matrix4x4> matrices);
@@ -0,0 +1,686 @@
+#include "Raycast.h"
+#include "Collision.h"
+#include "MathFunction.h"
+#include "SimdFloat.h"
+#include <algorithm>
+#include <assert.h>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+	// カーネルで当たらなかったレーンの値
+	// NaNはどの比較も偽になるので、maxDistanceが無限大でも当たりにならない
+	const float kMiss = std::numeric_limits<float>::quiet_NaN();
+
+	// 束のAABBを作るときのレイの長さの上限(これより遠い形状は束では見ない)
+	const float kMaxPacketLength = 1.0e30f;
+
+	// 束で調べるレイの向きの広がり(先頭のレイとの角度が約25度以内)
+	// 外れる束はレイ1本ずつ、形状をSIMDの幅ずつ調べる方が速い
+	const float kCoherentCosine = 0.9f;
+
+	// 束ねたレイ(1本を全レーンに配るか、レーンごとに別のレイを読む)
+	template<typename F>
+	struct RayLanes {
+		F originX;
+		F originY;
+		F originZ;
+		F directionX;
+		F directionY;
+		F directionZ;
+	};
+
+	template<typename F>
+	RayLanes<F> BroadcastRay(const Ray& ray) {
+		return {
+			F::Broadcast(ray.origin.x), F::Broadcast(ray.origin.y), F::Broadcast(ray.origin.z),
+			F::Broadcast(ray.direction.x), F::Broadcast(ray.direction.y), F::Broadcast(ray.direction.z),
+		};
+	}
+
+	template<typename F>
+	RayLanes<F> LoadRays(const RaysSoA& rays, size_t i) {
+		return {
+			F::Load(&rays.originX[i]), F::Load(&rays.originY[i]), F::Load(&rays.originZ[i]),
+			F::Load(&rays.directionX[i]), F::Load(&rays.directionY[i]), F::Load(&rays.directionZ[i]),
+		};
+	}
+
+	// |o + t*d - c|^2 = r^2 の小さい方の解(始点が中なら0)
+	template<typename F>
+	F SphereKernel(const RayLanes<F>& ray, F centerX, F centerY, F centerZ, F radius) {
+		F offsetX = ray.originX - centerX;
+		F offsetY = ray.originY - centerY;
+		F offsetZ = ray.originZ - centerZ;
+		F b = ray.directionX * offsetX + ray.directionY * offsetY + ray.directionZ * offsetZ;
+		F c = offsetX * offsetX + offsetY * offsetY + offsetZ * offsetZ - radius * radius;
+		F discriminant = b * b - c;
+
+		F zero = F::Broadcast(0.0f);
+		F entry = zero - b - F::Sqrt(F::Max(discriminant, zero));
+		typename F::Mask crosses = (discriminant >= zero) & (entry >= zero);
+		return F::Select(c <= zero, zero, F::Select(crosses, entry, F::Broadcast(kMiss)));
+	}
+
+	// 平面に平行なレイは当たらない
+	template<typename F>
+	F PlaneKernel(const RayLanes<F>& ray, F normalX, F normalY, F normalZ, F distance) {
+		F denominator = normalX * ray.directionX + normalY * ray.directionY + normalZ * ray.directionZ;
+		F height = normalX * ray.originX + normalY * ray.originY + normalZ * ray.originZ - distance;
+
+		F zero = F::Broadcast(0.0f);
+		typename F::Mask valid = denominator != zero;
+		F t = (zero - height) / F::Select(valid, denominator, F::Broadcast(1.0f));
+		return F::Select(valid & (t >= zero), t, F::Broadcast(kMiss));
+	}
+
+	// 線分(始点a, 終点b)を軸とするカプセル = 円柱の胴体と両端の球
+	// 始点が外にあれば、入る位置は3つのうち最も近いもの
+	template<typename F>
+	F CapsuleKernel(const RayLanes<F>& ray, F originX, F originY, F originZ, F endX, F endY, F endZ, F radius) {
+		F axisX = endX - originX;
+		F axisY = endY - originY;
+		F axisZ = endZ - originZ;
+		F offsetX = ray.originX - originX;
+		F offsetY = ray.originY - originY;
+		F offsetZ = ray.originZ - originZ;
+		F axisAxis = axisX * axisX + axisY * axisY + axisZ * axisZ;
+		F axisDirection = axisX * ray.directionX + axisY * ray.directionY + axisZ * ray.directionZ;
+		F axisOffset = axisX * offsetX + axisY * offsetY + axisZ * offsetZ;
+		F directionOffset = ray.directionX * offsetX + ray.directionY * offsetY + ray.directionZ * offsetZ;
+		F offsetOffset = offsetX * offsetX + offsetY * offsetY + offsetZ * offsetZ;
+		F radiusSq = radius * radius;
+
+		F zero = F::Broadcast(0.0f);
+		F one = F::Broadcast(1.0f);
+		F miss = F::Broadcast(kMiss);
+
+		// 始点から軸への最短距離(長さ0の線分は始点からの距離)
+		F s = F::Min(F::Max(axisOffset / F::Max(axisAxis, F::Broadcast(FLT_MIN)), zero), one);
+		F closestX = offsetX - s * axisX;
+		F closestY = offsetY - s * axisY;
+		F closestZ = offsetZ - s * axisZ;
+		typename F::Mask inside = closestX * closestX + closestY * closestY + closestZ * closestZ <= radiusSq;
+
+		// 胴体(軸に平行なレイと長さ0の線分はa = 0になるので端の球に任せる)
+		F a = axisAxis - axisDirection * axisDirection;
+		F b = axisAxis * directionOffset - axisOffset * axisDirection;
+		F c = axisAxis * offsetOffset - axisOffset * axisOffset - radiusSq * axisAxis;
+		F h = b * b - a * c;
+		typename F::Mask bodyValid = (a > zero) & (h >= zero);
+		F bodyT = (zero - b - F::Sqrt(F::Max(h, zero))) / F::Select(bodyValid, a, one);
+		F along = axisOffset + bodyT * axisDirection;
+		typename F::Mask bodyHit = bodyValid & (bodyT >= zero) & (along > zero) & (along < axisAxis);
+		F best = F::Select(bodyHit, bodyT, miss);
+
+		// 始点側の球
+		F hA = directionOffset * directionOffset - (offsetOffset - radiusSq);
+		F tA = zero - directionOffset - F::Sqrt(F::Max(hA, zero));
+		typename F::Mask hitA = (hA >= zero) & (tA >= zero);
+		// best != bestはまだ当たっていない(NaN)レーン
+		best = F::Select(hitA & ((tA < best) | (best != best)), tA, best);
+
+		// 終点側の球(始点をbへ移した値を展開したもの)
+		F directionOffsetB = directionOffset - axisDirection;
+		F offsetOffsetB = offsetOffset - (axisOffset + axisOffset) + axisAxis;
+		F hB = directionOffsetB * directionOffsetB - (offsetOffsetB - radiusSq);
+		F tB = zero - directionOffsetB - F::Sqrt(F::Max(hB, zero));
+		typename F::Mask hitB = (hB >= zero) & (tB >= zero);
+		best = F::Select(hitB & ((tB < best) | (best != best)), tB, best);
+
+		return F::Select(inside, zero, best);
+	}
+
+	// 形状countを幅ずつkernel(lanes, i)に通し、結果をvisit(t, i)へ渡す(visitがfalseを返したら打ち切る)
+	template<typename Kernel, typename Visit>
+	bool ScanShapes(const Ray& ray, size_t count, Kernel&& kernel, Visit&& visit) {
+		size_t i = 0;
+		{
+			RayLanes<VectorFloat> lanes = BroadcastRay<VectorFloat>(ray);
+			for (; i + VectorFloat::kWidth <= count; i += VectorFloat::kWidth) {
+				if (!visit(kernel(lanes, i), i)) {
+					return false;
+				}
+			}
+		}
+		RayLanes<ScalarFloat> lanes = BroadcastRay<ScalarFloat>(ray);
+		for (; i < count; ++i) {
+			if (!visit(kernel(lanes, i), i)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// 平面を幅ずつ調べる(平面は木に入れないので毎回全部を見る)
+	template<typename Visit>
+	bool ScanPlanes(const Scene& scene, const Ray& ray, Visit&& visit) {
+		PlanesSoA planes = scene.GetPlanes();
+		return ScanShapes(ray, planes.distance.size(), [&](const auto& lanes, size_t i) {
+			typedef std::remove_cvref_t<decltype(lanes.originX)> F;
+			return PlaneKernel(lanes, F::Load(&planes.normalX[i]), F::Load(&planes.normalY[i]), F::Load(&planes.normalZ[i]), F::Load(&planes.distance[i]));
+			}, std::forward<Visit>(visit));
+	}
+
+	// 木の葉が指す形状と、そのレイ(の束)との交差
+	template<typename F>
+	F IntersectLeaf(const RayLanes<F>& lanes, const Scene& scene, Scene::ShapeType type, size_t index, float segmentRadius) {
+		if (type == Scene::ShapeType::kSphere) {
+			SpheresSoA spheres = scene.GetSpheres();
+			return SphereKernel(lanes, F::Broadcast(spheres.centerX[index]), F::Broadcast(spheres.centerY[index]), F::Broadcast(spheres.centerZ[index]), F::Broadcast(spheres.radius[index]));
+		}
+		SegmentsSoA segments = scene.GetSegments();
+		return CapsuleKernel(lanes, F::Broadcast(segments.originX[index]), F::Broadcast(segments.originY[index]), F::Broadcast(segments.originZ[index]),
+			F::Broadcast(segments.endX[index]), F::Broadcast(segments.endY[index]), F::Broadcast(segments.endZ[index]), F::Broadcast(segmentRadius));
+	}
+
+	// 葉の形状の配列の中の位置
+	// Updateのあとに消えた形状を指していればScene::kInvalidIndex(呼び出し側でその葉を飛ばす)
+	size_t GetLeafIndex(const Scene& scene, const SceneRaycaster& raycaster, int32_t proxyId, Scene::ShapeType& type) {
+		Scene::Handle handle = raycaster.GetHandle(proxyId);
+		type = handle.type;
+		return scene.GetIndex(handle);
+	}
+
+	// 同じ距離なら球・線分・平面の順、同じ種類では配列の前の方を先とする並び
+	bool IsBefore(float distance, Scene::ShapeType type, size_t index, float otherDistance, Scene::ShapeType otherType, size_t otherIndex) {
+		if (distance != otherDistance) {
+			return distance < otherDistance;
+		}
+		return type != otherType ? type < otherType : index < otherIndex;
+	}
+
+	// 最も近い当たりを縮めながら探すときの状態
+	struct NearestHit {
+		float distance = INFINITY;
+		Scene::ShapeType type = Scene::ShapeType::kSphere;
+		size_t index = 0;
+
+		void Update(float t, Scene::ShapeType otherType, size_t otherIndex) {
+			if (IsBefore(t, otherType, otherIndex, distance, type, index)) {
+				distance = t;
+				type = otherType;
+				index = otherIndex;
+			}
+		}
+	};
+
+	// 当たった形状の位置と法線を埋める
+	void FillHit(const Scene& scene, const Ray& ray, Scene::ShapeType type, size_t index, float distance, RaycastHit& hit) {
+		hit.distance = distance;
+		hit.point = Add(ray.origin, Multiply(distance, ray.direction));
+		hit.handle = scene.GetHandle(type, index);
+
+		const Vector3 back = Multiply(-1.0f, ray.direction);
+		Vector3 outward = back;
+		if (type == Scene::ShapeType::kPlane) {
+			PlanesSoA planes = scene.GetPlanes();
+			Vector3 normal = { planes.normalX[index], planes.normalY[index], planes.normalZ[index] };
+			hit.normal = Dot(normal, ray.direction) > 0.0f ? Multiply(-1.0f, normal) : normal;
+			TryNormalize(hit.normal, hit.normal);
+			return;
+		}
+		if (type == Scene::ShapeType::kSphere) {
+			SpheresSoA spheres = scene.GetSpheres();
+			outward = Subtract(hit.point, { spheres.centerX[index], spheres.centerY[index], spheres.centerZ[index] });
+		} else {
+			SegmentsSoA segments = scene.GetSegments();
+			Segment segment = { { segments.originX[index], segments.originY[index], segments.originZ[index] }, { segments.endX[index], segments.endY[index], segments.endZ[index] } };
+			outward = Subtract(hit.point, ClosestPoint(hit.point, segment));
+		}
+		// 始点が中にあるときと、中心と重なったときはレイの来た向き
+		if (distance == 0.0f || !TryNormalize(outward, hit.normal)) {
+			hit.normal = back;
+		}
+	}
+
+	[[maybe_unused]] bool IsNormalized(const Vector3& direction) {
+		return std::fabs(Dot(direction, direction) - 1.0f) < 1.0e-3f;
+	}
+
+	// レイの束の全区間(始点からmaxDistanceまで)を囲むAABB
+	// 形状がこれに触れなければ、束のどのレイにも当たらない(近い向きのレイを束ねるほど小さくなる)
+	template<typename F>
+	AABB MakePacketBounds(const RaysSoA& rays, size_t i) {
+		AABB bounds = { { INFINITY, INFINITY, INFINITY }, { -INFINITY, -INFINITY, -INFINITY } };
+		for (size_t lane = 0; lane < F::kWidth; ++lane) {
+			const size_t ray = i + lane;
+			// 無限大のままだと向きの0の成分で0 * 無限大 = NaNになり、平面との判定で中心を求めるときにあふれる
+			const float length = std::min(rays.maxDistance[ray], kMaxPacketLength);
+			const float startX = rays.originX[ray];
+			const float startY = rays.originY[ray];
+			const float startZ = rays.originZ[ray];
+			const float endX = startX + length * rays.directionX[ray];
+			const float endY = startY + length * rays.directionY[ray];
+			const float endZ = startZ + length * rays.directionZ[ray];
+			bounds.min = { std::min({ bounds.min.x, startX, endX }), std::min({ bounds.min.y, startY, endY }), std::min({ bounds.min.z, startZ, endZ }) };
+			bounds.max = { std::max({ bounds.max.x, startX, endX }), std::max({ bounds.max.y, startY, endY }), std::max({ bounds.max.z, startZ, endZ }) };
+		}
+		return bounds;
+	}
+
+	// 束のレイがみな先頭のレイに近い向きか(ばらばらの向きでは束のAABBが大きくなり、形状を飛ばせない)
+	template<typename F>
+	bool IsCoherentPacket(const RaysSoA& rays, size_t i) {
+		for (size_t lane = 1; lane < F::kWidth; ++lane) {
+			float cosine = rays.directionX[i] * rays.directionX[i + lane] + rays.directionY[i] * rays.directionY[i + lane] + rays.directionZ[i] * rays.directionZ[i + lane];
+			if (cosine < kCoherentCosine) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	Ray GetRay(const RaysSoA& rays, size_t i) {
+		return { { rays.originX[i], rays.originY[i], rays.originZ[i] }, { rays.directionX[i], rays.directionY[i], rays.directionZ[i] }, rays.maxDistance[i] };
+	}
+
+	// レイの束ごとの、最も近い形状
+	template<typename F>
+	struct NearestLanes {
+		F distance;
+		F index;// 2^24個までは誤差なく表せる
+		F type;
+	};
+
+	// 木から取り出す順は配列の順と違うので、同じ距離のときは種類と位置で比べる(IsBeforeと同じ並び)
+	template<typename F>
+	void UpdateNearest(NearestLanes<F>& nearest, F t, F maxDistance, Scene::ShapeType type, size_t index) {
+		const F typeLanes = F::Broadcast(static_cast<float>(type));
+		const F indexLanes = F::Broadcast(static_cast<float>(index));
+		typename F::Mask before = (typeLanes < nearest.type) | ((typeLanes == nearest.type) & (indexLanes < nearest.index));
+		typename F::Mask closer = (t <= maxDistance) & ((t < nearest.distance) | ((t == nearest.distance) & before));
+		nearest.distance = F::Select(closer, t, nearest.distance);
+		nearest.index = F::Select(closer, indexLanes, nearest.index);
+		nearest.type = F::Select(closer, typeLanes, nearest.type);
+	}
+
+	// レイi..i+幅それぞれの最初に当たる形状(形状を1つ配るたびに束の全レイと判定する)
+	// 束のAABBに触れる球とカプセルだけを木から取り出す
+	template<typename F>
+	NearestLanes<F> NearestPacket(const Scene& scene, const SceneRaycaster& raycaster, const RaysSoA& rays, size_t i) {
+		RayLanes<F> lanes = LoadRays<F>(rays, i);
+		F maxDistance = F::Load(&rays.maxDistance[i]);
+		NearestLanes<F> nearest = { F::Broadcast(INFINITY), F::Broadcast(0.0f), F::Broadcast(0.0f) };
+		const AABB bounds = MakePacketBounds<F>(rays, i);
+
+		const float segmentRadius = raycaster.GetSegmentRadius();
+		raycaster.GetTree().Query(bounds, [&](int32_t proxyId) {
+			Scene::ShapeType type;
+			size_t index = GetLeafIndex(scene, raycaster, proxyId, type);
+			if (index == Scene::kInvalidIndex) {
+				return true;
+			}
+			UpdateNearest(nearest, IntersectLeaf(lanes, scene, type, index, segmentRadius), maxDistance, type, index);
+			return true;
+			});
+		PlanesSoA planes = scene.GetPlanes();
+		for (size_t j = 0; j < planes.distance.size(); ++j) {
+			if (!IsCollision(bounds, Plane{ { planes.normalX[j], planes.normalY[j], planes.normalZ[j] }, planes.distance[j] })) {
+				continue;
+			}
+			F t = PlaneKernel(lanes, F::Broadcast(planes.normalX[j]), F::Broadcast(planes.normalY[j]), F::Broadcast(planes.normalZ[j]), F::Broadcast(planes.distance[j]));
+			UpdateNearest(nearest, t, maxDistance, Scene::ShapeType::kPlane, j);
+		}
+		return nearest;
+	}
+
+	template<typename F>
+	size_t StoreNearestPacket(const Scene& scene, const SceneRaycaster& raycaster, const RaysSoA& rays, size_t i, RaycastHit* hits) {
+		NearestLanes<F> nearest = NearestPacket<F>(scene, raycaster, rays, i);
+		float distance[F::kWidth];
+		float index[F::kWidth];
+		float type[F::kWidth];
+		nearest.distance.Store(distance);
+		nearest.index.Store(index);
+		nearest.type.Store(type);
+
+		size_t hitCount = 0;
+		for (size_t lane = 0; lane < F::kWidth; ++lane) {
+			RaycastHit& hit = hits[lane];
+			if (distance[lane] == INFINITY) {
+				hit = { INFINITY, {}, {}, {} };
+				continue;
+			}
+			FillHit(scene, GetRay(rays, i + lane), static_cast<Scene::ShapeType>(static_cast<int>(type[lane])), static_cast<size_t>(index[lane]), distance[lane], hit);
+			++hitCount;
+		}
+		return hitCount;
+	}
+
+	// レイi..i+幅のどれがどれかに当たるか(全レーンが当たったら打ち切る)
+	template<typename F>
+	uint32_t AnyPacket(const Scene& scene, const SceneRaycaster& raycaster, const RaysSoA& rays, size_t i) {
+		RayLanes<F> lanes = LoadRays<F>(rays, i);
+		F maxDistance = F::Load(&rays.maxDistance[i]);
+		const uint32_t all = (1u << F::kWidth) - 1u;
+		uint32_t bits = 0;
+		const AABB bounds = MakePacketBounds<F>(rays, i);
+
+		PlanesSoA planes = scene.GetPlanes();
+		for (size_t j = 0; j < planes.distance.size() && bits != all; ++j) {
+			if (!IsCollision(bounds, Plane{ { planes.normalX[j], planes.normalY[j], planes.normalZ[j] }, planes.distance[j] })) {
+				continue;
+			}
+			F t = PlaneKernel(lanes, F::Broadcast(planes.normalX[j]), F::Broadcast(planes.normalY[j]), F::Broadcast(planes.normalZ[j]), F::Broadcast(planes.distance[j]));
+			bits |= (t <= maxDistance).Bits();
+		}
+		if (bits == all) {
+			return bits;
+		}
+
+		const float segmentRadius = raycaster.GetSegmentRadius();
+		raycaster.GetTree().Query(bounds, [&](int32_t proxyId) {
+			Scene::ShapeType type;
+			size_t index = GetLeafIndex(scene, raycaster, proxyId, type);
+			if (index == Scene::kInvalidIndex) {
+				return true;
+			}
+			bits |= (IntersectLeaf(lanes, scene, type, index, segmentRadius) <= maxDistance).Bits();
+			return bits != all;
+			});
+		return bits;
+	}
+
+	void CheckSizes([[maybe_unused]] const RaysSoA& rays, [[maybe_unused]] size_t outputSize) {
+		[[maybe_unused]] const size_t count = rays.originX.size();
+		assert(rays.originY.size() == count && rays.originZ.size() == count);
+		assert(rays.directionX.size() == count && rays.directionY.size() == count && rays.directionZ.size() == count);
+		assert(rays.maxDistance.size() == count);
+		assert(outputSize >= count);
+	}
+
+}
+
+bool IntersectRay(const Ray& ray, const Sphere& sphere, float& distance)
+{
+	ScalarFloat t = SphereKernel(BroadcastRay<ScalarFloat>(ray), ScalarFloat::Broadcast(sphere.center.x), ScalarFloat::Broadcast(sphere.center.y),
+		ScalarFloat::Broadcast(sphere.center.z), ScalarFloat::Broadcast(sphere.radius));
+	if (!(t.value <= ray.maxDistance)) {
+		return false;
+	}
+	distance = t.value;
+	return true;
+}
+
+bool IntersectRay(const Ray& ray, const Plane& plane, float& distance)
+{
+	ScalarFloat t = PlaneKernel(BroadcastRay<ScalarFloat>(ray), ScalarFloat::Broadcast(plane.normal.x), ScalarFloat::Broadcast(plane.normal.y),
+		ScalarFloat::Broadcast(plane.normal.z), ScalarFloat::Broadcast(plane.distance));
+	if (!(t.value <= ray.maxDistance)) {
+		return false;
+	}
+	distance = t.value;
+	return true;
+}
+
+bool IntersectRay(const Ray& ray, const Segment& segment, float radius, float& distance)
+{
+	ScalarFloat t = CapsuleKernel(BroadcastRay<ScalarFloat>(ray),
+		ScalarFloat::Broadcast(segment.origin.x), ScalarFloat::Broadcast(segment.origin.y), ScalarFloat::Broadcast(segment.origin.z),
+		ScalarFloat::Broadcast(segment.diff.x), ScalarFloat::Broadcast(segment.diff.y), ScalarFloat::Broadcast(segment.diff.z), ScalarFloat::Broadcast(radius));
+	if (!(t.value <= ray.maxDistance)) {
+		return false;
+	}
+	distance = t.value;
+	return true;
+}
+
+void SceneRaycaster::DestroyLeaf(Leaf& leaf)
+{
+	tree_.DestroyProxy(leaf.proxy);
+	leaf.proxy = DynamicAABBTree::kNullNode;
+}
+
+void SceneRaycaster::Synchronize(const Scene& scene, Scene::ShapeType type)
+{
+	const uint32_t kind = static_cast<uint32_t>(type);
+	std::vector<Leaf>& leaves = leaves_[kind];
+	SpheresSoA spheres = scene.GetSpheres();
+	SegmentsSoA segments = scene.GetSegments();
+	for (size_t index = 0; index < scene.GetCount(type); ++index) {
+		AABB aabb;
+		if (type == Scene::ShapeType::kSphere) {
+			aabb = MakeAABB(Sphere{ { spheres.centerX[index], spheres.centerY[index], spheres.centerZ[index] }, spheres.radius[index] });
+		} else {
+			aabb = MakeAABB(Segment{ { segments.originX[index], segments.originY[index], segments.originZ[index] }, { segments.endX[index], segments.endY[index], segments.endZ[index] } });
+			aabb.min = Subtract(aabb.min, { segmentRadius_, segmentRadius_, segmentRadius_ });
+			aabb.max = Add(aabb.max, { segmentRadius_, segmentRadius_, segmentRadius_ });
+		}
+
+		const Scene::Handle handle = scene.GetHandle(type, index);
+		if (leaves.size() <= handle.slot) {
+			leaves.resize(handle.slot + 1);
+		}
+		Leaf& leaf = leaves[handle.slot];
+		// 同じスロットでも世代が違えば別の形状なので葉を作り直す
+		if (leaf.proxy != DynamicAABBTree::kNullNode && leaf.generation != handle.generation) {
+			DestroyLeaf(leaf);
+		}
+		if (leaf.proxy == DynamicAABBTree::kNullNode) {
+			leaf.proxy = tree_.CreateProxy(aabb, handle.slot << 1 | kind);
+			leaf.generation = handle.generation;
+		} else {
+			tree_.MoveProxy(leaf.proxy, aabb);
+		}
+		leaf.stamp = stamp_;
+	}
+}
+
+void SceneRaycaster::Update(const Scene& scene, float segmentRadius)
+{
+	// 太さが変わったらカプセルの葉は全部作り直す
+	if (segmentRadius != segmentRadius_) {
+		for (Leaf& leaf : leaves_[static_cast<size_t>(Scene::ShapeType::kSegment)]) {
+			if (leaf.proxy != DynamicAABBTree::kNullNode) {
+				DestroyLeaf(leaf);
+			}
+		}
+		segmentRadius_ = segmentRadius;
+	}
+
+	++stamp_;
+	Synchronize(scene, Scene::ShapeType::kSphere);
+	if (segmentRadius_ > 0.0f) {
+		Synchronize(scene, Scene::ShapeType::kSegment);
+	}
+
+	// 今回見なかった葉(消えた形状、線分を見ないときの線分)を外す
+	for (std::vector<Leaf>& leaves : leaves_) {
+		for (Leaf& leaf : leaves) {
+			if (leaf.proxy != DynamicAABBTree::kNullNode && leaf.stamp != stamp_) {
+				DestroyLeaf(leaf);
+			}
+		}
+	}
+}
+
+bool Raycast(const Scene& scene, const SceneRaycaster& raycaster, const Ray& ray, RaycastHit& hit)
+{
+	assert(IsNormalized(ray.direction));
+	NearestHit nearest;
+
+	// 先に平面を見て、当たればその距離より遠い箱は開かない
+	float distances[VectorFloat::kWidth];
+	ScanPlanes(scene, ray, [&](auto t, size_t i) {
+		typedef decltype(t) F;
+		uint32_t bits = (t <= F::Broadcast(ray.maxDistance)).Bits();
+		if (bits) {
+			t.Store(distances);
+			for (size_t lane = 0; lane < F::kWidth; ++lane) {
+				if ((bits >> lane) & 1u) {
+					nearest.Update(distances[lane], Scene::ShapeType::kPlane, i + lane);
+				}
+			}
+		}
+		return true;
+		});
+
+	const RayLanes<ScalarFloat> lanes = BroadcastRay<ScalarFloat>(ray);
+	const float segmentRadius = raycaster.GetSegmentRadius();
+	raycaster.GetTree().RayCast(ray.origin, ray.direction, std::min(ray.maxDistance, nearest.distance), [&](int32_t proxyId, float maxT) {
+		Scene::ShapeType type;
+		size_t index = GetLeafIndex(scene, raycaster, proxyId, type);
+		if (index == Scene::kInvalidIndex) {
+			return maxT;
+		}
+		float t = IntersectLeaf(lanes, scene, type, index, segmentRadius).value;
+		if (t <= ray.maxDistance) {
+			nearest.Update(t, type, index);
+		}
+		// 見つかった距離まで縮める。同じ距離の形状は並びで比べるので、0で当たったときも打ち切らずに0のすぐ先まで残す
+		return std::min(maxT, std::max(nearest.distance, FLT_MIN));
+		});
+
+	if (nearest.distance == INFINITY) {
+		return false;
+	}
+	FillHit(scene, ray, nearest.type, nearest.index, nearest.distance, hit);
+	return true;
+}
+
+bool RaycastAny(const Scene& scene, const SceneRaycaster& raycaster, const Ray& ray)
+{
+	assert(IsNormalized(ray.direction));
+	bool planeHit = !ScanPlanes(scene, ray, [&](auto t, size_t) {
+		typedef decltype(t) F;
+		return !(t <= F::Broadcast(ray.maxDistance)).Bits();
+		});
+	if (planeHit) {
+		return true;
+	}
+
+	bool hit = false;
+	const RayLanes<ScalarFloat> lanes = BroadcastRay<ScalarFloat>(ray);
+	const float segmentRadius = raycaster.GetSegmentRadius();
+	raycaster.GetTree().RayCast(ray.origin, ray.direction, ray.maxDistance, [&](int32_t proxyId, float maxT) {
+		Scene::ShapeType type;
+		size_t index = GetLeafIndex(scene, raycaster, proxyId, type);
+		if (index == Scene::kInvalidIndex) {
+			return maxT;
+		}
+		hit = IntersectLeaf(lanes, scene, type, index, segmentRadius).value <= ray.maxDistance;
+		return hit ? 0.0f : maxT;
+		});
+	return hit;
+}
+
+size_t RaycastAll(const Scene& scene, const SceneRaycaster& raycaster, const Ray& ray, std::span<RaycastHit> hits)
+{
+	assert(IsNormalized(ray.direction));
+
+	// hits[0, stored)を最大ヒープ(先頭が最も遠い)にして、入りきらなければ先頭より近いものだけ入れ替える
+	// 数を返すので探す距離は縮めない
+	// 配列の位置は距離も種類も同じときだけ引く
+	auto isBefore = [&](const RaycastHit& a, const RaycastHit& b) {
+		if (a.distance != b.distance || a.handle.type != b.handle.type) {
+			return IsBefore(a.distance, a.handle.type, 0, b.distance, b.handle.type, 0);
+		}
+		return scene.GetIndex(a.handle) < scene.GetIndex(b.handle);
+		};
+	size_t hitCount = 0;
+	size_t stored = 0;
+	auto add = [&](Scene::ShapeType type, size_t index, float distance) {
+		++hitCount;
+		RaycastHit candidate = { distance, {}, {}, scene.GetHandle(type, index) };
+		if (stored < hits.size()) {
+			hits[stored++] = candidate;
+			std::push_heap(hits.begin(), hits.begin() + stored, isBefore);
+		} else if (stored != 0 && isBefore(candidate, hits[0])) {
+			std::pop_heap(hits.begin(), hits.begin() + stored, isBefore);
+			hits[stored - 1] = candidate;
+			std::push_heap(hits.begin(), hits.begin() + stored, isBefore);
+		}
+		};
+
+	float distances[VectorFloat::kWidth];
+	ScanPlanes(scene, ray, [&](auto t, size_t i) {
+		typedef decltype(t) F;
+		uint32_t bits = (t <= F::Broadcast(ray.maxDistance)).Bits();
+		if (bits) {
+			t.Store(distances);
+			for (size_t lane = 0; lane < F::kWidth; ++lane) {
+				if ((bits >> lane) & 1u) {
+					add(Scene::ShapeType::kPlane, i + lane, distances[lane]);
+				}
+			}
+		}
+		return true;
+		});
+
+	const RayLanes<ScalarFloat> lanes = BroadcastRay<ScalarFloat>(ray);
+	const float segmentRadius = raycaster.GetSegmentRadius();
+	raycaster.GetTree().RayCast(ray.origin, ray.direction, ray.maxDistance, [&](int32_t proxyId, float maxT) {
+		Scene::ShapeType type;
+		size_t index = GetLeafIndex(scene, raycaster, proxyId, type);
+		if (index == Scene::kInvalidIndex) {
+			return maxT;
+		}
+		float t = IntersectLeaf(lanes, scene, type, index, segmentRadius).value;
+		if (t <= ray.maxDistance) {
+			add(type, index, t);
+		}
+		return maxT;
+		});
+
+	// 近い順に並べてから位置と法線を埋める
+	std::sort_heap(hits.begin(), hits.begin() + stored, isBefore);
+	for (size_t i = 0; i < stored; ++i) {
+		const Scene::Handle handle = hits[i].handle;
+		FillHit(scene, ray, handle.type, scene.GetIndex(handle), hits[i].distance, hits[i]);
+	}
+	return hitCount;
+}
+
+size_t RaycastBatch(const Scene& scene, const SceneRaycaster& raycaster, const RaysSoA& rays, std::span<RaycastHit> hits)
+{
+	const size_t count = rays.originX.size();
+	CheckSizes(rays, hits.size());
+
+	size_t hitCount = 0;
+	size_t i = 0;
+	for (; i + VectorFloat::kWidth <= count; i += VectorFloat::kWidth) {
+		if (IsCoherentPacket<VectorFloat>(rays, i)) {
+			hitCount += StoreNearestPacket<VectorFloat>(scene, raycaster, rays, i, hits.data() + i);
+			continue;
+		}
+		for (size_t lane = 0; lane < VectorFloat::kWidth; ++lane) {
+			RaycastHit& hit = hits[i + lane];
+			if (Raycast(scene, raycaster, GetRay(rays, i + lane), hit)) {
+				++hitCount;
+			} else {
+				hit = { INFINITY, {}, {}, {} };
+			}
+		}
+	}
+	for (; i < count; ++i) {
+		hitCount += StoreNearestPacket<ScalarFloat>(scene, raycaster, rays, i, hits.data() + i);
+	}
+	return hitCount;
+}
+
+size_t RaycastAnyBatch(const Scene& scene, const SceneRaycaster& raycaster, const RaysSoA& rays, std::span<uint8_t> occluded)
+{
+	const size_t count = rays.originX.size();
+	CheckSizes(rays, occluded.size());
+
+	size_t hitCount = 0;
+	size_t i = 0;
+	for (; i + VectorFloat::kWidth <= count; i += VectorFloat::kWidth) {
+		const bool coherent = IsCoherentPacket<VectorFloat>(rays, i);
+		uint32_t bits = coherent ? AnyPacket<VectorFloat>(scene, raycaster, rays, i) : 0;
+		for (size_t lane = 0; lane < VectorFloat::kWidth; ++lane) {
+			occluded[i + lane] = coherent ? static_cast<uint8_t>((bits >> lane) & 1u) : RaycastAny(scene, raycaster, GetRay(rays, i + lane));
+			hitCount += occluded[i + lane];
+		}
+	}
+	for (; i < count; ++i) {
+		occluded[i] = static_cast<uint8_t>(AnyPacket<ScalarFloat>(scene, raycaster, rays, i));
+		hitCount += occluded[i];
+	}
+	return hitCount;
+}
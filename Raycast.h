@@ -0,0 +1,133 @@
+#pragma once
+#include "DynamicAABBTree.h"
+#include "Primitive.h"
+#include "Scene.h"
+#include <Vector3.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// 半直線 origin + distance * direction (0 <= distance <= maxDistance)
+/// directionは正規化しておくこと(distanceがそのまま距離になる)
+/// </summary>
+struct Ray {
+	Vector3 origin;
+	Vector3 direction;
+	float maxDistance;
+};
+
+/// <summary>
+/// レイが当たった位置
+/// </summary>
+struct RaycastHit {
+	float distance;// 始点からの距離(始点が形状の中なら0)
+	Vector3 point;
+	Vector3 normal;// レイの来た側を向く単位法線(始点が形状の中なら-direction)
+	Scene::Handle handle;
+};
+
+/// <summary>
+/// SoA形式のレイ列(RaycastBatch)
+/// </summary>
+struct RaysSoA {
+	std::span<const float> originX;
+	std::span<const float> originY;
+	std::span<const float> originZ;
+	std::span<const float> directionX;
+	std::span<const float> directionY;
+	std::span<const float> directionZ;
+	std::span<const float> maxDistance;
+};
+
+// 1つの形状との交差(当たったときだけdistanceを書く)
+// 平面は両面で、平面に平行なレイ(平面の上を走るレイも)は当たらない
+// 線分はradiusの太さのカプセルとして扱う
+bool IntersectRay(const Ray& ray, const Sphere& sphere, float& distance);
+bool IntersectRay(const Ray& ray, const Plane& plane, float& distance);
+bool IntersectRay(const Ray& ray, const Segment& segment, float radius, float& distance);
+
+/// <summary>
+/// Sceneの球と線分(太さsegmentRadiusのカプセル)を動的AABBツリーに入れた、レイの問い合わせ用の索引
+/// 平面は無限に広がるので木には入れず、問い合わせのたびに全部を調べる(BroadPhaseと同じ)
+/// 形状を追加・削除・移動したら、問い合わせの前にUpdateで木を合わせること
+/// (合わせる前の問い合わせでは、消えた形状の葉は飛ばし、追加や移動した形状は見落とすことがある)
+/// 1つのシーン専用で、Updateのたびにそのシーンのハンドルで前回の葉を引き継ぐ
+/// </summary>
+class SceneRaycaster {
+public:
+	/// <summary>
+	/// 木をシーンに合わせる
+	/// 前回からある形状はfat AABBからはみ出したときだけ組み替え、増えた形状は葉を足し、消えた形状は葉を外す
+	/// </summary>
+	/// <param name="scene">問い合わせるシーン</param>
+	/// <param name="segmentRadius">線分を扱うカプセルの太さ(0以下なら線分は見ない。変えると線分の葉を作り直す)</param>
+	void Update(const Scene& scene, float segmentRadius);
+
+	float GetSegmentRadius() const { return segmentRadius_; }
+	const DynamicAABBTree& GetTree() const { return tree_; }
+
+	// 木の葉が指す形状(Updateの時点のハンドル)
+	Scene::Handle GetHandle(int32_t proxyId) const {
+		const uint32_t userData = tree_.GetUserData(proxyId);
+		const Scene::ShapeType type = static_cast<Scene::ShapeType>(userData & 1u);
+		const uint32_t slot = userData >> 1;
+		return { type, slot, leaves_[userData & 1u][slot].generation };
+	}
+
+private:
+	// シーンのスロットごとの葉
+	struct Leaf {
+		int32_t proxy = DynamicAABBTree::kNullNode;
+		uint32_t generation = 0;
+		uint32_t stamp = 0;// 最後に見たUpdateの番号(古いままなら形状は消えている)
+	};
+
+	void Synchronize(const Scene& scene, Scene::ShapeType type);
+	void DestroyLeaf(Leaf& leaf);
+
+	DynamicAABBTree tree_;
+	std::vector<Leaf> leaves_[2];// 球と線分
+	float segmentRadius_ = 0.0f;
+	uint32_t stamp_ = 0;
+};
+
+// 以下の問い合わせは、sceneに合わせてUpdateしたraycasterの木をたどる
+// 線分はraycasterのsegmentRadiusの太さのカプセルとして扱う
+
+/// <summary>
+/// シーンの中でレイが最初に当たる形状
+/// 当たりが見つかるたびに探す距離を縮めるので、それより遠い箱は開かない
+/// 同じ距離で当たったときは球・線分・平面の順、同じ種類では配列の前の方を返す
+/// </summary>
+/// <returns>当たればtrue</returns>
+bool Raycast(const Scene& scene, const SceneRaycaster& raycaster, const Ray& ray, RaycastHit& hit);
+
+/// <summary>
+/// どれかに当たるか(遮蔽・視線判定用。最初に見つけた時点で打ち切る)
+/// </summary>
+bool RaycastAny(const Scene& scene, const SceneRaycaster& raycaster, const Ray& ray);
+
+/// <summary>
+/// 当たった形状を近い順にhitsへ書く
+/// hitsに入りきらないときは近い方からhits.size()個を残す(hitsを最大ヒープにして、遠いものから押し出す)
+/// 戻り値で足りたかを確かめること
+/// </summary>
+/// <returns>当たった形状の数(hits.size()より大きいこともある)</returns>
+size_t RaycastAll(const Scene& scene, const SceneRaycaster& raycaster, const Ray& ray, std::span<RaycastHit> hits);
+
+/// <summary>
+/// N本のレイそれぞれの最初に当たる形状をまとめて求める(hits[i]がi本目)
+/// レイをSIMDの幅ずつ束ねて、束の区間を囲むAABBに触れる形状を木から取り出し、束の全部と判定する
+/// 近い向きのレイ(画面の隣り合う画素など)を続けて並べるほど速い。向きのばらばらな束はレイ1本ずつ調べる
+/// 当たらなかったレイはdistanceが無限大で、handleは無効なまま
+/// </summary>
+/// <returns>当たったレイの数</returns>
+size_t RaycastBatch(const Scene& scene, const SceneRaycaster& raycaster, const RaysSoA& rays, std::span<RaycastHit> hits);
+
+/// <summary>
+/// N本のレイそれぞれがどれかに当たるか(occluded[i]が0/1)。束の全部が当たった時点でその束は打ち切る
+/// </summary>
+/// <returns>当たったレイの数</returns>
+size_t RaycastAnyBatch(const Scene& scene, const SceneRaycaster& raycaster, const RaysSoA& rays, std::span<uint8_t> occluded);
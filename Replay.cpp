@@ -0,0 +1,361 @@
+#include "Replay.h"
+#include "CollisionBatch.h"
+#include "FrameArena.h"
+#include "MathFunction.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+	const char kMagic[4] = { 'M', 'T', '3', 'R' };
+
+	// DIK_ESCAPE
+	const uint32_t kEscapeKey = 0x01;
+
+	// 記録ファイルの先頭(後ろにフレームが続く)
+	struct ReplayHeader {
+		char magic[4];// "MT3R"
+		uint32_t version;
+		uint64_t frameCount;
+		uint32_t sphereCount;
+		uint32_t seed;
+		double stepSeconds;
+		float viewportWidth;
+		float viewportHeight;
+	};
+	static_assert(sizeof(ReplayHeader) == 40, "ReplayHeader is part of the file format");
+
+	// 各フレームの先頭の1バイト。立っているものだけが後ろに続く(経過時間は毎フレーム)
+	enum FrameFlag : uint8_t {
+		kKeysChanged = 1u << 0,
+		kDirectionChanged = 1u << 1,
+		kSegmentOriginChanged = 1u << 2,
+		kCameraRotateChanged = 1u << 3,
+		kCameraTranslateChanged = 1u << 4,
+		kPaused = 1u << 5,
+		kReset = 1u << 6,
+	};
+
+	bool Equals(const Vector3& a, const Vector3& b) {
+		return std::memcmp(&a, &b, sizeof(Vector3)) == 0;
+	}
+
+	void Append(std::vector<uint8_t>& bytes, const void* data, size_t size) {
+		const uint8_t* begin = static_cast<const uint8_t*>(data);
+		bytes.insert(bytes.end(), begin, begin + size);
+	}
+
+	bool Read(std::span<const uint8_t> bytes, size_t& position, void* data, size_t size) {
+		if (bytes.size() - position < size) {
+			return false;
+		}
+		std::memcpy(data, bytes.data() + position, size);
+		position += size;
+		return true;
+	}
+
+	// 1フレームを読む。書かれていない値はpreviousのまま
+	bool DecodeFrame(std::span<const uint8_t> bytes, size_t& position, ReplayFrame& previous) {
+		uint8_t flags;
+		if (!Read(bytes, position, &flags, sizeof(flags)) || (flags & 0x80u) || !Read(bytes, position, &previous.frameSeconds, sizeof(double))) {
+			return false;
+		}
+		bool valid = true;
+		if (flags & kKeysChanged) {
+			valid = valid && Read(bytes, position, previous.keys, sizeof(previous.keys));
+		}
+		if (flags & kDirectionChanged) {
+			valid = valid && Read(bytes, position, &previous.direction, sizeof(Vector3));
+		}
+		if (flags & kSegmentOriginChanged) {
+			valid = valid && Read(bytes, position, &previous.segmentOrigin, sizeof(Vector3));
+		}
+		if (flags & kCameraRotateChanged) {
+			valid = valid && Read(bytes, position, &previous.cameraRotate, sizeof(Vector3));
+		}
+		if (flags & kCameraTranslateChanged) {
+			valid = valid && Read(bytes, position, &previous.cameraTranslate, sizeof(Vector3));
+		}
+		previous.paused = (flags & kPaused) != 0;
+		previous.reset = (flags & kReset) != 0;
+		return valid;
+	}
+
+	uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+		// FNV-1a
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+}
+
+void PackKeys(const char keys[256], uint8_t packed[32])
+{
+	std::memset(packed, 0, 32);
+	for (uint32_t key = 0; key < 256; ++key) {
+		if (keys[key] != 0) {
+			packed[key >> 3] |= static_cast<uint8_t>(1u << (key & 7));
+		}
+	}
+}
+
+void InitializeInteractiveState(InteractiveState& state, const ReplaySettings& settings)
+{
+	state.settings = settings;
+	state.simulation = MakeSimulationScene(settings.sphereCount, settings.seed);
+	state.timestep = FixedTimestep(settings.stepSeconds);
+
+	state.segment = { { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+	state.scene = Scene();
+	state.segmentHandle = state.scene.Add(state.segment);
+	state.scene.Add(Plane{ { 0.0f, 1.0f, 0.0f }, 1.0f });
+
+	state.camera = Camera();
+	state.camera.SetPerspective(0.45f, settings.viewportWidth / settings.viewportHeight, 0.1f, 100.0f);
+	state.camera.SetViewport(0, 0, settings.viewportWidth, settings.viewportHeight, 0.0f, 1.0f);
+
+	state.segmentHits = {};
+	state.stepsThisFrame = 0;
+}
+
+void UpdateInteractiveFrame(InteractiveState& state, const ReplayFrame& frame)
+{
+	if (frame.reset) {
+		state.simulation = MakeSimulationScene(state.settings.sphereCount, state.settings.seed);
+		state.timestep.Reset();
+	}
+	state.stepsThisFrame = 0;
+	if (!frame.paused) {
+		state.stepsThisFrame = RunFixedSteps(state.timestep, frame.frameSeconds, [&](float stepSeconds) { StepSimulation(state.simulation, stepSeconds); });
+	}
+
+	// 前フレームのImGuiで変わっていなければ何も計算しない
+	state.camera.SetRotate(frame.cameraRotate);
+	state.camera.SetTranslate(frame.cameraTranslate);
+	state.camera.GetViewProjectionViewportMatrix();
+
+	// 単位ベクトルにしてからスケーリング(スライダーが全部0のときは下向きのまま)
+	const float segmentLength = 1.0f;
+	Vector3 normalizedDir;
+	if (!TryNormalize(frame.direction, normalizedDir)) {
+		normalizedDir = { 0.0f, -1.0f, 0.0f };
+	}
+	state.segment.origin = frame.segmentOrigin;
+	state.segment.diff = Add(state.segment.origin, Multiply(segmentLength, normalizedDir));
+	state.scene.Set(state.segmentHandle, state.segment);
+
+	const size_t segmentCount = state.scene.GetCount(Scene::ShapeType::kSegment);
+	const size_t planeCount = state.scene.GetCount(Scene::ShapeType::kPlane);
+	std::span<uint8_t> segmentHits = GetFrameArena().AllocateArray<uint8_t>(segmentCount * planeCount);
+	{
+		PROFILE_SCOPE("IsCollision");
+		IsCollisionBatch(state.scene.GetSegments(), state.scene.GetPlanes(), { segmentHits, {} });
+	}
+	state.segmentHits = segmentHits;
+}
+
+uint64_t HashInteractiveFrame(uint64_t hash, const InteractiveState& state)
+{
+	hash = HashBytes(hash, &state.segment, sizeof(Segment));
+	hash = HashBytes(hash, state.segmentHits.data(), state.segmentHits.size());
+	hash = HashBytes(hash, &state.stepsThisFrame, sizeof(state.stepsThisFrame));
+	hash = HashBytes(hash, &state.camera.GetViewProjectionViewportMatrix(), sizeof(Matrix4x4));
+	uint64_t simulationHash = HashSimulation(state.simulation);
+	return HashBytes(hash, &simulationHash, sizeof(simulationHash));
+}
+
+void ReplayRecorder::Begin(const ReplaySettings& settings)
+{
+	settings_ = settings;
+	bytes_.clear();
+	previous_ = {};
+	frameCount_ = 0;
+}
+
+void ReplayRecorder::Add(const ReplayFrame& frame)
+{
+	uint8_t flags = 0;
+	if (std::memcmp(frame.keys, previous_.keys, sizeof(frame.keys)) != 0) {
+		flags |= kKeysChanged;
+	}
+	// 最初のフレームは全部書く
+	const bool first = frameCount_ == 0;
+	if (first || !Equals(frame.direction, previous_.direction)) {
+		flags |= kDirectionChanged;
+	}
+	if (first || !Equals(frame.segmentOrigin, previous_.segmentOrigin)) {
+		flags |= kSegmentOriginChanged;
+	}
+	if (first || !Equals(frame.cameraRotate, previous_.cameraRotate)) {
+		flags |= kCameraRotateChanged;
+	}
+	if (first || !Equals(frame.cameraTranslate, previous_.cameraTranslate)) {
+		flags |= kCameraTranslateChanged;
+	}
+	if (frame.paused) {
+		flags |= kPaused;
+	}
+	if (frame.reset) {
+		flags |= kReset;
+	}
+
+	Append(bytes_, &flags, sizeof(flags));
+	Append(bytes_, &frame.frameSeconds, sizeof(double));
+	if (flags & kKeysChanged) {
+		Append(bytes_, frame.keys, sizeof(frame.keys));
+	}
+	if (flags & kDirectionChanged) {
+		Append(bytes_, &frame.direction, sizeof(Vector3));
+	}
+	if (flags & kSegmentOriginChanged) {
+		Append(bytes_, &frame.segmentOrigin, sizeof(Vector3));
+	}
+	if (flags & kCameraRotateChanged) {
+		Append(bytes_, &frame.cameraRotate, sizeof(Vector3));
+	}
+	if (flags & kCameraTranslateChanged) {
+		Append(bytes_, &frame.cameraTranslate, sizeof(Vector3));
+	}
+	previous_ = frame;
+	++frameCount_;
+}
+
+bool ReplayRecorder::Write(const char* path) const
+{
+	ReplayHeader header = {};
+	std::memcpy(header.magic, kMagic, sizeof(kMagic));
+	header.version = kReplayVersion;
+	header.frameCount = frameCount_;
+	header.sphereCount = settings_.sphereCount;
+	header.seed = settings_.seed;
+	header.stepSeconds = settings_.stepSeconds;
+	header.viewportWidth = settings_.viewportWidth;
+	header.viewportHeight = settings_.viewportHeight;
+
+	FILE* file = std::fopen(path, "wb");
+	if (!file) {
+		return false;
+	}
+	bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+	written = written && std::fwrite(bytes_.data(), 1, bytes_.size(), file) == bytes_.size();
+	return std::fclose(file) == 0 && written;
+}
+
+bool ReplayReader::Open(const char* path)
+{
+	std::vector<uint8_t> bytes;
+	FILE* file = std::fopen(path, "rb");
+	if (!file) {
+		return false;
+	}
+	uint8_t buffer[65536];
+	size_t read;
+	while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+		bytes.insert(bytes.end(), buffer, buffer + read);
+	}
+	std::fclose(file);
+	return OpenMemory(bytes);
+}
+
+bool ReplayReader::OpenMemory(std::span<const uint8_t> bytes)
+{
+	bytes_.assign(bytes.begin(), bytes.end());
+	frameCount_ = 0;
+	Rewind();
+
+	ReplayHeader header;
+	size_t position = 0;
+	if (!Read(bytes_, position, &header, sizeof(header)) || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+		header.version != kReplayVersion || header.stepSeconds <= 0.0 || header.viewportWidth <= 0.0f || header.viewportHeight <= 0.0f) {
+		bytes_.clear();
+		return false;
+	}
+	settings_ = { header.sphereCount, header.seed, header.stepSeconds, header.viewportWidth, header.viewportHeight };
+
+	// 先に最後まで読んで、途中で切れていないかを確かめる
+	ReplayFrame frame = {};
+	for (uint64_t i = 0; i < header.frameCount; ++i) {
+		if (!DecodeFrame(bytes_, position, frame)) {
+			bytes_.clear();
+			return false;
+		}
+	}
+	if (position != bytes_.size()) {
+		bytes_.clear();
+		return false;
+	}
+	frameCount_ = static_cast<size_t>(header.frameCount);
+	Rewind();
+	return true;
+}
+
+bool ReplayReader::Next(ReplayFrame& frame)
+{
+	if (frameIndex_ >= frameCount_ || !DecodeFrame(bytes_, position_, previous_)) {
+		return false;
+	}
+	++frameIndex_;
+	frame = previous_;
+	return true;
+}
+
+void ReplayReader::Rewind()
+{
+	position_ = sizeof(ReplayHeader);
+	frameIndex_ = 0;
+	previous_ = {};
+}
+
+ReplayReport RunReplay(ReplayReader& reader)
+{
+	InteractiveState state;
+	InitializeInteractiveState(state, reader.GetSettings());
+
+	ReplayReport report = {};
+	report.hash = 14695981039346656037ull;
+	report.frameMs.reserve(reader.GetFrameCount());
+	ReplayFrame frame;
+	bool escapeWasDown = false;
+	reader.Rewind();
+	while (reader.Next(frame)) {
+		// 1フレームを1回の計測としてプロファイラに記録する
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		Profiler::Get().BeginFrame();
+		GetFrameArena().Reset();
+		UpdateInteractiveFrame(state, frame);
+		Profiler::Get().EndFrame();
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+		report.frameMs.push_back(std::chrono::duration<float, std::milli>(end - start).count());
+		report.hash = HashInteractiveFrame(report.hash, state);
+		report.stepCount += state.stepsThisFrame;
+		++report.frameCount;
+
+		bool escapeDown = IsKeyDown(frame, kEscapeKey);
+		if (escapeDown && !escapeWasDown) {
+			break;
+		}
+		escapeWasDown = escapeDown;
+	}
+
+	for (float ms : report.frameMs) {
+		report.seconds += ms / 1000.0;
+	}
+	if (!report.frameMs.empty()) {
+		std::vector<float> sorted = report.frameMs;
+		std::sort(sorted.begin(), sorted.end());
+		report.averageMs = report.seconds * 1000.0 / static_cast<double>(sorted.size());
+		report.p50Ms = sorted[(sorted.size() - 1) / 2];
+		report.p99Ms = sorted[(sorted.size() - 1) * 99 / 100];
+		report.maxMs = sorted.back();
+	}
+	report.framesPerSecond = report.seconds > 0.0 ? static_cast<double>(report.frameCount) / report.seconds : 0.0;
+	return report;
+}
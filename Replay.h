@@ -0,0 +1,158 @@
+#pragma once
+#include "Camera.h"
+#include "FixedTimestep.h"
+#include "Primitive.h"
+#include "Scene.h"
+#include "Simulation.h"
+#include <Vector3.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// 1フレームぶんの入力(キーとImGuiで変える値)
+/// WinMainのループはこれを作ってからUpdateInteractiveFrameに渡すので、記録したものを流せば同じ更新になる
+/// </summary>
+struct ReplayFrame {
+	double frameSeconds;// FrameTimer::Tickの値(固定刻みで回すステップ数はこれで決まる)
+	uint8_t keys[32];// GetHitKeyStateAllの256キーを1ビットずつ
+	Vector3 direction;// "Direction"スライダー
+	Vector3 segmentOrigin;// "segment.origine"スライダー
+	Vector3 cameraRotate;
+	Vector3 cameraTranslate;
+	bool paused;
+	bool reset;// このフレームの最初にシミュレーションを作り直す
+};
+
+/// <summary>
+/// GetHitKeyStateAllの結果(0か0以外)を256ビットに詰める
+/// </summary>
+void PackKeys(const char keys[256], uint8_t packed[32]);
+
+inline bool IsKeyDown(const ReplayFrame& frame, uint32_t key) { return (frame.keys[key >> 3] >> (key & 7)) & 1; }
+
+/// <summary>
+/// 記録ファイルの先頭に残す、シーンの作り方
+/// </summary>
+struct ReplaySettings {
+	uint32_t sphereCount;// MakeSimulationSceneの引数
+	uint32_t seed;
+	double stepSeconds;// 固定刻みの幅
+	float viewportWidth;// カメラのビューポートとアスペクト比
+	float viewportHeight;
+};
+
+/// <summary>
+/// WinMainとヘッドレスの再生で共有する、描画以外の状態
+/// (跳ねる球のシミュレーション、線分と平面のシーン、カメラ、線分×平面の判定結果)
+/// </summary>
+struct InteractiveState {
+	ReplaySettings settings;
+	SimulationState simulation;
+	FixedTimestep timestep;
+	Scene scene;
+	Scene::Handle segmentHandle;// スライダーで動かす線分
+	Segment segment;
+	Camera camera;
+	std::span<const uint8_t> segmentHits;// 平面j×線分iの判定(j * 線分の数 + i)。フレームアリーナの中なので次のResetまで有効
+	uint32_t stepsThisFrame;
+};
+
+/// <summary>
+/// 初期状態(WinMainの起動直後と同じ)を作る
+/// </summary>
+void InitializeInteractiveState(InteractiveState& state, const ReplaySettings& settings);
+
+/// <summary>
+/// 1フレーム進める(固定刻みのシミュレーション、カメラ、線分の更新、線分×平面の一括判定)
+/// 判定結果はフレームアリーナに置くので、先にGetFrameArena().Reset()しておくこと
+/// </summary>
+void UpdateInteractiveFrame(InteractiveState& state, const ReplayFrame& frame);
+
+/// <summary>
+/// 結果のハッシュを続ける(線分、判定結果、球の位置と速度のビット列)
+/// 毎フレーム呼ぶと、途中で一度ずれて元に戻った場合も違うハッシュになる
+/// </summary>
+uint64_t HashInteractiveFrame(uint64_t hash, const InteractiveState& state);
+
+// 形式が変わったら上げる(読み込みは同じ版だけを受け付ける)
+const uint32_t kReplayVersion = 1;
+
+/// <summary>
+/// フレームごとの入力をメモリにためて、終わったらファイルに書き出す
+/// 前のフレームから変わったものだけを書くので、何も触っていないフレームは9バイト
+/// </summary>
+class ReplayRecorder {
+public:
+	void Begin(const ReplaySettings& settings);
+
+	void Add(const ReplayFrame& frame);
+
+	size_t GetFrameCount() const { return frameCount_; }
+	size_t GetByteSize() const { return bytes_.size(); }
+
+	/// <returns>書き込めたらtrue</returns>
+	bool Write(const char* path) const;
+
+private:
+	ReplaySettings settings_ = {};
+	std::vector<uint8_t> bytes_;
+	ReplayFrame previous_ = {};
+	size_t frameCount_ = 0;
+};
+
+/// <summary>
+/// 記録ファイルを読み込んで、フレームを順に取り出す
+/// </summary>
+class ReplayReader {
+public:
+	/// <returns>読めて、形式と版が正しければtrue</returns>
+	bool Open(const char* path);
+
+	// バイト列から読む(Writeしたファイルの中身と同じもの)
+	bool OpenMemory(std::span<const uint8_t> bytes);
+
+	const ReplaySettings& GetSettings() const { return settings_; }
+	size_t GetFrameCount() const { return frameCount_; }
+
+	/// <summary>
+	/// 次のフレーム
+	/// </summary>
+	/// <returns>最後まで読んだか、途中で壊れていたらfalse</returns>
+	bool Next(ReplayFrame& frame);
+
+	// 最初のフレームに戻る
+	void Rewind();
+
+private:
+	std::vector<uint8_t> bytes_;
+	ReplaySettings settings_ = {};
+	size_t frameCount_ = 0;
+	size_t position_ = 0;
+	size_t frameIndex_ = 0;
+	ReplayFrame previous_ = {};
+};
+
+/// <summary>
+/// 再生の結果
+/// </summary>
+struct ReplayReport {
+	uint64_t frameCount;
+	uint64_t stepCount;// シミュレーションを進めた回数
+	double seconds;// 更新にかかった実時間の合計
+	double framesPerSecond;
+	double averageMs;
+	double p50Ms;
+	double p99Ms;
+	double maxMs;
+	uint64_t hash;// 全フレームのHashInteractiveFrameを続けたもの
+	std::vector<float> frameMs;// フレームごとの更新時間
+};
+
+/// <summary>
+/// 窓もフレーム待ちもなしに、記録した入力で最後まで更新を回す(性能と結果の回帰確認用)
+/// 時間はUpdateInteractiveFrameだけを測り、ハッシュの計算は含めない
+/// ESCが押されたフレームで止める(WinMainと同じ)
+/// </summary>
+ReplayReport RunReplay(ReplayReader& reader);
@@ -0,0 +1,233 @@
+#include "Scene.h"
+#include <assert.h>
+
+namespace {
+
+	// 種類ごとのフィールド数(Sphere: 中心xyzと半径, Segment: 始点xyzと終点xyz, Plane: 法線xyzと距離)
+	const uint32_t kColumnCounts[] = { 4, 6, 4 };
+
+	const uint32_t kNullSlot = 0xFFFFFFFFu;
+
+}
+
+Scene::Handle Scene::Add(const Sphere& sphere)
+{
+	const float values[] = { sphere.center.x, sphere.center.y, sphere.center.z, sphere.radius };
+	return Add(ShapeType::kSphere, values);
+}
+
+Scene::Handle Scene::Add(const Segment& segment)
+{
+	const float values[] = { segment.origin.x, segment.origin.y, segment.origin.z, segment.diff.x, segment.diff.y, segment.diff.z };
+	return Add(ShapeType::kSegment, values);
+}
+
+Scene::Handle Scene::Add(const Plane& plane)
+{
+	const float values[] = { plane.normal.x, plane.normal.y, plane.normal.z, plane.distance };
+	return Add(ShapeType::kPlane, values);
+}
+
+bool Scene::Remove(Handle handle)
+{
+	if (!IsValid(handle)) {
+		return false;
+	}
+
+	Storage& storage = storages_[static_cast<size_t>(handle.type)];
+	const uint32_t dense = storage.slotToDense[handle.slot];
+	const uint32_t last = static_cast<uint32_t>(storage.denseToSlot.size() - 1);
+
+	// 末尾の形状を空いた位置へ移して詰める
+	for (uint32_t column = 0; column < kColumnCounts[static_cast<size_t>(handle.type)]; ++column) {
+		storage.columns[column][dense] = storage.columns[column][last];
+		storage.columns[column].pop_back();
+	}
+	const uint32_t movedSlot = storage.denseToSlot[last];
+	storage.denseToSlot[dense] = movedSlot;
+	storage.slotToDense[movedSlot] = dense;
+	storage.denseToSlot.pop_back();
+
+	// スロットは世代を進めて空きリストへ
+	++storage.generations[handle.slot];
+	storage.slotToDense[handle.slot] = storage.freeSlot;
+	storage.freeSlot = handle.slot;
+	return true;
+}
+
+bool Scene::IsValid(Handle handle) const
+{
+	if (handle.type >= ShapeType::kCount) {
+		return false;
+	}
+	const Storage& storage = storages_[static_cast<size_t>(handle.type)];
+	return handle.slot < storage.generations.size() && storage.generations[handle.slot] == handle.generation;
+}
+
+bool Scene::Get(Handle handle, Sphere& sphere) const
+{
+	float values[4];
+	if (handle.type != ShapeType::kSphere || !Read(handle, values)) {
+		return false;
+	}
+	sphere = { { values[0], values[1], values[2] }, values[3] };
+	return true;
+}
+
+bool Scene::Get(Handle handle, Segment& segment) const
+{
+	float values[6];
+	if (handle.type != ShapeType::kSegment || !Read(handle, values)) {
+		return false;
+	}
+	segment = { { values[0], values[1], values[2] }, { values[3], values[4], values[5] } };
+	return true;
+}
+
+bool Scene::Get(Handle handle, Plane& plane) const
+{
+	float values[4];
+	if (handle.type != ShapeType::kPlane || !Read(handle, values)) {
+		return false;
+	}
+	plane = { { values[0], values[1], values[2] }, values[3] };
+	return true;
+}
+
+bool Scene::Set(Handle handle, const Sphere& sphere)
+{
+	const float values[] = { sphere.center.x, sphere.center.y, sphere.center.z, sphere.radius };
+	return handle.type == ShapeType::kSphere && Write(handle, values);
+}
+
+bool Scene::Set(Handle handle, const Segment& segment)
+{
+	const float values[] = { segment.origin.x, segment.origin.y, segment.origin.z, segment.diff.x, segment.diff.y, segment.diff.z };
+	return handle.type == ShapeType::kSegment && Write(handle, values);
+}
+
+bool Scene::Set(Handle handle, const Plane& plane)
+{
+	const float values[] = { plane.normal.x, plane.normal.y, plane.normal.z, plane.distance };
+	return handle.type == ShapeType::kPlane && Write(handle, values);
+}
+
+size_t Scene::GetIndex(Handle handle) const
+{
+	return IsValid(handle) ? storages_[static_cast<size_t>(handle.type)].slotToDense[handle.slot] : kInvalidIndex;
+}
+
+Scene::Handle Scene::GetHandle(ShapeType type, size_t index) const
+{
+	const Storage& storage = storages_[static_cast<size_t>(type)];
+	assert(index < storage.denseToSlot.size());
+	uint32_t slot = storage.denseToSlot[index];
+	return { type, slot, storage.generations[slot] };
+}
+
+SpheresSoA Scene::GetSpheres() const
+{
+	return { GetColumn(ShapeType::kSphere, 0), GetColumn(ShapeType::kSphere, 1), GetColumn(ShapeType::kSphere, 2), GetColumn(ShapeType::kSphere, 3) };
+}
+
+SegmentsSoA Scene::GetSegments() const
+{
+	return {
+		GetColumn(ShapeType::kSegment, 0), GetColumn(ShapeType::kSegment, 1), GetColumn(ShapeType::kSegment, 2),
+		GetColumn(ShapeType::kSegment, 3), GetColumn(ShapeType::kSegment, 4), GetColumn(ShapeType::kSegment, 5),
+	};
+}
+
+PlanesSoA Scene::GetPlanes() const
+{
+	return { GetColumn(ShapeType::kPlane, 0), GetColumn(ShapeType::kPlane, 1), GetColumn(ShapeType::kPlane, 2), GetColumn(ShapeType::kPlane, 3) };
+}
+
+SphereColumns Scene::GetSphereColumns()
+{
+	return { GetColumn(ShapeType::kSphere, 0), GetColumn(ShapeType::kSphere, 1), GetColumn(ShapeType::kSphere, 2), GetColumn(ShapeType::kSphere, 3) };
+}
+
+SegmentColumns Scene::GetSegmentColumns()
+{
+	return {
+		GetColumn(ShapeType::kSegment, 0), GetColumn(ShapeType::kSegment, 1), GetColumn(ShapeType::kSegment, 2),
+		GetColumn(ShapeType::kSegment, 3), GetColumn(ShapeType::kSegment, 4), GetColumn(ShapeType::kSegment, 5),
+	};
+}
+
+PlaneColumns Scene::GetPlaneColumns()
+{
+	return { GetColumn(ShapeType::kPlane, 0), GetColumn(ShapeType::kPlane, 1), GetColumn(ShapeType::kPlane, 2), GetColumn(ShapeType::kPlane, 3) };
+}
+
+void Scene::Reserve(ShapeType type, size_t count)
+{
+	Storage& storage = storages_[static_cast<size_t>(type)];
+	for (uint32_t column = 0; column < kColumnCounts[static_cast<size_t>(type)]; ++column) {
+		storage.columns[column].reserve(count);
+	}
+	storage.denseToSlot.reserve(count);
+	storage.slotToDense.reserve(count);
+	storage.generations.reserve(count);
+}
+
+void Scene::Clear()
+{
+	for (uint32_t type = 0; type < static_cast<uint32_t>(ShapeType::kCount); ++type) {
+		Storage& storage = storages_[type];
+		while (!storage.denseToSlot.empty()) {
+			uint32_t slot = storage.denseToSlot.back();
+			Remove({ static_cast<ShapeType>(type), slot, storage.generations[slot] });
+		}
+	}
+}
+
+Scene::Handle Scene::Add(ShapeType type, const float* values)
+{
+	Storage& storage = storages_[static_cast<size_t>(type)];
+	const uint32_t dense = static_cast<uint32_t>(storage.denseToSlot.size());
+
+	// 空きスロットがあれば使い回す(世代は削除のときに進めてある)
+	uint32_t slot = storage.freeSlot;
+	if (slot != kNullSlot) {
+		storage.freeSlot = storage.slotToDense[slot];
+		storage.slotToDense[slot] = dense;
+	} else {
+		slot = static_cast<uint32_t>(storage.generations.size());
+		storage.slotToDense.push_back(dense);
+		storage.generations.push_back(1);
+	}
+
+	for (uint32_t column = 0; column < kColumnCounts[static_cast<size_t>(type)]; ++column) {
+		storage.columns[column].push_back(values[column]);
+	}
+	storage.denseToSlot.push_back(slot);
+	return { type, slot, storage.generations[slot] };
+}
+
+bool Scene::Read(Handle handle, float* values) const
+{
+	if (!IsValid(handle)) {
+		return false;
+	}
+	const Storage& storage = storages_[static_cast<size_t>(handle.type)];
+	const uint32_t dense = storage.slotToDense[handle.slot];
+	for (uint32_t column = 0; column < kColumnCounts[static_cast<size_t>(handle.type)]; ++column) {
+		values[column] = storage.columns[column][dense];
+	}
+	return true;
+}
+
+bool Scene::Write(Handle handle, const float* values)
+{
+	if (!IsValid(handle)) {
+		return false;
+	}
+	Storage& storage = storages_[static_cast<size_t>(handle.type)];
+	const uint32_t dense = storage.slotToDense[handle.slot];
+	for (uint32_t column = 0; column < kColumnCounts[static_cast<size_t>(handle.type)]; ++column) {
+		storage.columns[column][dense] = values[column];
+	}
+	return true;
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include "CollisionBatch.h"
+#include "Primitive.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// 書き換えられるSoA形式の球列(Scene::GetSphereColumns)
+/// </summary>
+struct SphereColumns {
+	std::span<float> centerX;
+	std::span<float> centerY;
+	std::span<float> centerZ;
+	std::span<float> radius;
+
+	operator SpheresSoA() const { return { centerX, centerY, centerZ, radius }; }
+};
+
+/// <summary>
+/// 書き換えられるSoA形式の線分列(Scene::GetSegmentColumns)
+/// </summary>
+struct SegmentColumns {
+	std::span<float> originX;
+	std::span<float> originY;
+	std::span<float> originZ;
+	std::span<float> endX;
+	std::span<float> endY;
+	std::span<float> endZ;
+
+	operator SegmentsSoA() const { return { originX, originY, originZ, endX, endY, endZ }; }
+};
+
+/// <summary>
+/// 書き換えられるSoA形式の平面列(Scene::GetPlaneColumns)
+/// </summary>
+struct PlaneColumns {
+	std::span<float> normalX;
+	std::span<float> normalY;
+	std::span<float> normalZ;
+	std::span<float> distance;
+
+	operator PlanesSoA() const { return { normalX, normalY, normalZ, distance }; }
+};
+
+/// <summary>
+/// Sphere/Segment/Planeを種類ごとにSoAの配列で持つシーン
+/// 配列は隙間なく詰めたまま(削除は末尾の要素を穴へ移すswap-and-pop)なので、
+/// GetSpheres/GetSegments/GetPlanesをそのままIsCollisionBatchやTransformToScreenへ渡せる
+/// 形状はハンドルで指す。ハンドルは配列の並びが変わっても同じ形状を指し、削除された形状のハンドルは世代で弾く
+/// </summary>
+class Scene {
+public:
+	enum class ShapeType : uint8_t {
+		kSphere,
+		kSegment,
+		kPlane,
+		kCount,
+	};
+
+	/// <summary>
+	/// 形状を指すハンドル(スロット番号と世代)
+	/// 削除するとスロットの世代が進むので、古いハンドルはIsValidでfalseになる
+	/// </summary>
+	struct Handle {
+		ShapeType type = ShapeType::kSphere;
+		uint32_t slot = 0xFFFFFFFFu;
+		uint32_t generation = 0;
+
+		bool operator==(const Handle& other) const { return type == other.type && slot == other.slot && generation == other.generation; }
+		bool operator!=(const Handle& other) const { return !(*this == other); }
+	};
+
+	// 形状を追加する(O(1)、配列が足りなければ伸ばす)
+	Handle Add(const Sphere& sphere);
+	Handle Add(const Segment& segment);
+	Handle Add(const Plane& plane);
+
+	/// <summary>
+	/// 形状を削除する(O(1))
+	/// 末尾の形状が空いた位置へ移るので、配列の添え字は変わる(ハンドルは変わらない)
+	/// </summary>
+	/// <returns>有効なハンドルだったらtrue</returns>
+	bool Remove(Handle handle);
+
+	bool IsValid(Handle handle) const;
+
+	// 形状を読み書きする(無効なハンドルならfalseで何もしない)
+	bool Get(Handle handle, Sphere& sphere) const;
+	bool Get(Handle handle, Segment& segment) const;
+	bool Get(Handle handle, Plane& plane) const;
+	bool Set(Handle handle, const Sphere& sphere);
+	bool Set(Handle handle, const Segment& segment);
+	bool Set(Handle handle, const Plane& plane);
+
+	// 配列の中の位置(一括処理の結果からハンドルへ戻すとき用、無効なハンドルならkInvalidIndex)
+	static const size_t kInvalidIndex = static_cast<size_t>(-1);
+	size_t GetIndex(Handle handle) const;
+	Handle GetHandle(ShapeType type, size_t index) const;
+
+	size_t GetCount(ShapeType type) const { return storages_[static_cast<size_t>(type)].denseToSlot.size(); }
+
+	// 一括処理へ渡す列(追加・削除するまで有効)
+	SpheresSoA GetSpheres() const;
+	SegmentsSoA GetSegments() const;
+	PlanesSoA GetPlanes() const;
+	SphereColumns GetSphereColumns();
+	SegmentColumns GetSegmentColumns();
+	PlaneColumns GetPlaneColumns();
+
+	// 追加で配列を伸ばさないように確保しておく
+	void Reserve(ShapeType type, size_t count);
+
+	// すべての形状を削除する(以前のハンドルはすべて無効になる)
+	void Clear();
+
+private:
+	// 1つの種類の形状(フィールドごとの列と、スロット⇔配列の位置の対応)
+	struct Storage {
+		std::vector<float> columns[6];// 使うのは種類ごとのフィールド数まで
+
+		std::vector<uint32_t> denseToSlot;// 配列の位置 → スロット
+		std::vector<uint32_t> slotToDense;// スロット → 配列の位置(空きスロットは次の空きスロット)
+		std::vector<uint32_t> generations;// スロットの世代
+		uint32_t freeSlot = 0xFFFFFFFFu;
+	};
+
+	Handle Add(ShapeType type, const float* values);
+	bool Read(Handle handle, float* values) const;
+	bool Write(Handle handle, const float* values);
+	std::span<float> GetColumn(ShapeType type, uint32_t column) { return storages_[static_cast<size_t>(type)].columns[column]; }
+	std::span<const float> GetColumn(ShapeType type, uint32_t column) const { return storages_[static_cast<size_t>(type)].columns[column]; }
+
+	Storage storages_[static_cast<size_t>(ShapeType::kCount)] = {};
+};
@@ -0,0 +1,238 @@
+#include "SceneSnapshot.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+	const char kMagic[4] = { 'M', 'T', '3', 'S' };
+
+	// 列はキャッシュラインにそろえる(SIMDでそのまま読めるように)
+	const uint64_t kColumnAlignment = 64;
+
+	// 種類ごとの最初の列と列の数
+	const uint32_t kFirstColumns[] = { 0, 4, 10 };
+	const uint32_t kColumnCounts[] = { 4, 6, 4 };
+	const uint32_t kTotalColumnCount = 14;
+
+	uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// 球・線分・平面の列をkTotalColumnCount本に並べる
+	void GatherColumns(const Scene& scene, std::span<const float> columns[kTotalColumnCount]) {
+		SpheresSoA spheres = scene.GetSpheres();
+		SegmentsSoA segments = scene.GetSegments();
+		PlanesSoA planes = scene.GetPlanes();
+		const std::span<const float> all[kTotalColumnCount] = {
+			spheres.centerX, spheres.centerY, spheres.centerZ, spheres.radius,
+			segments.originX, segments.originY, segments.originZ, segments.endX, segments.endY, segments.endZ,
+			planes.normalX, planes.normalY, planes.normalZ, planes.distance,
+		};
+		for (uint32_t column = 0; column < kTotalColumnCount; ++column) {
+			columns[column] = all[column];
+		}
+	}
+
+}
+
+bool WriteSceneSnapshot(const char* path, const Scene& scene, const SceneCamera& camera)
+{
+	std::span<const float> columns[kTotalColumnCount];
+	GatherColumns(scene, columns);
+
+	SceneSnapshotHeader header = {};
+	std::memcpy(header.magic, kMagic, sizeof(kMagic));
+	header.version = kSceneSnapshotVersion;
+	header.headerSize = sizeof(SceneSnapshotHeader);
+	header.camera = camera;
+	for (uint32_t type = 0; type < static_cast<uint32_t>(Scene::ShapeType::kCount); ++type) {
+		header.counts[type] = static_cast<uint32_t>(scene.GetCount(static_cast<Scene::ShapeType>(type)));
+	}
+	uint64_t offset = AlignUp(sizeof(SceneSnapshotHeader), kColumnAlignment);
+	for (uint32_t column = 0; column < kTotalColumnCount; ++column) {
+		header.columnOffsets[column] = offset;
+		offset = AlignUp(offset + columns[column].size_bytes(), kColumnAlignment);
+	}
+
+	FILE* file = std::fopen(path, "wb");
+	if (!file) {
+		return false;
+	}
+
+	// 列の間の詰め物は0で埋める
+	static const char kZeros[kColumnAlignment] = {};
+	bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+	uint64_t position = sizeof(header);
+	for (uint32_t column = 0; written && column < kTotalColumnCount; ++column) {
+		uint64_t padding = header.columnOffsets[column] - position;
+		written = std::fwrite(kZeros, 1, static_cast<size_t>(padding), file) == padding;
+		written = written && std::fwrite(columns[column].data(), 1, columns[column].size_bytes(), file) == columns[column].size_bytes();
+		position = header.columnOffsets[column] + columns[column].size_bytes();
+	}
+	return std::fclose(file) == 0 && written;
+}
+
+bool SceneSnapshot::Open(const char* path)
+{
+	Close();
+
+	const void* data = nullptr;
+	size_t size = 0;
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	HANDLE mapping = nullptr;
+	if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	}
+	CloseHandle(file);
+	if (!mapping) {
+		return false;
+	}
+	data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data) {
+		CloseHandle(mapping);
+		return false;
+	}
+	mapping_ = mapping;
+	size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int file = ::open(path, O_RDONLY);
+	if (file < 0) {
+		return false;
+	}
+	struct stat status;
+	void* mapped = MAP_FAILED;
+	if (fstat(file, &status) == 0 && status.st_size > 0) {
+		size = static_cast<size_t>(status.st_size);
+		mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+	}
+	::close(file);
+	if (mapped == MAP_FAILED) {
+		return false;
+	}
+	data = mapped;
+#endif
+	header_ = static_cast<const SceneSnapshotHeader*>(data);
+	size_ = size;
+
+	// 形式と版、列がファイルに収まっているかだけを確かめる(中身は読まない)
+	bool valid = size >= sizeof(SceneSnapshotHeader) && std::memcmp(header_->magic, kMagic, sizeof(kMagic)) == 0 &&
+		header_->version == kSceneSnapshotVersion && header_->headerSize == sizeof(SceneSnapshotHeader);
+	for (uint32_t type = 0; valid && type < static_cast<uint32_t>(Scene::ShapeType::kCount); ++type) {
+		uint64_t bytes = static_cast<uint64_t>(header_->counts[type]) * sizeof(float);
+		for (uint32_t column = kFirstColumns[type]; valid && column < kFirstColumns[type] + kColumnCounts[type]; ++column) {
+			uint64_t offset = header_->columnOffsets[column];
+			valid = offset % alignof(float) == 0 && offset >= sizeof(SceneSnapshotHeader) && offset <= size && bytes <= size - offset;
+		}
+	}
+	if (!valid) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void SceneSnapshot::Close()
+{
+	if (!header_) {
+		return;
+	}
+#if defined(_WIN32)
+	UnmapViewOfFile(header_);
+	CloseHandle(static_cast<HANDLE>(mapping_));
+#else
+	munmap(const_cast<SceneSnapshotHeader*>(header_), size_);
+#endif
+	header_ = nullptr;
+	size_ = 0;
+	mapping_ = nullptr;
+}
+
+SpheresSoA SceneSnapshot::GetSpheres() const
+{
+	const Scene::ShapeType type = Scene::ShapeType::kSphere;
+	return { GetColumn(0, type), GetColumn(1, type), GetColumn(2, type), GetColumn(3, type) };
+}
+
+SegmentsSoA SceneSnapshot::GetSegments() const
+{
+	const Scene::ShapeType type = Scene::ShapeType::kSegment;
+	return { GetColumn(0, type), GetColumn(1, type), GetColumn(2, type), GetColumn(3, type), GetColumn(4, type), GetColumn(5, type) };
+}
+
+PlanesSoA SceneSnapshot::GetPlanes() const
+{
+	const Scene::ShapeType type = Scene::ShapeType::kPlane;
+	return { GetColumn(0, type), GetColumn(1, type), GetColumn(2, type), GetColumn(3, type) };
+}
+
+void SceneSnapshot::CopyTo(Scene& scene) const
+{
+	SpheresSoA spheres = GetSpheres();
+	SegmentsSoA segments = GetSegments();
+	PlanesSoA planes = GetPlanes();
+	scene.Reserve(Scene::ShapeType::kSphere, scene.GetCount(Scene::ShapeType::kSphere) + spheres.radius.size());
+	scene.Reserve(Scene::ShapeType::kSegment, scene.GetCount(Scene::ShapeType::kSegment) + segments.originX.size());
+	scene.Reserve(Scene::ShapeType::kPlane, scene.GetCount(Scene::ShapeType::kPlane) + planes.distance.size());
+	for (size_t i = 0; i < spheres.radius.size(); ++i) {
+		scene.Add(Sphere{ { spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i] }, spheres.radius[i] });
+	}
+	for (size_t i = 0; i < segments.originX.size(); ++i) {
+		scene.Add(Segment{ { segments.originX[i], segments.originY[i], segments.originZ[i] }, { segments.endX[i], segments.endY[i], segments.endZ[i] } });
+	}
+	for (size_t i = 0; i < planes.distance.size(); ++i) {
+		scene.Add(Plane{ { planes.normalX[i], planes.normalY[i], planes.normalZ[i] }, planes.distance[i] });
+	}
+}
+
+bool SceneSnapshot::WriteText(const char* path) const
+{
+	if (!header_) {
+		return false;
+	}
+	FILE* file = std::fopen(path, "wb");
+	if (!file) {
+		return false;
+	}
+
+	// 1行に1つの形状を書く(差分ツールで形状ごとの違いが見えるように)
+	const SceneCamera& camera = header_->camera;
+	std::fprintf(file, "mt3scene %u\n", header_->version);
+	std::fprintf(file, "camera rotate %.9g %.9g %.9g translate %.9g %.9g %.9g\n",
+		camera.rotate.x, camera.rotate.y, camera.rotate.z, camera.translate.x, camera.translate.y, camera.translate.z);
+
+	const char* names[] = { "spheres", "segments", "planes" };
+	for (uint32_t type = 0; type < static_cast<uint32_t>(Scene::ShapeType::kCount); ++type) {
+		const uint32_t count = header_->counts[type];
+		std::fprintf(file, "%s %u\n", names[type], count);
+		for (uint32_t i = 0; i < count; ++i) {
+			for (uint32_t column = 0; column < kColumnCounts[type]; ++column) {
+				std::fprintf(file, column == 0 ? "%.9g" : " %.9g", GetColumn(column, static_cast<Scene::ShapeType>(type))[i]);
+			}
+			std::fputc('\n', file);
+		}
+	}
+	return std::fclose(file) == 0;
+}
+
+std::span<const float> SceneSnapshot::GetColumn(uint32_t column, Scene::ShapeType type) const
+{
+	const size_t index = static_cast<size_t>(type);
+	const char* base = reinterpret_cast<const char*>(header_);
+	return { reinterpret_cast<const float*>(base + header_->columnOffsets[kFirstColumns[index] + column]), header_->counts[index] };
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "CollisionBatch.h"
+#include "Scene.h"
+#include <Vector3.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/// <summary>
+/// スナップショットに残すカメラの状態(main.cppのcameraRotate/cameraTranslate)
+/// </summary>
+struct SceneCamera {
+	Vector3 rotate;
+	Vector3 translate;
+};
+
+// 形式が変わったら上げる(読み込みは同じ版だけを受け付ける)
+const uint32_t kSceneSnapshotVersion = 1;
+
+/// <summary>
+/// バイナリのシーンファイルの先頭
+/// 後ろにSceneの列(球: 中心xyz・半径, 線分: 始点xyz・終点xyz, 平面: 法線xyz・距離)を
+/// 列ごとに64バイト境界へそろえてそのまま並べる。数値はリトルエンディアンのfloat
+/// </summary>
+struct SceneSnapshotHeader {
+	char magic[4];// "MT3S"
+	uint32_t version;
+	uint32_t headerSize;// sizeof(SceneSnapshotHeader)
+	uint32_t reserved;
+	SceneCamera camera;
+	uint32_t counts[static_cast<size_t>(Scene::ShapeType::kCount)];// 種類ごとの数
+	uint32_t reserved2;
+	uint64_t columnOffsets[14];// ファイル先頭からの各列の位置(球4列, 線分6列, 平面4列の順)
+};
+static_assert(sizeof(SceneSnapshotHeader) == 168, "SceneSnapshotHeader is part of the file format");
+
+/// <summary>
+/// シーンとカメラをバイナリで書き出す
+/// </summary>
+/// <returns>書き込めたらtrue</returns>
+bool WriteSceneSnapshot(const char* path, const Scene& scene, const SceneCamera& camera);
+
+/// <summary>
+/// バイナリのシーンファイルを読み取り専用でメモリに割り当てて、列をそのまま見せる
+/// (Linuxではmmap、WindowsではMapViewOfFile。読み込みのときに解析もコピーもしない)
+/// Getで返す列はCloseするまで有効。開いている間は同じファイルへ書き出さないこと
+/// </summary>
+class SceneSnapshot {
+public:
+	SceneSnapshot() = default;
+	~SceneSnapshot() { Close(); }
+
+	SceneSnapshot(const SceneSnapshot&) = delete;
+	SceneSnapshot& operator=(const SceneSnapshot&) = delete;
+
+	/// <summary>
+	/// ファイルを開いて先頭と列の位置を確かめる
+	/// </summary>
+	/// <returns>開けて、形式と版が正しければtrue</returns>
+	bool Open(const char* path);
+
+	void Close();
+
+	bool IsOpen() const { return header_ != nullptr; }
+
+	const SceneCamera& GetCamera() const { return header_->camera; }
+	size_t GetCount(Scene::ShapeType type) const { return header_->counts[static_cast<size_t>(type)]; }
+
+	SpheresSoA GetSpheres() const;
+	SegmentsSoA GetSegments() const;
+	PlanesSoA GetPlanes() const;
+
+	// 形状をSceneへコピーする(編集するとき用。sceneは先に空にしておく)
+	void CopyTo(Scene& scene) const;
+
+	/// <summary>
+	/// 差分を見るためのテキスト形式で書き出す(floatは%.9gで元の値に戻せる桁数)
+	/// </summary>
+	/// <returns>書き込めたらtrue</returns>
+	bool WriteText(const char* path) const;
+
+private:
+	std::span<const float> GetColumn(uint32_t column, Scene::ShapeType type) const;
+
+	const SceneSnapshotHeader* header_ = nullptr;
+	size_t size_ = 0;
+	void* mapping_ = nullptr;// WindowsのファイルマッピングのHANDLE
+};
@@ -0,0 +1,161 @@
+#pragma once
+#include "MathFunctionSimd.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(MT3_SIMD_SSE)
+#include <immintrin.h>
+#endif
+
+/// <summary>
+/// バッチ処理のカーネルを1つの書き方で書くための薄いラッパー
+/// ScalarFloatは1要素(端数処理用)、VectorFloatは使える最大幅(AVX:8, SSE:4)
+/// カーネルをテンプレートにしてどちらでも実体化できるよう、同じ関数を揃えてある
+/// </summary>
+struct ScalarMask {
+	bool value;
+
+	ScalarMask operator&(ScalarMask other) const { return { value && other.value }; }
+	ScalarMask operator|(ScalarMask other) const { return { value || other.value }; }
+	ScalarMask AndNot(ScalarMask other) const { return { value && !other.value }; }
+
+	// 下位ビットから各レーンの真偽を並べたもの
+	uint32_t Bits() const { return value ? 1u : 0u; }
+	bool Any() const { return value; }
+};
+
+struct ScalarFloat {
+	typedef ScalarMask Mask;
+	static const size_t kWidth = 1;
+
+	float value;
+
+	static ScalarFloat Load(const float* p) { return { *p }; }
+	static ScalarFloat Broadcast(float f) { return { f }; }
+	void Store(float* p) const { *p = value; }
+
+	ScalarFloat operator+(ScalarFloat other) const { return { value + other.value }; }
+	ScalarFloat operator-(ScalarFloat other) const { return { value - other.value }; }
+	ScalarFloat operator*(ScalarFloat other) const { return { value * other.value }; }
+	ScalarFloat operator/(ScalarFloat other) const { return { value / other.value }; }
+
+	Mask operator<(ScalarFloat other) const { return { value < other.value }; }
+	Mask operator<=(ScalarFloat other) const { return { value <= other.value }; }
+	Mask operator>(ScalarFloat other) const { return { value > other.value }; }
+	Mask operator>=(ScalarFloat other) const { return { value >= other.value }; }
+	Mask operator==(ScalarFloat other) const { return { value == other.value }; }
+	Mask operator!=(ScalarFloat other) const { return { value != other.value }; }
+
+	static ScalarFloat Min(ScalarFloat a, ScalarFloat b) { return { a.value < b.value ? a.value : b.value }; }
+	static ScalarFloat Max(ScalarFloat a, ScalarFloat b) { return { a.value > b.value ? a.value : b.value }; }
+	static ScalarFloat Sqrt(ScalarFloat a) { return { std::sqrt(a.value) }; }
+	// maskが真のレーンはa、偽のレーンはb
+	static ScalarFloat Select(Mask mask, ScalarFloat a, ScalarFloat b) { return { mask.value ? a.value : b.value }; }
+};
+
+#if defined(MT3_SIMD_AVX)
+
+struct VectorMask {
+	__m256 value;
+
+	VectorMask operator&(VectorMask other) const { return { _mm256_and_ps(value, other.value) }; }
+	VectorMask operator|(VectorMask other) const { return { _mm256_or_ps(value, other.value) }; }
+	VectorMask AndNot(VectorMask other) const { return { _mm256_andnot_ps(other.value, value) }; }
+
+	uint32_t Bits() const { return static_cast<uint32_t>(_mm256_movemask_ps(value)); }
+	bool Any() const { return _mm256_movemask_ps(value) != 0; }
+};
+
+struct VectorFloat {
+	typedef VectorMask Mask;
+	static const size_t kWidth = 8;
+
+	__m256 value;
+
+	static VectorFloat Load(const float* p) { return { _mm256_loadu_ps(p) }; }
+	static VectorFloat Broadcast(float f) { return { _mm256_set1_ps(f) }; }
+	void Store(float* p) const { _mm256_storeu_ps(p, value); }
+
+	VectorFloat operator+(VectorFloat other) const { return { _mm256_add_ps(value, other.value) }; }
+	VectorFloat operator-(VectorFloat other) const { return { _mm256_sub_ps(value, other.value) }; }
+	VectorFloat operator*(VectorFloat other) const { return { _mm256_mul_ps(value, other.value) }; }
+	VectorFloat operator/(VectorFloat other) const { return { _mm256_div_ps(value, other.value) }; }
+
+	Mask operator<(VectorFloat other) const { return { _mm256_cmp_ps(value, other.value, _CMP_LT_OQ) }; }
+	Mask operator<=(VectorFloat other) const { return { _mm256_cmp_ps(value, other.value, _CMP_LE_OQ) }; }
+	Mask operator>(VectorFloat other) const { return { _mm256_cmp_ps(value, other.value, _CMP_GT_OQ) }; }
+	Mask operator>=(VectorFloat other) const { return { _mm256_cmp_ps(value, other.value, _CMP_GE_OQ) }; }
+	Mask operator==(VectorFloat other) const { return { _mm256_cmp_ps(value, other.value, _CMP_EQ_OQ) }; }
+	Mask operator!=(VectorFloat other) const { return { _mm256_cmp_ps(value, other.value, _CMP_NEQ_UQ) }; }
+
+	static VectorFloat Min(VectorFloat a, VectorFloat b) { return { _mm256_min_ps(a.value, b.value) }; }
+	static VectorFloat Max(VectorFloat a, VectorFloat b) { return { _mm256_max_ps(a.value, b.value) }; }
+	static VectorFloat Sqrt(VectorFloat a) { return { _mm256_sqrt_ps(a.value) }; }
+	static VectorFloat Select(Mask mask, VectorFloat a, VectorFloat b) { return { _mm256_blendv_ps(b.value, a.value, mask.value) }; }
+};
+
+#elif defined(MT3_SIMD_SSE)
+
+struct VectorMask {
+	__m128 value;
+
+	VectorMask operator&(VectorMask other) const { return { _mm_and_ps(value, other.value) }; }
+	VectorMask operator|(VectorMask other) const { return { _mm_or_ps(value, other.value) }; }
+	VectorMask AndNot(VectorMask other) const { return { _mm_andnot_ps(other.value, value) }; }
+
+	uint32_t Bits() const { return static_cast<uint32_t>(_mm_movemask_ps(value)); }
+	bool Any() const { return _mm_movemask_ps(value) != 0; }
+};
+
+struct VectorFloat {
+	typedef VectorMask Mask;
+	static const size_t kWidth = 4;
+
+	__m128 value;
+
+	static VectorFloat Load(const float* p) { return { _mm_loadu_ps(p) }; }
+	static VectorFloat Broadcast(float f) { return { _mm_set1_ps(f) }; }
+	void Store(float* p) const { _mm_storeu_ps(p, value); }
+
+	VectorFloat operator+(VectorFloat other) const { return { _mm_add_ps(value, other.value) }; }
+	VectorFloat operator-(VectorFloat other) const { return { _mm_sub_ps(value, other.value) }; }
+	VectorFloat operator*(VectorFloat other) const { return { _mm_mul_ps(value, other.value) }; }
+	VectorFloat operator/(VectorFloat other) const { return { _mm_div_ps(value, other.value) }; }
+
+	Mask operator<(VectorFloat other) const { return { _mm_cmplt_ps(value, other.value) }; }
+	Mask operator<=(VectorFloat other) const { return { _mm_cmple_ps(value, other.value) }; }
+	Mask operator>(VectorFloat other) const { return { _mm_cmpgt_ps(value, other.value) }; }
+	Mask operator>=(VectorFloat other) const { return { _mm_cmpge_ps(value, other.value) }; }
+	Mask operator==(VectorFloat other) const { return { _mm_cmpeq_ps(value, other.value) }; }
+	Mask operator!=(VectorFloat other) const { return { _mm_cmpneq_ps(value, other.value) }; }
+
+	static VectorFloat Min(VectorFloat a, VectorFloat b) { return { _mm_min_ps(a.value, b.value) }; }
+	static VectorFloat Max(VectorFloat a, VectorFloat b) { return { _mm_max_ps(a.value, b.value) }; }
+	static VectorFloat Sqrt(VectorFloat a) { return { _mm_sqrt_ps(a.value) }; }
+	static VectorFloat Select(Mask mask, VectorFloat a, VectorFloat b) {
+		return { _mm_or_ps(_mm_and_ps(mask.value, a.value), _mm_andnot_ps(mask.value, b.value)) };
+	}
+};
+
+#else
+
+typedef ScalarMask VectorMask;
+typedef ScalarFloat VectorFloat;
+
+#endif
+
+/// <summary>
+/// マスクの各レーンを0/1のバイトで書き出す
+/// </summary>
+template<typename Mask>
+inline uint32_t StoreMaskBytes(Mask mask, size_t width, uint8_t* out) {
+	uint32_t bits = mask.Bits();
+	uint32_t count = 0;
+	for (size_t lane = 0; lane < width; ++lane) {
+		uint8_t bit = static_cast<uint8_t>((bits >> lane) & 1u);
+		out[lane] = bit;
+		count += bit;
+	}
+	return count;
+}
@@ -0,0 +1,160 @@
+#include "Simulation.h"
+#include "ContinuousCollision.h"
+#include "FrameArena.h"
+#include "MathFunction.h"
+#include "Profiler.h"
+#include <chrono>
+#include <cstring>
+#include <random>
+
+namespace {
+
+	// 箱の大きさ(x, zは±kBoxHalfWidth、yは0からkBoxHeight)
+	const float kBoxHalfWidth = 5.0f;
+	const float kBoxHeight = 10.0f;
+
+	// 1ステップで跳ね返りを解く回数の上限(角に挟まれたときに止まるように)
+	const int kMaxBounces = 4;
+
+	uint64_t HashBits(uint64_t hash, float value) {
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		for (int byte = 0; byte < 4; ++byte) {
+			hash ^= (bits >> (byte * 8)) & 0xFFu;
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+}
+
+SimulationState MakeSimulationScene(uint32_t sphereCount, uint32_t seed)
+{
+	SimulationState state;
+	state.gravity = { 0.0f, -9.8f, 0.0f };
+	state.restitution = 0.8f;
+	state.stepCount = 0;
+	state.planes = {
+		{ { 0.0f, 1.0f, 0.0f }, 0.0f },
+		{ { 0.0f, -1.0f, 0.0f }, -kBoxHeight },
+		{ { 1.0f, 0.0f, 0.0f }, -kBoxHalfWidth },
+		{ { -1.0f, 0.0f, 0.0f }, -kBoxHalfWidth },
+		{ { 0.0f, 0.0f, 1.0f }, -kBoxHalfWidth },
+		{ { 0.0f, 0.0f, -1.0f }, -kBoxHalfWidth },
+	};
+
+	std::mt19937 engine(seed);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	auto random = [&](float min, float max) { return min + (max - min) * unit(engine); };
+
+	state.current.resize(sphereCount);
+	state.velocities.resize(sphereCount);
+	for (uint32_t i = 0; i < sphereCount; ++i) {
+		float radius = random(0.1f, 0.3f);
+		float extent = kBoxHalfWidth - radius;
+		state.current[i] = { { random(-extent, extent), random(radius, kBoxHeight - radius), random(-extent, extent) }, radius };
+		// 1ステップで半径より大きく動く速さも混ぜる
+		state.velocities[i] = { random(-20.0f, 20.0f), random(-20.0f, 20.0f), random(-20.0f, 20.0f) };
+	}
+	state.previous = state.current;
+	return state;
+}
+
+void StepSimulation(SimulationState& state, float stepSeconds)
+{
+	PROFILE_SCOPE("StepSimulation");
+	const size_t sphereCount = state.current.size();
+	const Vector3 gravityStep = Multiply(stepSeconds, state.gravity);
+
+	for (size_t i = 0; i < sphereCount; ++i) {
+		state.previous[i] = state.current[i];
+
+		Sphere sphere = state.current[i];
+		Vector3 velocity = Add(state.velocities[i], gravityStep);
+
+		// 最初に当たる平面まで進めて跳ね返し、残りの時間でもう一度進める
+		float remaining = stepSeconds;
+		for (int bounce = 0; bounce < kMaxBounces && remaining > 0.0f; ++bounce) {
+			Vector3 displacement = Multiply(remaining, velocity);
+
+			float earliest = 1.0f;
+			const Plane* hitPlane = nullptr;
+			for (const Plane& plane : state.planes) {
+				// 離れていく平面は見ない(接したまま跳ね返った直後にもう一度当たらないように)
+				if (Dot(displacement, plane.normal) >= 0.0f) {
+					continue;
+				}
+				float timeOfImpact;
+				if (ComputeTimeOfImpact(sphere, displacement, plane, timeOfImpact) && timeOfImpact < earliest) {
+					earliest = timeOfImpact;
+					hitPlane = &plane;
+				}
+			}
+
+			sphere.center = Add(sphere.center, Multiply(earliest, displacement));
+			if (!hitPlane) {
+				break;
+			}
+
+			// 法線方向の速度だけを反転して弱める
+			float normalSpeed = Dot(velocity, hitPlane->normal);
+			velocity = Subtract(velocity, Multiply((1.0f + state.restitution) * normalSpeed, hitPlane->normal));
+			remaining *= 1.0f - earliest;
+		}
+
+		state.current[i] = sphere;
+		state.velocities[i] = velocity;
+	}
+
+	++state.stepCount;
+}
+
+Sphere GetInterpolatedSphere(const SimulationState& state, size_t index, float alpha)
+{
+	const Sphere& previous = state.previous[index];
+	const Sphere& current = state.current[index];
+	return { Add(previous.center, Multiply(alpha, Subtract(current.center, previous.center))), current.radius };
+}
+
+uint64_t HashSimulation(const SimulationState& state)
+{
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < state.current.size(); ++i) {
+		const Sphere& sphere = state.current[i];
+		const Vector3& velocity = state.velocities[i];
+		hash = HashBits(hash, sphere.center.x);
+		hash = HashBits(hash, sphere.center.y);
+		hash = HashBits(hash, sphere.center.z);
+		hash = HashBits(hash, velocity.x);
+		hash = HashBits(hash, velocity.y);
+		hash = HashBits(hash, velocity.z);
+	}
+	return hash;
+}
+
+HeadlessReport RunHeadless(SimulationState& state, float stepSeconds, uint64_t stepCount)
+{
+	FrameTimer stepTimer;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::time_point last = start;
+	for (uint64_t step = 0; step < stepCount; ++step) {
+		// 1ステップを1フレームとしてプロファイラに記録する
+		Profiler::Get().BeginFrame();
+		GetFrameArena().Reset();
+		StepSimulation(state, stepSeconds);
+		Profiler::Get().EndFrame();
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		stepTimer.AddSample(std::chrono::duration<double>(now - last).count());
+		last = now;
+	}
+
+	HeadlessReport report;
+	report.stepCount = stepCount;
+	report.seconds = std::chrono::duration<double>(last - start).count();
+	report.stepsPerSecond = report.seconds > 0.0 ? static_cast<double>(stepCount) / report.seconds : 0.0;
+	report.stepStats = stepTimer.GetStats();
+	report.hash = HashSimulation(state);
+	return report;
+}
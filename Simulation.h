@@ -0,0 +1,64 @@
+#pragma once
+#include "FixedTimestep.h"
+#include "Primitive.h"
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 固定刻みで動かすシーン(重力で落ちて平面の箱の中で跳ねる球)
+/// previousは直前のステップ開始時の球で、描画はpreviousとcurrentを補間する
+/// 平面との衝突はCCDで求めるので、速い球も刻み幅に関係なくすり抜けない
+/// </summary>
+struct SimulationState {
+	std::vector<Sphere> previous;
+	std::vector<Sphere> current;
+	std::vector<Vector3> velocities;
+	std::vector<Plane> planes;// 球は法線の向いている側に置く
+	Vector3 gravity;
+	float restitution;// 反発係数
+	uint64_t stepCount;
+};
+
+/// <summary>
+/// 原点を中心とした箱の中に球をばらまいたシーンを作る(同じseedなら同じシーン)
+/// </summary>
+/// <param name="sphereCount">球の数</param>
+/// <param name="seed">乱数シード</param>
+SimulationState MakeSimulationScene(uint32_t sphereCount, uint32_t seed);
+
+/// <summary>
+/// 1ステップ進める
+/// </summary>
+/// <param name="state">シーン</param>
+/// <param name="stepSeconds">刻み幅</param>
+void StepSimulation(SimulationState& state, float stepSeconds);
+
+/// <summary>
+/// 描画用に、前のステップと今のステップの間を補間した球
+/// </summary>
+/// <param name="alpha">FixedTimestep::GetAlpha()</param>
+Sphere GetInterpolatedSphere(const SimulationState& state, size_t index, float alpha);
+
+/// <summary>
+/// 球の位置と速度のビット列から作るハッシュ(実行の結果が同じかを比べる用)
+/// </summary>
+uint64_t HashSimulation(const SimulationState& state);
+
+/// <summary>
+/// ヘッドレス実行の結果
+/// </summary>
+struct HeadlessReport {
+	uint64_t stepCount;
+	double seconds;// 実時間
+	double stepsPerSecond;
+	FrameTimeStats stepStats;// 直近のステップにかかった時間
+	uint64_t hash;// 終了時のHashSimulation
+};
+
+/// <summary>
+/// 描画もフレーム待ちもせずに、できるだけ速くstepCount回進める(耐久・スループット計測用)
+/// </summary>
+/// <param name="state">シーン</param>
+/// <param name="stepSeconds">刻み幅</param>
+/// <param name="stepCount">進める回数</param>
+HeadlessReport RunHeadless(SimulationState& state, float stepSeconds, uint64_t stepCount);
@@ -0,0 +1,112 @@
+#include "SphereWireframe.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <numbers>
+
+namespace {
+
+	SphereWireframe BuildSphereWireframe(uint32_t subdivision) {
+		const float kLatEvery = std::numbers::pi_v<float> / static_cast<float>(subdivision); // 緯度分割1つ分の角度 θd
+		const float kLonEvery = 2.0f * std::numbers::pi_v<float> / static_cast<float>(subdivision); // 経度分割1つ分の角度 φd
+		const uint32_t ringCount = subdivision - 1;
+		const uint32_t vertexCount = ringCount * subdivision + 2;
+		const uint32_t southPole = 0;
+		const uint32_t northPole = vertexCount - 1;
+
+		SphereWireframe wireframe;
+		wireframe.subdivision = subdivision;
+		wireframe.x.reserve(vertexCount);
+		wireframe.y.reserve(vertexCount);
+		wireframe.z.reserve(vertexCount);
+
+		// 経度ごとのsin/cosは全ての輪で共通
+		std::vector<float> lonSin(subdivision);
+		std::vector<float> lonCos(subdivision);
+		for (uint32_t lonIndex = 0; lonIndex < subdivision; ++lonIndex) {
+			float lon = kLonEvery * lonIndex; // φ
+			lonSin[lonIndex] = std::sin(lon);
+			lonCos[lonIndex] = std::cos(lon);
+		}
+
+		wireframe.x.push_back(0.0f);
+		wireframe.y.push_back(-1.0f);
+		wireframe.z.push_back(0.0f);
+		for (uint32_t ring = 1; ring <= ringCount; ++ring) {
+			float lat = -std::numbers::pi_v<float> / 2.0f + kLatEvery * ring; // θ
+			float latSin = std::sin(lat);
+			float latCos = std::cos(lat);
+			for (uint32_t lonIndex = 0; lonIndex < subdivision; ++lonIndex) {
+				wireframe.x.push_back(latCos * lonCos[lonIndex]);
+				wireframe.y.push_back(latSin);
+				wireframe.z.push_back(latCos * lonSin[lonIndex]);
+			}
+		}
+		wireframe.x.push_back(0.0f);
+		wireframe.y.push_back(1.0f);
+		wireframe.z.push_back(0.0f);
+
+		auto ringVertex = [&](uint32_t ring, uint32_t lonIndex) {
+			return 1 + (ring - 1) * subdivision + lonIndex % subdivision;
+		};
+
+		// 緯線(輪ごとに隣の経度へ)
+		for (uint32_t ring = 1; ring <= ringCount; ++ring) {
+			for (uint32_t lonIndex = 0; lonIndex < subdivision; ++lonIndex) {
+				wireframe.lines.push_back(ringVertex(ring, lonIndex));
+				wireframe.lines.push_back(ringVertex(ring, lonIndex + 1));
+			}
+		}
+
+		// 経線(南極から北極へ)
+		for (uint32_t lonIndex = 0; lonIndex < subdivision; ++lonIndex) {
+			uint32_t previous = southPole;
+			for (uint32_t ring = 1; ring <= ringCount; ++ring) {
+				wireframe.lines.push_back(previous);
+				wireframe.lines.push_back(ringVertex(ring, lonIndex));
+				previous = ringVertex(ring, lonIndex);
+			}
+			wireframe.lines.push_back(previous);
+			wireframe.lines.push_back(northPole);
+		}
+
+		return wireframe;
+	}
+
+}
+
+const SphereWireframe& GetSphereWireframe(uint32_t subdivision)
+{
+	static std::unique_ptr<SphereWireframe> cache[kMaxSphereSubdivision + 1];
+	static std::mutex mutex;
+
+	subdivision = std::clamp(subdivision, kMinSphereSubdivision, kMaxSphereSubdivision);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!cache[subdivision]) {
+		cache[subdivision] = std::make_unique<SphereWireframe>(BuildSphereWireframe(subdivision));
+	}
+	return *cache[subdivision];
+}
+
+Matrix4x4 MakeSphereWireframeMatrix(const Vector3& center, float radius, const Matrix4x4& viewProjectionViewportMatrix)
+{
+	// (拡縮・移動) × viewProjectionViewport
+	// 上3行は半径倍、4行目は中心で3行を重ねたものに元の4行目を足したもの
+	const Matrix4x4& m = viewProjectionViewportMatrix;
+	Matrix4x4 matrix;
+	for (int column = 0; column < 4; ++column) {
+		matrix.m[0][column] = radius * m.m[0][column];
+		matrix.m[1][column] = radius * m.m[1][column];
+		matrix.m[2][column] = radius * m.m[2][column];
+		matrix.m[3][column] = center.x * m.m[0][column] + center.y * m.m[1][column] + center.z * m.m[2][column] + m.m[3][column];
+	}
+	return matrix;
+}
+
+size_t TransformSphereWireframe(const SphereWireframe& wireframe, const Vector3& center, float radius, const Matrix4x4& viewProjectionViewportMatrix, const ScreenPointsSoA& screen)
+{
+	Matrix4x4 matrix = MakeSphereWireframeMatrix(center, radius, viewProjectionViewportMatrix);
+	return TransformToScreen({ wireframe.x, wireframe.y, wireframe.z }, matrix, screen);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "TransformBatch.h"
+#include <Matrix4x4.h>
+#include <Vector3.h>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 単位球(半径1、中心原点)の緯線・経線のワイヤーフレーム
+/// 頂点は重複なしで、並びは 南極, 緯度1の輪(経度順), ..., 緯度subdivision-1の輪, 北極
+/// </summary>
+struct SphereWireframe {
+	uint32_t subdivision;// 緯度・経度の分割数
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+	std::vector<uint32_t> lines;// 2つずつで1本の線(頂点の添え字)
+};
+
+// 指定できる分割数の範囲
+const uint32_t kMinSphereSubdivision = 3;
+const uint32_t kMaxSphereSubdivision = 64;
+
+/// <summary>
+/// 分割数ごとに1度だけ作って共有する単位球のワイヤーフレームを返す
+/// 分割数は[kMinSphereSubdivision, kMaxSphereSubdivision]に丸める
+/// </summary>
+const SphereWireframe& GetSphereWireframe(uint32_t subdivision);
+
+/// <summary>
+/// 単位球を中心と半径で拡縮・移動する行列にviewProjectionViewportを掛けたものを返す
+/// 単位球の頂点をこの行列で変換すると、TransformSphereWireframeと同じ結果になる
+/// </summary>
+/// <param name="center">中心</param>
+/// <param name="radius">半径</param>
+/// <param name="viewProjectionViewportMatrix">Multiply(viewProjectionMatrix, viewportMatrix)</param>
+/// <returns>(拡縮・移動) × viewProjectionViewport</returns>
+Matrix4x4 MakeSphereWireframeMatrix(const Vector3& center, float radius, const Matrix4x4& viewProjectionViewportMatrix);
+
+/// <summary>
+/// 単位球の頂点を、中心と半径で拡縮・移動してからスクリーンへ一括変換する
+/// 拡縮・移動は行列に畳み込むので、頂点ごとの計算はTransformToScreenだけ
+/// </summary>
+/// <param name="wireframe">GetSphereWireframeの結果</param>
+/// <param name="center">中心</param>
+/// <param name="radius">半径</param>
+/// <param name="viewProjectionViewportMatrix">Multiply(viewProjectionMatrix, viewportMatrix)</param>
+/// <param name="screen">出力先(頂点数以上)</param>
+/// <returns>見えている頂点の数</returns>
+size_t TransformSphereWireframe(const SphereWireframe& wireframe, const Vector3& center, float radius, const Matrix4x4& viewProjectionViewportMatrix, const ScreenPointsSoA& screen);
@@ -0,0 +1,269 @@
+#include "TransformBatch.h"
+#include "MathFunction.h"
+#include "MathFunctionSimd.h"
+#include <assert.h>
+#include <bit>
+
+#if defined(MT3_SIMD_SSE)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+	// これ以下のwはカメラの後ろとして扱う
+	const float kMinW = 1.0e-6f;
+
+	// 1点ずつ処理する(SIMDの端数と非対応環境用)
+	uint8_t TransformToScreenPoint(float x, float y, float z, const Matrix4x4& m, float& screenX, float& screenY) {
+		float w = x * m.m[0][3] + y * m.m[1][3] + z * m.m[2][3] + m.m[3][3];
+		if (!(w > kMinW)) {
+			screenX = 0.0f;
+			screenY = 0.0f;
+			return 0;
+		}
+
+		float inverseW = 1.0f / w;
+		screenX = (x * m.m[0][0] + y * m.m[1][0] + z * m.m[2][0] + m.m[3][0]) * inverseW;
+		screenY = (x * m.m[0][1] + y * m.m[1][1] + z * m.m[2][1] + m.m[3][1]) * inverseW;
+		return 1;
+	}
+
+#if defined(MT3_SIMD_SSE)
+	// 4つとも|θ| <= kSinCosMaxAngleか(NaNは偽)
+	bool IsSinCos4InRange(__m128 theta) {
+		const __m128 absTheta = _mm_andnot_ps(_mm_set1_ps(-0.0f), theta);
+		return _mm_movemask_ps(_mm_cmple_ps(absTheta, _mm_set1_ps(kSinCosMaxAngle))) == 0xF;
+	}
+
+	/// <summary>
+	/// 4つの角度のsin/cosをまとめて求める(SinCosと同じ範囲の縮約と多項式近似)
+	/// 誤差はsinf/cosfに対して数ULP程度。|θ| <= kSinCosMaxAngleに限る
+	/// (象限をcvttpsで整数にするので、2^31*π/4を超えると結果が壊れる)
+	/// </summary>
+	void SinCos4(__m128 theta, __m128& sin, __m128& cos) {
+		assert(IsSinCos4InRange(theta));
+
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000u)));
+		const __m128i one = _mm_set1_epi32(1);
+		const __m128i two = _mm_set1_epi32(2);
+		const __m128i four = _mm_set1_epi32(4);
+
+		__m128 signSin = _mm_and_ps(theta, signMask);
+		__m128 x = _mm_andnot_ps(signMask, theta);
+
+		// π/4単位の象限を求める
+		__m128i quadrant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+		quadrant = _mm_and_si128(_mm_add_epi32(quadrant, one), _mm_set1_epi32(~1));
+		__m128 y = _mm_cvtepi32_ps(quadrant);
+
+		__m128 swapSignSin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, four), 29));
+		__m128 useSinPolynomial = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, two), _mm_setzero_si128()));
+		__m128 signCos = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(quadrant, two), four), 29));
+		signSin = _mm_xor_ps(signSin, swapSignSin);
+
+		// x - y*π/4 を3段階に分けて誤差を抑える
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(0.78515625f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8f)));
+
+		__m128 z = _mm_mul_ps(x, x);
+
+		// cosの多項式
+		__m128 polyCos = _mm_set1_ps(2.443315711809948e-5f);
+		polyCos = _mm_add_ps(_mm_mul_ps(polyCos, z), _mm_set1_ps(-1.388731625493765e-3f));
+		polyCos = _mm_add_ps(_mm_mul_ps(polyCos, z), _mm_set1_ps(4.166664568298827e-2f));
+		polyCos = _mm_mul_ps(_mm_mul_ps(polyCos, z), z);
+		polyCos = _mm_sub_ps(polyCos, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+		polyCos = _mm_add_ps(polyCos, _mm_set1_ps(1.0f));
+
+		// sinの多項式
+		__m128 polySin = _mm_set1_ps(-1.9515295891e-4f);
+		polySin = _mm_add_ps(_mm_mul_ps(polySin, z), _mm_set1_ps(8.3321608736e-3f));
+		polySin = _mm_add_ps(_mm_mul_ps(polySin, z), _mm_set1_ps(-1.6666654611e-1f));
+		polySin = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(polySin, z), x), x);
+
+		__m128 sinValue = _mm_or_ps(_mm_and_ps(useSinPolynomial, polySin), _mm_andnot_ps(useSinPolynomial, polyCos));
+		__m128 cosValue = _mm_or_ps(_mm_and_ps(useSinPolynomial, polyCos), _mm_andnot_ps(useSinPolynomial, polySin));
+
+		sin = _mm_xor_ps(sinValue, signSin);
+		cos = _mm_xor_ps(cosValue, signCos);
+	}
+#endif
+
+	// 1個分のSRTから行列を作る(端数とSIMD非対応環境用)
+	void MakeAffineMatrixAt(const TransformsSoA& transforms, size_t i, Matrix4x4& matrix) {
+		matrix = MakeAffineMatrix(
+			{ transforms.scaleX[i], transforms.scaleY[i], transforms.scaleZ[i] },
+			{ transforms.rotateX[i], transforms.rotateY[i], transforms.rotateZ[i] },
+			{ transforms.translateX[i], transforms.translateY[i], transforms.translateZ[i] });
+	}
+
+}
+
+size_t TransformToScreen(const PointsSoA& points, const Matrix4x4& viewProjectionViewportMatrix, const ScreenPointsSoA& screen)
+{
+	const size_t count = points.x.size();
+	assert(points.y.size() == count && points.z.size() == count);
+	assert(screen.x.size() >= count && screen.y.size() >= count && screen.visible.size() >= count);
+
+	const Matrix4x4& m = viewProjectionViewportMatrix;
+	const float* px = points.x.data();
+	const float* py = points.y.data();
+	const float* pz = points.z.data();
+	float* sx = screen.x.data();
+	float* sy = screen.y.data();
+	uint8_t* visible = screen.visible.data();
+
+	size_t visibleCount = 0;
+	size_t i = 0;
+
+#if defined(MT3_SIMD_AVX)
+	{
+		const __m256 m00 = _mm256_set1_ps(m.m[0][0]), m10 = _mm256_set1_ps(m.m[1][0]), m20 = _mm256_set1_ps(m.m[2][0]), m30 = _mm256_set1_ps(m.m[3][0]);
+		const __m256 m01 = _mm256_set1_ps(m.m[0][1]), m11 = _mm256_set1_ps(m.m[1][1]), m21 = _mm256_set1_ps(m.m[2][1]), m31 = _mm256_set1_ps(m.m[3][1]);
+		const __m256 m03 = _mm256_set1_ps(m.m[0][3]), m13 = _mm256_set1_ps(m.m[1][3]), m23 = _mm256_set1_ps(m.m[2][3]), m33 = _mm256_set1_ps(m.m[3][3]);
+		const __m256 minW = _mm256_set1_ps(kMinW);
+		const __m256 one = _mm256_set1_ps(1.0f);
+
+		for (; i + 8 <= count; i += 8) {
+			__m256 x = _mm256_loadu_ps(px + i);
+			__m256 y = _mm256_loadu_ps(py + i);
+			__m256 z = _mm256_loadu_ps(pz + i);
+
+			__m256 w = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m03), _mm256_mul_ps(y, m13)), _mm256_mul_ps(z, m23)), m33);
+			__m256 front = _mm256_cmp_ps(w, minW, _CMP_GT_OQ);
+			__m256 inverseW = _mm256_and_ps(_mm256_div_ps(one, _mm256_blendv_ps(one, w, front)), front);
+
+			__m256 clipX = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m00), _mm256_mul_ps(y, m10)), _mm256_mul_ps(z, m20)), m30);
+			__m256 clipY = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m01), _mm256_mul_ps(y, m11)), _mm256_mul_ps(z, m21)), m31);
+			_mm256_storeu_ps(sx + i, _mm256_mul_ps(clipX, inverseW));
+			_mm256_storeu_ps(sy + i, _mm256_mul_ps(clipY, inverseW));
+
+			int mask = _mm256_movemask_ps(front);
+			for (int lane = 0; lane < 8; ++lane) {
+				visible[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+			}
+			visibleCount += static_cast<size_t>(std::popcount(static_cast<unsigned int>(mask)));
+		}
+	}
+#endif
+
+#if defined(MT3_SIMD_SSE)
+	{
+		const __m128 m00 = _mm_set1_ps(m.m[0][0]), m10 = _mm_set1_ps(m.m[1][0]), m20 = _mm_set1_ps(m.m[2][0]), m30 = _mm_set1_ps(m.m[3][0]);
+		const __m128 m01 = _mm_set1_ps(m.m[0][1]), m11 = _mm_set1_ps(m.m[1][1]), m21 = _mm_set1_ps(m.m[2][1]), m31 = _mm_set1_ps(m.m[3][1]);
+		const __m128 m03 = _mm_set1_ps(m.m[0][3]), m13 = _mm_set1_ps(m.m[1][3]), m23 = _mm_set1_ps(m.m[2][3]), m33 = _mm_set1_ps(m.m[3][3]);
+		const __m128 minW = _mm_set1_ps(kMinW);
+		const __m128 one = _mm_set1_ps(1.0f);
+
+		for (; i + 4 <= count; i += 4) {
+			__m128 x = _mm_loadu_ps(px + i);
+			__m128 y = _mm_loadu_ps(py + i);
+			__m128 z = _mm_loadu_ps(pz + i);
+
+			__m128 w = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m03), _mm_mul_ps(y, m13)), _mm_mul_ps(z, m23)), m33);
+			__m128 front = _mm_cmpgt_ps(w, minW);
+			// 後ろの点は1で割ってから0を掛ける(0除算を起こさない)
+			__m128 safeW = _mm_or_ps(_mm_and_ps(front, w), _mm_andnot_ps(front, one));
+			__m128 inverseW = _mm_and_ps(_mm_div_ps(one, safeW), front);
+
+			__m128 clipX = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m00), _mm_mul_ps(y, m10)), _mm_mul_ps(z, m20)), m30);
+			__m128 clipY = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m01), _mm_mul_ps(y, m11)), _mm_mul_ps(z, m21)), m31);
+			_mm_storeu_ps(sx + i, _mm_mul_ps(clipX, inverseW));
+			_mm_storeu_ps(sy + i, _mm_mul_ps(clipY, inverseW));
+
+			int mask = _mm_movemask_ps(front);
+			visible[i + 0] = static_cast<uint8_t>(mask & 1);
+			visible[i + 1] = static_cast<uint8_t>((mask >> 1) & 1);
+			visible[i + 2] = static_cast<uint8_t>((mask >> 2) & 1);
+			visible[i + 3] = static_cast<uint8_t>((mask >> 3) & 1);
+			visibleCount += static_cast<size_t>((mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1));
+		}
+	}
+#endif
+
+	for (; i < count; ++i) {
+		visible[i] = TransformToScreenPoint(px[i], py[i], pz[i], m, sx[i], sy[i]);
+		visibleCount += visible[i];
+	}
+
+	return visibleCount;
+}
+
+void MakeAffineMatrices(const TransformsSoA& transforms, std::span<Matrix4x4> matrices)
+{
+	const size_t count = transforms.scaleX.size();
+	assert(matrices.size() >= count);
+
+	size_t i = 0;
+
+#if defined(MT3_SIMD_SSE)
+	for (; i + 4 <= count; i += 4) {
+		__m128 rotateX = _mm_loadu_ps(&transforms.rotateX[i]);
+		__m128 rotateY = _mm_loadu_ps(&transforms.rotateY[i]);
+		__m128 rotateZ = _mm_loadu_ps(&transforms.rotateZ[i]);
+		if (!IsSinCos4InRange(rotateX) || !IsSinCos4InRange(rotateY) || !IsSinCos4InRange(rotateZ)) {
+			// 大きすぎる角度を含む4個はスカラー版(sinf/cosfへ戻る)で作る
+			for (size_t k = i; k < i + 4; ++k) {
+				MakeAffineMatrixAt(transforms, k, matrices[k]);
+			}
+			continue;
+		}
+
+		__m128 sinX, cosX, sinY, cosY, sinZ, cosZ;
+		SinCos4(rotateX, sinX, cosX);
+		SinCos4(rotateY, sinY, cosY);
+		SinCos4(rotateZ, sinZ, cosZ);
+
+		__m128 scaleX = _mm_loadu_ps(&transforms.scaleX[i]);
+		__m128 scaleY = _mm_loadu_ps(&transforms.scaleY[i]);
+		__m128 scaleZ = _mm_loadu_ps(&transforms.scaleZ[i]);
+		__m128 sinXsinY = _mm_mul_ps(sinX, sinY);
+		__m128 cosXsinY = _mm_mul_ps(cosX, sinY);
+
+		// MakeAffineMatrixと同じ式を4個分まとめて計算する(各変数のレーンkがk番目の行列)
+		__m128 row0[4] = {
+			_mm_mul_ps(scaleX, _mm_mul_ps(cosY, cosZ)),
+			_mm_mul_ps(scaleX, _mm_mul_ps(cosY, sinZ)),
+			_mm_mul_ps(scaleX, _mm_xor_ps(sinY, _mm_set1_ps(-0.0f))),
+			_mm_setzero_ps(),
+		};
+		__m128 row1[4] = {
+			_mm_mul_ps(scaleY, _mm_sub_ps(_mm_mul_ps(sinXsinY, cosZ), _mm_mul_ps(cosX, sinZ))),
+			_mm_mul_ps(scaleY, _mm_add_ps(_mm_mul_ps(sinXsinY, sinZ), _mm_mul_ps(cosX, cosZ))),
+			_mm_mul_ps(scaleY, _mm_mul_ps(sinX, cosY)),
+			_mm_setzero_ps(),
+		};
+		__m128 row2[4] = {
+			_mm_mul_ps(scaleZ, _mm_add_ps(_mm_mul_ps(cosXsinY, cosZ), _mm_mul_ps(sinX, sinZ))),
+			_mm_mul_ps(scaleZ, _mm_sub_ps(_mm_mul_ps(cosXsinY, sinZ), _mm_mul_ps(sinX, cosZ))),
+			_mm_mul_ps(scaleZ, _mm_mul_ps(cosX, cosY)),
+			_mm_setzero_ps(),
+		};
+		__m128 row3[4] = {
+			_mm_loadu_ps(&transforms.translateX[i]),
+			_mm_loadu_ps(&transforms.translateY[i]),
+			_mm_loadu_ps(&transforms.translateZ[i]),
+			_mm_set1_ps(1.0f),
+		};
+
+		// 転置するとk本目がk番目の行列の行になる
+		_MM_TRANSPOSE4_PS(row0[0], row0[1], row0[2], row0[3]);
+		_MM_TRANSPOSE4_PS(row1[0], row1[1], row1[2], row1[3]);
+		_MM_TRANSPOSE4_PS(row2[0], row2[1], row2[2], row2[3]);
+		_MM_TRANSPOSE4_PS(row3[0], row3[1], row3[2], row3[3]);
+
+		for (int k = 0; k < 4; ++k) {
+			Matrix4x4& matrix = matrices[i + k];
+			_mm_storeu_ps(matrix.m[0], row0[k]);
+			_mm_storeu_ps(matrix.m[1], row1[k]);
+			_mm_storeu_ps(matrix.m[2], row2[k]);
+			_mm_storeu_ps(matrix.m[3], row3[k]);
+		}
+	}
+#endif
+
+	for (; i < count; ++i) {
+		MakeAffineMatrixAt(transforms, i, matrices[i]);
+	}
+}
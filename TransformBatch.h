@@ -0,0 +1,59 @@
+#pragma once
+#include <Matrix4x4.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/// <summary>
+/// SoA形式で並べた座標列(x,y,zを別々の配列で持つ)
+/// </summary>
+struct PointsSoA {
+	std::span<const float> x;
+	std::span<const float> y;
+	std::span<const float> z;
+};
+
+/// <summary>
+/// スクリーン座標の出力先
+/// visibleはカメラの後ろ(w <= 0)の点で0、それ以外で1になる
+/// </summary>
+struct ScreenPointsSoA {
+	std::span<float> x;
+	std::span<float> y;
+	std::span<uint8_t> visible;
+};
+
+/// <summary>
+/// ワールド座標→クリップ→スクリーン座標への一括変換
+/// Transform(Transform(p, viewProjection), viewport)と同じ結果を、除算1回で4/8点ずつ求める
+/// カメラの後ろの点はassertせずにvisible=0を立て、座標は0にする
+/// </summary>
+/// <param name="points">ワールド座標</param>
+/// <param name="viewProjectionViewportMatrix">Multiply(viewProjectionMatrix, viewportMatrix)</param>
+/// <param name="screen">出力先(pointsと同じ要素数)</param>
+/// <returns>見えている点の数</returns>
+size_t TransformToScreen(const PointsSoA& points, const Matrix4x4& viewProjectionViewportMatrix, const ScreenPointsSoA& screen);
+
+/// <summary>
+/// SoA形式で並べたSRT(拡縮・回転・移動)の列
+/// すべての配列は同じ要素数にする
+/// </summary>
+struct TransformsSoA {
+	std::span<const float> scaleX;
+	std::span<const float> scaleY;
+	std::span<const float> scaleZ;
+	std::span<const float> rotateX;
+	std::span<const float> rotateY;
+	std::span<const float> rotateZ;
+	std::span<const float> translateX;
+	std::span<const float> translateY;
+	std::span<const float> translateZ;
+};
+
+/// <summary>
+/// N個のSRTからワールド行列を一括で作る
+/// MakeAffineMatrixと同じ式を4個ずつ計算し、sin/cosも4個まとめて求める
+/// </summary>
+/// <param name="transforms">SRTの列</param>
+/// <param name="matrices">出力先(transformsと同じ要素数以上)</param>
+void MakeAffineMatrices(const TransformsSoA& transforms, std::span<Matrix4x4> matrices);
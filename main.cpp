@@ -14,112 +14,239 @@
 #include "DirectXCommon.h"
 #include "WinApp.h"
 
+#include "MathFunction.h"
+#include "MathExpression.h"
+#include "Collision.h"
+#include "TransformBatch.h"
+#include "SphereWireframe.h"
+#include "DebugDraw.h"
+#include "Frustum.h"
+#include "Camera.h"
+#include "FixedTimestep.h"
+#include "Simulation.h"
+#include "Profiler.h"
+#include "InstancedWireframe.h"
+#include "InstancedWireframeRenderer.h"
+#include "FrameArena.h"
+#include "Scene.h"
+#include "SceneSnapshot.h"
+#include "Replay.h"
+#include "CollisionBatch.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
 const char kWindowTitle[] = "LC1C_14_タカムラシュン_タイトル";
 
 const float kWindowWidth = 1080.0f;
 const float kWindowHeight = 720.0f;
 
-typedef struct Segment {
-	Vector3 origin;// 始点
-	Vector3 diff;// 終点
-}Segment;
-
-typedef struct Sphere {
-	Vector3 center;// 中心点
-	float radius;// 半径
-}Sphere;
+// 跳ねる球のシーン(更新は固定刻み、描画は補間)
+const uint32_t kSimulationSphereCount = 64;
+const uint32_t kSimulationSeed = 1;
+const double kSimulationStepSeconds = 1.0 / 60.0;
 
-typedef struct Plane {
-	Vector3 normal;// 法線
-	float distance;// 距離
-}Plane;
+// 描画関数は線をDebugDrawにためるだけで、フレームの最後にまとめてNoviceへ渡す
+void DrawGrid(const Matrix4x4& viewProjectionViewportMatrix, DebugDraw& debugDraw);
 
-// 行列をベクトルに変換する関数
-Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix);
+// 分割数はGetSphereWireframeに渡す緯度・経度の分割数
+// 視錐台の外にある球は頂点を作る前に捨てる
+void DrawSphere(const Vector3& center, float radius, const Frustum& frustum, const Matrix4x4& viewProjectionViewportMatrix, uint32_t color, DebugDraw& debugDraw, uint32_t subdivision = 20);
 
-/// <summary>
-/// cotangent(余接)を求める関数
-/// </summary>
-/// <param name="theta">θ(シータ)</param>
-/// <returns>cotangent</returns>
-float Cotangent(float theta);
+void DrawPlane(const Plane& plane, const Matrix4x4& viewProjectionViewportMatrix, uint32_t color, DebugDraw& debugDraw);
 
-/// <summary>
-/// アフィン行列作成関数
-/// </summary>
-/// <param name="scale">縮尺</param>
-/// <param name="rotate">thetaを求めるための数値</param>
-/// <param name="translate">三次元座標でのx,y,zの移動量</param>
-/// <returns>アフィン行列</returns>
-Matrix4x4 MakeAffineMatrix(Vector3 scale, Vector3 rotate, Vector3 translate);
+void DrawSegment(const Segment& segment, const Matrix4x4& viewProjectionViewportMatrix, uint32_t color, DebugDraw& debugDraw);
 
-/// <summary>
-/// 4x4逆行列を求める関数
-/// </summary>
-/// <param name="matrix4x4">逆行列を求めたい行列</param>
-/// <returns>4x4逆行列</returns>
-Matrix4x4 Inverse(Matrix4x4 matrix4x4);
+// "--headless [ステップ数] [--trace]"のとき、窓を作らずにシミュレーションだけを最速で回して結果を表示する
+// "--headless --scene パス"のときは、シーンファイルを読んで線分×平面を一括判定した時間を表示する
+// "--headless --replay パス [--trace]"のときは、"--record パス"で残した入力で更新だけを回して時間とハッシュを表示する
+int RunHeadlessCommand(const char* commandLine);
+int RunSceneCommand(const char* argument);
+int RunReplayCommand(const char* commandLine, const char* argument);
 
-/// <summary>
-/// 4x4行列の積を求める関数
-/// </summary>
-/// <param name="matrix1">1つ目の行列</param>
-/// <param name="matrix2">1つ目の行列</param>
-/// <returns>4x4行列の積</returns>
-Matrix4x4 Multiply(Matrix4x4 matrix1, Matrix4x4 matrix2);
+// /SUBSYSTEM:WINDOWSのexeにはコンソールが無いので、起動元のコンソールにつないで標準出力と標準エラーを開き直す
+// ファイルやパイプへリダイレクトされている出力はそのまま使う
+void AttachParentConsole();
 
-/// <summary>
-/// 投視投影行列作成関数
-/// </summary>
-/// <param name="fovY">縦の画角</param>
-/// <param name="aspectRatio">アスペクト比</param>
-/// <param name="nearClip">近平面への距離</param>
-/// <param name="farClip">遠平面への距離</param>
-/// <returns>投視投影行列</returns>
-Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip);
+// コマンドラインの"--オプション パス"のパス(空白までの1語)を取り出す
+void ReadPathArgument(const char* argument, char* path, size_t size);
 
-Vector3 TransformWithoutW(const Vector3& vector, const Matrix4x4& matrix);
+// 画面のシーンとカメラを保存するファイル(scene.txtは差分を見るためのテキスト版)
+const char kSceneSnapshotPath[] = "scene.mt3";
+const char kSceneTextPath[] = "scene.txt";
 
-/// <summary>
-/// ビューポート行列作成関数
-/// </summary>
-/// <param name="left">左側の座標</param>
-/// <param name="top">上側の座標</param>
-/// <param name="width">切り取るスクリーンの幅</param>
-/// <param name="height">切り取るスクリーンの高さ</param>
-/// <param name="minDepth">最小深度値</param>
-/// <param name="maxDepth">最大深度値</param>
-/// <returns></returns>
-Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth);
+// 区間ごとの平均とp99を並べる(Segment Controllerの右に置く)
+void DrawProfilerWindow();
 
-void DrawGrid(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix);
+void AttachParentConsole()
+{
+	// リダイレクトの有無はつなぐ前のハンドルで判断する
+	HANDLE output = GetStdHandle(STD_OUTPUT_HANDLE);
+	HANDLE error = GetStdHandle(STD_ERROR_HANDLE);
+	const bool outputRedirected = output != nullptr && output != INVALID_HANDLE_VALUE;
+	const bool errorRedirected = error != nullptr && error != INVALID_HANDLE_VALUE;
+	if (outputRedirected && errorRedirected) {
+		return;
+	}
+	// エクスプローラーから起動したときなど、親にコンソールが無ければ何も出さない
+	if (!AttachConsole(ATTACH_PARENT_PROCESS)) {
+		return;
+	}
+	FILE* stream = nullptr;
+	if (!outputRedirected) {
+		freopen_s(&stream, "CONOUT$", "w", stdout);
+	}
+	if (!errorRedirected) {
+		freopen_s(&stream, "CONOUT$", "w", stderr);
+	}
+}
 
-void DrawSphere(const Vector3& center, float radius, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
+int RunHeadlessCommand(const char* commandLine)
+{
+	if (const char* sceneArgument = std::strstr(commandLine, "--scene")) {
+		return RunSceneCommand(sceneArgument + std::strlen("--scene"));
+	}
+	if (const char* replayArgument = std::strstr(commandLine, "--replay")) {
+		return RunReplayCommand(commandLine, replayArgument + std::strlen("--replay"));
+	}
 
-Vector3 Project(const Vector3& v1, const Vector3& v2);
+	// 既定は10分ぶん
+	uint64_t stepCount = 36000;
+	const char* argument = std::strstr(commandLine, "--headless") + std::strlen("--headless");
+	char* end = nullptr;
+	uint64_t parsed = std::strtoull(argument, &end, 10);
+	if (end != argument && parsed > 0) {
+		stepCount = parsed;
+	}
 
-Vector3 ClosestPoint(const Vector3& point, const Segment& segment);
+	SimulationState simulation = MakeSimulationScene(kSimulationSphereCount, kSimulationSeed);
+	HeadlessReport report = RunHeadless(simulation, static_cast<float>(kSimulationStepSeconds), stepCount);
+	std::printf("%llu steps in %.3f s (%.0f steps/s), step avg %.4f ms, max %.4f ms, hash %016llx\n",
+		static_cast<unsigned long long>(report.stepCount), report.seconds, report.stepsPerSecond,
+		report.stepStats.averageMs, report.stepStats.maxMs, static_cast<unsigned long long>(report.hash));
 
-Vector3 Subtract(const Vector3& v1, const Vector3& v2);
+	// "--trace"があれば最後の計測をChrome trace形式で残す
+	if (std::strstr(commandLine, "--trace")) {
+		Profiler::Get().WriteChromeTrace("profile_trace.json");
+	}
+	return 0;
+}
 
-Vector3 Add(const Vector3& v1, const Vector3& v2);
+void ReadPathArgument(const char* argument, char* path, size_t size)
+{
+	while (*argument == ' ') {
+		++argument;
+	}
+	size_t length = 0;
+	for (; length + 1 < size && argument[length] != '\0' && argument[length] != ' '; ++length) {
+		path[length] = argument[length];
+	}
+	path[length] = '\0';
+}
 
-float Dot(const Vector3& v1, const Vector3& v2);
+int RunSceneCommand(const char* argument)
+{
+	char path[260];
+	ReadPathArgument(argument, path, sizeof(path));
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	SceneSnapshot snapshot;
+	if (!snapshot.Open(path)) {
+		std::printf("cannot open scene \"%s\"\n", path);
+		return 1;
+	}
+	std::chrono::steady_clock::time_point opened = std::chrono::steady_clock::now();
+
+	// 読み込んだ列をそのまま一括判定へ渡す
+	const size_t segmentCount = snapshot.GetCount(Scene::ShapeType::kSegment);
+	const size_t planeCount = snapshot.GetCount(Scene::ShapeType::kPlane);
+	std::vector<uint8_t> hits(segmentCount * planeCount);
+	size_t hitCount = IsCollisionBatch(snapshot.GetSegments(), snapshot.GetPlanes(), { hits, {} });
+	std::chrono::steady_clock::time_point tested = std::chrono::steady_clock::now();
+
+	std::printf("%zu spheres, %zu segments, %zu planes: open %.3f ms, segment x plane %.3f ms (%zu hits)\n",
+		snapshot.GetCount(Scene::ShapeType::kSphere), segmentCount, planeCount,
+		std::chrono::duration<double, std::milli>(opened - start).count(),
+		std::chrono::duration<double, std::milli>(tested - opened).count(), hitCount);
+	return 0;
+}
 
-bool IsCollision(const Segment& segment, const Plane& plane);
+int RunReplayCommand(const char* commandLine, const char* argument)
+{
+	char path[260];
+	ReadPathArgument(argument, path, sizeof(path));
+	ReplayReader reader;
+	if (!reader.Open(path)) {
+		std::printf("cannot open replay \"%s\"\n", path);
+		return 1;
+	}
 
-float GetLength(const Vector3& v1);
+	ReplayReport report = RunReplay(reader);
+	std::printf("%llu frames, %llu steps in %.3f s (%.0f frames/s), frame avg %.4f ms, p50 %.4f ms, p99 %.4f ms, max %.4f ms, hash %016llx\n",
+		static_cast<unsigned long long>(report.frameCount), static_cast<unsigned long long>(report.stepCount), report.seconds, report.framesPerSecond,
+		report.averageMs, report.p50Ms, report.p99Ms, report.maxMs, static_cast<unsigned long long>(report.hash));
 
-Vector3 Perpendicular(const Vector3& vector);
+	if (std::strstr(commandLine, "--trace")) {
+		Profiler::Get().WriteChromeTrace("profile_trace.json");
+	}
+	return 0;
+}
 
-void DrawPlane(const Plane& plane, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
+void DrawProfilerWindow()
+{
+	Profiler& profiler = Profiler::Get();
 
-Vector3 Normalize(const Vector3& v);
+	ImGui::SetNextWindowPos(ImVec2(410, 0), ImGuiCond_FirstUseEver);
+	ImGui::Begin("Profiler");
+	bool enabled = Profiler::IsEnabled();
+	if (ImGui::Checkbox("Enabled", &enabled)) {
+		Profiler::SetEnabled(enabled);
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Export trace")) {
+		profiler.WriteChromeTrace("profile_trace.json");
+	}
+	ImGui::Text("last %u frames", profiler.GetFrameCount());
+
+	if (ImGui::BeginTable("Scopes", 5)) {
+		ImGui::TableSetupColumn("scope");
+		ImGui::TableSetupColumn("avg ms");
+		ImGui::TableSetupColumn("p99 ms");
+		ImGui::TableSetupColumn("max ms");
+		ImGui::TableSetupColumn("calls");
+		ImGui::TableHeadersRow();
+		for (uint32_t scope = 0; scope < profiler.GetScopeCount(); ++scope) {
+			Profiler::ScopeStats stats = profiler.GetStats(scope);
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::Text("%s", stats.name);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", stats.averageMs);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", stats.p99Ms);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", stats.maxMs);
+			ImGui::TableNextColumn();
+			ImGui::Text("%u", stats.lastCallCount);
+		}
+		ImGui::EndTable();
+	}
+	ImGui::End();
+}
 
-Vector3 Cross(const Vector3& v1, const Vector3& v2);
+// DebugDrawのバックエンド(NoviceのDrawLineは整数座標なのでここで四捨五入する)
+void SubmitNoviceLines(void* context, std::span<const DebugLine> lines);
 
 // Windowsアプリでのエントリーポイント(main関数)
-int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
+int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR commandLine, int) {
+
+	if (commandLine && std::strstr(commandLine, "--headless")) {
+		// "--scene"と"--replay"もここを通るので、表示の前に1度だけコンソールへつなぐ
+		AttachParentConsole();
+		return RunHeadlessCommand(commandLine);
+	}
 
 	// ライブラリの初期化
 	Novice::Initialize(kWindowTitle, 1280, 720);
@@ -133,17 +260,49 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
 	Vector3 cameraRotate = { 0.26f, 0.0f, 0.0f };
 	Vector3 cameraTranslate = { 0.0f, 1.9f, -6.49f };
+	Vector3 segmentOrigin = { 0.0f, 1.0f, 0.0f };
+
+	// 更新はヘッドレスの再生と同じ関数で行う
+	// (シミュレーションは固定刻み、線分と平面はシーンの列をまとめて判定、行列はカメラの値が変わったフレームだけ作り直す)
+	const ReplaySettings settings = { kSimulationSphereCount, kSimulationSeed, kSimulationStepSeconds, 1280.0f, 720.0f };
+	InteractiveState state;
+	InitializeInteractiveState(state, settings);
+	SimulationState& simulation = state.simulation;
+	FixedTimestep& timestep = state.timestep;
+	Scene& scene = state.scene;
+	const Camera& camera = state.camera;
+
+	// デバッグ線はフレームごとにためて1回で描く
+	DebugDraw debugDraw;
+	debugDraw.SetBackend(&SubmitNoviceLines, nullptr);
+
+	FrameTimer frameTimer;
+	bool simulationPaused = false;
+	bool resetRequested = false;
+
+	// "--record パス"のときは、毎フレームの入力をためて終了時に書き出す
+	char recordPath[260] = {};
+	if (const char* recordArgument = commandLine ? std::strstr(commandLine, "--record") : nullptr) {
+		ReadPathArgument(recordArgument + std::strlen("--record"), recordPath, sizeof(recordPath));
+	}
+	const bool recording = recordPath[0] != '\0';
+	ReplayRecorder recorder;
+	recorder.Begin(settings);
 
-	Segment segment = { {0.0f,1.0f,0.0f},{0.0f,0.0f,0.0f} };
-	Plane plane = { {0.0f,1.0f,0.0f}, 1.0f };
-
-	// 固定したい線分の長さ
-	const float segmentLength = 1.0f;
+	// 球は形状をGPUに置いたままインスタンス描画する(準備に失敗したときはCPUで変換して描く)
+	InstancedWireframeRenderer wireframeRenderer;
+	bool gpuInstancing = wireframeRenderer.Initialize(DirectXCommon::GetInstance()->GetDevice());
+	WireframeInstanceBuffer sphereInstances;
+	sphereInstances.Reserve(kSimulationSphereCount);
 
 	// ウィンドウの×ボタンが押されるまでループ
 	while (Novice::ProcessMessage() == 0) {
 		// フレームの開始
 		Novice::BeginFrame();
+		Profiler::Get().BeginFrame();
+
+		// 前のフレームの作業領域をまとめて捨てる
+		GetFrameArena().Reset();
 
 		// キー入力を受け取る
 		memcpy(preKeys, keys, 256);
@@ -153,29 +312,27 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		/// ↓更新処理ここから
 		///
 
-		Matrix4x4 cameraMatrix = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, cameraRotate, cameraTranslate);
-		Matrix4x4 viewMatrix = Inverse(cameraMatrix);
-		Matrix4x4 projectionMatrix = MakePerspectiveFovMatrix(0.45f, 1280.0f / 720.0f, 0.1f, 100.0f);
-		Matrix4x4 viewProjectionMatrix = Multiply(viewMatrix, projectionMatrix);
-		Matrix4x4 viewportMatrix = MakeViewportMatrix(0, 0, 1280, 720, 0.0f, 1.0f);
-
 		// direction（方向ベクトル）をImGuiで調整可能にする
 		static Vector3 direction = { 0.0f, -1.0f, 0.0f }; // 初期は下向き
 		ImGui::SliderFloat3("Direction", &direction.x, -1.0f, 1.0f);
 
-		// 単位ベクトルにしてからスケーリング
-		Vector3 normalizedDir = Normalize(direction);
-		segment.diff = Add(segment.origin, {
-			normalizedDir.x * segmentLength,
-			normalizedDir.y * segmentLength,
-			normalizedDir.z * segmentLength
-			});
+		// このフレームの入力をまとめる(前のフレームのImGuiで変えた値もここで入る)
+		ReplayFrame input;
+		input.frameSeconds = frameTimer.Tick();
+		PackKeys(keys, input.keys);
+		input.direction = direction;
+		input.segmentOrigin = segmentOrigin;
+		input.cameraRotate = cameraRotate;
+		input.cameraTranslate = cameraTranslate;
+		input.paused = simulationPaused;
+		input.reset = resetRequested;
+		resetRequested = false;
+		if (recording) {
+			recorder.Add(input);
+		}
 
-
-		Segment transformSegment = {
-			Transform(Transform(segment.origin,viewProjectionMatrix),viewportMatrix),
-			Transform(Transform(segment.diff,viewProjectionMatrix),viewportMatrix)
-		};
+		UpdateInteractiveFrame(state, input);
+		const Matrix4x4& viewProjectionViewportMatrix = camera.GetViewProjectionViewportMatrix();
 
 		///
 		/// ↑更新処理ここまで
@@ -186,42 +343,114 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		///
 
 		// グリッドの描画
-		DrawGrid(viewProjectionMatrix, viewportMatrix);
+		DrawGrid(viewProjectionViewportMatrix, debugDraw);
 
 		// 描画
-		if (IsCollision(segment, plane)) {
-			Novice::DrawLine(
-				static_cast<int>(transformSegment.origin.x),
-				static_cast<int>(transformSegment.origin.y),
-				static_cast<int>(transformSegment.diff.x),
-				static_cast<int>(transformSegment.diff.y),
-				0xFF0000FF
-			);
+		const size_t segmentCount = scene.GetCount(Scene::ShapeType::kSegment);
+		const size_t planeCount = scene.GetCount(Scene::ShapeType::kPlane);
+		std::span<const uint8_t> segmentHits = state.segmentHits;
+		for (size_t i = 0; i < segmentCount; ++i) {
+			// どれかの平面に当たっていれば赤
+			bool hit = false;
+			for (size_t j = 0; j < planeCount; ++j) {
+				hit = hit || segmentHits[j * segmentCount + i];
+			}
+			Segment sceneSegment;
+			scene.Get(scene.GetHandle(Scene::ShapeType::kSegment, i), sceneSegment);
+			DrawSegment(sceneSegment, viewProjectionViewportMatrix, hit ? 0xFF0000FF : 0xFFFFFFFF, debugDraw);
+		}
+
+		for (size_t i = 0; i < planeCount; ++i) {
+			Plane scenePlane;
+			scene.Get(scene.GetHandle(Scene::ShapeType::kPlane, i), scenePlane);
+			DrawPlane(scenePlane, viewProjectionViewportMatrix, 0x000000FF, debugDraw);
+		}
+
+		// 前のステップと今のステップの間を補間して描く
+		float alpha = timestep.GetAlpha();
+		if (gpuInstancing) {
+			// CPUは見えている球の行列を並べるだけで、頂点の変換は頂点シェーダーで行う
+			sphereInstances.Clear();
+			for (size_t i = 0; i < simulation.current.size(); ++i) {
+				Sphere sphere = GetInterpolatedSphere(simulation, i, alpha);
+				if (IsVisible(camera.GetFrustum(), sphere)) {
+					sphereInstances.AddSphere(sphere.center, sphere.radius, 0x4040FFFF);
+				}
+			}
+			wireframeRenderer.BeginFrame(camera.GetViewMatrix(), camera.GetProjectionMatrix(), camera.GetTranslate());
+			wireframeRenderer.Draw(DirectXCommon::GetInstance()->GetCommandList(), InstancedWireframeRenderer::Shape::kSphere, sphereInstances.GetInstances());
 		} else {
-			Novice::DrawLine(
-				static_cast<int>(transformSegment.origin.x),
-				static_cast<int>(transformSegment.origin.y),
-				static_cast<int>(transformSegment.diff.x),
-				static_cast<int>(transformSegment.diff.y),
-				0xFFFFFFFF
-			);
+			for (size_t i = 0; i < simulation.current.size(); ++i) {
+				Sphere sphere = GetInterpolatedSphere(simulation, i, alpha);
+				DrawSphere(sphere.center, sphere.radius, camera.GetFrustum(), viewProjectionViewportMatrix, 0x4040FFFF, debugDraw, 8);
+			}
 		}
 
-		DrawPlane(plane, viewProjectionMatrix, viewportMatrix, 0x000000FF);
+		// ためた線をまとめて描く
+		debugDraw.Flush();
 
 		ImGui::Begin("Segment Controller");
 		ImGui::SetWindowSize(ImVec2(400, 300)); // 幅400, 高さ300
-		ImGui::SliderFloat3("segment.origine", &segment.origin.x, -5.0f, 5.0f);
+		ImGui::SliderFloat3("segment.origine", &segmentOrigin.x, -5.0f, 5.0f);
 		ImGui::DragFloat3("Rotate", &cameraRotate.x, 0.01f);
 		ImGui::SliderFloat3("Translate", &cameraTranslate.x, -10.0f, 10.0f);
+		if (ImGui::Button("Save scene")) {
+			WriteSceneSnapshot(kSceneSnapshotPath, scene, { cameraRotate, cameraTranslate });
+			SceneSnapshot saved;
+			if (saved.Open(kSceneSnapshotPath)) {
+				saved.WriteText(kSceneTextPath);
+			}
+		}
+		// 読み込んだシーンは記録に入らないので、記録中は読み込まない
+		ImGui::SameLine();
+		if (!recording && ImGui::Button("Load scene")) {
+			SceneSnapshot snapshot;
+			if (snapshot.Open(kSceneSnapshotPath)) {
+				cameraRotate = snapshot.GetCamera().rotate;
+				cameraTranslate = snapshot.GetCamera().translate;
+				scene.Clear();
+				snapshot.CopyTo(scene);
+				// 最初の線分をスライダーで動かす線分にする(無ければ今の線分を足す)
+				if (scene.GetCount(Scene::ShapeType::kSegment) > 0) {
+					state.segmentHandle = scene.GetHandle(Scene::ShapeType::kSegment, 0);
+					scene.Get(state.segmentHandle, state.segment);
+					segmentOrigin = state.segment.origin;
+				} else {
+					state.segmentHandle = scene.Add(state.segment);
+				}
+			}
+		}
 		ImGui::End();
 
+		FrameTimeStats frameStats = frameTimer.GetStats();
+		ImGui::Begin("Simulation");
+		ImGui::Text("frame %.2f ms (avg %.2f, min %.2f, max %.2f)", frameStats.lastMs, frameStats.averageMs, frameStats.minMs, frameStats.maxMs);
+		ImGui::Text("steps %llu, dropped %llu, alpha %.2f", static_cast<unsigned long long>(timestep.GetStepCount()),
+			static_cast<unsigned long long>(timestep.GetDroppedStepCount()), alpha);
+		ImGui::Text("frame arena %zu / %zu KB (peak %zu KB, grown %llu times)", GetFrameArena().GetUsedBytes() / 1024,
+			GetFrameArena().GetCapacity() / 1024, GetFrameArena().GetPeakBytes() / 1024, static_cast<unsigned long long>(GetFrameArena().GetGrowCount()));
+		ImGui::Checkbox("Pause", &simulationPaused);
+		if (wireframeRenderer.IsInitialized()) {
+			ImGui::Checkbox("GPU instancing", &gpuInstancing);
+			ImGui::Text("instances %zu (%zu bytes)", sphereInstances.GetInstances().size(), sphereInstances.GetByteSize());
+		}
+		// 作り直すのは次のフレームの更新の最初(記録にも入る)
+		if (ImGui::Button("Reset")) {
+			resetRequested = true;
+		}
+		if (recording) {
+			ImGui::Text("recording %zu frames (%zu bytes)", recorder.GetFrameCount(), recorder.GetByteSize());
+		}
+		ImGui::End();
+
+		DrawProfilerWindow();
 
 		///
 		/// ↑描画処理ここまで
 		///
 
 		// フレームの終了
+		Profiler::Get().EndFrame();
 		Novice::EndFrame();
 
 		// ESCキーが押されたらループを抜ける
@@ -230,178 +459,87 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		}
 	}
 
+	if (recording) {
+		recorder.Write(recordPath);
+	}
+
 	// ライブラリの終了
 	Novice::Finalize();
 	return 0;
 }
-void DrawGrid(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix) {
+void DrawGrid(const Matrix4x4& viewProjectionViewportMatrix, DebugDraw& debugDraw) {
+	PROFILE_SCOPE("DrawGrid");
 	const float kGridHalfWidth = 2.0f;
 	const uint32_t kSubdivision = 10;
 	const float kGridEvery = (kGridHalfWidth * 2.0f) / static_cast<float>(kSubdivision);
+	const uint32_t kLineCount = (kSubdivision + 1) * 2;
+	const uint32_t kPointCount = kLineCount * 2;
+
+	// 端点をSoAで並べてから一括で変換する
+	float x[kPointCount];
+	float y[kPointCount];
+	float z[kPointCount];
+	uint32_t colors[kLineCount];
 
 	for (uint32_t i = 0; i <= kSubdivision; ++i) {
 		float offset = -kGridHalfWidth + i * kGridEvery;
+		uint32_t point = i * 4;
 
 		// 色を決定（中央線だけ黒、それ以外は灰色）
 		uint32_t color = (offset == 0.0f) ? 0x000000FF : 0xAAAAAAFF;
+		colors[i * 2] = color;
+		colors[i * 2 + 1] = color;
 
 		// Z方向（X軸に平行）
-		Vector3 start = { -kGridHalfWidth, 0.0f, offset };
-		Vector3 end = { kGridHalfWidth, 0.0f, offset };
-		start = Transform(Transform(start, viewProjectionMatrix), viewportMatrix);
-		end = Transform(Transform(end, viewProjectionMatrix), viewportMatrix);
-		Novice::DrawLine(static_cast<int>(start.x), static_cast<int>(start.y), static_cast<int>(end.x), static_cast<int>(end.y), color);
+		x[point] = -kGridHalfWidth; y[point] = 0.0f; z[point] = offset;
+		x[point + 1] = kGridHalfWidth; y[point + 1] = 0.0f; z[point + 1] = offset;
 
 		// X方向（Z軸に平行）
-		start = { offset, 0.0f, -kGridHalfWidth };
-		end = { offset, 0.0f, kGridHalfWidth };
-		start = Transform(Transform(start, viewProjectionMatrix), viewportMatrix);
-		end = Transform(Transform(end, viewProjectionMatrix), viewportMatrix);
-		Novice::DrawLine(static_cast<int>(start.x), static_cast<int>(start.y), static_cast<int>(end.x), static_cast<int>(end.y), color);
+		x[point + 2] = offset; y[point + 2] = 0.0f; z[point + 2] = -kGridHalfWidth;
+		x[point + 3] = offset; y[point + 3] = 0.0f; z[point + 3] = kGridHalfWidth;
 	}
-}
 
-void DrawSphere(const Vector3& center, float radius, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color) {
-	const uint32_t kSubdivision = 20; //分割数
-	const float kLatEvery = static_cast<float>(M_PI) / static_cast<float>(kSubdivision); // 緯度分割1つ分の角度 θd
-	const float kLonEvery = static_cast<float>(2.0f * M_PI) / static_cast<float>(kSubdivision); // 経度分割1つ分の角度 φd
-
-	// 緯度の方向に分割 -π/2~π/2
-	for (uint32_t latIndex = 0; latIndex < kSubdivision; ++latIndex) {
-		float lat = -static_cast<float>(M_PI) / 2.0f + kLatEvery * latIndex; // θ
-
-		// 経度の方向に分割 θ~2π
-		for (uint32_t lonIndex = 0; lonIndex < kSubdivision; ++lonIndex) {
-			float lon = kLonEvery * lonIndex; // φ
-
-			// 緯線
-			Vector3 a = {
-				center.x + radius * cosf(lat) * cosf(lon),
-				center.y + radius * sinf(lat),
-				center.z + radius * cosf(lat) * sinf(lon)
-			};
-
-			Vector3 b = {
-				center.x + radius * cosf(lat + kLatEvery) * cosf(lon),
-				center.y + radius * sinf(lat + kLatEvery),
-				center.z + radius * cosf(lat + kLatEvery) * sinf(lon)
-			};
-
-			// 経線
-			Vector3 c = {
-				center.x + radius * cosf(lat) * cosf(lon + kLonEvery),
-				center.y + radius * sinf(lat),
-				center.z + radius * cosf(lat) * sinf(lon + kLonEvery)
-			};
-
-			a = Transform(Transform(a, viewProjectionMatrix), viewportMatrix);
-			b = Transform(Transform(b, viewProjectionMatrix), viewportMatrix);
-			c = Transform(Transform(c, viewProjectionMatrix), viewportMatrix);
-
-			Novice::DrawLine((int)a.x, (int)a.y, (int)b.x, (int)b.y, color);
-			Novice::DrawLine((int)a.x, (int)a.y, (int)c.x, (int)c.y, color);
-		}
-	}
-}
-
-Vector3 Project(const Vector3& v1, const Vector3& v2) {
-	float dot = v1.x * v2.x + v1.y * v2.y + v1.z * v2.z; // v1・v2
-	float normSq = v2.x * v2.x + v2.y * v2.y + v2.z * v2.z; // ||v2||^2
+	float screenX[kPointCount];
+	float screenY[kPointCount];
+	uint8_t visible[kPointCount];
+	TransformToScreen({ x, y, z }, viewProjectionViewportMatrix, { screenX, screenY, visible });
 
-	if (normSq == 0.0f) {
-		return Vector3{ 0.0f, 0.0f, 0.0f }; // ゼロベクトルへの射影はゼロ
+	// カメラの後ろへ伸びる線も近平面で切って描く
+	for (uint32_t line = 0; line < kLineCount; ++line) {
+		const uint32_t indices[2] = { line * 2, line * 2 + 1 };
+		AddClippedLines(debugDraw, { x, y, z }, { screenX, screenY, visible }, indices, viewProjectionViewportMatrix, colors[line]);
 	}
-
-	float scale = dot / normSq;
-	return Vector3{
-		scale * v2.x,
-		scale * v2.y,
-		scale * v2.z
-	};
-}
-
-Vector3 Subtract(const Vector3& v1, const Vector3& v2)
-{
-	Vector3 result;
-
-	result = { v1.x - v2.x,v1.y - v2.y ,v1.z - v2.z };
-
-	return result;
-}
-
-Vector3 Add(const Vector3& v1, const Vector3& v2)
-{
-	Vector3 result;
-
-	result = { v1.x + v2.x,v1.y + v2.y ,v1.z + v2.z };
-
-	return result;
-}
-
-float Dot(const Vector3& v1, const Vector3& v2)
-{
-	float dot =
-		v1.x * v2.x +
-		v1.y * v2.y +
-		v1.z * v2.z;
-
-	return dot;
 }
 
-bool IsCollision(const Segment& segment, const Plane& plane)
-{
-	// 線分の方向ベクトルを求める
-	Vector3 direction = Subtract(segment.diff, segment.origin);
-
-	// 始点から平面への距離
-	float dotA = Dot(plane.normal, segment.origin) - plane.distance;
-	float dotB = Dot(plane.normal, segment.diff) - plane.distance;
-
-	// 端点が平面の反対側にある → 符号が異なる（または片方が0）
-	if (dotA * dotB <= 0.0f) {
-		return true;
+void DrawSphere(const Vector3& center, float radius, const Frustum& frustum, const Matrix4x4& viewProjectionViewportMatrix, uint32_t color, DebugDraw& debugDraw, uint32_t subdivision) {
+	PROFILE_SCOPE("DrawSphere");
+	if (!IsVisible(frustum, Sphere{ center, radius })) {
+		return;
 	}
 
-	return false;
-}
+	// 単位球の頂点と線は分割数ごとに1度だけ作って使い回す
+	const SphereWireframe& wireframe = GetSphereWireframe(subdivision);
+	const size_t vertexCount = wireframe.x.size();
 
+	// 変換結果の置き場はフレーム用のアリーナから取り、描き終わったら戻す
+	FrameArena& arena = GetFrameArena();
+	FrameArena::Scope scope(arena);
+	std::span<float> screenX = arena.AllocateArray<float>(vertexCount);
+	std::span<float> screenY = arena.AllocateArray<float>(vertexCount);
+	std::span<uint8_t> visible = arena.AllocateArray<uint8_t>(vertexCount);
 
-//bool IsCollision(const Segment& segment, const Plane& plane)
-//{
-//	float dot = Dot(plane.normal,segment.diff);
-//
-//	if (dot == 0.0f) {
-//		return false;
-//	}
-//
-//	float t = (plane.distance - Dot(segment.origin, segment.diff)) / dot;
-//
-//	if (t > 0.0f && t < 1.0f) {
-//		return true;
-//	} else {
-//		return false;
-//	}
-//
-//}
-
-float GetLength(const Vector3& v1)
-{
-	float length = sqrtf(v1.x * v1.x + v1.y * v1.y + v1.z * v1.z);
+	// 拡縮・移動を畳み込んだ行列なら、単位球の頂点のまま近平面で切れる
+	const Matrix4x4 sphereMatrix = MakeSphereWireframeMatrix(center, radius, viewProjectionViewportMatrix);
+	const PointsSoA points = { wireframe.x, wireframe.y, wireframe.z };
+	TransformToScreen(points, sphereMatrix, { screenX, screenY, visible });
 
-	return length;
+	// カメラの後ろへ伸びる線も近平面で切って描く
+	AddClippedLines(debugDraw, points, { screenX, screenY, visible }, wireframe.lines, sphereMatrix, color);
 }
 
-Vector3 Perpendicular(const Vector3& vector)
-{
-	if (vector.x != 0.0f || vector.y != 0.0f) {
-		return{ -vector.y,vector.x,0.0f };
-	}
-
-	return { 0.0f,-vector.z,vector.y };
-}
-
-void DrawPlane(const Plane& plane, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+void DrawPlane(const Plane& plane, const Matrix4x4& viewProjectionViewportMatrix, uint32_t color, DebugDraw& debugDraw)
 {
+	PROFILE_SCOPE("DrawPlane");
 	// 1.中心点を決める
 	Vector3 center = {
 		plane.distance * plane.normal.x,
@@ -423,7 +561,9 @@ void DrawPlane(const Plane& plane, const Matrix4x4& viewProjectionMatrix, const
 	perpendiculars[3] = { -perpendiculars[2].x,-perpendiculars[2].y,-perpendiculars[2].z };
 
 	// 6.2~5のベクトルを中心にそれぞれ定数売して足すと4頂点が出来上がる
-	Vector3 points[4];
+	float x[4];
+	float y[4];
+	float z[4];
 	for (int32_t index = 0; index < 4; ++index) {
 		Vector3 extend = {
 		2.0f * perpendiculars[index].x,
@@ -432,485 +572,44 @@ void DrawPlane(const Plane& plane, const Matrix4x4& viewProjectionMatrix, const
 		};
 
 		Vector3 point = Add(center, extend);
-		points[index] = Transform(Transform(point, viewProjectionMatrix), viewportMatrix);
-
+		x[index] = point.x;
+		y[index] = point.y;
+		z[index] = point.z;
 	}
 
-	Novice::DrawLine(
-		static_cast<int>(points[0].x),
-		static_cast<int>(points[0].y),
-		static_cast<int>(points[2].x),
-		static_cast<int>(points[2].y), color);
-
-	Novice::DrawLine(
-		static_cast<int>(points[2].x),
-		static_cast<int>(points[2].y),
-		static_cast<int>(points[1].x),
-		static_cast<int>(points[1].y), color);
-
-	Novice::DrawLine(
-		static_cast<int>(points[1].x),
-		static_cast<int>(points[1].y),
-		static_cast<int>(points[3].x),
-		static_cast<int>(points[3].y), color);
-
-	Novice::DrawLine(
-		static_cast<int>(points[3].x),
-		static_cast<int>(points[3].y),
-		static_cast<int>(points[0].x),
-		static_cast<int>(points[0].y), color);
+	float screenX[4];
+	float screenY[4];
+	uint8_t visible[4];
+	TransformToScreen({ x, y, z }, viewProjectionViewportMatrix, { screenX, screenY, visible });
 
+	const uint32_t indices[] = { 0, 2, 2, 1, 1, 3, 3, 0 };
+	AddClippedLines(debugDraw, { x, y, z }, { screenX, screenY, visible }, indices, viewProjectionViewportMatrix, color);
 }
 
-Vector3 Normalize(const Vector3& v)
+void DrawSegment(const Segment& segment, const Matrix4x4& viewProjectionViewportMatrix, uint32_t color, DebugDraw& debugDraw)
 {
-	Vector3 normalised;
-	float nolm;
-
-	nolm = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
-
-	normalised = { v.x / nolm,v.y / nolm, v.z / nolm };
-
-	return normalised;
+	PROFILE_SCOPE("DrawSegment");
+	// 始点と終点(diff)をまとめて変換する(カメラの後ろに回ってもassertしない)
+	float x[2] = { segment.origin.x, segment.diff.x };
+	float y[2] = { segment.origin.y, segment.diff.y };
+	float z[2] = { segment.origin.z, segment.diff.z };
+
+	float screenX[2];
+	float screenY[2];
+	uint8_t visible[2];
+	TransformToScreen({ x, y, z }, viewProjectionViewportMatrix, { screenX, screenY, visible });
+
+	const uint32_t indices[] = { 0, 1 };
+	AddClippedLines(debugDraw, { x, y, z }, { screenX, screenY, visible }, indices, viewProjectionViewportMatrix, color);
 }
 
-Vector3 Cross(const Vector3& v1, const Vector3& v2)
+void SubmitNoviceLines(void*, std::span<const DebugLine> lines)
 {
-	Vector3 result;
-
-	result.x = (v1.y * v2.z) - (v1.z * v2.y);
-	result.y = (v1.z * v2.x) - (v1.x * v2.z);
-	result.z = (v1.x * v2.y) - (v1.y * v2.x);
-
-	return result;
-}
-
-Vector3 ClosestPoint(const Vector3& point, const Segment& segment)
-{
-	Vector3 closestPoint;
-	Vector3 project = Project(Subtract(point, segment.origin), segment.diff);
-
-	closestPoint = { project.x + segment.origin.x,project.y + segment.origin.y ,project.z + segment.origin.z };
-
-	return closestPoint;
-}
-
-Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix)
-{
-	Vector3 resultVector3;
-
-	resultVector3.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + 1.0f * matrix.m[3][0];
-	resultVector3.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + 1.0f * matrix.m[3][1];
-	resultVector3.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + 1.0f * matrix.m[3][2];
-
-	float w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + 1.0f * matrix.m[3][3];
-
-	assert(w != 0.0f);
-
-	resultVector3.x /= w;
-	resultVector3.y /= w;
-	resultVector3.z /= w;
-
-	return resultVector3;
-}
-
-
-float Cotangent(float theta)
-{
-	float cotngent;
-
-	cotngent = 1.0f / std::tanf(theta);
-
-	return cotngent;
-}
-
-Matrix4x4 MakeAffineMatrix(Vector3 scale, Vector3 rotate, Vector3 translate)
-{
-	//====================
-	// 拡縮の行列の作成
-	//====================
-	Matrix4x4 scaleMatrix4x4;
-	scaleMatrix4x4.m[0][0] = scale.x;
-	scaleMatrix4x4.m[0][1] = 0.0f;
-	scaleMatrix4x4.m[0][2] = 0.0f;
-	scaleMatrix4x4.m[0][3] = 0.0f;
-
-	scaleMatrix4x4.m[1][0] = 0.0f;
-	scaleMatrix4x4.m[1][1] = scale.y;
-	scaleMatrix4x4.m[1][2] = 0.0f;
-	scaleMatrix4x4.m[1][3] = 0.0f;
-
-	scaleMatrix4x4.m[2][0] = 0.0f;
-	scaleMatrix4x4.m[2][1] = 0.0f;
-	scaleMatrix4x4.m[2][2] = scale.z;
-	scaleMatrix4x4.m[2][3] = 0.0f;
-
-	scaleMatrix4x4.m[3][0] = 0.0f;
-	scaleMatrix4x4.m[3][1] = 0.0f;
-	scaleMatrix4x4.m[3][2] = 0.0f;
-	scaleMatrix4x4.m[3][3] = 1.0f;
-
-	//===================
-	// 回転の行列の作成
-	//===================
-	// Xの回転行列
-	Matrix4x4 rotateMatrixX;
-	rotateMatrixX.m[0][0] = 1.0f;
-	rotateMatrixX.m[0][1] = 0.0f;
-	rotateMatrixX.m[0][2] = 0.0f;
-	rotateMatrixX.m[0][3] = 0.0f;
-
-	rotateMatrixX.m[1][0] = 0.0f;
-	rotateMatrixX.m[1][1] = cosf(rotate.x);
-	rotateMatrixX.m[1][2] = sinf(rotate.x);
-	rotateMatrixX.m[1][3] = 0.0f;
-
-	rotateMatrixX.m[2][0] = 0.0f;
-	rotateMatrixX.m[2][1] = -sinf(rotate.x);
-	rotateMatrixX.m[2][2] = cosf(rotate.x);
-	rotateMatrixX.m[2][3] = 0.0f;
-
-	rotateMatrixX.m[3][0] = 0.0f;
-	rotateMatrixX.m[3][1] = 0.0f;
-	rotateMatrixX.m[3][2] = 0.0f;
-	rotateMatrixX.m[3][3] = 1.0f;
-
-	// Yの回転行列
-	Matrix4x4 rotateMatrixY;
-	rotateMatrixY.m[0][0] = cosf(rotate.y);
-	rotateMatrixY.m[0][1] = 0.0f;
-	rotateMatrixY.m[0][2] = -sinf(rotate.y);
-	rotateMatrixY.m[0][3] = 0.0f;
-
-	rotateMatrixY.m[1][0] = 0.0f;
-	rotateMatrixY.m[1][1] = 1.0f;
-	rotateMatrixY.m[1][2] = 0.0f;
-	rotateMatrixY.m[1][3] = 0.0f;
-
-	rotateMatrixY.m[2][0] = sinf(rotate.y);
-	rotateMatrixY.m[2][1] = 0.0f;
-	rotateMatrixY.m[2][2] = cosf(rotate.y);
-	rotateMatrixY.m[2][3] = 0.0f;
-
-	rotateMatrixY.m[3][0] = 0.0f;
-	rotateMatrixY.m[3][1] = 0.0f;
-	rotateMatrixY.m[3][2] = 0.0f;
-	rotateMatrixY.m[3][3] = 1.0f;
-
-	// Zの回転行列
-	Matrix4x4 rotateMatrixZ;
-	rotateMatrixZ.m[0][0] = cosf(rotate.z);
-	rotateMatrixZ.m[0][1] = sinf(rotate.z);
-	rotateMatrixZ.m[0][2] = 0.0f;
-	rotateMatrixZ.m[0][3] = 0.0f;
-
-	rotateMatrixZ.m[1][0] = -sinf(rotate.z);
-	rotateMatrixZ.m[1][1] = cosf(rotate.z);
-	rotateMatrixZ.m[1][2] = 0.0f;
-	rotateMatrixZ.m[1][3] = 0.0f;
-
-	rotateMatrixZ.m[2][0] = 0.0f;
-	rotateMatrixZ.m[2][1] = 0.0f;
-	rotateMatrixZ.m[2][2] = 1.0f;
-	rotateMatrixZ.m[2][3] = 0.0f;
-
-	rotateMatrixZ.m[3][0] = 0.0f;
-	rotateMatrixZ.m[3][1] = 0.0f;
-	rotateMatrixZ.m[3][2] = 0.0f;
-	rotateMatrixZ.m[3][3] = 1.0f;
-
-	// 回転行列の作成
-	Matrix4x4 rotateMatrix4x4;
-
-	rotateMatrix4x4 = Multiply(rotateMatrixX, Multiply(rotateMatrixY, rotateMatrixZ));
-
-	//==================
-	// 移動の行列の作成
-	//==================
-	Matrix4x4 translateMatrix4x4;
-	translateMatrix4x4.m[0][0] = 1.0f;
-	translateMatrix4x4.m[0][1] = 0.0f;
-	translateMatrix4x4.m[0][2] = 0.0f;
-	translateMatrix4x4.m[0][3] = 0.0f;
-
-	translateMatrix4x4.m[1][0] = 0.0f;
-	translateMatrix4x4.m[1][1] = 1.0f;
-	translateMatrix4x4.m[1][2] = 0.0f;
-	translateMatrix4x4.m[1][3] = 0.0f;
-
-	translateMatrix4x4.m[2][0] = 0.0f;
-	translateMatrix4x4.m[2][1] = 0.0f;
-	translateMatrix4x4.m[2][2] = 1.0f;
-	translateMatrix4x4.m[2][3] = 0.0f;
-
-	translateMatrix4x4.m[3][0] = translate.x;
-	translateMatrix4x4.m[3][1] = translate.y;
-	translateMatrix4x4.m[3][2] = translate.z;
-	translateMatrix4x4.m[3][3] = 1.0f;
-
-	//====================
-	// アフィン行列の作成
-	//====================
-	// 上で作った行列からアフィン行列を作る
-	// アフィン行列の作成（スケール→回転→移動の順）
-	Matrix4x4 affineMatrix4x4;
-	affineMatrix4x4 = Multiply(scaleMatrix4x4, Multiply(rotateMatrix4x4, translateMatrix4x4));
-
-	return  affineMatrix4x4;
-}
-
-Matrix4x4 Inverse(Matrix4x4 matrix4x4)
-{
-	// 行列式|A|を求める
-	float bottom =
-		(matrix4x4.m[0][0] * matrix4x4.m[1][1] * matrix4x4.m[2][2] * matrix4x4.m[3][3])
-		+ (matrix4x4.m[0][0] * matrix4x4.m[1][2] * matrix4x4.m[2][3] * matrix4x4.m[3][1])
-		+ (matrix4x4.m[0][0] * matrix4x4.m[1][3] * matrix4x4.m[2][1] * matrix4x4.m[3][2])
-		- (matrix4x4.m[0][0] * matrix4x4.m[1][3] * matrix4x4.m[2][2] * matrix4x4.m[3][1])
-		- (matrix4x4.m[0][0] * matrix4x4.m[1][2] * matrix4x4.m[2][1] * matrix4x4.m[3][3])
-		- (matrix4x4.m[0][0] * matrix4x4.m[1][1] * matrix4x4.m[2][3] * matrix4x4.m[3][2])
-		- (matrix4x4.m[0][1] * matrix4x4.m[1][0] * matrix4x4.m[2][2] * matrix4x4.m[3][3])
-		- (matrix4x4.m[0][2] * matrix4x4.m[1][0] * matrix4x4.m[2][3] * matrix4x4.m[3][1])
-		- (matrix4x4.m[0][3] * matrix4x4.m[1][0] * matrix4x4.m[2][1] * matrix4x4.m[3][2])
-		+ (matrix4x4.m[0][3] * matrix4x4.m[1][0] * matrix4x4.m[2][2] * matrix4x4.m[3][1])
-		+ (matrix4x4.m[0][2] * matrix4x4.m[1][0] * matrix4x4.m[2][1] * matrix4x4.m[3][3])
-		+ (matrix4x4.m[0][1] * matrix4x4.m[1][0] * matrix4x4.m[2][3] * matrix4x4.m[3][2])
-		+ (matrix4x4.m[0][1] * matrix4x4.m[1][2] * matrix4x4.m[2][0] * matrix4x4.m[3][3])
-		+ (matrix4x4.m[0][2] * matrix4x4.m[1][3] * matrix4x4.m[2][0] * matrix4x4.m[3][1])
-		+ (matrix4x4.m[0][3] * matrix4x4.m[1][1] * matrix4x4.m[2][0] * matrix4x4.m[3][2])
-		- (matrix4x4.m[0][3] * matrix4x4.m[1][2] * matrix4x4.m[2][0] * matrix4x4.m[3][1])
-		- (matrix4x4.m[0][2] * matrix4x4.m[1][1] * matrix4x4.m[2][0] * matrix4x4.m[3][3])
-		- (matrix4x4.m[0][1] * matrix4x4.m[1][3] * matrix4x4.m[2][0] * matrix4x4.m[3][2])
-		- (matrix4x4.m[0][1] * matrix4x4.m[1][2] * matrix4x4.m[2][3] * matrix4x4.m[3][0])
-		- (matrix4x4.m[0][2] * matrix4x4.m[1][3] * matrix4x4.m[2][1] * matrix4x4.m[3][0])
-		- (matrix4x4.m[0][3] * matrix4x4.m[1][1] * matrix4x4.m[2][2] * matrix4x4.m[3][0])
-		+ (matrix4x4.m[0][3] * matrix4x4.m[1][2] * matrix4x4.m[2][1] * matrix4x4.m[3][0])
-		+ (matrix4x4.m[0][2] * matrix4x4.m[1][1] * matrix4x4.m[2][3] * matrix4x4.m[3][0])
-		+ (matrix4x4.m[0][1] * matrix4x4.m[1][3] * matrix4x4.m[2][2] * matrix4x4.m[3][0]);
-
-	Matrix4x4 resoultMatrix;
-
-	// 1行目
-	resoultMatrix.m[0][0] = 1.0f / bottom * (
-		(matrix4x4.m[1][1] * matrix4x4.m[2][2] * matrix4x4.m[3][3])
-		+ (matrix4x4.m[1][2] * matrix4x4.m[2][3] * matrix4x4.m[3][1])
-		+ (matrix4x4.m[1][3] * matrix4x4.m[2][1] * matrix4x4.m[3][2])
-		- (matrix4x4.m[1][3] * matrix4x4.m[2][2] * matrix4x4.m[3][1])
-		- (matrix4x4.m[1][2] * matrix4x4.m[2][1] * matrix4x4.m[3][3])
-		- (matrix4x4.m[1][1] * matrix4x4.m[2][3] * matrix4x4.m[3][2]));
-
-	resoultMatrix.m[0][1] = 1.0f / bottom * (
-		-(matrix4x4.m[0][1] * matrix4x4.m[2][2] * matrix4x4.m[3][3])
-		- (matrix4x4.m[0][2] * matrix4x4.m[2][3] * matrix4x4.m[3][1])
-		- (matrix4x4.m[0][3] * matrix4x4.m[2][1] * matrix4x4.m[3][2])
-		+ (matrix4x4.m[0][3] * matrix4x4.m[2][2] * matrix4x4.m[3][1])
-		+ (matrix4x4.m[0][2] * matrix4x4.m[2][1] * matrix4x4.m[3][3])
-		+ (matrix4x4.m[0][1] * matrix4x4.m[2][3] * matrix4x4.m[3][2]));
-
-	resoultMatrix.m[0][2] = 1.0f / bottom * (
-		(matrix4x4.m[0][1] * matrix4x4.m[1][2] * matrix4x4.m[3][3])
-		+ (matrix4x4.m[0][2] * matrix4x4.m[1][3] * matrix4x4.m[3][1])
-		+ (matrix4x4.m[0][3] * matrix4x4.m[1][1] * matrix4x4.m[3][2])
-		- (matrix4x4.m[0][3] * matrix4x4.m[1][2] * matrix4x4.m[3][1])
-		- (matrix4x4.m[0][2] * matrix4x4.m[1][1] * matrix4x4.m[3][3])
-		- (matrix4x4.m[0][1] * matrix4x4.m[1][3] * matrix4x4.m[3][2]));
-
-	resoultMatrix.m[0][3] = 1.0f / bottom * (
-		-(matrix4x4.m[0][1] * matrix4x4.m[1][2] * matrix4x4.m[2][3])
-		- (matrix4x4.m[0][2] * matrix4x4.m[1][3] * matrix4x4.m[2][1])
-		- (matrix4x4.m[0][3] * matrix4x4.m[1][1] * matrix4x4.m[2][2])
-		+ (matrix4x4.m[0][3] * matrix4x4.m[1][2] * matrix4x4.m[2][1])
-		+ (matrix4x4.m[0][2] * matrix4x4.m[1][1] * matrix4x4.m[2][3])
-		+ (matrix4x4.m[0][1] * matrix4x4.m[1][3] * matrix4x4.m[2][2]));
-
-	// 2行目
-	resoultMatrix.m[1][0] = 1.0f / bottom * (
-		-(matrix4x4.m[1][0] * matrix4x4.m[2][2] * matrix4x4.m[3][3])
-		- (matrix4x4.m[1][2] * matrix4x4.m[2][3] * matrix4x4.m[3][0])
-		- (matrix4x4.m[1][3] * matrix4x4.m[2][0] * matrix4x4.m[3][2])
-		+ (matrix4x4.m[1][3] * matrix4x4.m[2][2] * matrix4x4.m[3][0])
-		+ (matrix4x4.m[1][2] * matrix4x4.m[2][0] * matrix4x4.m[3][3])
-		+ (matrix4x4.m[1][0] * matrix4x4.m[2][3] * matrix4x4.m[3][2]));
-
-	resoultMatrix.m[1][1] = 1.0f / bottom * (
-		(matrix4x4.m[0][0] * matrix4x4.m[2][2] * matrix4x4.m[3][3])
-		+ (matrix4x4.m[0][2] * matrix4x4.m[2][3] * matrix4x4.m[3][0])
-		+ (matrix4x4.m[0][3] * matrix4x4.m[2][0] * matrix4x4.m[3][2])
-		- (matrix4x4.m[0][3] * matrix4x4.m[2][2] * matrix4x4.m[3][0])
-		- (matrix4x4.m[0][2] * matrix4x4.m[2][0] * matrix4x4.m[3][3])
-		- (matrix4x4.m[0][0] * matrix4x4.m[2][3] * matrix4x4.m[3][2]));
-
-	resoultMatrix.m[1][2] = 1.0f / bottom * (
-		-(matrix4x4.m[0][0] * matrix4x4.m[1][2] * matrix4x4.m[3][3])
-		- (matrix4x4.m[0][2] * matrix4x4.m[1][3] * matrix4x4.m[3][0])
-		- (matrix4x4.m[0][3] * matrix4x4.m[1][0] * matrix4x4.m[3][2])
-		+ (matrix4x4.m[0][3] * matrix4x4.m[1][2] * matrix4x4.m[3][0])
-		+ (matrix4x4.m[0][2] * matrix4x4.m[1][0] * matrix4x4.m[3][3])
-		+ (matrix4x4.m[0][0] * matrix4x4.m[1][3] * matrix4x4.m[3][2]));
-
-	resoultMatrix.m[1][3] = 1.0f / bottom * (
-		(matrix4x4.m[0][0] * matrix4x4.m[1][2] * matrix4x4.m[2][3])
-		+ (matrix4x4.m[0][2] * matrix4x4.m[1][3] * matrix4x4.m[2][0])
-		+ (matrix4x4.m[0][3] * matrix4x4.m[1][0] * matrix4x4.m[2][2])
-		- (matrix4x4.m[0][3] * matrix4x4.m[1][2] * matrix4x4.m[2][0])
-		- (matrix4x4.m[0][2] * matrix4x4.m[1][0] * matrix4x4.m[2][3])
-		- (matrix4x4.m[0][0] * matrix4x4.m[1][3] * matrix4x4.m[2][2]));
-
-	// 3行目
-	resoultMatrix.m[2][0] = 1.0f / bottom * (
-		(matrix4x4.m[1][0] * matrix4x4.m[2][1] * matrix4x4.m[3][3])
-		+ (matrix4x4.m[1][1] * matrix4x4.m[2][3] * matrix4x4.m[3][0])
-		+ (matrix4x4.m[1][3] * matrix4x4.m[2][0] * matrix4x4.m[3][1])
-		- (matrix4x4.m[1][3] * matrix4x4.m[2][1] * matrix4x4.m[3][0])
-		- (matrix4x4.m[1][1] * matrix4x4.m[2][0] * matrix4x4.m[3][3])
-		- (matrix4x4.m[1][0] * matrix4x4.m[2][3] * matrix4x4.m[3][1]));
-
-	resoultMatrix.m[2][1] = 1.0f / bottom * (
-		-(matrix4x4.m[0][0] * matrix4x4.m[2][1] * matrix4x4.m[3][3])
-		- (matrix4x4.m[0][1] * matrix4x4.m[2][3] * matrix4x4.m[3][0])
-		- (matrix4x4.m[0][3] * matrix4x4.m[2][0] * matrix4x4.m[3][1])
-		+ (matrix4x4.m[0][3] * matrix4x4.m[2][1] * matrix4x4.m[3][0])
-		+ (matrix4x4.m[0][1] * matrix4x4.m[2][0] * matrix4x4.m[3][3])
-		+ (matrix4x4.m[0][0] * matrix4x4.m[2][3] * matrix4x4.m[3][1]));
-
-	resoultMatrix.m[2][2] = 1.0f / bottom * (
-		(matrix4x4.m[0][0] * matrix4x4.m[1][1] * matrix4x4.m[3][3])
-		+ (matrix4x4.m[0][1] * matrix4x4.m[1][3] * matrix4x4.m[3][0])
-		+ (matrix4x4.m[0][3] * matrix4x4.m[1][0] * matrix4x4.m[3][1])
-		- (matrix4x4.m[0][3] * matrix4x4.m[1][1] * matrix4x4.m[3][0])
-		- (matrix4x4.m[0][1] * matrix4x4.m[1][0] * matrix4x4.m[3][3])
-		- (matrix4x4.m[0][0] * matrix4x4.m[1][3] * matrix4x4.m[3][1]));
-
-	resoultMatrix.m[2][3] = 1.0f / bottom * (
-		-(matrix4x4.m[0][0] * matrix4x4.m[1][1] * matrix4x4.m[2][3])
-		- (matrix4x4.m[0][1] * matrix4x4.m[1][3] * matrix4x4.m[2][0])
-		- (matrix4x4.m[0][3] * matrix4x4.m[1][0] * matrix4x4.m[2][1])
-		+ (matrix4x4.m[0][3] * matrix4x4.m[1][1] * matrix4x4.m[2][0])
-		+ (matrix4x4.m[0][1] * matrix4x4.m[1][0] * matrix4x4.m[2][3])
-		+ (matrix4x4.m[0][0] * matrix4x4.m[1][3] * matrix4x4.m[2][1]));
-
-	// 4行目
-	resoultMatrix.m[3][0] = 1.0f / bottom * (
-		-(matrix4x4.m[1][0] * matrix4x4.m[2][1] * matrix4x4.m[3][2])
-		- (matrix4x4.m[1][1] * matrix4x4.m[2][2] * matrix4x4.m[3][0])
-		- (matrix4x4.m[1][2] * matrix4x4.m[2][0] * matrix4x4.m[3][1])
-		+ (matrix4x4.m[1][2] * matrix4x4.m[2][1] * matrix4x4.m[3][0])
-		+ (matrix4x4.m[1][1] * matrix4x4.m[2][0] * matrix4x4.m[3][2])
-		+ (matrix4x4.m[1][0] * matrix4x4.m[2][2] * matrix4x4.m[3][1]));
-
-	resoultMatrix.m[3][1] = 1.0f / bottom * (
-		(matrix4x4.m[0][0] * matrix4x4.m[2][1] * matrix4x4.m[3][2])
-		+ (matrix4x4.m[0][1] * matrix4x4.m[2][2] * matrix4x4.m[3][0])
-		+ (matrix4x4.m[0][2] * matrix4x4.m[2][0] * matrix4x4.m[3][1])
-		- (matrix4x4.m[0][2] * matrix4x4.m[2][1] * matrix4x4.m[3][0])
-		- (matrix4x4.m[0][1] * matrix4x4.m[2][0] * matrix4x4.m[3][2])
-		- (matrix4x4.m[0][0] * matrix4x4.m[2][2] * matrix4x4.m[3][1]));
-
-	resoultMatrix.m[3][2] = 1.0f / bottom * (
-		-(matrix4x4.m[0][0] * matrix4x4.m[1][1] * matrix4x4.m[3][2])
-		- (matrix4x4.m[0][1] * matrix4x4.m[1][2] * matrix4x4.m[3][0])
-		- (matrix4x4.m[0][2] * matrix4x4.m[1][0] * matrix4x4.m[3][1])
-		+ (matrix4x4.m[0][2] * matrix4x4.m[1][1] * matrix4x4.m[3][0])
-		+ (matrix4x4.m[0][1] * matrix4x4.m[1][0] * matrix4x4.m[3][2])
-		+ (matrix4x4.m[0][0] * matrix4x4.m[1][2] * matrix4x4.m[3][1]));
-
-	resoultMatrix.m[3][3] = 1.0f / bottom * (
-		(matrix4x4.m[0][0] * matrix4x4.m[1][1] * matrix4x4.m[2][2])
-		+ (matrix4x4.m[0][1] * matrix4x4.m[1][2] * matrix4x4.m[2][0])
-		+ (matrix4x4.m[0][2] * matrix4x4.m[1][0] * matrix4x4.m[2][1])
-		- (matrix4x4.m[0][2] * matrix4x4.m[1][1] * matrix4x4.m[2][0])
-		- (matrix4x4.m[0][1] * matrix4x4.m[1][0] * matrix4x4.m[2][2])
-		- (matrix4x4.m[0][0] * matrix4x4.m[1][2] * matrix4x4.m[2][1]));
-
-	return resoultMatrix;
-}
-
-Matrix4x4 Multiply(Matrix4x4 matrix1, Matrix4x4 matrix2)
-{
-	Matrix4x4 resoultMatrix4x4;
-
-	resoultMatrix4x4.m[0][0] = matrix1.m[0][0] * matrix2.m[0][0] + matrix1.m[0][1] * matrix2.m[1][0] + matrix1.m[0][2] * matrix2.m[2][0] + matrix1.m[0][3] * matrix2.m[3][0];
-	resoultMatrix4x4.m[0][1] = matrix1.m[0][0] * matrix2.m[0][1] + matrix1.m[0][1] * matrix2.m[1][1] + matrix1.m[0][2] * matrix2.m[2][1] + matrix1.m[0][3] * matrix2.m[3][1];
-	resoultMatrix4x4.m[0][2] = matrix1.m[0][0] * matrix2.m[0][2] + matrix1.m[0][1] * matrix2.m[1][2] + matrix1.m[0][2] * matrix2.m[2][2] + matrix1.m[0][3] * matrix2.m[3][2];
-	resoultMatrix4x4.m[0][3] = matrix1.m[0][0] * matrix2.m[0][3] + matrix1.m[0][1] * matrix2.m[1][3] + matrix1.m[0][2] * matrix2.m[2][3] + matrix1.m[0][3] * matrix2.m[3][3];
-
-	resoultMatrix4x4.m[1][0] = matrix1.m[1][0] * matrix2.m[0][0] + matrix1.m[1][1] * matrix2.m[1][0] + matrix1.m[1][2] * matrix2.m[2][0] + matrix1.m[1][3] * matrix2.m[3][0];
-	resoultMatrix4x4.m[1][1] = matrix1.m[1][0] * matrix2.m[0][1] + matrix1.m[1][1] * matrix2.m[1][1] + matrix1.m[1][2] * matrix2.m[2][1] + matrix1.m[1][3] * matrix2.m[3][1];
-	resoultMatrix4x4.m[1][2] = matrix1.m[1][0] * matrix2.m[0][2] + matrix1.m[1][1] * matrix2.m[1][2] + matrix1.m[1][2] * matrix2.m[2][2] + matrix1.m[1][3] * matrix2.m[3][2];
-	resoultMatrix4x4.m[1][3] = matrix1.m[1][0] * matrix2.m[0][3] + matrix1.m[1][1] * matrix2.m[1][3] + matrix1.m[1][2] * matrix2.m[2][3] + matrix1.m[1][3] * matrix2.m[3][3];
-
-	resoultMatrix4x4.m[2][0] = matrix1.m[2][0] * matrix2.m[0][0] + matrix1.m[2][1] * matrix2.m[1][0] + matrix1.m[2][2] * matrix2.m[2][0] + matrix1.m[2][3] * matrix2.m[3][0];
-	resoultMatrix4x4.m[2][1] = matrix1.m[2][0] * matrix2.m[0][1] + matrix1.m[2][1] * matrix2.m[1][1] + matrix1.m[2][2] * matrix2.m[2][1] + matrix1.m[2][3] * matrix2.m[3][1];
-	resoultMatrix4x4.m[2][2] = matrix1.m[2][0] * matrix2.m[0][2] + matrix1.m[2][1] * matrix2.m[1][2] + matrix1.m[2][2] * matrix2.m[2][2] + matrix1.m[2][3] * matrix2.m[3][2];
-	resoultMatrix4x4.m[2][3] = matrix1.m[2][0] * matrix2.m[0][3] + matrix1.m[2][1] * matrix2.m[1][3] + matrix1.m[2][2] * matrix2.m[2][3] + matrix1.m[2][3] * matrix2.m[3][3];
-
-	resoultMatrix4x4.m[3][0] = matrix1.m[3][0] * matrix2.m[0][0] + matrix1.m[3][1] * matrix2.m[1][0] + matrix1.m[3][2] * matrix2.m[2][0] + matrix1.m[3][3] * matrix2.m[3][0];
-	resoultMatrix4x4.m[3][1] = matrix1.m[3][0] * matrix2.m[0][1] + matrix1.m[3][1] * matrix2.m[1][1] + matrix1.m[3][2] * matrix2.m[2][1] + matrix1.m[3][3] * matrix2.m[3][1];
-	resoultMatrix4x4.m[3][2] = matrix1.m[3][0] * matrix2.m[0][2] + matrix1.m[3][1] * matrix2.m[1][2] + matrix1.m[3][2] * matrix2.m[2][2] + matrix1.m[3][3] * matrix2.m[3][2];
-	resoultMatrix4x4.m[3][3] = matrix1.m[3][0] * matrix2.m[0][3] + matrix1.m[3][1] * matrix2.m[1][3] + matrix1.m[3][2] * matrix2.m[2][3] + matrix1.m[3][3] * matrix2.m[3][3];
-
-	return resoultMatrix4x4;
-}
-
-Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth)
-{
-	Matrix4x4 viewportMatrix4x4;
-
-	viewportMatrix4x4.m[0][0] = width / 2.0f;
-	viewportMatrix4x4.m[0][1] = 0.0f;
-	viewportMatrix4x4.m[0][2] = 0.0f;
-	viewportMatrix4x4.m[0][3] = 0.0f;
-
-	viewportMatrix4x4.m[1][0] = 0.0f;
-	viewportMatrix4x4.m[1][1] = -height / 2.0f;
-	viewportMatrix4x4.m[1][2] = 0.0f;
-	viewportMatrix4x4.m[1][3] = 0.0f;
-
-	viewportMatrix4x4.m[2][0] = 0.0f;
-	viewportMatrix4x4.m[2][1] = 0.0f;
-	viewportMatrix4x4.m[2][2] = maxDepth - minDepth;
-	viewportMatrix4x4.m[2][3] = 0.0f;
-
-	viewportMatrix4x4.m[3][0] = left + width / 2.0f;
-	viewportMatrix4x4.m[3][1] = top + height / 2.0f;
-	viewportMatrix4x4.m[3][2] = minDepth;
-	viewportMatrix4x4.m[3][3] = 1.0f;
-
-	return viewportMatrix4x4;
-}
-
-Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip)
-{
-	Matrix4x4 perspectiveFovMatrix;
-
-	perspectiveFovMatrix.m[0][0] = 1.0f / aspectRatio * Cotangent(fovY / 2.0f);
-	perspectiveFovMatrix.m[0][1] = 0.0f;
-	perspectiveFovMatrix.m[0][2] = 0.0f;
-	perspectiveFovMatrix.m[0][3] = 0.0f;
-
-	perspectiveFovMatrix.m[1][0] = 0.0f;
-	perspectiveFovMatrix.m[1][1] = Cotangent(fovY / 2.0f);
-	perspectiveFovMatrix.m[1][2] = 0.0f;
-	perspectiveFovMatrix.m[1][3] = 0.0f;
-
-	perspectiveFovMatrix.m[2][0] = 0.0f;
-	perspectiveFovMatrix.m[2][1] = 0.0f;
-	perspectiveFovMatrix.m[2][2] = farClip / (farClip - nearClip);
-	perspectiveFovMatrix.m[2][3] = 1.0f;
-
-	perspectiveFovMatrix.m[3][0] = 0.0f;
-	perspectiveFovMatrix.m[3][1] = 0.0f;
-	perspectiveFovMatrix.m[3][2] = (-nearClip * farClip) / (farClip - nearClip);
-	perspectiveFovMatrix.m[3][3] = 0.0f;
-
-	return perspectiveFovMatrix;
+	for (const DebugLine& line : lines) {
+		Novice::DrawLine(
+			static_cast<int>(std::lround(line.startX)),
+			static_cast<int>(std::lround(line.startY)),
+			static_cast<int>(std::lround(line.endX)),
+			static_cast<int>(std::lround(line.endY)), line.color);
+	}
 }
-
-Vector3 TransformWithoutW(const Vector3& vector, const Matrix4x4& matrix)
-{
-	Vector3 result;
-	result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + matrix.m[3][0];
-	result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + matrix.m[3][1];
-	result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + matrix.m[3][2];
-	return result;
-}
\ No newline at end of file